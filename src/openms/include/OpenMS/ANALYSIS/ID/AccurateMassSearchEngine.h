@@ -277,14 +277,16 @@ public:
 
     /// main method of AccurateMassSearchEngine
     /// input map is not const, since it will get annotated with results
+    /// @note Features are queried in parallel (if OpenMP is enabled); results are reported in input order.
     void run(FeatureMap&, MzTab&) const;
 
     /// main method of AccurateMassSearchEngine
     /// input map is not const, since it will get annotated with results
     /// @note Call init() before calling run!
+    /// @note Consensus features are queried in parallel (if OpenMP is enabled); results are reported in input order.
     void run(ConsensusMap&, MzTab&) const;
 
-    /// parse database and adduct files
+    /// parse database and adduct files and precompute which database entries are compatible with which adduct
     void init();
 
 protected:
@@ -342,6 +344,12 @@ private:
     void parseAdductsFile_(const String& filename, std::vector<AdductInfo>& result);
     void searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const;
 
+    /// parse the formulas of all database entries and compute their compatibility with all adducts (called by init())
+    void buildCompatibilityIndex_();
+
+    /// throws if the database is empty or @p ion_mode is neither 'positive' nor 'negative' (checked once before parallel querying)
+    void checkQueryPreconditions_(const String& ion_mode) const;
+
     /// add search results to a Consensus/Feature
     void annotate_(const std::vector<AccurateMassSearchResult>&, BaseFeature&) const;
 
@@ -365,7 +373,15 @@ private:
       std::vector<String> massIDs;
       String formula;
     };
-    std::vector<MappingEntry_> mass_mappings_;
+    std::vector<MappingEntry_> mass_mappings_; ///< database entries, sorted by mass
+
+    /// @name Precomputed, read-only views of mass_mappings_ (same order), filled by init()
+    //@{
+    std::vector<double> db_masses_; ///< masses of all entries (contiguous for the binary search)
+    std::vector<EmpiricalFormula> db_formulas_; ///< parsed formulas of all entries
+    std::vector<std::vector<bool> > pos_adducts_compatible_; ///< [adduct][entry]: can entry carry pos_adducts_[adduct]?
+    std::vector<std::vector<bool> > neg_adducts_compatible_; ///< [adduct][entry]: can entry carry neg_adducts_[adduct]?
+    //@}
 
     struct CompareEntryAndMass_ // defined here to allow for inlining by compiler
     {
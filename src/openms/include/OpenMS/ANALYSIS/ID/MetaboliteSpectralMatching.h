@@ -40,6 +40,7 @@
 #include <OpenMS/FORMAT/MzTab.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
@@ -175,9 +176,47 @@ namespace OpenMS
       std::vector<PeptideHit::PeakAnnotation>& annotations,
       double mz_lower_bound = 0.0);
 
-    /// main method of MetaboliteSpectralMatching
+    /**
+      @brief main method of MetaboliteSpectralMatching
+
+      Searches the MS2 spectra of the first map against the spectral library given as second map.
+
+      The library is sorted by precursor m/z and each library spectrum is binned once (see BinnedSpectrum).
+      Library spectra within the precursor tolerance of a query are only scored if the binned spectra show
+      that at least three query peaks can be matched (otherwise the hyperscore would be zero anyway), so the
+      reported scores are identical to scoring all precursor candidates. Query spectra are processed in parallel.
+    */
     void run(PeakMap &, PeakMap &, MzTab &);
 
+    /**
+      @brief Stores the spectral library @p spec_db in a binary cache file, which is much faster to load than mzML
+
+      Only the information used for matching is stored: RT, MS level, precursors (m/z, charge, intensity),
+      peaks and meta values (converted to strings).
+      If @p source (the file @p spec_db was loaded from) is given, its path, size and modification time are
+      stored as well, so isLibraryCacheCurrent() can detect a changed library.
+
+      @exception Exception::UnableToCreateFile if the file cannot be written
+    */
+    static void storeLibraryCache(const String& filename, const PeakMap& spec_db, const String& source = "");
+
+    /**
+      @brief Loads a spectral library stored by storeLibraryCache()
+
+      @exception Exception::FileNotFound if the file does not exist
+      @exception Exception::ParseError if the file is not a (compatible) library cache
+    */
+    static void loadLibraryCache(const String& filename, PeakMap& spec_db);
+
+    /**
+      @brief Checks whether the library cache @p filename was stored by storeLibraryCache() from the current version of @p source
+
+      Compares the path, size and modification time of @p source to the ones stored in the cache.
+
+      @return false if the cache does not exist, is not a (compatible) library cache, or was created from a different or modified file
+    */
+    static bool isLibraryCacheCurrent(const String& filename, const String& source);
+
   protected:
     void updateMembers_() override;
 
@@ -191,6 +230,11 @@ namespace OpenMS
       std::vector<PeptideHit::PeakAnnotation>* annotations = 0,
       double mz_lower_bound = 0.0);
 
+    /// upper bound for the number of experimental peaks (given by their sorted bin indices) matching a peak of the binned DB spectrum
+    static Size countPotentialMatches_(
+      const std::vector<BinnedSpectrum::SparseVectorIndexType>& exp_bin_indices,
+      const BinnedSpectrum& db_bins);
+
   private:
     /// private member functions
     void exportMzTab_(const std::vector<SpectralMatch>&, MzTab&);
@@ -36,6 +36,7 @@
 
 
 #include <OpenMS/ANALYSIS/ID/AhoCorasickAmbiguous.h>
+#include <OpenMS/ANALYSIS/ID/ProteinIndex.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/CONCEPT/LogStream.h>
@@ -56,6 +57,7 @@
 #include <atomic>
 #include <algorithm>
 #include <fstream>
+#include <memory>
 
 
 namespace OpenMS
@@ -119,6 +121,11 @@ namespace OpenMS
   Threading:
   This tool support multiple threads (@p threads option) to speed up computation, at the cost of little extra memory.
 
+  Prebuilt index:
+  When the same database is used over and over, a ProteinIndex can be built once (see @ref UTILS_ProteinIndexBuilder) and passed via setProteinIndex().
+  Peptides are then looked up in the (memory-mapped) index instead of scanning the whole database with an Aho-Corasick automaton.
+  The database itself is still required for accessions and target/decoy information and must be the one the index was built from (this is verified).
+
 */
 
  class OPENMS_DLLAPI PeptideIndexing :
@@ -270,6 +277,15 @@ public:
 
       bool invalid_protein_sequence = false; // check for proteins with modifications, i.e. '[' or '(', and throw an exception
 
+      if (protein_index_)
+      { // prebuilt index instead of Aho-Corasick
+        ExitCodes ret = searchProteinIndex_(proteins, pep_ids, func, acc_to_prot, protein_is_decoy, protein_accessions, invalid_protein_sequence);
+        if (ret != EXECUTION_OK)
+        {
+          return ret;
+        }
+      }
+      else
       { // new scope - forget data after search
       
         /*
@@ -727,6 +743,13 @@ public:
 
      bool isPrefix() const;
 
+     /**
+       @brief Use a prebuilt index of the protein database for searching (see ProteinIndex); pass a null pointer to scan the database instead (default)
+
+       The index must have been built from the database passed to run(), using the same 'IL_equivalent' setting.
+     */
+     void setProteinIndex(std::shared_ptr<const ProteinIndex> index);
+
  protected:
 
     struct PeptideProteinMatchInformation
@@ -825,8 +848,182 @@ public:
       }
     }
 
+    /**
+      @brief Maps the peptides of @p pep_ids to the proteins of protein_index_ (instead of using Aho-Corasick)
+
+      Reads @p proteins once (starting with the cache filled by run()) to obtain accessions and decoy information,
+      and verifies that the database is the one the index was built from.
+
+      @return ILLEGAL_PARAMETERS if the index does not match the database or the settings, PEPTIDE_IDS_EMPTY if there are no peptides
+    */
+    template<typename T>
+    ExitCodes searchProteinIndex_(FASTAContainer<T>& proteins,
+                                  const std::vector<PeptideIdentification>& pep_ids,
+                                  FoundProteinFunctor& func,
+                                  Map<String, Size>& acc_to_prot,
+                                  std::vector<bool>& protein_is_decoy,
+                                  std::vector<std::string>& protein_accessions,
+                                  bool& invalid_protein_sequence)
+    {
+      const size_t PROTEIN_CACHE_SIZE = 4e5;
+      const ProteinIndex& index = *protein_index_;
+
+      if (index.isILEquivalent() != IL_equivalent_)
+      {
+        OPENMS_LOG_ERROR << "Error: The protein index was built " << (index.isILEquivalent() ? "with" : "without") << " 'IL_equivalent', which does not match the current setting."
+                         << " Please rebuild the index or change the setting." << std::endl;
+        return ILLEGAL_PARAMETERS;
+      }
+
+      // same order as in run(), since the results are iterated in the same way
+      std::vector<String> peptides;
+      bool has_illegal_AAs(false);
+      for (std::vector<PeptideIdentification>::const_iterator it1 = pep_ids.begin(); it1 != pep_ids.end(); ++it1)
+      {
+        const std::vector<PeptideHit>& hits = it1->getHits();
+        for (std::vector<PeptideHit>::const_iterator it2 = hits.begin(); it2 != hits.end(); ++it2)
+        {
+          String seq = it2->getSequence().toUnmodifiedString().remove('*');
+          if (seqan::isAmbiguous(seqan::AAString(seq.c_str())))
+          {
+            OPENMS_LOG_ERROR << "Peptide sequence '" << it2->getSequence() << "' contains one or more ambiguous amino acids (B|J|Z|X).\n";
+            has_illegal_AAs = true;
+          }
+          if (IL_equivalent_) // convert L to I;
+          {
+            seq.substitute('L', 'I');
+          }
+          peptides.push_back(seq);
+        }
+      }
+      if (has_illegal_AAs)
+      {
+        OPENMS_LOG_ERROR << "One or more peptides contained illegal amino acids. This is not allowed!"
+                  << "\nPlease either remove the peptide or replace it with one of the unambiguous ones (while allowing for ambiguous AA's to match the protein)." << std::endl;
+      }
+
+      OPENMS_LOG_INFO << "Mapping " << peptides.size() << " peptides to " << (proteins.size() == PROTEIN_CACHE_SIZE ? "? (unknown number of)" : String(proteins.size()))  << " proteins." << std::endl;
+
+      if (peptides.empty())
+      {
+        OPENMS_LOG_WARN << "Warning: Peptide identifications have no hits inside! Output will be empty as well." << std::endl;
+        return PEPTIDE_IDS_EMPTY;
+      }
+
+      OPENMS_LOG_INFO << "Searching protein index with up to " << aaa_max_ << " ambiguous amino acid(s) and " << mm_max_ << " mismatch(es)!" << std::endl;
+
+      uint16_t count_j_proteins(0);
+
+      this->startProgress(0, 1, "Reading database");
+      String prot;
+      while (proteins.activateCache()) // swap in last cache
+      {
+        const Size offset = proteins.getChunkOffset();
+        const Size prot_count = proteins.chunkSize();
+        protein_accessions.resize(offset + prot_count);
+        protein_is_decoy.resize(offset + prot_count);
+        for (Size i = 0; i < prot_count; ++i)
+        {
+          const FASTAFile::FASTAEntry& entry = proteins.chunkAt(i);
+          const Size prot_idx = offset + i;
+          protein_accessions[prot_idx] = entry.identifier;
+          protein_is_decoy[prot_idx] = (prefix_ ? entry.identifier.hasPrefix(decoy_string_) : entry.identifier.hasSuffix(decoy_string_));
+          if (entry.sequence.has('[') || entry.sequence.has('('))
+          {
+            invalid_protein_sequence = true;
+          }
+          if (!IL_equivalent_ && entry.sequence.has('J'))
+          {
+            ++count_j_proteins;
+          }
+          prot = entry.sequence;
+          ProteinIndex::normalizeSequence(prot, IL_equivalent_);
+          if (prot_idx >= index.size() || prot != index.getProteinSequence(prot_idx))
+          {
+            OPENMS_LOG_ERROR << "Error: The protein index does not match the database (first difference at protein '" << entry.identifier << "'). Please rebuild the index." << std::endl;
+            return ILLEGAL_PARAMETERS;
+          }
+        }
+        proteins.cacheChunk(PROTEIN_CACHE_SIZE);
+      }
+      this->endProgress();
+      if (protein_accessions.size() != index.size())
+      {
+        OPENMS_LOG_ERROR << "Error: The protein index contains " << index.size() << " proteins, but the database has " << protein_accessions.size() << ". Please rebuild the index." << std::endl;
+        return ILLEGAL_PARAMETERS;
+      }
+
+      this->startProgress(0, peptides.size(), "Searching protein index");
+      std::atomic<int> progress_peps(0);
+      std::vector<Size> hit_proteins; // proteins with hits (passing the enzyme filter or not)
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        FoundProteinFunctor func_threads(func); // still empty; copies the enzyme settings
+        std::vector<ProteinIndex::Hit> hits;
+        std::vector<Size> hit_proteins_thread;
+        String prot_seq;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100) nowait
+#endif
+        for (SignedSize i = 0; i < (SignedSize)peptides.size(); ++i)
+        {
+          ++progress_peps; // atomic
+          if (omp_get_thread_num() == 0)
+          {
+            this->setProgress(progress_peps);
+          }
+
+          index.search(peptides[i], aaa_max_, mm_max_, hits);
+          Size last_protein = index.size();
+          for (const ProteinIndex::Hit& hit : hits)
+          {
+            if (hit.protein_index != last_protein) // hits are sorted by protein
+            {
+              last_protein = hit.protein_index;
+              prot_seq = index.getProteinSequence(last_protein);
+              hit_proteins_thread.push_back(last_protein);
+            }
+            func_threads.addHit(i, hit.protein_index, peptides[i].size(), prot_seq, (Int)hit.position);
+          }
+        }
+
+#ifdef _OPENMP
+#pragma omp critical(PeptideIndexer_joinIndex)
+#endif
+        {
+          func.merge(func_threads);
+          hit_proteins.insert(hit_proteins.end(), hit_proteins_thread.begin(), hit_proteins_thread.end());
+        }
+      }
+      this->endProgress();
+
+      for (Size prot_idx : hit_proteins)
+      {
+        acc_to_prot[protein_accessions[prot_idx]] = prot_idx;
+      }
+
+      OPENMS_LOG_INFO << "\nProtein index search done:\n  found " << func.filter_passed << " hits for " << func.pep_to_prot.size() << " of " << peptides.size() << " peptides.\n";
+
+      // write some stats
+      OPENMS_LOG_INFO << "Peptide hits passing enzyme filter: " << func.filter_passed << "\n"
+               << "     ... rejected by enzyme filter: " << func.filter_rejected << std::endl;
+
+      if (count_j_proteins)
+      {
+        OPENMS_LOG_WARN << "PeptideIndexer found " << count_j_proteins << " protein sequences in your database containing the amino acid 'J'."
+          << "To match 'J' in a protein, an ambiguous amino acid placeholder for I/L will be used.\n"
+          << "This costs runtime and eats into the 'aaa_max' limit, leaving less opportunity for B/Z/X matches.\n"
+          << "If you want 'J' to be treated as unambiguous, enable '-IL_equivalent'!" << std::endl;
+      }
+      return EXECUTION_OK;
+    }
+
     void updateMembers_() override;
 
+    std::shared_ptr<const ProteinIndex> protein_index_; ///< prebuilt index (optional)
+
     String decoy_string_;
     bool prefix_;
     String missing_decoy_action_;
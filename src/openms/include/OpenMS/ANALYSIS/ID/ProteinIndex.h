@@ -0,0 +1,206 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/FASTAContainer.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class file_mapping;
+    class mapped_region;
+  }
+}
+
+namespace OpenMS
+{
+
+/**
+  @brief Persistent suffix array index over a protein database, for repeated peptide-to-protein mapping.
+
+  The index holds the concatenated protein sequences (each terminated by '$') together with their suffix array.
+  It is built once per database (see @ref UTILS_ProteinIndexBuilder), stored to disk and memory-mapped by load(),
+  so that subsequent runs of @ref TOPP_PeptideIndexer can look up peptides directly instead of building an
+  Aho-Corasick automaton and scanning the whole database every time.
+
+  Sequences are normalized as in PeptideIndexing: '*' is removed and, if the index is built with @p IL_equivalent,
+  'L' and 'J' are converted to 'I'. Peptides passed to search() must be normalized in the same way.
+
+  Matching follows AhoCorasickAmbiguous: the ambiguous amino acids B, J, Z and X in a protein match any of the amino
+  acids they stand for (D/N, I/L, E/Q and any, respectively), each counting as one ambiguous match; all other differences
+  count as mismatches. Peptides must not contain ambiguous amino acids.
+
+  The file stores 32-bit offsets and uses the byte order of the machine which built it; the total length of all protein
+  sequences is therefore limited to 4 G residues.
+
+  @ingroup Analysis_ID
+*/
+class OPENMS_DLLAPI ProteinIndex
+{
+public:
+  /// Occurrence of a peptide in the database
+  struct Hit
+  {
+    Size protein_index; ///< index of the protein in the database (FASTA order)
+    Size position; ///< position of the peptide within the (normalized) protein sequence
+
+    bool operator<(const Hit& rhs) const
+    {
+      return std::tie(protein_index, position) < std::tie(rhs.protein_index, rhs.position);
+    }
+  };
+
+  /// Default constructor (empty index)
+  ProteinIndex();
+
+  /// Destructor
+  ~ProteinIndex();
+
+  /// Not copyable (may hold a memory mapping)
+  ProteinIndex(const ProteinIndex&) = delete;
+  ProteinIndex& operator=(const ProteinIndex&) = delete;
+
+  /**
+    @brief Builds the index from all proteins in @p proteins (read from the beginning)
+
+    Requires memory for the concatenated sequences plus about 20 bytes per residue during construction.
+
+    @throw Exception::InvalidSize if the database is too large for 32-bit offsets
+  */
+  template <typename T>
+  void build(FASTAContainer<T>& proteins, bool IL_equivalent)
+  {
+    const int PROTEIN_CACHE_SIZE = 400000;
+    clear();
+    IL_equivalent_ = IL_equivalent;
+    proteins.reset();
+    proteins.cacheChunk(PROTEIN_CACHE_SIZE);
+    while (proteins.activateCache())
+    {
+      for (Size i = 0; i < proteins.chunkSize(); ++i)
+      {
+        appendProtein_(proteins.chunkAt(i).sequence);
+      }
+      proteins.cacheChunk(PROTEIN_CACHE_SIZE);
+    }
+    proteins.reset();
+    buildSuffixArray_();
+  }
+
+  /**
+    @brief Stores the index to @p filename
+
+    @throw Exception::UnableToCreateFile if the file cannot be written
+  */
+  void store(const String& filename) const;
+
+  /**
+    @brief Loads an index from @p filename by memory-mapping it (the file is not read into memory up front)
+
+    @throw Exception::FileNotFound if the file does not exist
+    @throw Exception::ParseError if the file is not a valid index
+  */
+  void load(const String& filename);
+
+  /// Resets to an empty index (releasing any memory mapping)
+  void clear();
+
+  /// Number of proteins in the index
+  Size size() const;
+
+  /// Is the index empty (no proteins)?
+  bool empty() const;
+
+  /// Were 'L' and 'J' converted to 'I' when building the index?
+  bool isILEquivalent() const;
+
+  /// Returns the normalized sequence of protein @p index
+  String getProteinSequence(Size index) const;
+
+  /// Length of the normalized sequence of protein @p index
+  Size getProteinLength(Size index) const;
+
+  /**
+    @brief Finds all occurrences of @p peptide (normalized, see class description)
+
+    @param peptide Peptide sequence
+    @param aaa_max Maximal number of ambiguous amino acids in the protein matched by the peptide
+    @param mm_max Maximal number of mismatches
+    @param hits Occurrences (cleared first), sorted by protein index and position
+  */
+  void search(const String& peptide, Size aaa_max, Size mm_max, std::vector<Hit>& hits) const;
+
+  /// Normalizes a protein or peptide sequence like PeptideIndexing does: removes '*' and converts L/J to I if @p IL_equivalent is set
+  static void normalizeSequence(String& sequence, bool IL_equivalent);
+
+protected:
+  /// appends a protein to the text (before buildSuffixArray_())
+  void appendProtein_(const String& sequence);
+
+  /// sorts all suffixes of text_buffer_ (prefix doubling with radix sort) and points the views to the buffers
+  void buildSuffixArray_();
+
+  /// recursive search of @p peptide from @p depth on, within the suffix array interval [@p lo, @p hi)
+  void search_(const String& peptide, Size depth, Size lo, Size hi, Size aaa_left, Size mm_left, std::vector<Hit>& hits) const;
+
+  /// suffix array interval [lo, hi) within [@p lo, @p hi) whose suffixes have character @p c at @p depth
+  std::pair<Size, Size> narrow_(Size lo, Size hi, Size depth, char c) const;
+
+  bool IL_equivalent_;
+
+  /// data of a built index
+  std::vector<char> text_buffer_;
+  std::vector<UInt32> starts_buffer_;
+  std::vector<UInt32> sa_buffer_;
+
+  /// data of a loaded index
+  std::unique_ptr<boost::interprocess::file_mapping> file_;
+  std::unique_ptr<boost::interprocess::mapped_region> region_;
+
+  /// views on either of the above
+  const char* text_; ///< concatenated sequences, each followed by '$'
+  const UInt32* starts_; ///< start of each protein in text_ (plus the text length at the end)
+  const UInt32* sa_; ///< suffix array of text_
+  Size text_length_;
+  Size protein_count_;
+};
+
+} // namespace OpenMS
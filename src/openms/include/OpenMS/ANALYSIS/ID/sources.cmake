@@ -32,6 +32,7 @@ MessagePasserFactory.h
 MetaboliteSpectralMatching.h
 PeptideProteinResolution.h
 PrecursorPurity.h
+ProteinIndex.h
 ProtonDistributionModel.h
 PeptideIndexing.h
 PercolatorFeatureSetHelper.h
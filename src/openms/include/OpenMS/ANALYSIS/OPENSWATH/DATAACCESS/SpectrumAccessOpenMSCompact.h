@@ -0,0 +1,94 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/CompactMSExperiment.h>
+
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace OpenMS
+{
+  /**
+    @brief An implementation of the OpenSWATH Spectrum Access interface using a CompactMSExperiment
+
+    Keeps all spectra in memory in the compact representation of
+    CompactMSExperiment (about half the memory of an MSExperiment) and decodes
+    a spectrum when it is accessed. Used by OpenSwathWorkflow with
+    "-readOptions compact" (see CompactSwathFileConsumer).
+  */
+  class OPENMS_DLLAPI SpectrumAccessOpenMSCompact :
+    public OpenSwath::ISpectrumAccess
+  {
+public:
+    typedef OpenMS::CompactMSExperiment MSExperimentType;
+
+    /// Constructor
+    explicit SpectrumAccessOpenMSCompact(boost::shared_ptr<MSExperimentType> ms_experiment);
+
+    /// Destructor
+    ~SpectrumAccessOpenMSCompact() override;
+
+    /**
+      @brief Copy constructor
+
+      Performs a light copy operation: only the pointer to the underlying
+      CompactMSExperiment is copied.
+    */
+    SpectrumAccessOpenMSCompact(const SpectrumAccessOpenMSCompact & rhs);
+
+    /// Light clone operator (actual data will not get copied)
+    boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const override;
+
+    OpenSwath::SpectrumPtr getSpectrumById(int id) override;
+
+    OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const override;
+
+    std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const override;
+
+    size_t getNrSpectra() const override;
+
+    OpenSwath::ChromatogramPtr getChromatogramById(int id) override;
+
+    size_t getNrChromatograms() const override;
+
+    std::string getChromatogramNativeID(int id) const override;
+
+private:
+    boost::shared_ptr<MSExperimentType> ms_experiment_;
+  };
+} //end namespace OpenMS
@@ -0,0 +1,166 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+   * @brief Loads SWATH maps into memory in background threads ahead of their use
+   *
+   * When OpenSWATH works on cached (or otherwise disk-backed) SWATH maps, the
+   * extraction threads either read the raw data lazily from disk or first copy
+   * each map into memory, in both cases stalling on I/O. This class loads the
+   * maps into memory (as SpectrumAccessOpenMSInMemory) in background threads,
+   * in the order in which they are given, while previously loaded maps are
+   * being processed.
+   *
+   * The number of maps held in memory (loaded or being loaded, and not yet
+   * released) is limited by @p max_maps and, optionally, by a memory budget.
+   * The memory budget is enforced using the average size of the maps loaded
+   * so far; a single map is always allowed, even if it exceeds the budget.
+   *
+   * Every (non-MS1) map has to be passed to release() exactly once, either
+   * after processing it (acquire() / release()) or when it is not needed at
+   * all (release() only, which prevents or discards its loading). Since maps
+   * are loaded in order, the maps need to be acquired approximately in order
+   * (e.g. by a dynamically scheduled OpenMP loop) to avoid stalling. MS1 maps
+   * are never loaded and acquire() returns them unmodified.
+   *
+   * All functions are thread-safe.
+   *
+   */
+  class OPENMS_DLLAPI SwathMapPrefetcher
+  {
+public:
+
+    /**
+     * @brief Constructor, starts loading immediately
+     *
+     * @param swath_maps The maps to be loaded (copied, the underlying data is shared)
+     * @param max_maps Maximal number of maps held in memory at once (at least 1)
+     * @param max_memory_mb Memory budget in MB for the loaded maps (0 means unlimited)
+     * @param nr_threads Number of background loading threads (at least 1)
+     */
+    SwathMapPrefetcher(const std::vector<OpenSwath::SwathMap>& swath_maps, Size max_maps,
+                       double max_memory_mb = 0.0, Size nr_threads = 1);
+
+    /// Destructor, stops loading and waits for the background threads
+    ~SwathMapPrefetcher();
+
+    /**
+     * @brief Returns the in-memory version of map @p index, waiting for it to be loaded
+     *
+     * @exception Exception::IllegalArgument if the map was already released
+     * @note Exceptions raised while loading a map are passed on to the caller
+     */
+    OpenSwath::SpectrumAccessPtr acquire(Size index);
+
+    /// Frees the in-memory version of map @p index (or cancels its loading)
+    void release(Size index);
+
+    /// Returns the maximal number of bytes used by loaded maps at any time so far
+    Size getPeakMemoryUsage() const;
+
+    /// Returns the number of maps loaded so far
+    Size getNrLoadedMaps() const;
+
+    /// Estimates the number of bytes occupied by the raw data of an in-memory @p map
+    static Size estimateMemoryUsage(OpenSwath::ISpectrumAccess& map);
+
+private:
+
+    /// Not implemented
+    SwathMapPrefetcher(const SwathMapPrefetcher& rhs);
+
+    /// Not implemented
+    SwathMapPrefetcher& operator=(const SwathMapPrefetcher& rhs);
+
+    enum MapState
+    {
+      PENDING,
+      LOADING,
+      LOADED,
+      RELEASED
+    };
+
+    /// Main function of the background threads
+    void loadMaps_();
+
+    /// Whether the budget allows to start loading another map (mutex_ must be locked)
+    bool canStartLoading_() const;
+
+    std::vector<OpenSwath::SwathMap> swath_maps_;
+    std::vector<MapState> state_;
+    std::vector<OpenSwath::SpectrumAccessPtr> loaded_maps_;
+    std::vector<Size> map_bytes_;
+
+    /// next map to be loaded
+    Size next_map_;
+    /// number of maps loaded or being loaded and not yet released
+    Size nr_in_memory_;
+    /// number of maps currently being loaded
+    Size nr_loading_;
+    /// number of maps loaded in total
+    Size nr_loaded_total_;
+    /// bytes occupied by loaded maps in total (for the average map size)
+    Size bytes_loaded_total_;
+    /// bytes occupied by the loaded, not yet released maps
+    Size bytes_in_memory_;
+    Size peak_bytes_;
+
+    Size max_maps_;
+    Size max_bytes_;
+
+    bool stop_;
+    std::exception_ptr error_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable state_changed_;
+    std::vector<std::thread> threads_;
+  };
+
+} //end namespace OpenMS
+
@@ -402,10 +402,31 @@ protected:
      *
      **/
     OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
-      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, prm, threads_outer_loop)
+      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, prm, threads_outer_loop),
+      prefetch_maps_(0),
+      prefetch_memory_mb_(0.0)
     {
     }
 
+    /** @brief Load SWATH maps into memory in the background during performExtraction()
+     *
+     *  While the current SWATH maps are being extracted and scored, up to
+     *  \p nr_maps maps are loaded into memory ahead of time by a background
+     *  thread (see SwathMapPrefetcher), which removes the I/O stalls of
+     *  disk-backed (cached) maps. Each map is freed as soon as it has been
+     *  processed.
+     *
+     *  @param nr_maps Maximal number of SWATH maps held in memory (0 disables prefetching)
+     *  @param max_memory_mb Memory budget for the prefetched maps in MB (0 means unlimited)
+     *
+     *  @note Should be at least the number of threads in the outer loop, otherwise threads will wait for data.
+     **/
+    void setPrefetch(Size nr_maps, double max_memory_mb)
+    {
+      prefetch_maps_ = nr_maps;
+      prefetch_memory_mb_ = max_memory_mb;
+    }
+
     /** @brief Execute OpenSWATH analysis on a set of SwathMaps and transitions.
      *
      * See OpenSwathWorkflow class for a detailed description of this function.
@@ -429,6 +450,8 @@ protected:
      * \p load_into_memory where larger batch sizes increase memory and
      * potentially decrease the utility of parallelization while loading data
      * into memory will increase memory usage but decrease execution time.
+     * If prefetching is enabled (see setPrefetch()), maps are always worked
+     * on in memory and \p load_into_memory has no effect on the SWATH maps.
      *
     */
     void performExtraction(const std::vector< OpenSwath::SwathMap > & swath_maps,
@@ -550,6 +573,12 @@ protected:
     void copyBatchTransitions_(const std::vector<OpenSwath::LightCompound>& used_compounds,
       const std::vector<OpenSwath::LightTransition>& all_transitions,
       std::vector<OpenSwath::LightTransition>& output);
+
+    /// Number of SWATH maps to load in the background (0 = no prefetching)
+    Size prefetch_maps_;
+
+    /// Memory budget in MB for prefetched SWATH maps (0 = unlimited)
+    double prefetch_memory_mb_;
   };
 
   /**
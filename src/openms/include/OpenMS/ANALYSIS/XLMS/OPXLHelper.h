@@ -40,6 +40,8 @@
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <functional>
+#include <limits>
 #include <numeric>
 
 namespace OpenMS
@@ -98,6 +100,11 @@ namespace OpenMS
           Assumes the list of peptides and the list of spectrum precursor masses are sorted by mass in ascending order,
           and the list of mono-link masses is sorted in descending order.
 
+          The candidates are collected in thread-local buffers and returned in the same order as a sequential enumeration.
+          Restricting the alpha peptides to the index range [@p alpha_begin, @p alpha_end) allows enumerating the candidates
+          in blocks of the mass-sorted peptide list, which bounds memory usage for large databases. Every candidate has exactly
+          one alpha peptide (the one with the lower index for cross-links), so consecutive blocks yield each candidate exactly once.
+
        * @param peptides The peptides with precomputed masses from the digestDatabase function
        * @param cross_link_mass_light Mass of the cross-linker, only the light one if a labeled linker is used
        * @param cross_link_mass_mono_link A list of possible masses for the cross-link, if it is attached to a peptide on one side
@@ -107,9 +114,11 @@ namespace OpenMS
        * @param precursor_correction_positions A vector of the position of the used precursor correction
        * @param precursor_mass_tolerance The precursor mass tolerance
        * @param precursor_mass_tolerance_unit_ppm The unit of the precursor mass tolerance ("Da" or "ppm")
+       * @param alpha_begin Index of the first peptide considered as alpha peptide
+       * @param alpha_end Index after the last peptide considered as alpha peptide
        * @return A vector of XLPrecursors containing all possible candidate cross-links
        */
-      static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm);
+      static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size alpha_begin = 0, Size alpha_end = std::numeric_limits<Size>::max());
 
       /**
        * @brief Digests a database with the given EnzymaticDigestion settings and precomputes masses for all peptides
@@ -256,6 +265,8 @@ namespace OpenMS
        * @param cross_link_name The name of the cross-linker, e.g. "DSS" or "BS3"
        * @param use_sequence_tags Whether to use sequence tags to filter out candidates
        * @param tags The list of sequence tags that are used to filter candidate sequences. Only applied if use_sequence_tags = true
+       * @param alpha_begin Index of the first peptide considered as alpha peptide (see enumerateCrossLinksAndMasses)
+       * @param alpha_end Index after the last peptide considered as alpha peptide
        */
       static std::vector <OPXLDataStructs::ProteinProteinCrossLink> collectPrecursorCandidates(const IntList& precursor_correction_steps,
                                                                                                 double precursor_mass,
@@ -268,7 +279,29 @@ namespace OpenMS
                                                                                                 StringList cross_link_residue2,
                                                                                                 String cross_link_name,
                                                                                                 bool use_sequence_tags = false,
-                                                                                                const std::vector<std::string>& tags = std::vector<std::string>());
+                                                                                                const std::vector<std::string>& tags = std::vector<std::string>(),
+                                                                                                Size alpha_begin = 0,
+                                                                                                Size alpha_end = std::numeric_limits<Size>::max());
+
+      /**
+       * @brief Enumerates and pre-scores the candidates of one spectrum in blocks of alpha peptides, only the best pre-scored matches are kept between blocks
+
+          With large databases, this bounds the memory needed for the candidates of one spectrum.
+
+       * @param peptide_count The number of (mass-sorted) peptides, that the candidates are enumerated from
+       * @param block_size The number of alpha peptides per block, 0 enumerates all candidates at once
+       * @param number_top_hits The number of best pre-scored matches kept between blocks
+       * @param collect_candidates Returns the candidates with alpha peptides in the index range [alpha_begin, alpha_end), see collectPrecursorCandidates
+       * @param prescore_candidates Pre-scores the given candidates and appends the matches to the given list
+       * @param prescored_csms The best pre-scored matches (output)
+       * @return The total number of enumerated candidates
+       */
+      static Size prescoreCandidatesInBlocks(Size peptide_count,
+                                             Size block_size,
+                                             Size number_top_hits,
+                                             const std::function<std::vector<OPXLDataStructs::ProteinProteinCrossLink>(Size, Size)>& collect_candidates,
+                                             const std::function<void(const std::vector<OPXLDataStructs::ProteinProteinCrossLink>&, std::vector<OPXLDataStructs::CrossLinkSpectrumMatch>&)>& prescore_candidates,
+                                             std::vector<OPXLDataStructs::CrossLinkSpectrumMatch>& prescored_csms);
 
       /**
        * @brief Computes the mass error of a precursor mass to a hit
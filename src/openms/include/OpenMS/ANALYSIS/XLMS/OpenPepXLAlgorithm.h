@@ -179,6 +179,7 @@ private:
     String enzyme_name_;
 
     Int number_top_hits_;
+    Size candidate_block_size_;
     String deisotope_mode_;
 
     String add_y_ions_;
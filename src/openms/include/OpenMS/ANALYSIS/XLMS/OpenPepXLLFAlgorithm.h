@@ -166,6 +166,7 @@ private:
     String enzyme_name_;
 
     Int number_top_hits_;
+    Size candidate_block_size_;
     String deisotope_mode_;
     bool use_sequence_tags_;
     Size sequence_tag_min_length_;
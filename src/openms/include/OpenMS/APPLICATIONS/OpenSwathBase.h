@@ -63,6 +63,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 // Algorithms
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMRTNormalizer.h>
@@ -149,7 +150,7 @@ protected:
    * @param file_list The input file(s)
    * @param split_file If loading a single file that contains a single SWATH window 
    * @param tmp Temporary directory
-   * @param readoptions Description on how to read the data ("normal", "cache")
+   * @param readoptions Description on how to read the data ("normal", "compact", "cache")
    * @param swath_windows_file Provided file containing the SWATH windows which will be mapped to the experimental windows
    * @param min_upper_edge_dist Distance for each assay to the upper edge of the SWATH window
    * @param force Whether to override the sanity check
@@ -173,6 +174,8 @@ protected:
                       const bool prm,
                       Interfaces::IMSDataConsumer* plugin_consumer = nullptr)
   {
+    Profiler::Stage stage("OpenSwathBase::loadSwathFiles");
+
     // (i) Load files
     loadSwathFiles_(file_list, split_file, tmp, readoptions, exp_meta, swath_maps, plugin_consumer);
 
@@ -311,6 +314,8 @@ protected:
                                                         const String& tr_file,
                                                         const Param& tsv_reader_param)
   {
+    Profiler::Stage stage("OpenSwathBase::loadTransitionList");
+
     OpenSwath::LightTargetedExperiment transition_exp;
     ProgressLogger progresslogger;
     progresslogger.setLogType(log_type_);
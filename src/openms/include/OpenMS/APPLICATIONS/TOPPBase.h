@@ -191,6 +191,27 @@ public:
     */
     static void setMaxNumberOfThreads(int num_threads);
 
+    /**
+      @brief Returns the exit code for a tool which was aborted by the exception @p e
+
+      @p message is set to the error message shown to the user. Used by main() and by
+      TOPPAS for the tools it runs in-process (see TOPPToolCores).
+    */
+    static ExitCodes getExitCode(const Exception::BaseException& e, String& message);
+
+    /**
+      @name Data processing auxiliary functions (for tools running outside of a TOPPBase)
+
+      The same as addDataProcessing_() and getProcessingInfo_(), for the tool @p tool_name
+      with the parameters @p param (the tool's section of its INI file).
+    */
+    //@{
+    static void addDataProcessing(ConsensusMap& map, const DataProcessing& dp, bool test_mode);
+    static void addDataProcessing(FeatureMap& map, const DataProcessing& dp);
+    static void addDataProcessing(PeakMap& map, const DataProcessing& dp);
+    static DataProcessing getProcessingInfo(const String& tool_name, const Param& param, bool test_mode, const std::set<DataProcessing::ProcessingAction>& actions);
+    //@}
+
 private:
     /// Tool name.  This is assigned once and for all in the constructor.
     String const tool_name_;
@@ -0,0 +1,114 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class GaussFilter;
+  class PeptideIndexing;
+  class SavitzkyGolayFilter;
+  class PeakPickerHiRes;
+
+  /**
+    @brief The processing steps of TOPP tools which can run on data held in memory
+
+    Each function contains what the respective tool does between loading its input files and
+    annotating and storing its results. The tools call them from their main_(), and TOPPAS
+    calls them to run these tools inside the workflow process on data handed over in memory
+    (see TOPPASInProcessTools), so both behave the same.
+
+    Problems with the input are reported by the returned exit code (see TOPPBase::ExitCodes) or
+    by an exception, exactly as in the tools.
+  */
+  class OPENMS_DLLAPI TOPPToolCores
+  {
+public:
+    /**
+      @name NoiseFilterGaussian, NoiseFilterSGolay
+
+      Smooths the spectra and chromatograms of @p exp in place.
+    */
+    //@{
+    static TOPPBase::ExitCodes smooth(GaussFilter& filter, PeakMap& exp);
+    static TOPPBase::ExitCodes smooth(SavitzkyGolayFilter& filter, PeakMap& exp);
+    //@}
+
+    /// PeakPickerHiRes: picks the peaks of @p input into @p output (see PeakPickerHiRes::pickExperiment())
+    static TOPPBase::ExitCodes pickPeaks(const PeakPickerHiRes& picker, const PeakMap& input, PeakMap& output, bool check_spectrum_type);
+
+    /**
+      @brief FeatureFinderCentroided: finds the features in the MS1 spectra of @p exp
+
+      Fragment spectra are removed from @p exp. @p in is the name of the input file (annotated
+      as primary MS run). Unless @p debug_level is at least 5, only the bounding boxes of the
+      convex hulls are kept and subordinate features are removed.
+
+      @exception Exception::FileEmpty if @p exp does not contain MS1 spectra
+      @exception Exception::IllegalArgument if the spectra are profile data and @p force is not set
+    */
+    static void findFeatures(PeakMap& exp, const String& in, const FeatureMap& seeds, const Param& algorithm_param, bool force, bool test_mode, Int debug_level, ProgressLogger::LogType log_type, FeatureMap& features);
+
+    /// FeatureFinderCentroided: stores the features found in @p exp as mzQuantML file
+    static void storeMzQuantML(const String& filename, const FeatureMap& features, const PeakMap& exp);
+
+    /// ConsensusMapNormalizer: normalizes the intensities of @p map with the algorithm @p algorithm_type
+    static TOPPBase::ExitCodes normalize(ConsensusMap& map, const String& algorithm_type, double ratio_threshold, const String& accession_filter, const String& description_filter);
+
+    /// PeptideIndexer: replaces @p db_name by the full path of the database if it is not readable as given; returns false if it cannot be found
+    static bool findDatabase(String& db_name);
+
+    /**
+      @brief PeptideIndexer: maps the peptides to the proteins of the database @p db_name
+
+      @p index_name is an optional protein index of the database. If @p compute_coverage is set,
+      the sequence coverage of the protein hits is annotated.
+
+      @return The exit code of the tool. Except for TOPPBase::ILLEGAL_PARAMETERS (e.g. the protein
+      index does not match the database), the results are written in any case.
+    */
+    static TOPPBase::ExitCodes indexPeptides(PeptideIndexing& indexer, const String& db_name, const String& index_name, bool compute_coverage, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids);
+  };
+
+}
@@ -621,8 +621,25 @@ protected:
     static AASequence fromString(const char* s,
                                  bool permissive = true);
 
+    /**
+      @brief Enables a process-wide memo cache for fromString()
+
+      If enabled, fromString() parses each distinct string only once and
+      returns copies of the cached result afterwards (see AASequenceCache).
+      This is useful if many identical sequence strings are parsed, e.g. when
+      reading identification results.
+
+      @param max_entries Maximum number of cached sequences (0 disables the cache, the default)
+    */
+    static void setParseCacheSize(Size max_entries);
+
+    /// Returns the maximum size of the process-wide parse cache (0 if disabled)
+    static Size getParseCacheSize();
+
   protected:
 
+    friend class AASequenceCache;
+
     std::vector<const Residue*> peptide_;
 
     const ResidueModification* n_term_mod_;
@@ -0,0 +1,143 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Thread-safe, size-bounded memo cache for parsing peptide sequences
+
+    Parsing a sequence string (AASequence::fromString()) involves parsing
+    modification notations and lookups in ResidueDB and ModificationsDB. When
+    reading identification or transition files, the same sequences typically
+    occur many times (e.g. in several spectra or transitions), so it pays off
+    to parse each distinct string only once and copy the result afterwards.
+
+    The cache is split into shards with separate locks, so it can be used from
+    many threads concurrently. Its size is bounded: once a shard is full, the
+    least recently used half of its entries is dropped (two-generation
+    eviction). Strings that cannot be parsed are not cached, the exception is
+    thrown on every call.
+
+    File readers use a local instance per file. A process-wide cache used by
+    AASequence::fromString() itself can be enabled with
+    AASequence::setParseCacheSize().
+
+    @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI AASequenceCache
+  {
+public:
+    /// Constructor; @p max_entries is the maximum number of cached sequences (0 disables caching)
+    explicit AASequenceCache(Size max_entries = 100000);
+
+    /// Destructor
+    ~AASequenceCache();
+
+    /**
+      @brief Returns the parsed sequence @p s (see AASequence::fromString())
+
+      @throws Exception::ParseError if an invalid string representation of an AA sequence is passed
+    */
+    AASequence parse(const String& s, bool permissive = true);
+
+    /**
+      @brief Parses all sequences in @p s into @p aas (same order), each distinct string is parsed only once
+
+      @throws Exception::ParseError if an invalid string representation of an AA sequence is passed
+    */
+    void parse(const std::vector<String>& s, std::vector<AASequence>& aas, bool permissive = true);
+
+    /// Returns the maximum number of cached sequences
+    Size getMaxSize() const;
+
+    /// Sets the maximum number of cached sequences (0 disables caching); clears the cache
+    void setMaxSize(Size max_entries);
+
+    /// Returns the number of currently cached sequences
+    Size size() const;
+
+    /// Removes all cached sequences
+    void clear();
+
+    /// Returns the number of parse() calls answered from the cache
+    Size getHits() const;
+
+    /// Returns the number of parse() calls that required parsing
+    Size getMisses() const;
+
+protected:
+    /// A part of the cache with its own lock
+    struct Shard_
+    {
+      std::mutex mutex;
+      /// recently used entries (index: permissive parsing or not)
+      std::unordered_map<String, AASequence> current[2];
+      /// older entries, dropped when 'current' is full
+      std::unordered_map<String, AASequence> previous[2];
+    };
+
+    /// Returns the shard responsible for @p s
+    Shard_& getShard_(const String& s);
+
+    /// Maximum number of entries per generation and shard
+    Size getShardCapacity_() const;
+
+    /// Number of shards (power of two)
+    static const Size nr_shards_ = 16;
+
+    std::vector<std::unique_ptr<Shard_> > shards_;
+
+    std::atomic<Size> max_entries_;
+
+    std::atomic<Size> hits_;
+
+    std::atomic<Size> misses_;
+
+private:
+    /// Not implemented
+    AASequenceCache(const AASequenceCache&);
+    AASequenceCache& operator=(const AASequenceCache&);
+  };
+
+} // namespace OpenMS
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <iterator>
 #include <map>
 #include <set>
 #include <algorithm>
@@ -77,24 +78,105 @@ namespace OpenMS
     are supported in different flavors. However, one must be careful, because this can lead to negative
     frequencies. In most cases this might be misleading, however, the class therefore supports difference
     formulae. E.g. formula differences of reactions from post-translational modifications.
+
+    Internally, the most common elements (C, H, N, O, P, S, Na, K and Cl) are stored in a fixed array,
+    all other elements (including specific isotopes like (13)C) in a map. Therefore, arithmetic
+    and mass calculations of typical (bio)molecules do not allocate memory and do not search a tree.
+    Iterating over a formula yields the common elements first (in the above order), followed by all
+    other elements. Elements with a count of zero are skipped.
   */
 
   class OPENMS_DLLAPI EmpiricalFormula
   {
 
 protected:
-	  /// Internal typedef for the used map type
-	  typedef std::map<const Element*, SignedSize> MapType_;
+    /// Internal typedef for the map of elements without a fixed slot
+    typedef std::map<const Element*, SignedSize> MapType_;
+
+public:
+    /// Number of elements with a fixed slot (C, H, N, O, P, S, Na, K, Cl)
+    static const Size NUMBER_OF_FIXED_ELEMENTS = 9;
+
+    /**
+      @brief Read-only forward iterator over the (element, count) pairs of a formula
 
+      Elements with a fixed slot come first, followed by all other elements. Elements with a count of zero are skipped.
+    */
+    class OPENMS_DLLAPI ConstIterator
+    {
 public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef std::pair<const Element*, SignedSize> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const value_type* pointer;
+      typedef const value_type& reference;
+
+      /// Default constructor (singular iterator)
+      ConstIterator() :
+        formula_(nullptr), slot_(NUMBER_OF_FIXED_ELEMENTS), it_(), current_(nullptr, 0)
+      {}
+
+      /// Constructor pointing to the given fixed @p slot (or to @p it for slot == NUMBER_OF_FIXED_ELEMENTS)
+      ConstIterator(const EmpiricalFormula* formula, Size slot, MapType_::const_iterator it) :
+        formula_(formula), slot_(slot), it_(it), current_(nullptr, 0)
+      {
+        advance_();
+      }
+
+      reference operator*() const { return current_; }
+
+      pointer operator->() const { return &current_; }
+
+      ConstIterator& operator++()
+      {
+        if (slot_ < NUMBER_OF_FIXED_ELEMENTS) ++slot_;
+        else ++it_;
+        advance_();
+        return *this;
+      }
+
+      ConstIterator operator++(int)
+      {
+        ConstIterator tmp(*this);
+        ++(*this);
+        return tmp;
+      }
+
+      bool operator==(const ConstIterator& rhs) const
+      {
+        return slot_ == rhs.slot_ && (slot_ < NUMBER_OF_FIXED_ELEMENTS || it_ == rhs.it_);
+      }
+
+      bool operator!=(const ConstIterator& rhs) const { return !(*this == rhs); }
+
+protected:
+      /// skips empty fixed slots and updates the current pair
+      void advance_()
+      {
+        while (slot_ < NUMBER_OF_FIXED_ELEMENTS && formula_->fixed_counts_[slot_] == 0) ++slot_;
+        if (slot_ < NUMBER_OF_FIXED_ELEMENTS)
+        {
+          current_ = value_type(getFixedElements_().elements[slot_], formula_->fixed_counts_[slot_]);
+        }
+        else if (formula_ != nullptr && it_ != formula_->others_.end())
+        {
+          current_ = *it_;
+        }
+      }
+
+      const EmpiricalFormula* formula_;
+      Size slot_;
+      MapType_::const_iterator it_;
+      value_type current_;
+    };
+
     /** @name Typedefs
     */
     //@{
-    /// Iterators
-    typedef MapType_::const_iterator ConstIterator;
-    typedef MapType_::const_iterator const_iterator;
-    typedef MapType_::iterator Iterator;
-    typedef MapType_::iterator iterator;
+    /// Iterators (read-only)
+    typedef ConstIterator const_iterator;
+    typedef ConstIterator Iterator;
+    typedef ConstIterator iterator;
     //@}
 
     /** @name Constructors and Destructors
@@ -106,8 +188,8 @@ public:
     /// Copy constructor
     EmpiricalFormula(const EmpiricalFormula&) = default;
 
-    /// Move constructor
-    EmpiricalFormula(EmpiricalFormula&&) = default;
+    /// Move constructor (leaves @p rhs empty)
+    EmpiricalFormula(EmpiricalFormula&& rhs) noexcept;
 
     /**
       Constructor from an OpenMS String
@@ -217,8 +299,8 @@ public:
     /// Assignment operator
     EmpiricalFormula& operator=(const EmpiricalFormula&) = default;
 
-    /// Move assignment operator
-    EmpiricalFormula& operator=(EmpiricalFormula&&) & = default;
+    /// Move assignment operator (leaves @p rhs empty)
+    EmpiricalFormula& operator=(EmpiricalFormula&& rhs) &;
 
     /// adds the elements of the given formula
     EmpiricalFormula& operator+=(const EmpiricalFormula& rhs);
@@ -269,25 +351,43 @@ public:
     /** @name Iterators
     */
     //@{
-    inline ConstIterator begin() const { return formula_.begin(); }
-
-    inline ConstIterator end() const { return formula_.end(); }
-    
-    inline Iterator begin() { return formula_.begin(); }
+    inline ConstIterator begin() const { return ConstIterator(this, 0, others_.begin()); }
 
-    inline Iterator end() { return formula_.end(); }
+    inline ConstIterator end() const { return ConstIterator(this, NUMBER_OF_FIXED_ELEMENTS, others_.end()); }
     //@}
 
 protected:
 
-    /// remove elements with count 0
+    /// the elements with a fixed slot and their weights
+    struct FixedElements_
+    {
+      const Element* elements[NUMBER_OF_FIXED_ELEMENTS];
+      double mono_weights[NUMBER_OF_FIXED_ELEMENTS];
+      double average_weights[NUMBER_OF_FIXED_ELEMENTS];
+    };
+
+    /// returns the elements with a fixed slot (initialized from the ElementDB on first use)
+    static const FixedElements_& getFixedElements_();
+
+    /// returns the fixed slot of @p element, or NUMBER_OF_FIXED_ELEMENTS if it has none
+    static Size getFixedSlot_(const Element* element);
+
+    /// adds @p number atoms of @p element (does not remove zeroed elements)
+    void addElement_(const Element* element, SignedSize number);
+
+    /// remove elements with count 0 from the map of other elements
     void removeZeroedElements_();
 
-    MapType_ formula_;
+    /// counts of the elements with a fixed slot
+    SignedSize fixed_counts_[NUMBER_OF_FIXED_ELEMENTS];
+
+    /// counts of all other elements
+    MapType_ others_;
 
     Int charge_;
 
-    Int parseFormula_(std::map<const Element*, SignedSize>& ef, const String& formula) const;
+    /// parses @p formula, adds its elements and returns its charge
+    Int parseFormula_(const String& formula);
 
   };
 
@@ -38,6 +38,8 @@
 #include <OpenMS/CHEMISTRY/DigestionEnzyme.h>
 
 #include <boost/regex.hpp>
+#include <bitset>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -55,6 +57,11 @@ namespace OpenMS
      peptides (cleaved and uncleaved) with up to @em n missed cleavages are returned.
      Thus @b no random selection of just @em n specific missed cleavage sites is performed.
 
+     The regular expressions of the enzymes only look at a few residues around each site. Such expressions are
+     compiled once (per process) into a lookup table over the two residues before and the residue after a site,
+     which replaces regex matching during digestion. Expressions which cannot be represented this way are matched
+     as regular expressions.
+
      @see ProteaseDigestion for functionality specific to protein digestion.
 
      @ingroup Chemistry
@@ -73,6 +80,21 @@ public:
     /// Names of the Specificity
     static const std::string NamesOfSpecificity[SIZE_OF_SPECIFICITY];
 
+    /// Digestion product, given by its position within the digested sequence
+    struct DigestionProduct
+    {
+      DigestionProduct(Size offset, Size length, Size missed_cleavages) :
+        offset(offset),
+        length(length),
+        missed_cleavages(missed_cleavages)
+      {
+      }
+
+      Size offset; ///< index of the first residue of the product in the sequence
+      Size length; ///< number of residues of the product
+      Size missed_cleavages; ///< number of missed cleavages within the product
+    };
+
     /// Name for no cleavage
     static const std::string NoCleavage;
 
@@ -135,6 +157,21 @@ public:
      */
     Size digestUnmodified(const StringView& sequence, std::vector<std::pair<Size,Size>>& output, Size min_length = 1, Size max_length = 0) const;
 
+    /**
+     @brief Performs the enzymatic digestion of an unmodified sequence.
+
+     Like the variant returning pairs of positions, but each product also reports its number of missed cleavages.
+     Products are appended in the same order as by the other variants, after clearing @p output. Reusing @p output
+     across calls avoids reallocation when digesting many sequences.
+
+     @param sequence Sequence to digest
+     @param output Digestion products (offset, length and missed cleavages)
+     @param min_length Minimal length of reported products
+     @param max_length Maximal length of reported products (0 = no restriction)
+     @return Number of discarded digestion products (which are not matching length restrictions)
+     */
+    Size digestUnmodified(const StringView& sequence, std::vector<DigestionProduct>& output, Size min_length = 1, Size max_length = 0) const;
+
     /**
     @brief Is the peptide fragment starting at position @p pos with length @p length within the sequence @p sequence generated by the current enzyme?
 
@@ -188,6 +225,26 @@ protected:
      */
     std::vector<int> tokenize_(const String& sequence, int start = 0, int end = -1) const;
 
+    /// Same as tokenize_() for the full range of @p sequence, but appends to @p positions (without clearing it)
+    void tokenize_(const StringView& sequence, std::vector<int>& positions) const;
+
+    /// Cleavage site table, indexed by the residue codes at p-2, p-1 and p (5 bits each)
+    typedef std::bitset<32768> CleavageTable;
+
+    /**
+      @brief Returns the cleavage site table compiled from the regular expression @p regex
+
+      The table is derived by evaluating @p regex on all contexts of two residues before and one residue after
+      a site and then verified against @p regex on random sequences. Tables are compiled once per process and shared.
+
+      @return The table, or a null pointer if @p regex cannot be represented by a table (e.g. if it consumes residues
+              or looks further than the context), in which case tokenize_() matches the regular expression.
+    */
+    static std::shared_ptr<const CleavageTable> getCleavageTable_(const String& regex);
+
+    /// Appends the cleavage positions in [@p start, @p end) of @p sequence according to @p table (same semantics as tokenize_())
+    static void scanCleavageSites_(const CleavageTable& table, const char* sequence, int start, int end, std::vector<int>& positions);
+
     /**
        @brief Helper function for digestUnmodified()
 
@@ -198,6 +255,7 @@ protected:
     */
     Size digestAfterTokenize_(const std::vector<int>& fragment_positions, const StringView& sequence, std::vector<StringView>& output, Size min_length = 0, Size max_length = -1) const;
     Size digestAfterTokenize_(const std::vector<int>& fragment_positions, const StringView& sequence, std::vector<std::pair<Size,Size>>& output, Size min_length = 0, Size max_length = -1) const;
+    Size digestAfterTokenize_(const std::vector<int>& fragment_positions, const StringView& sequence, std::vector<DigestionProduct>& output, Size min_length = 0, Size max_length = -1) const;
 
     /**
        @brief Counts the number of missed cleavages in a sequence fragment
@@ -216,6 +274,8 @@ protected:
     const DigestionEnzyme* enzyme_;
     /// Regex for tokenizing (huge speedup by making this a member instead of stack object in tokenize_())
     boost::regex re_;
+    /// Cleavage site table for the enzyme's regex (null if not representable, see getCleavageTable_())
+    std::shared_ptr<const CleavageTable> cleavage_table_;
 
     /// specificity of enzyme
     Specificity specificity_;
@@ -0,0 +1,232 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
+
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <set>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @ingroup Chemistry
+
+    @brief Precomputed averagine isotope patterns for fast lookup by mass.
+
+    CoarseIsotopePatternGenerator::estimateFromPeptideWeight() and its
+    fragment variants estimate an averagine formula and convolve it for every
+    call. Algorithms which query averagine patterns for every peak or feature
+    candidate spend most of their time in these convolutions.
+
+    This table evaluates the averagine model once for a set of mass nodes and
+    answers queries from the enclosing nodes. The averagine formula of a mass
+    is obtained by rounding the atom counts, so the exact patterns jump
+    whenever one of the rounded counts of C, N, O, S or P changes (e.g. every
+    22 Da for carbon) and only drift slowly in between (hydrogen). The table
+    is therefore split into segments at these jumps and never interpolates
+    across a segment boundary.
+
+    With a maximal error of zero (default), the segments are also split where
+    the number of hydrogens changes. The averagine formula is then constant
+    within each segment and lookups return exactly what
+    CoarseIsotopePatternGenerator computes, at the cost of about one node per
+    Dalton. With a positive maximal error, the abundances are interpolated
+    linearly between nodes, which are inserted until the largest deviation
+    between interpolated and exact (normalized) abundances at the center
+    between two nodes is below the requested accuracy, or the nodes are closer
+    than the minimal node distance. This needs about a tenth of the nodes. The
+    deviation that was actually achieved is available from getMaxError().
+
+    The table stores the first @p max_isotope abundances; lookups for fewer
+    isotopes renormalize the prefix, just like the generator does for a
+    smaller maximal isotope. Queries outside the tabulated mass range or for
+    more isotopes than stored are answered by the exact generator, so the
+    table can be used as a drop-in replacement.
+
+    All lookup methods are const and the table is not modified after
+    construction, so a single instance can be shared between threads
+    (see getDefaultTable()).
+  */
+  class OPENMS_DLLAPI CoarseIsotopePatternTable
+  {
+public:
+    /// Averagine models available for the table
+    enum AveragineModel
+    {
+      PEPTIDE, ///< Senko et al. (see CoarseIsotopePatternGenerator::estimateFromPeptideWeight)
+      RNA,     ///< Zubarev et al. (see CoarseIsotopePatternGenerator::estimateFromRNAWeight)
+      DNA,     ///< Zubarev et al. (see CoarseIsotopePatternGenerator::estimateFromDNAWeight)
+      SIZE_OF_AVERAGINEMODEL
+    };
+
+    /// Names of the averagine models (as used in parameters, i.e. "peptide", "RNA", "DNA")
+    static const std::string NamesOfAveragineModel[SIZE_OF_AVERAGINEMODEL];
+
+    /**
+      @brief Builds the table
+
+      @param max_mass Largest average weight that is tabulated
+      @param max_isotope Number of isotopes stored per node
+      @param max_error Largest tolerated absolute deviation of interpolated from exact (normalized) abundances (0 = exact table)
+      @param model Averagine model
+      @param min_node_distance Nodes are not refined below this distance (in Da)
+
+      @exception Exception::InvalidValue if @p max_error is negative or one of the other numeric arguments is not positive
+    */
+    CoarseIsotopePatternTable(double max_mass = 10000.0, Size max_isotope = 10, double max_error = 0.0,
+                              AveragineModel model = PEPTIDE, double min_node_distance = 0.5);
+
+    /// Returns a shared, lazily built table with default settings for @p model, which is safe to use from multiple threads
+    static const CoarseIsotopePatternTable& getDefaultTable(AveragineModel model = PEPTIDE);
+
+    /// @name Accessors
+    //@{
+    /// Smallest tabulated average weight
+    double getMinMass() const;
+
+    /// Largest tabulated average weight
+    double getMaxMass() const;
+
+    /// Number of isotopes stored per node
+    Size getMaxIsotope() const;
+
+    /// Number of nodes of the table
+    Size getNumberOfNodes() const;
+
+    /// Largest deviation of interpolated from exact abundances measured between the nodes
+    double getMaxError() const;
+
+    /// Averagine model used to build the table
+    AveragineModel getModel() const;
+    //@}
+
+    /// Returns true if @p average_weight can be answered from the table (otherwise the exact generator is used)
+    bool isTabulated(double average_weight) const;
+
+    /**
+      @brief Estimates the isotope distribution for @p average_weight
+
+      Equivalent to CoarseIsotopePatternGenerator(max_isotope).estimateFromPeptideWeight(average_weight)
+      (or the RNA/DNA variant, depending on the model).
+
+      @param average_weight Average weight of the molecule
+      @param max_isotope Number of isotopes to report (0 = all stored isotopes)
+    */
+    IsotopeDistribution estimateFromWeight(double average_weight, Size max_isotope = 0) const;
+
+    /**
+      @brief Writes the normalized isotope abundances for @p average_weight into @p intensities
+
+      Same as estimateFromWeight() but without masses. @p intensities is resized to the
+      number of isotopes (impossible isotopes of small molecules are reported as zero),
+      so repeated calls with the same buffer do not allocate.
+
+      @param average_weight Average weight of the molecule
+      @param max_isotope Number of isotopes to report (0 = all stored isotopes)
+      @param intensities Output buffer
+    */
+    void getIntensities(double average_weight, Size max_isotope, std::vector<double>& intensities) const;
+
+    /**
+      @brief Estimates the fragment isotope distribution given the isolated precursor isotopes
+
+      Equivalent to CoarseIsotopePatternGenerator::estimateForFragmentFromPeptideWeight()
+      (or the RNA/DNA variant, depending on the model). The fragment and the complementary
+      fragment distributions are both taken from the table.
+
+      @param average_weight_precursor Average weight of the precursor
+      @param average_weight_fragment Average weight of the fragment
+      @param precursor_isotopes The precursor isotopes that were isolated. 0 corresponds to the mono-isotopic molecule (M0), 1->M1, etc.
+
+      @pre average_weight_precursor >= average_weight_fragment
+      @pre precursor_isotopes.size() > 0
+    */
+    IsotopeDistribution estimateForFragmentFromWeight(double average_weight_precursor, double average_weight_fragment, const std::set<UInt>& precursor_isotopes) const;
+
+protected:
+    /// A node of the table
+    struct Node
+    {
+      double weight;
+      /// false if the next node belongs to a different segment (no interpolation towards it)
+      bool connected;
+    };
+
+    /// Computes the exact distribution (normalized over max_isotope_ abundances) at @p average_weight
+    void computeExact_(double average_weight, double* intensities) const;
+
+    /// Computes the nodes of the segment [@p left, @p right] (refined to the requested accuracy)
+    void computeSegment_(double left, double right, double max_error, double min_node_distance,
+                         std::vector<double>& weights, std::vector<double>& intensities, double& error) const;
+
+    /// Locates @p average_weight in the table, returns false if it is not tabulated
+    bool locate_(double average_weight, Size& node, double& fraction) const;
+
+    /// Interpolates the first @p n abundances at @p node / @p fraction and renormalizes them
+    void interpolate_(Size node, double fraction, Size n, double* intensities) const;
+
+    /// Rounded atom counts (C, H, N, O, S, P) of the averagine formula for @p average_weight
+    void estimateCounts_(double average_weight, double* counts) const;
+
+    /// Limits @p n to the number of possible isotopes and computes the monoisotopic weight of the averagine formula for @p average_weight
+    void finalize_(double average_weight, Size& n, double& mono_weight) const;
+
+    /// Averagine composition of the model (C, H, N, O, S, P)
+    double composition_[6];
+    /// Average weights of C, H, N, O, S, P
+    double average_weights_[6];
+    /// Monoisotopic weights of C, H, N, O, S, P
+    double mono_weights_[6];
+    /// Nominal mass difference between heaviest and lightest isotope of C, H, N, O, S, P
+    double isotope_spans_[6];
+    /// Average weight of one unit of the averagine composition
+    double average_total_;
+
+    double max_mass_;
+    Size max_isotope_;
+    double max_error_;
+    AveragineModel model_;
+
+    /// Nodes, sorted by weight
+    std::vector<Node> nodes_;
+    /// Abundances of all nodes, max_isotope_ values per node
+    std::vector<double> intensities_;
+  };
+
+} // namespace OpenMS
+
@@ -5,6 +5,7 @@ set(directory include/OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION)
 ### list all header files of the directory here
 set(sources_list_h
   CoarseIsotopePatternGenerator.h
+  CoarseIsotopePatternTable.h
   IsotopeDistribution.h
   IsotopePatternGenerator.h
 )
@@ -34,11 +34,13 @@
 
 #pragma once
 
+#include <OpenMS/DATASTRUCTURES/AtomicSnapshot.h>
 #include <OpenMS/DATASTRUCTURES/Map.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
 #include <set>
+#include <unordered_map>
 
 namespace OpenMS
 {
@@ -69,6 +71,10 @@ namespace OpenMS
       databases. This can be done by providing a path through
       initializeModificationsDB(), however it is important that this is done
       *before* the first call to getInstance().
+
+      All lookups are thread-safe and do not lock: they operate on an
+      immutable snapshot of the database, which is replaced (copy-on-write)
+      whenever modifications are added, e.g. by addModification().
   */
   class OPENMS_DLLAPI ModificationsDB
   {
@@ -181,6 +187,23 @@ protected:
     /// Stores the mappings of (unique) names to the modifications
     Map<String, std::set<const ResidueModification*> > modification_names_;
 
+    /// Immutable lookup tables used by all queries (built from mods_ and modification_names_)
+    struct Snapshot
+    {
+      /// all modifications (same order as mods_)
+      std::vector<const ResidueModification*> mods;
+      /// index of each modification in @p mods
+      std::unordered_map<const ResidueModification*, Size> index;
+      /// (unique) names to modifications
+      std::unordered_map<String, std::vector<const ResidueModification*> > names;
+    };
+
+    /// Lookup tables currently visible to readers
+    AtomicSnapshot<Snapshot> snapshot_;
+
+    /// Makes the current content of mods_ and modification_names_ visible to readers; call after every change (while holding the write lock)
+    void publishSnapshot_();
+
     /// Helper function to check if a residue matches the origin for a modification
     bool residuesMatch_(const String& residue, const ResidueModification* origin) const;
 
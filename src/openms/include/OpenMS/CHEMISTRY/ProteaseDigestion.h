@@ -37,6 +37,7 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
+#include <OpenMS/DATASTRUCTURES/FASTAContainer.h>
 
 #include <string>
 #include <vector>
@@ -99,6 +100,56 @@ namespace OpenMS
     /// forwards to isValidProduct using protein.toUnmodifiedString()
     bool isValidProduct(const AASequence& protein, int pep_pos, int pep_length, bool ignore_missed_cleavages = true, bool allow_nterm_protein_cleavage = false, bool allow_random_asp_pro_cleavage = false) const;
 
+    /**
+      @brief Digests all proteins of a database in parallel
+
+      Proteins are read from @p proteins in chunks of @p chunk_size entries; the proteins of each chunk are
+      digested concurrently (using OpenMP), each thread reusing its own product buffer.
+      For every protein, @p callback is invoked as callback(index, entry, products), with the index of the protein
+      in the database, its FASTA entry and its digestion products (see digestUnmodified()).
+      The products refer to positions in entry.sequence, which is digested as is (e.g. including a trailing '*').
+
+      @note @p callback is called concurrently from multiple threads and in no particular order. It must synchronize
+            access to shared data itself and must not throw.
+
+      @param proteins Protein database (e.g. FASTAContainer<TFI_File> or FASTAContainer<TFI_Vector>); it is read from the beginning
+      @param callback Function object receiving the products of each protein
+      @param min_length Minimal length of reported products
+      @param max_length Maximal length of reported products (0 = no restriction)
+      @param chunk_size Number of proteins held in memory at a time (ignored for FASTAContainer<TFI_Vector>)
+      @return Number of digested proteins
+    */
+    template <typename T, typename Callback>
+    Size digestDatabase(FASTAContainer<T>& proteins, Callback callback, Size min_length = 1, Size max_length = 0, Size chunk_size = 100000) const
+    {
+      Size protein_count(0);
+      proteins.reset();
+      proteins.cacheChunk(int(chunk_size));
+      while (proteins.activateCache()) // swap in last cache
+      {
+        const SignedSize chunk_entries = SignedSize(proteins.chunkSize());
+        const Size chunk_offset = proteins.getChunkOffset();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+          std::vector<DigestionProduct> products;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100) nowait
+#endif
+          for (SignedSize i = 0; i < chunk_entries; ++i)
+          {
+            const FASTAFile::FASTAEntry& entry = proteins.chunkAt(i);
+            digestUnmodified(StringView(entry.sequence), products, min_length, max_length);
+            callback(chunk_offset + i, entry, products);
+          }
+        }
+        protein_count += chunk_entries;
+        proteins.cacheChunk(int(chunk_size));
+      }
+      return protein_count;
+    }
+
   };
 
 } // namespace OpenMS
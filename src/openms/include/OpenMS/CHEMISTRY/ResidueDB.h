@@ -34,11 +34,13 @@
 
 #pragma once
 
+#include <OpenMS/DATASTRUCTURES/AtomicSnapshot.h>
 #include <OpenMS/DATASTRUCTURES/Map.h>
 #include <boost/unordered_map.hpp>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <set>
+#include <unordered_map>
 
 namespace OpenMS
 {
@@ -56,6 +58,10 @@ namespace OpenMS
       By default no modified residues are stored in an instance. However, if one
       queries the instance with getModifiedResidue, a new modified residue is
       added.
+
+      Queries do not lock: they operate on an immutable snapshot of the lookup
+      tables, which is replaced (copy-on-write) whenever a new modified residue
+      is added.
   */
   class OPENMS_DLLAPI ResidueDB
   {
@@ -219,5 +225,22 @@ protected:
     Map<String, std::set<const Residue*> > residues_by_set_;
 
     std::set<String> residue_sets_;
+
+    /// Immutable lookup tables used by all queries (built from the members above)
+    struct Snapshot
+    {
+      std::unordered_map<String, const Residue*> residue_names;
+      std::unordered_map<String, std::unordered_map<String, const Residue*> > residue_mod_names;
+      std::set<const Residue*> residues;
+      std::set<const Residue*> modified_residues;
+      Map<String, std::set<const Residue*> > residues_by_set;
+      std::set<String> residue_sets;
+    };
+
+    /// Lookup tables currently visible to readers
+    AtomicSnapshot<Snapshot> snapshot_;
+
+    /// Makes the current content of the lookup tables visible to readers; call after every change (while holding the write lock)
+    void publishSnapshot_();
   };
 }
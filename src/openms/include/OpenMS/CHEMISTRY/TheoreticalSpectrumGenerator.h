@@ -91,6 +91,29 @@ namespace OpenMS
     /// Generates a spectrum for a peptide sequence, with the ion types that are set in the tool parameters
     virtual void getSpectrum(PeakSpectrum& spec, const AASequence& peptide, Int min_charge, Int max_charge) const;
 
+    /**
+      @brief Computes the prefix masses of a peptide, as input for getFragmentMZs()
+
+      @p prefix_masses[i] is the N-terminal modification plus the internal masses of the first @p i residues,
+      the last entry additionally contains the C-terminal modification (i.e. it has peptide.size() + 1 entries).
+    */
+    static void getPrefixMasses(const AASequence& peptide, std::vector<double>& prefix_masses);
+
+    /**
+      @brief Fast path of getSpectrum() for database search engines
+
+      Fills @p mzs (sorted by m/z) and @p ion_types (the ion letter, e.g. 'b' or 'y', of each position) with the
+      ion series set in the parameters, computed from the prefix masses of the peptide (see getPrefixMasses()).
+      The positions agree with the ones of getSpectrum() up to floating point rounding.
+      Losses, isotope peaks, precursor peaks, immonium ions, intensities and annotations are not generated.
+      Search engines can create annotated spectra with getSpectrum() for the reported hits only.
+
+      The arrays are cleared but keep their capacity, i.e. no memory is allocated if they are reused for several peptides.
+
+      @exception Exception::InvalidSize is thrown if c- or x-ions are requested for a single amino acid
+    */
+    void getFragmentMZs(const std::vector<double>& prefix_masses, Int min_charge, Int max_charge, std::vector<double>& mzs, std::vector<char>& ion_types) const;
+
     /// overwrite
     void updateMembers_() override;
     //@}
@@ -109,6 +132,9 @@ namespace OpenMS
     /// helper to add an isotope cluster to a spectrum, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
     void addIsotopeCluster_(PeakSpectrum& spectrum, const AASequence& ion, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Residue::ResidueType res_type, Int charge, double intensity) const;
 
+    /// merges the ion series of the given type and charge into the sorted m/z and ion type arrays (used by getFragmentMZs())
+    void mergeIonSeries_(const std::vector<double>& prefix_masses, Residue::ResidueType res_type, Int charge, std::vector<double>& mzs, std::vector<char>& ion_types) const;
+
     /// helper for mapping residue type to letter
     static char residueTypeToIonLetter_(Residue::ResidueType res_type);
 
@@ -68,6 +68,27 @@ private:
     double threshold_;
 
 public:
+    /// linkage methods of the sparse clustering backend (see clusterSparse())
+    enum LinkageMethod
+    {
+      SINGLE_LINKAGE, ///< minimum spanning tree (Kruskal)
+      COMPLETE_LINKAGE, ///< nearest-neighbour chain
+      AVERAGE_LINKAGE ///< nearest-neighbour chain (UPGMA)
+    };
+
+    /// distance between two elements (indices into the data) as used by the sparse clustering backend
+    struct SparseDistance
+    {
+      SparseDistance(Size first_index, Size second_index, float dist) :
+        first(first_index), second(second_index), distance(dist)
+      {
+      }
+
+      Size first;
+      Size second;
+      float distance;
+    };
+
     /// default constructor
     ClusterHierarchical() :
       threshold_(1.0)
@@ -100,6 +121,7 @@ public:
 
         The similarity functor must provide the similarity calculation with the ()-operator and
         yield normalized values in range of [0,1] for the type of < Data >.
+        The distances are computed in parallel, so the functor must be callable concurrently.
 
         @param data vector of objects to be clustered
         @param comparator similarity functor fitting for types in data
@@ -120,9 +142,12 @@ public:
         // create distance matrix for data using comparator
         original_distance.clear();
         original_distance.resize(data.size(), 1);
-        for (Size i = 0; i < data.size(); i++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)data.size(); i++)
         {
-          for (Size j = 0; j < i; j++)
+          for (SignedSize j = 0; j < i; j++)
           {
             // distance value is 1-similarity value, since similarity is in range of [0,1]
             original_distance.setValueQuick(i, j, 1 - comparator(data[i], data[j]));
@@ -160,33 +185,114 @@ public:
       std::vector<BinaryTreeNode> & cluster_tree, 
       DistanceMatrix<float> & original_distance)
     {
-      std::vector<BinnedSpectrum> binned_data;
-      binned_data.reserve(data.size());
+      std::vector<BinnedSpectrum> binned_data(data.size());
 
       //transform each PeakSpectrum to a corresponding BinnedSpectrum with given settings of size and spread
-      for (Size i = 0; i < data.size(); i++)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize i = 0; i < (SignedSize)data.size(); i++)
       {
         //double sz(2), UInt sp(1);
-        binned_data.push_back(BinnedSpectrum(data[i], sz, false, sp, offset));
+        binned_data[i] = BinnedSpectrum(data[i], sz, false, sp, offset);
       }
 
       //create distancematrix for data with comparator
       original_distance.clear();
       original_distance.resize(data.size(), 1);
 
-      for (Size i = 0; i < binned_data.size(); i++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)binned_data.size(); i++)
       {
-        for (Size j = 0; j < i; j++)
+        for (SignedSize j = 0; j < i; j++)
         {
           //distance value is 1-similarity value, since similarity is in range of [0,1]
-          original_distance.setValue(i, j, 1 - comparator(binned_data[i], binned_data[j]));
+          original_distance.setValueQuick(i, j, 1 - comparator(binned_data[i], binned_data[j]));
         }
       }
+      original_distance.updateMinElement();
 
       // create Clustering with ClusterMethod, DistanceMatrix and Data
       clusterer(original_distance, cluster_tree, threshold_);
     }
 
+    /**
+        @brief Sparse clustering function
+
+        Computes the pairwise distances (1 - similarity) of @p data in parallel, but only stores those
+        below the threshold, and clusters them with clusterSparse(Size, std::vector<SparseDistance>&, LinkageMethod, std::vector<BinaryTreeNode>&) const.
+        In contrast to cluster(), no DistanceMatrix is materialized, so memory scales with the number of
+        related pairs instead of quadratically with the number of elements.
+
+        The similarity functor must be callable concurrently from several threads.
+
+        @param data vector of objects to be clustered
+        @param comparator similarity functor fitting for types in data, yielding values in [0,1]
+        @param linkage the linkage method
+        @param cluster_tree the vector that will hold the BinaryTreeNodes representing the clustering (same format as produced by the ClusterFunctor s)
+        @throw ClusterFunctor::InsufficientInput if @p data contains less than two elements
+    */
+    template <typename Data, typename SimilarityComparator>
+    void clusterSparse(const std::vector<Data> & data,
+      const SimilarityComparator & comparator,
+      const LinkageMethod linkage,
+      std::vector<BinaryTreeNode> & cluster_tree) const
+    {
+      const float threshold = threshold_;
+      std::vector<std::vector<SparseDistance> > rows(data.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)data.size(); i++)
+      {
+        for (SignedSize j = 0; j < i; j++)
+        {
+          // distance value is 1-similarity value, since similarity is in range of [0,1]
+          float distance = 1 - comparator(data[i], data[j]);
+          if (distance < threshold)
+          {
+            rows[i].push_back(SparseDistance(j, i, distance));
+          }
+        }
+      }
+
+      std::vector<SparseDistance> distances;
+      for (Size i = 0; i < rows.size(); i++)
+      {
+        distances.insert(distances.end(), rows[i].begin(), rows[i].end());
+        std::vector<SparseDistance>().swap(rows[i]);
+      }
+      clusterSparse(data.size(), distances, linkage, cluster_tree);
+    }
+
+    /**
+        @brief Sparse clustering of precomputed distances
+
+        Single linkage is computed as the minimum spanning tree of the distance graph (Kruskal),
+        complete and average linkage with the nearest-neighbour chain algorithm. Only pairs listed in
+        @p distances with a distance below the threshold are considered related; all other pairs are
+        treated as lying at the threshold. This is exact for single and complete linkage. For average
+        linkage it caps the distances at the threshold, which is exact for the default threshold of 1
+        when distances are derived from normalized similarities.
+
+        The result has the format of the ClusterFunctor s: merge steps with increasing distance,
+        clusters represented by their smallest element index (left_child < right_child), followed by
+        dummy steps with distance -1 connecting the clusters that are not merged below the threshold.
+
+        @param element_count number of elements to be clustered
+        @param distances pairwise distances (each pair at most once); will be reordered
+        @param linkage the linkage method
+        @param cluster_tree the vector that will hold the BinaryTreeNodes representing the clustering
+        @throw ClusterFunctor::InsufficientInput if @p element_count is less than two
+        @throw Exception::IndexOverflow if an index in @p distances is not below @p element_count
+    */
+    void clusterSparse(const Size element_count,
+      std::vector<SparseDistance> & distances,
+      const LinkageMethod linkage,
+      std::vector<BinaryTreeNode> & cluster_tree) const;
+
     /// get the threshold
     double getThreshold()
     {
@@ -0,0 +1,161 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Publishes immutable snapshots of read-mostly data to concurrent readers
+
+    Writers build a new (complete) instance of @p T and hand it over using
+    publish(). Readers obtain the current instance using load() and can use it
+    without any further synchronization for as long as they hold on to the
+    returned pointer, even if a newer snapshot is published in the meantime
+    (copy-on-write / RCU-style publication). Outdated snapshots are freed once
+    the last reader has released them.
+
+    Each thread caches the snapshot it has seen last. As long as no new
+    snapshot was published, load() therefore only needs one atomic read and
+    does not take any lock; only the first load() after a publication
+    synchronizes with the writer.
+
+    This is intended for lookup tables which are filled once and only rarely
+    extended afterwards (e.g. ModificationsDB, ResidueDB).
+
+    @ingroup Datastructures
+  */
+  template <typename T>
+  class AtomicSnapshot
+  {
+public:
+    /// Pointer to an immutable snapshot
+    typedef std::shared_ptr<const T> Pointer;
+
+    /// Default constructor (no snapshot published yet, load() returns a null pointer)
+    AtomicSnapshot() :
+      current_(),
+      version_(0),
+      id_(nextId_())
+    {
+    }
+
+    /// Constructor publishing an initial snapshot
+    explicit AtomicSnapshot(Pointer initial) :
+      current_(initial),
+      version_(1),
+      id_(nextId_())
+    {
+    }
+
+    /// Returns the most recently published snapshot
+    Pointer load() const
+    {
+      CacheEntry_& entry = cacheEntry_();
+      if (entry.version != version_.load(std::memory_order_acquire))
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry.snapshot = current_;
+        entry.version = version_.load(std::memory_order_relaxed);
+      }
+      return entry.snapshot;
+    }
+
+    /// Replaces the current snapshot by @p snapshot (readers of the previous snapshot are not affected)
+    void publish(Pointer snapshot)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      current_.swap(snapshot);
+      version_.fetch_add(1, std::memory_order_release);
+      // the previous snapshot is released (if unused) when 'snapshot' goes out of scope
+    }
+
+    /// Returns the number of snapshots published so far
+    Size getVersion() const
+    {
+      return version_.load(std::memory_order_acquire);
+    }
+
+private:
+    /// Not copyable
+    AtomicSnapshot(const AtomicSnapshot&) = delete;
+    AtomicSnapshot& operator=(const AtomicSnapshot&) = delete;
+
+    /// Per-thread copy of the last snapshot seen for one AtomicSnapshot instance
+    struct CacheEntry_
+    {
+      const AtomicSnapshot* owner;
+      Size id;
+      Size version;
+      Pointer snapshot;
+    };
+
+    /// Returns the cache entry of the calling thread for this instance
+    CacheEntry_& cacheEntry_() const
+    {
+      static thread_local std::vector<CacheEntry_> cache;
+      for (CacheEntry_& entry : cache)
+      {
+        if (entry.owner == this && entry.id == id_) return entry;
+      }
+      cache.push_back(CacheEntry_{this, id_, std::numeric_limits<Size>::max(), Pointer()});
+      return cache.back();
+    }
+
+    /// Returns a process-wide unique id (instances may be created at the address of a destroyed one)
+    static Size nextId_()
+    {
+      static std::atomic<Size> counter(0);
+      return ++counter;
+    }
+
+    /// Current snapshot (guarded by mutex_)
+    Pointer current_;
+    /// Number of publications (readers compare it to their cached version)
+    std::atomic<Size> version_;
+    /// Unique id of this instance
+    Size id_;
+    /// Serializes writers and readers refreshing their cached snapshot
+    mutable std::mutex mutex_;
+  };
+
+} // namespace OpenMS
@@ -4,6 +4,7 @@ set(directory include/OpenMS/DATASTRUCTURES)
 ### list all header files of the directory here
 set(sources_list_h
 Adduct.h
+AtomicSnapshot.h
 BinaryTreeNode.h
 CalibrationData.h
 ChargePair.h
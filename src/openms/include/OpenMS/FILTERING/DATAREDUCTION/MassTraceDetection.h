@@ -65,6 +65,12 @@ namespace OpenMS
       length as well as having the minimal sample rate criterion fulfilled) get
       added to the result.
 
+      Besides the in-memory run method, spectra can be passed one at a time
+      via addSpectrum() (e.g. from an IMSDataConsumer while the input file is
+      read), followed by a call to run(std::vector<MassTrace>&, const Size).
+      In this case only the MS1 peaks above the noise threshold are kept in
+      memory; the result is the same as for the in-memory run.
+
       @htmlinclude OpenMS_MassTraceDetection.parameters
 
       @ingroup Quantitation
@@ -95,6 +101,15 @@ namespace OpenMS
         /// Invokes the run method (see above) on merely a subregion of a @ref MSExperiment map.
         void run(PeakMap::ConstAreaIterator & begin, PeakMap::ConstAreaIterator & end, std::vector<MassTrace> & found_masstraces);
 
+        /** @name Streaming interface
+        */
+
+        /// Adds a spectrum (peaks sorted by m/z) for the next call of run(std::vector<MassTrace>&, const Size). Spectra that are not MS1 are ignored.
+        void addSpectrum(const MSSpectrum & spectrum);
+
+        /// Extracts mass traces from the spectra passed to addSpectrum() and discards these spectra afterwards.
+        void run(std::vector<MassTrace> & found_masstraces, const Size max_traces = 0);
+
         /** @name Private methods and members
         */
     protected:
@@ -104,6 +119,13 @@ namespace OpenMS
 
         typedef std::multimap<double, std::pair<Size, Size> > MapIdxSortedByInt;
 
+        /// Step 1 of the algorithm: keeps the peaks of an MS1 spectrum above the noise threshold and records potential chromatographic apices
+        void addSpectrum_(const MSSpectrum & spectrum,
+                          MapIdxSortedByInt & chrom_apices,
+                          Size & peak_count,
+                          PeakMap & work_exp,
+                          std::vector<Size> & spec_offsets) const;
+
         /// The internal run method
         void run_(const MapIdxSortedByInt& chrom_apices,
                   const Size peak_count,
@@ -125,5 +147,11 @@ namespace OpenMS
         double max_trace_length_;
 
         bool reestimate_mt_sd_;
+
+        // data passed via addSpectrum()
+        MapIdxSortedByInt stream_apices_;
+        Size stream_peak_count_;
+        PeakMap stream_exp_;
+        std::vector<Size> stream_offsets_;
     };
 }
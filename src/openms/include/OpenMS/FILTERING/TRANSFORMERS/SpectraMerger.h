@@ -205,71 +205,37 @@ public:
     {
 
       // convert spectra's precursors to clusterizable data
-      Size data_size;
-      std::vector<BinaryTreeNode> tree;
-      Map<Size, Size> index_mapping;
-      // local scope to save memory - we do not need the clustering stuff later
+      std::vector<BaseFeature> data;
+      std::vector<Size> index_mapping; // index in data ==> experiment index
+      for (Size i = 0; i < exp.size(); ++i)
       {
-        std::vector<BaseFeature> data;
-
-        for (Size i = 0; i < exp.size(); ++i)
+        if (exp[i].getMSLevel() != 2)
         {
-          if (exp[i].getMSLevel() != 2)
-          {
-            continue;
-          }
-
-          // remember which index in distance data ==> experiment index
-          index_mapping[data.size()] = i;
-
-          // make cluster element
-          BaseFeature bf;
-          bf.setRT(exp[i].getRT());
-          std::vector<Precursor> pcs = exp[i].getPrecursors();
-          if (pcs.empty())
-          {
-            throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
-          }
-          if (pcs.size() > 1)
-          {
-            OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
-          }
-          bf.setMZ(pcs[0].getMZ());
-          data.push_back(bf);
+          continue;
         }
-        data_size = data.size();
 
-        SpectraDistance_ llc;
-        llc.setParameters(param_.copy("precursor_method:", true));
-        SingleLinkage sl;
-        DistanceMatrix<float> dist; // will be filled
-        ClusterHierarchical ch;
+        // remember which index in distance data ==> experiment index
+        index_mapping.push_back(i);
 
-        //ch.setThreshold(0.99);
-        // clustering ; threshold is implicitly at 1.0, i.e. distances of 1.0 (== similarity 0) will not be clustered
-        ch.cluster<BaseFeature, SpectraDistance_>(data, llc, sl, tree, dist);
-      }
-
-      // extract the clusters
-      ClusterAnalyzer ca;
-      std::vector<std::vector<Size> > clusters;
-      // count number of real tree nodes (not the -1 ones):
-      Size node_count = 0;
-      for (Size ii = 0; ii < tree.size(); ++ii)
-      {
-        if (tree[ii].distance >= 1)
+        // make cluster element
+        BaseFeature bf;
+        bf.setRT(exp[i].getRT());
+        const std::vector<Precursor>& pcs = exp[i].getPrecursors();
+        if (pcs.empty())
         {
-          tree[ii].distance = -1;  // manually set to disconnect, as SingleLinkage does not support it
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
         }
-        if (tree[ii].distance != -1)
+        if (pcs.size() > 1)
         {
-          ++node_count;
+          OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
         }
+        bf.setMZ(pcs[0].getMZ());
+        data.push_back(bf);
       }
-      ca.cut(data_size - node_count, tree, clusters);
 
-      //std::cerr << "Treesize: " << (tree.size()+1) << "   #clusters: " << clusters.size() << std::endl;
-      //std::cerr << "tree:\n" << ca.newickTree(tree, true) << "\n";
+      // extract the clusters (single linkage, cut at similarity 0)
+      std::vector<std::vector<Size> > clusters;
+      clusterPrecursors_(data, clusters);
 
       // convert to blocks
       MergeBlocks spectra_to_merge;
@@ -479,6 +445,19 @@ public:
 
 protected:
 
+    /**
+        @brief single linkage clustering of precursors, cut at similarity 0
+
+        Equivalent to clustering a full DistanceMatrix with SingleLinkage and cutting the tree
+        where the distance reaches 1, but only pairs within the RT and m/z tolerances of
+        "precursor_method" are compared (RT-sorted sweep), so memory stays linear in the number
+        of spectra. The connected components of this sparse similarity graph are the clusters.
+
+        @param data precursors (RT and m/z) of the spectra to be clustered
+        @param clusters indices into @p data; each cluster is sorted ascending and clusters are sorted by their first element
+    */
+    void clusterPrecursors_(const std::vector<BaseFeature>& data, std::vector<std::vector<Size> >& clusters) const;
+
     /**
         @brief merges blocks of spectra of a certain level
 
@@ -0,0 +1,84 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/CompactMSExperiment.h>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Consumer class that stores the data in compact form.
+
+    This class keeps spectra and chromatograms passed to it in memory as a
+    CompactMSExperiment (spectra are encoded as they arrive, so the full
+    precision map is never held in memory). The data can be accessed through
+    getData().
+
+    @code
+    MSDataCompactingConsumer consumer;
+    MzMLFile().transform(filename, &consumer, true);
+    const CompactMSExperiment& exp = consumer.getData();
+    @endcode
+
+  */
+  class OPENMS_DLLAPI MSDataCompactingConsumer :
+    public Interfaces::IMSDataConsumer
+  {
+  private:
+    CompactMSExperiment exp_;
+
+  public:
+
+    MSDataCompactingConsumer();
+
+    void setExperimentalSettings(const ExperimentalSettings & settings) override;
+
+    void setExpectedSize(Size s_size, Size c_size) override;
+
+    void consumeSpectrum(SpectrumType & s) override;
+
+    void consumeChromatogram(ChromatogramType & c) override;
+
+    const CompactMSExperiment& getData() const;
+
+    /// Moves the data out of the consumer (which is left empty)
+    void swapData(CompactMSExperiment& exp);
+
+  };
+} //end namespace OpenMS
+
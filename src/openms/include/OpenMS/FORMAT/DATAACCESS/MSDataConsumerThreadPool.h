@@ -0,0 +1,133 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Passes spectra to a set of consumers using a pool of worker threads.
+
+    Each spectrum handed to consumeSpectrum() is copied into a queue of its
+    target consumer and written by one of the worker threads. A consumer is
+    only ever used by one thread at a time and receives its spectra in the
+    order in which they were submitted, so consumers writing to their own
+    file (e.g. MSDataCachedConsumer or PlainMSDataWritingConsumer) can be
+    used without modification. This allows to write many output files (e.g.
+    one per SWATH window) in parallel while the input is read sequentially.
+
+    The number of queued spectra is limited: consumeSpectrum() blocks until
+    the worker threads have caught up.
+
+    @note The consumers are not owned by the pool and must outlive it (or
+    at least the next call to finish()).
+
+  */
+  class OPENMS_DLLAPI MSDataConsumerThreadPool
+  {
+  public:
+
+    /**
+      @brief Constructor, starts the worker threads
+
+      @param nr_threads Number of worker threads (at least 1)
+      @param max_queued_spectra Maximal number of spectra waiting to be written (0 means 64 per thread)
+    */
+    MSDataConsumerThreadPool(Size nr_threads, Size max_queued_spectra = 0);
+
+    /// Destructor, waits until all queued spectra are written (errors are ignored, use finish() to receive them)
+    ~MSDataConsumerThreadPool();
+
+    /**
+      @brief Queues a copy of @p s to be passed to @p consumer
+
+      @note Exceptions raised by a consumer in a worker thread are rethrown by the next call to consumeSpectrum() or finish()
+    */
+    void consumeSpectrum(Interfaces::IMSDataConsumer* consumer, const MSSpectrum& s);
+
+    /// Waits until all queued spectra are written, rethrows the first error raised by a consumer
+    void finish();
+
+    /// Returns the number of worker threads
+    Size getNrThreads() const;
+
+  private:
+
+    /// Not implemented
+    MSDataConsumerThreadPool(const MSDataConsumerThreadPool& rhs);
+
+    /// Not implemented
+    MSDataConsumerThreadPool& operator=(const MSDataConsumerThreadPool& rhs);
+
+    struct Target
+    {
+      Interfaces::IMSDataConsumer* consumer;
+      std::deque<MSSpectrum> queue;
+      bool scheduled; ///< waiting in ready_ or being written
+    };
+
+    /// Main function of the worker threads
+    void work_();
+
+    std::deque<Target> targets_;
+    std::map<Interfaces::IMSDataConsumer*, Size> target_index_;
+    /// targets with queued spectra which are not being written
+    std::deque<Size> ready_;
+
+    Size queued_;
+    Size max_queued_;
+    bool stop_;
+    std::exception_ptr error_;
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable work_done_;
+    std::vector<std::thread> threads_;
+  };
+
+} //end namespace OpenMS
+
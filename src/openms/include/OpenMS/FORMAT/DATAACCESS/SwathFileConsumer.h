@@ -35,6 +35,7 @@
 #pragma once
 
 #include <boost/cast.hpp>
+#include <boost/shared_ptr.hpp>
 
 // Datastructures
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
@@ -42,15 +43,18 @@
 
 // Consumers
 #include <OpenMS/FORMAT/DATAACCESS/MSDataCachedConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataConsumerThreadPool.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
 
 // Helpers
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCompact.h>
 
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
+#include <OpenMS/KERNEL/CompactMSExperiment.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 
 #ifdef _OPENMP
@@ -137,6 +141,29 @@ public:
     void setExpectedSize(Size, Size) override {}
     void setExperimentalSettings(const ExperimentalSettings& exp) override {settings_ = exp; }
 
+    /**
+     * @brief Write the data of the individual maps in parallel
+     *
+     * Consumers which write the maps to disk (one file per SWATH window and
+     * one for MS1) pass the spectra to a pool of @p nr_threads writer threads
+     * (see MSDataConsumerThreadPool), such that encoding and writing of the
+     * different windows happens concurrently. Has no effect on consumers
+     * keeping the data in memory and needs to be called before the first
+     * spectrum is consumed.
+     *
+     * @param nr_threads Number of writer threads (0 or 1 writes all data in the calling thread)
+     * @param max_queued_spectra Maximal number of spectra waiting to be written (0 means 64 per thread)
+     *
+     */
+    void setWriterThreads(Size nr_threads, Size max_queued_spectra = 0)
+    {
+      writer_pool_.reset();
+      if (nr_threads > 1)
+      {
+        writer_pool_.reset(new MSDataConsumerThreadPool(nr_threads, max_queued_spectra));
+      }
+    }
+
     /**
      * @brief Populate the vector of swath maps after consuming all spectra.
      *
@@ -155,7 +182,7 @@ public:
       if (ms1_map_)
       {
         OpenSwath::SwathMap map;
-        map.sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(ms1_map_);
+        map.sptr = getSpectrumAccess_(-1);
         map.lower = -1;
         map.upper = -1;
         map.center = -1;
@@ -175,7 +202,7 @@ public:
       for (Size i = 0; i < swath_maps_.size(); i++)
       {
         OpenSwath::SwathMap map;
-        map.sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_maps_[i]);
+        map.sptr = getSpectrumAccess_((int)i);
         map.lower = swath_map_boundaries_[i].lower;
         map.upper = swath_map_boundaries_[i].upper;
         map.center = swath_map_boundaries_[i].center;
@@ -303,6 +330,41 @@ protected:
      */
     virtual void ensureMapsAreFilled_() = 0;
 
+    /**
+     * @brief Provide access to the spectra of the MS1 map (@p swath_nr < 0) or of SWATH map @p swath_nr
+     *
+     * Called by retrieveSwathMaps() for ms1_map_ and each of the swath_maps_.
+     * Consumers which do not keep the spectra in these maps override it.
+     */
+    virtual OpenSwath::SpectrumAccessPtr getSpectrumAccess_(int swath_nr)
+    {
+      return SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_nr < 0 ? ms1_map_ : swath_maps_[swath_nr]);
+    }
+
+    /**
+     * @brief Pass a spectrum to a writing consumer
+     *
+     * Uses the writer threads if enabled (see setWriterThreads()), in which
+     * case a copy of @p s is written asynchronously and @p s remains unchanged.
+     */
+    void writeSpectrum_(Interfaces::IMSDataConsumer* consumer, MapType::SpectrumType& s)
+    {
+      if (writer_pool_)
+      {
+        writer_pool_->consumeSpectrum(consumer, s);
+      }
+      else
+      {
+        consumer->consumeSpectrum(s);
+      }
+    }
+
+    /// Wait until all spectra passed to writeSpectrum_() have been written
+    void finishWriting_()
+    {
+      if (writer_pool_) writer_pool_->finish();
+    }
+
     /// A list of Swath map identifiers (lower/upper boundary and center)
     std::vector<OpenSwath::SwathMap> swath_map_boundaries_;
 
@@ -323,6 +385,9 @@ protected:
     /// How many windows were correctly annotated (non-zero window limits)
     size_t correct_window_counter_;
 
+    /// Optional writer threads (see setWriterThreads())
+    boost::shared_ptr<MSDataConsumerThreadPool> writer_pool_;
+
   };
 
   /**
@@ -380,6 +445,72 @@ protected:
     void ensureMapsAreFilled_() override {}
   };
 
+  /**
+   * @brief Compact in-memory implementation of FullSwathFileConsumer
+   *
+   * Keeps all the spectra in memory, encoded as CompactMSExperiment (about
+   * half the memory of RegularSwathFileConsumer, see CompactSpectrum for the
+   * precision of the m/z values). The spectra are decoded on access through
+   * SpectrumAccessOpenMSCompact.
+   *
+   */
+  class OPENMS_DLLAPI CompactSwathFileConsumer :
+    public FullSwathFileConsumer
+  {
+
+public:
+    typedef PeakMap MapType;
+    typedef MapType::SpectrumType SpectrumType;
+    typedef MapType::ChromatogramType ChromatogramType;
+
+    CompactSwathFileConsumer() {}
+
+    CompactSwathFileConsumer(std::vector<OpenSwath::SwathMap> known_window_boundaries) :
+      FullSwathFileConsumer(known_window_boundaries) {}
+
+protected:
+    void consumeSwathSpectrum_(MapType::SpectrumType& s, size_t swath_nr) override
+    {
+      while (swath_maps_.size() <= swath_nr)
+      {
+        // swath_maps_ only hold the meta data, the spectra are in compact_swath_maps_
+        swath_maps_.push_back(boost::shared_ptr<PeakMap>(new PeakMap(settings_)));
+        compact_swath_maps_.push_back(boost::shared_ptr<CompactMSExperiment>(new CompactMSExperiment));
+      }
+      compact_swath_maps_[swath_nr]->addSpectrum(s);
+    }
+
+    void consumeMS1Spectrum_(MapType::SpectrumType& s) override
+    {
+      if (!ms1_map_)
+      {
+        ms1_map_ = boost::shared_ptr<PeakMap>(new PeakMap(settings_));
+        compact_ms1_map_ = boost::shared_ptr<CompactMSExperiment>(new CompactMSExperiment);
+      }
+      compact_ms1_map_->addSpectrum(s);
+    }
+
+    void ensureMapsAreFilled_() override
+    {
+      if (compact_ms1_map_)
+      {
+        compact_ms1_map_->setExperimentalSettings(settings_);
+      }
+      for (auto& map : compact_swath_maps_)
+      {
+        map->setExperimentalSettings(settings_);
+      }
+    }
+
+    OpenSwath::SpectrumAccessPtr getSpectrumAccess_(int swath_nr) override
+    {
+      return OpenSwath::SpectrumAccessPtr(new SpectrumAccessOpenMSCompact(swath_nr < 0 ? compact_ms1_map_ : compact_swath_maps_[swath_nr]));
+    }
+
+    std::vector<boost::shared_ptr<CompactMSExperiment> > compact_swath_maps_;
+    boost::shared_ptr<CompactMSExperiment> compact_ms1_map_;
+  };
+
   /**
    * @brief On-disk cached implementation of FullSwathFileConsumer
    *
@@ -420,6 +551,9 @@ public:
 
     ~CachedSwathFileConsumer() override
     {
+      // Wait for the writer threads before deleting the consumers they use
+      writer_pool_.reset();
+
       // Properly delete the MSDataCachedConsumer -> free memory and _close_ file stream
       while (!swath_consumers_.empty())
       {
@@ -453,7 +587,8 @@ protected:
       {
         addNewSwathMap_();
       }
-      swath_consumers_[swath_nr]->consumeSpectrum(s); // write data to cached file; clear data from spectrum s
+      writeSpectrum_(swath_consumers_[swath_nr], s); // write data to cached file
+      clearSpectrumData_(s);
       swath_maps_[swath_nr]->addSpectrum(s); // append for the metadata (actual data was deleted)
     }
 
@@ -473,15 +608,27 @@ protected:
       {
         addMS1Map_();
       }
-      ms1_consumer_->consumeSpectrum(s);
+      writeSpectrum_(ms1_consumer_, s);
+      clearSpectrumData_(s);
       ms1_map_->addSpectrum(s); // append for the metadata (actual data is deleted)
     }
 
+    /// Remove the data of a spectrum written to disk, but keep its meta data
+    void clearSpectrumData_(MapType::SpectrumType& s)
+    {
+      s.clear(false);
+      s.setFloatDataArrays({});
+      s.setIntegerDataArrays({});
+    }
+
     void ensureMapsAreFilled_() override
     {
       size_t swath_consumers_size = swath_consumers_.size();
       bool have_ms1 = (ms1_consumer_ != nullptr);
 
+      // all data has to be on disk before the files are closed
+      finishWriting_();
+
       // Properly delete the MSDataCachedConsumer -> free memory and _close_ file stream
       // The file streams to the cached data on disc can and should be closed
       // here safely. Since ensureMapsAreFilled_ is called after consuming all
@@ -584,6 +731,9 @@ protected:
 
     void deleteSetNull_()
     {
+      // Wait for the writer threads before deleting the consumers they use
+      writer_pool_.reset();
+
       // Properly delete the MSDataCachedConsumer -> free memory and _close_ file stream
       while (!swath_consumers_.empty())
       {
@@ -613,7 +763,7 @@ protected:
       {
         addNewSwathMap_();
       }
-      swath_consumers_[swath_nr]->consumeSpectrum(s);
+      writeSpectrum_(swath_consumers_[swath_nr], s);
       s.clear(false);
     }
 
@@ -631,11 +781,12 @@ protected:
       {
         addMS1Map_();
       }
-      ms1_consumer_->consumeSpectrum(s);
+      writeSpectrum_(ms1_consumer_, s);
     }
 
     void ensureMapsAreFilled_() override
     {
+      finishWriting_();
       deleteSetNull_();
     }
 
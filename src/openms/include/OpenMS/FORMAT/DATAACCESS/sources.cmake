@@ -7,6 +7,8 @@ set(sources_list_h
   MSDataAggregatingConsumer.h
   MSDataCachedConsumer.h
   MSDataChainingConsumer.h
+  MSDataCompactingConsumer.h
+  MSDataConsumerThreadPool.h
   MSDataStoringConsumer.h
   MSDataSqlConsumer.h
   MSDataTransformingConsumer.h
@@ -45,9 +45,14 @@
 #include <OpenMS/CHEMISTRY/DigestionEnzymeProtein.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/CVTermList.h>
 
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace OpenMS
@@ -63,6 +68,15 @@ namespace OpenMS
         In read-mode, this class will parse an MzIdentML XML file and append the input
         identifications to the provided PeptideIdentifications and ProteinIdentifications.
 
+        Reading is done in a single streaming pass: the SequenceCollection
+        (DBSequence, Peptide and PeptideEvidence elements) is condensed into
+        compact index tables as it is encountered, and each SpectrumIdentificationResult
+        is converted into a PeptideIdentification as soon as its closing tag is
+        read. Thus, no document tree is built and memory usage is proportional to
+        the resulting identifications. Cross-linking MS results (SpectrumIdentificationProtocol
+        with "cross-linking search") are not supported by the streaming reader;
+        parsing is aborted softly in that case and isCrossLinkingSearch() returns true.
+
         @note Do not use this class. It is only needed in MzIdentMLFile.
         @note DOM and STREAM handler for MzIdentML have the same interface for legacy id structures.
     */
@@ -99,6 +113,9 @@ public:
       //Docu in base class
       void writeTo(std::ostream& os) override;
 
+      /// Returns true if reading was aborted because the file contains cross-linking MS results
+      bool isCrossLinkingSearch() const;
+
 protected:
       /// Progress logger
       const ProgressLogger& logger_;
@@ -157,15 +174,23 @@ protected:
       /// Convenience method to remove the [] from OpenMS internal file uri representation
       String trimOpenMSfileURI(const String file) const;
 
-      /// Abstraction of PeptideHit loop for most PeptideHits
-      void writePeptideHit(const PeptideHit& hit,
-                                std::vector<PeptideIdentification>::const_iterator& it,
-                                std::map<String, String>& pep_ids,
-                                String cv_ns, std::set<String>& sen_set,
-                                std::map<String, String>& sen_ids,
-                                std::map<String, std::vector<String> >& pep_evis,
-                                std::map<String, double>& pp_identifier_2_thresh,
-                                String& sidres);
+      /// Returns the spectrum reference of @p pep_id (or a reference built from its m/z and RT)
+      String getSpectrumReference_(const PeptideIdentification& pep_id) const;
+
+      /// Returns the id of the SpectraData element for the run of @p pep_id (or @p default_ref if the run is unknown)
+      String getSpectraDataRef_(const PeptideIdentification& pep_id, const String& default_ref) const;
+
+      /**@name Helper functions to write the elements of PeptideHits (except for XL-MS data), one at a time */
+      //@{
+      /// Writes the Peptide element with id @p pepid for sequence @p seq
+      void writePeptide_(String& s, const AASequence& seq, const String& pepid) const;
+
+      /// Writes the PeptideEvidence elements of @p hit (for Peptide @p pepid) and returns their ids in @p pevid_ids
+      void writePeptideEvidences_(String& s, const PeptideHit& hit, const String& pepid, const std::map<String, String>& sen_ids, std::vector<String>& pevid_ids) const;
+
+      /// Writes the SpectrumIdentificationItem element of @p hit in @p pep_id
+      void writeSpectrumIdentificationItem_(String& s, const PeptideHit& hit, const PeptideIdentification& pep_id, const String& pepid, const std::vector<String>& pevid_ids, const String& cv_ns, const std::map<String, double>& pp_identifier_2_thresh) const;
+      //@}
 
       /// Abstraction of PeptideHit loop for XL-MS data from OpenPepXL
       void writeXLMSPeptideHit(const PeptideHit& hit,
@@ -179,6 +204,28 @@ protected:
                                 std::map<String, String>& ppxl_specref_2_element,
                                 String& sid, bool alpha_peptide);
 
+      /**@name Helper functions to build the internal id structures while streaming */
+      //@{
+      /// Handles opening tags when reading into ProteinIdentification/PeptideIdentification
+      void startInternalElement_(const String& parent_tag, const xercesc::Attributes& attributes);
+      /// Handles closing tags when reading into ProteinIdentification/PeptideIdentification
+      void endInternalElement_();
+      /// Handles cvParam elements depending on their parent element
+      void handleInternalCVParam_(const String& parent_tag, const CVTerm& term);
+      /// Handles userParam elements depending on their parent element
+      void handleInternalUserParam_(const String& parent_tag, const String& name, const DataValue& value);
+      /// Converts the attributes of a cvParam element
+      CVTerm parseCvParam_(const xercesc::Attributes& attributes) const;
+      /// Converts the attributes of a userParam element
+      std::pair<String, DataValue> parseUserParam_(const xercesc::Attributes& attributes) const;
+      /// Builds the sequence of the current Peptide element from its sequence, substitutions and modifications
+      AASequence buildPeptideSequence_() const;
+      /// Builds the PeptideHit of the current SpectrumIdentificationItem and appends it to the current PeptideIdentification
+      void buildPeptideHit_();
+      /// Sorts the PeptideEvidence table by Peptide (stable) and builds the offsets into it
+      void indexPeptideEvidences_();
+      //@}
+
 private:
       MzIdentMLHandler();
       MzIdentMLHandler(const MzIdentMLHandler& rhs);
@@ -193,6 +240,103 @@ private:
       Int current_mod_location_;
       ProteinHit actual_protein_;
 
+      /**@name Streaming reader state (internal identification structures) */
+      //@{
+      /// Condensed information of a PeptideEvidence element, references resolved to table indices
+      struct PeptideEvidenceRecord
+      {
+        Size peptide;
+        Size db_sequence;
+        Int start;
+        Int end;
+        char pre;
+        char post;
+        bool is_decoy;
+      };
+      /// Condensed information of a DBSequence element
+      struct DBSequenceRecord
+      {
+        String accession;
+        String sequence;
+      };
+      /// Modification element of a Peptide, processed when the Peptide is complete
+      struct PeptideModificationRecord
+      {
+        SignedSize location;
+        String mass_delta;
+        std::vector<CVTerm> cvs;
+      };
+      /// SubstitutionModification element of a Peptide
+      struct SubstitutionRecord
+      {
+        String location;
+        char original;
+        char replacement;
+      };
+      /// References of a SpectrumIdentification element (one ProteinIdentification each)
+      struct SpectrumIdentificationRecord
+      {
+        String spectra_data_ref;
+        String search_database_ref;
+        String protocol_ref;
+        Size protein_index;
+      };
+
+      bool xl_ms_search_ = false; ///< true if a cross-linking search was detected (reading is aborted)
+
+      std::vector<AASequence> peptides_; ///< Peptide sequences in document order
+      std::unordered_map<String, Size> peptide_index_; ///< Peptide id -> index into peptides_
+      std::vector<PeptideEvidenceRecord> evidences_; ///< PeptideEvidences, grouped by Peptide after the SequenceCollection
+      std::vector<Size> evidence_offsets_; ///< Offsets into evidences_ per Peptide (size: peptides_.size() + 1)
+      std::vector<DBSequenceRecord> db_sequences_; ///< DBSequences in document order
+      std::unordered_map<String, Size> db_sequence_index_; ///< DBSequence id -> index into db_sequences_
+
+      std::map<String, std::pair<String, String> > software_map_; ///< AnalysisSoftware id -> (name, version)
+      std::map<String, String> spectra_data_map_; ///< SpectraData id -> location
+      std::map<String, std::pair<String, String> > database_map_; ///< SearchDatabase id -> (location, version)
+      std::vector<SpectrumIdentificationRecord> spectrum_identifications_; ///< SpectrumIdentification elements in document order
+      std::map<String, Size> sil_protein_index_; ///< SpectrumIdentificationList id -> index into pro_id_
+      std::vector<std::unordered_set<String> > protein_accessions_; ///< accessions of ProteinHits already added per index into pro_id_
+
+      std::set<String> software_terms_; ///< children of "analysis software"
+      std::set<String> enzyme_terms_; ///< children of "cleavage agent name"
+      std::set<String> threshold_terms_; ///< children of "statistical threshold"
+      std::set<String> q_score_terms_; ///< children of "PSM-level q-value"
+      std::set<String> e_score_terms_; ///< children of "E-value" terms
+      std::set<String> specific_score_terms_; ///< children of "search engine specific score for PSMs"
+
+      String current_id_; ///< id attribute of the current element of interest
+      String current_ref_; ///< main reference attribute of the current element of interest
+      String current_name_; ///< name attribute (or name param) of the current element of interest
+      String current_version_; ///< version attribute of the current element of interest
+      String current_user_name_; ///< name taken from userParams (AnalysisSoftware)
+      bool current_user_name_final_ = false; ///< a userParam containing "name" was found
+      String current_text_; ///< accumulated character data (Seq, PeptideSequence)
+      String current_date_; ///< activityDate of the current SpectrumIdentification
+      SpectrumIdentificationRecord current_si_; ///< current SpectrumIdentification
+      std::vector<SubstitutionRecord> current_substitutions_; ///< SubstitutionModifications of the current Peptide
+      std::vector<PeptideModificationRecord> current_modifications_; ///< Modifications of the current Peptide
+
+      ProteinIdentification::SearchParameters current_search_parameters_; ///< SearchParameters of the current protocol
+      CVTermList current_threshold_; ///< Threshold params of the current protocol
+      double current_precursor_tolerance_ = 0.0; ///< numerically greater ParentTolerance
+      double current_fragment_tolerance_ = 0.0; ///< numerically greater FragmentTolerance
+      String current_mod_residues_; ///< residues of the current SearchModification
+      bool current_mod_fixed_ = false; ///< fixedMod of the current SearchModification
+      std::set<String> current_mod_specificities_; ///< SpecificityRules of the current SearchModification
+
+      Size current_protein_index_ = 0; ///< index into pro_id_ of the current SpectrumIdentificationList
+      CVTermList current_result_cvs_; ///< cvParams of the current SpectrumIdentificationResult
+      std::map<String, DataValue> current_result_ups_; ///< userParams of the current SpectrumIdentificationResult
+      CVTermList current_item_cvs_; ///< cvParams of the current SpectrumIdentificationItem
+      std::map<String, DataValue> current_item_ups_; ///< userParams of the current SpectrumIdentificationItem
+      double current_item_calc_mz_ = 0.0; ///< calculatedMassToCharge of the current SpectrumIdentificationItem
+      double current_item_exp_mz_ = 0.0; ///< experimentalMassToCharge of the current SpectrumIdentificationItem
+      Int current_item_charge_ = 0; ///< chargeState of the current SpectrumIdentificationItem
+      Int current_item_rank_ = 0; ///< rank of the current SpectrumIdentificationItem
+      bool current_item_pass_ = false; ///< passThreshold of the current SpectrumIdentificationItem
+      //@}
+
     };
   } // namespace Internal
 } // namespace OpenMS
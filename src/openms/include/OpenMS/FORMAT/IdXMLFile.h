@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <OpenMS/CHEMISTRY/AASequenceCache.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
@@ -178,6 +179,8 @@ protected:
     String* document_id_;
     /// true if a prot id is contained in the current run
     bool prot_id_in_run_;
+    /// Parses each distinct peptide sequence only once (valid during load())
+    AASequenceCache* sequence_cache_;
     //@}
   };
 
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/AASequenceCache.h>
 #include <OpenMS/CHEMISTRY/Element.h>
 #include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
 #include <OpenMS/FORMAT/XMLFile.h>
@@ -208,6 +209,9 @@ private:
     /// Pointer to wrapper for looking up spectrum meta data
     const SpectrumMetaDataLookup* lookup_;
 
+    /// Parses each distinct peptide sequence only once (valid during load())
+    AASequenceCache* sequence_cache_;
+
     /// Name of the associated experiment (filename of the data file, extension will be removed)
     String exp_name_;
 
@@ -0,0 +1,168 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/CompactSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/METADATA/ExperimentalSettings.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Memory-efficient, in-memory representation of a mass spectrometry experiment
+
+    Stores all spectra as CompactSpectrum objects (8 instead of 16 bytes per
+    peak, see CompactSpectrum for the precision of the m/z encoding) while
+    chromatograms are stored unmodified. The read interface follows
+    OnDiscMSExperiment: spectra are decoded on access and returned by value,
+    so the class can be used wherever an OnDiscMSExperiment is used when the
+    data fits into memory in compact form.
+
+    Decoding is a read-only operation, so concurrent access from several
+    threads is safe.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI CompactMSExperiment
+  {
+public:
+
+    /// Default constructor
+    CompactMSExperiment() = default;
+
+    /// Copy constructor
+    CompactMSExperiment(const CompactMSExperiment& source) = default;
+
+    /// Move constructor
+    CompactMSExperiment(CompactMSExperiment&& source) = default;
+
+    /// Assignment operator
+    CompactMSExperiment& operator=(const CompactMSExperiment& source) = default;
+
+    /// Move assignment operator
+    CompactMSExperiment& operator=(CompactMSExperiment&& source) = default;
+
+    /// Destructor
+    ~CompactMSExperiment() = default;
+
+    /// Equality operator
+    bool operator==(const CompactMSExperiment& rhs) const;
+
+    /// Inequality operator
+    bool operator!=(const CompactMSExperiment& rhs) const;
+
+    /**
+      @brief Encodes all data of @p exp
+
+      Spectra are removed from @p exp while they are encoded (which keeps the
+      peak memory close to the size of the compact representation), meta data
+      and chromatograms remain in @p exp.
+    */
+    void fromExperiment(PeakMap& exp);
+
+    /// Decodes all spectra and copies chromatograms and meta data into @p exp
+    void toExperiment(PeakMap& exp) const;
+
+    /// Returns the number of spectra
+    Size getNrSpectra() const;
+
+    /// Returns the number of chromatograms
+    Size getNrChromatograms() const;
+
+    /// Alias for getNrSpectra()
+    Size size() const;
+
+    /// Returns whether the experiment contains neither spectra nor chromatograms
+    bool empty() const;
+
+    /// Decodes spectrum @p id (no range check)
+    MSSpectrum getSpectrum(Size id) const;
+
+    /// Alias for getSpectrum()
+    MSSpectrum operator[](Size id) const;
+
+    /// Returns the compact spectrum @p id without decoding it (no range check)
+    const CompactSpectrum& getCompactSpectrum(Size id) const;
+
+    /// Returns chromatogram @p id (no range check)
+    const MSChromatogram& getChromatogram(Size id) const;
+
+    /// Returns the compact spectra
+    const std::vector<CompactSpectrum>& getSpectra() const;
+
+    /// Returns the chromatograms
+    const std::vector<MSChromatogram>& getChromatograms() const;
+
+    /// Encodes and appends a spectrum
+    void addSpectrum(const MSSpectrum& spectrum);
+
+    /// Appends an already encoded spectrum
+    void addSpectrum(CompactSpectrum&& spectrum);
+
+    /// Appends a chromatogram
+    void addChromatogram(const MSChromatogram& chromatogram);
+
+    /// Reserves space for @p s_size spectra and @p c_size chromatograms
+    void reserve(Size s_size, Size c_size);
+
+    /// Returns the meta data of the experiment
+    const ExperimentalSettings& getExperimentalSettings() const;
+
+    /// Sets the meta data of the experiment
+    void setExperimentalSettings(const ExperimentalSettings& settings);
+
+    /// Removes all spectra, chromatograms and meta data
+    void clear();
+
+    /// Returns the number of bytes occupied by the encoded spectrum peaks
+    Size getPeakDataSize() const;
+
+protected:
+
+    /// meta data
+    ExperimentalSettings settings_;
+
+    /// encoded spectra
+    std::vector<CompactSpectrum> spectra_;
+
+    /// chromatograms
+    std::vector<MSChromatogram> chromatograms_;
+  };
+
+} // namespace OpenMS
+
@@ -0,0 +1,153 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Memory-efficient, read-only representation of a spectrum
+
+    An MSSpectrum stores each peak as a Peak1D, i.e. a double m/z value and a
+    float intensity (16 bytes per peak including padding). This class stores
+    the same data in 8 bytes per peak: intensities are kept as float
+    (identical to Peak1D) while m/z values are encoded as 32 bit fixed-point
+    offsets from the smallest m/z in the spectrum. The quantization step is
+    derived from the m/z range of the spectrum (range / 2^32), so the maximal
+    absolute m/z error is half a step, e.g. less than 5e-7 Th for a spectrum
+    spanning 4000 Th (see getMZAccuracy()). Peak order is preserved.
+
+    All spectrum meta data (retention time, MS level, precursors, data arrays,
+    ...) is kept without modification.
+
+    Use this class (or CompactMSExperiment) to keep large maps in memory when
+    random access to full-precision Peak1D objects is not required; convert
+    back to an MSSpectrum using toSpectrum() when processing a spectrum.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI CompactSpectrum
+  {
+public:
+
+    /// Default constructor (empty spectrum)
+    CompactSpectrum();
+
+    /// Constructor from a spectrum (see set())
+    explicit CompactSpectrum(const MSSpectrum& spectrum);
+
+    /// Copy constructor
+    CompactSpectrum(const CompactSpectrum& source) = default;
+
+    /// Move constructor
+    CompactSpectrum(CompactSpectrum&& source) = default;
+
+    /// Destructor
+    ~CompactSpectrum() = default;
+
+    /// Assignment operator
+    CompactSpectrum& operator=(const CompactSpectrum& source) = default;
+
+    /// Move assignment operator
+    CompactSpectrum& operator=(CompactSpectrum&& source) = default;
+
+    /// Equality operator (compares encoded data and meta data)
+    bool operator==(const CompactSpectrum& rhs) const;
+
+    /// Inequality operator
+    bool operator!=(const CompactSpectrum& rhs) const;
+
+    /// Encodes @p spectrum, replacing the current content
+    void set(const MSSpectrum& spectrum);
+
+    /// Decodes the spectrum (meta data and peaks)
+    MSSpectrum toSpectrum() const;
+
+    /// Decodes the spectrum (meta data and peaks) into @p spectrum
+    void get(MSSpectrum& spectrum) const;
+
+    /// Returns the number of peaks
+    Size size() const;
+
+    /// Returns whether the spectrum contains no peaks
+    bool empty() const;
+
+    /// Removes peaks and meta data
+    void clear();
+
+    /// Returns the (decoded) m/z of peak @p index (no range check)
+    double getMZ(Size index) const;
+
+    /// Returns the intensity of peak @p index (no range check)
+    float getIntensity(Size index) const;
+
+    /// Returns the maximal absolute m/z deviation introduced by the encoding
+    double getMZAccuracy() const;
+
+    /// Returns the meta data of the spectrum (an MSSpectrum without peaks)
+    const MSSpectrum& getSettings() const;
+
+    /// Returns the retention time
+    double getRT() const;
+
+    /// Returns the MS level
+    UInt getMSLevel() const;
+
+    /// Returns the number of bytes occupied by the encoded peak data
+    Size getPeakDataSize() const;
+
+protected:
+
+    /// meta data of the spectrum, without peaks
+    MSSpectrum settings_;
+
+    /// m/z of code zero
+    double mz_offset_;
+
+    /// m/z difference between two consecutive codes
+    double mz_step_;
+
+    /// encoded m/z values
+    std::vector<UInt32> mz_codes_;
+
+    /// intensities
+    std::vector<float> intensities_;
+  };
+
+} // namespace OpenMS
+
@@ -10,6 +10,8 @@ ChromatogramTools.h
 ComparatorUtils.h
 ConsensusFeature.h
 ConversionHelper.h
+CompactMSExperiment.h
+CompactSpectrum.h
 ConsensusMap.h
 ConversionHelper.h
 DPeak.h
@@ -0,0 +1,174 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Collects run time, memory and counter statistics of processing stages
+
+    Algorithms annotate their main processing stages using the scoped timer
+    Profiler::Stage and may count processed items using addCount().
+    Profiling is disabled by default, in which case annotations only cost a
+    flag check. When enabled (e.g. via the common '-profile' option of TOPP
+    tools), each stage records
+
+      - the number of calls,
+      - wall (clock) time and CPU time (user + system, summed over all threads),
+      - the thread utilization (CPU time / wall time),
+      - the peak memory consumption of the process at the end of the stage and
+        how much the stage increased it (see SysInfo::getProcessPeakMemoryConsumption()).
+
+    Statistics of all calls of a stage with the same name are accumulated.
+    The report can be written as JSON file using storeJSON().
+
+    @code
+    void MyAlgorithm::run(PeakMap& exp)
+    {
+      Profiler::Stage stage("MyAlgorithm::run");
+      ...
+      Profiler::addCount("MyAlgorithm::spectra", exp.size());
+    }
+    @endcode
+
+    @note CPU times are taken for the whole process, so stages should be
+    annotated outside of parallel regions. Nested stages are supported, the
+    time of the inner stage is then included in the outer one.
+
+    @ingroup System
+  */
+  class OPENMS_DLLAPI Profiler
+  {
+public:
+
+    /// Accumulated statistics of a single processing stage
+    struct OPENMS_DLLAPI StageStatistics
+    {
+      /// number of times the stage was run
+      Size calls;
+      /// accumulated wall time in seconds
+      double wall_time;
+      /// accumulated CPU time (user + system) in seconds
+      double cpu_time;
+      /// peak memory consumption of the process (in KB) when the stage finished, 0 if unknown
+      size_t peak_memory;
+      /// largest increase of the peak memory consumption (in KB) during a single call of the stage
+      size_t peak_memory_increase;
+
+      StageStatistics();
+
+      /// CPU time divided by wall time, i.e. the average number of busy threads
+      double getThreadUtilization() const;
+    };
+
+    /**
+      @brief Scoped timer for a processing stage
+
+      Measurement starts on construction and the statistics are recorded
+      when the object is destroyed (or stop() is called). Does nothing if
+      profiling is disabled at construction time.
+    */
+    class OPENMS_DLLAPI Stage
+    {
+public:
+      /// Start measuring the stage @p name
+      explicit Stage(const String& name);
+
+      /// Stops the measurement (if still running)
+      ~Stage();
+
+      /// Stop the measurement and record the statistics (only the first call has an effect)
+      void stop();
+
+private:
+      /// not implemented
+      Stage(const Stage&);
+      Stage& operator=(const Stage&);
+
+      String name_;
+      bool active_;
+      StopWatch watch_;
+      size_t peak_memory_before_;
+    };
+
+    /// Enable or disable profiling (disabled by default)
+    static void setEnabled(bool enabled);
+
+    /// Returns if profiling is enabled
+    static bool isEnabled();
+
+    /// Remove all recorded statistics
+    static void clear();
+
+    /// Record a single run of stage @p name (accumulated with previous runs of the same stage)
+    static void addStage(const String& name, double wall_time, double cpu_time, size_t peak_memory, size_t peak_memory_increase);
+
+    /// Add @p count to the counter @p name (ignored if profiling is disabled)
+    static void addCount(const String& name, Int64 count = 1);
+
+    /// Returns the names of all recorded stages, in the order they were first finished
+    static std::vector<String> getStageNames();
+
+    /// Returns the statistics of stage @p name (all zero if the stage was never recorded)
+    static StageStatistics getStage(const String& name);
+
+    /// Returns all counters
+    static std::map<String, Int64> getCounts();
+
+    /**
+      @brief Write all recorded statistics to a JSON file
+
+      @param filename Output file
+      @param name Name of the profiled program (e.g. the TOPP tool), stored in the report
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    static void storeJSON(const String& filename, const String& name = "");
+
+private:
+    static bool enabled_;
+    static std::vector<String> stage_names_;
+    static std::map<String, StageStatistics> stages_;
+    static std::map<String, Int64> counts_;
+  };
+}
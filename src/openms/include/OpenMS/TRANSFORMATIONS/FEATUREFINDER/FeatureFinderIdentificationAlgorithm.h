@@ -239,6 +239,9 @@ protected:
 
   void createAssayLibrary_(PeptideMap& peptide_map, PeptideRefRTMap& ref_rt_map);
 
+  /// extract chromatograms for the assay library from the LC-MS data (in batches of similar RT)
+  void extractChromatograms_();
+
   void addPeptideToMap_(PeptideIdentification& peptide, 
     PeptideMap& peptide_map,
     bool external = false) const;
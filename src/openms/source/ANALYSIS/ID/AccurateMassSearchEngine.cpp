@@ -42,8 +42,13 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#include <exception>
 #include <numeric>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -564,16 +569,17 @@ namespace OpenMS
     }
 
     // Depending on ion_mode_internal_, either positive or negative adducts are used
-    std::vector<AdductInfo>::const_iterator it_s, it_e;
+    const std::vector<AdductInfo>* adducts;
+    const std::vector<std::vector<bool> >* adducts_compatible;
     if (ion_mode == "positive")
     {
-      it_s = pos_adducts_.begin();
-      it_e = pos_adducts_.end();
+      adducts = &pos_adducts_;
+      adducts_compatible = &pos_adducts_compatible_;
     }
     else if (ion_mode == "negative")
     {
-      it_s = neg_adducts_.begin();
-      it_e = neg_adducts_.end();
+      adducts = &neg_adducts_;
+      adducts_compatible = &neg_adducts_compatible_;
     }
     else
     {
@@ -581,8 +587,10 @@ namespace OpenMS
     }
 
     std::pair<Size, Size> hit_idx;
-    for (std::vector<AdductInfo>::const_iterator it = it_s; it != it_e; ++it)
+    for (Size adduct_idx = 0; adduct_idx < adducts->size(); ++adduct_idx)
     {
+      std::vector<AdductInfo>::const_iterator it = adducts->begin() + adduct_idx;
+      const std::vector<bool>& compatible = (*adducts_compatible)[adduct_idx];
       if (observed_charge != 0 && (std::abs(observed_charge) != std::abs(it->getCharge())))
       { // charge of evidence and adduct must match in absolute terms (absolute, since any FeatureFinder gives only positive charges, even for negative-mode spectra)
         // observed_charge==0 will pass, since we basically do not know its real charge (apparently, no isotopes were found)
@@ -627,8 +635,8 @@ namespace OpenMS
       // store information from query hits in AccurateMassSearchResult objects
       for (Size i = hit_idx.first; i < hit_idx.second; ++i)
       {
-        // check if DB entry is compatible to the adduct
-        if (!it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))
+        // check if DB entry is compatible to the adduct (precomputed by init())
+        if (!compatible[i])
         {
           // only written if TOPP tool has --debug
           OPENMS_LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << it->getName() << "'. Omitting.\n";
@@ -636,7 +644,7 @@ namespace OpenMS
         }
 
         // compute ppm errors
-        double db_mass = mass_mappings_[i].mass;
+        double db_mass = db_masses_[i];
         double theoretical_mz = it->getMZ(db_mass);
         double error_ppm_mz = Math::getPPM(observed_mz, theoretical_mz); // negative values are allowed!
 
@@ -770,6 +778,8 @@ namespace OpenMS
     parseAdductsFile_(pos_adducts_fname_, pos_adducts_);
     parseAdductsFile_(neg_adducts_fname_, neg_adducts_);
 
+    buildCompatibilityIndex_();
+
     is_initialized_ = true;
   }
 
@@ -786,38 +796,74 @@ namespace OpenMS
       ion_mode_internal = resolveAutoMode_(fmap);
     }
 
-    // map for storing overall results
-    QueryResultsTable overall_results;
-    Size dummy_count(0);
-    for (Size i = 0; i < fmap.size(); ++i)
+    if (!fmap.empty()) checkQueryPreconditions_(ion_mode_internal);
+
+    // query all features in parallel (read-only access to the database); results are collected in input order
+    QueryResultsTable feature_results(fmap.size());
+    startProgress(0, fmap.size(), "searching features");
+    Size progress(0);
+    std::exception_ptr omp_exception;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)fmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
+      // no barrier here .. only an atomic update of progress value
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
 
-      // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
-      queryByFeature(fmap[i], i, ion_mode_internal, query_results);
+      IF_MASTERTHREAD // progress logger, only master thread sets progress
+      {
+        setProgress(progress);
+      }
 
-      if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
+      try
+      {
+        std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
 
-      bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
-      if (is_dummy) ++dummy_count;
+        // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
+        queryByFeature(fmap[i], i, ion_mode_internal, query_results);
 
-      if (iso_similarity_ && !is_dummy)
-      {
-        if (!fmap[i].metaValueExists("num_of_masstraces"))
-        {
-          OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity.";
-        }
-        else if ((Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
+        if (iso_similarity_ && !query_results.empty() && query_results[0].getMatchingIndex() != (Size)-1 &&
+            fmap[i].metaValueExists("num_of_masstraces") && (Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
         { // compute isotope pattern similarities (do not take the best-scoring one, since it might have really bad ppm or other properties --
           // it is impossible to decide here which one is best
           for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
           {
-            String emp_formula(query_results[hit_idx].getFormulaString());
-            double iso_sim(computeIsotopePatternSimilarity_(fmap[i], EmpiricalFormula(emp_formula)));
+            double iso_sim(computeIsotopePatternSimilarity_(fmap[i], db_formulas_[query_results[hit_idx].getMatchingIndex()]));
             query_results[hit_idx].setIsotopesSimScore(iso_sim);
           }
         }
       }
+      catch (...) // e.g. unparseable 'dc_charge_adducts'; rethrown after the parallel region
+      {
+#ifdef _OPENMP
+#pragma omp critical (AccurateMassSearchEngine_exception)
+#endif
+        if (!omp_exception) omp_exception = std::current_exception();
+      }
+    }
+    endProgress();
+    if (omp_exception) std::rethrow_exception(omp_exception);
+
+    // map for storing overall results
+    QueryResultsTable overall_results;
+    Size dummy_count(0);
+    for (Size i = 0; i < fmap.size(); ++i)
+    {
+      std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
+
+      if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
+
+      bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
+      if (is_dummy) ++dummy_count;
+
+      if (iso_similarity_ && !is_dummy && !fmap[i].metaValueExists("num_of_masstraces"))
+      {
+        OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity.";
+      }
 
       // debug output
       //        for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
@@ -826,8 +872,8 @@ namespace OpenMS
       //        }
 
       // String feat_label(fmap[i].getMetaValue(3));
-      overall_results.push_back(query_results);
       annotate_(query_results, fmap[i]);
+      overall_results.push_back(std::move(query_results));
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     fmap.getProteinIdentifications().resize(fmap.getProteinIdentifications().size() + 1);
@@ -900,16 +946,48 @@ namespace OpenMS
     ConsensusMap::ColumnHeaders fd_map = cmap.getColumnHeaders();
     Size num_of_maps = fd_map.size();
 
-    // map for storing overall results
-    QueryResultsTable overall_results;
+    if (!cmap.empty()) checkQueryPreconditions_(ion_mode_internal);
+
+    // map for storing overall results (query all consensus features in parallel, results are collected in input order)
+    QueryResultsTable overall_results(cmap.size());
+    startProgress(0, cmap.size(), "searching consensus features");
+    Size progress(0);
+    std::exception_ptr omp_exception;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)cmap.size(); ++i)
+    {
+      // no barrier here .. only an atomic update of progress value
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+
+      IF_MASTERTHREAD // progress logger, only master thread sets progress
+      {
+        setProgress(progress);
+      }
+
+      try
+      {
+        // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
+        queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, overall_results[i]);
+      }
+      catch (...) // e.g. unparseable 'dc_charge_adducts'; rethrown after the parallel region
+      {
+#ifdef _OPENMP
+#pragma omp critical (AccurateMassSearchEngine_exception)
+#endif
+        if (!omp_exception) omp_exception = std::current_exception();
+      }
+    }
+    endProgress();
+    if (omp_exception) std::rethrow_exception(omp_exception);
 
     for (Size i = 0; i < cmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
-      // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
-      queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, query_results);
-      annotate_(query_results, cmap[i]);
-      overall_results.push_back(query_results);
+      annotate_(overall_results[i], cmap[i]);
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     cmap.getProteinIdentifications().resize(cmap.getProteinIdentifications().size() + 1);
@@ -1460,17 +1538,17 @@ namespace OpenMS
     //OPENMS_LOG_INFO << "searchMass: neutral_query_mass=" << neutral_query_mass << " diff_mz=" << diff_mz << " ppm allowed:" << mass_error_value_ << std::endl;
 
     // binary search for formulas which are within diff_mz distance
-    if (mass_mappings_.empty())
+    if (db_masses_.empty())
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There are no entries found in mass-to-ids mapping file! Aborting... ", "0");
     }
 
-    std::vector<MappingEntry_>::const_iterator lower_it = std::lower_bound(mass_mappings_.begin(), mass_mappings_.end(), neutral_query_mass - diff_mass, CompareEntryAndMass_()); // first element equal or larger
-    std::vector<MappingEntry_>::const_iterator upper_it = std::upper_bound(mass_mappings_.begin(), mass_mappings_.end(), neutral_query_mass + diff_mass, CompareEntryAndMass_()); // first element greater than
+    std::vector<double>::const_iterator lower_it = std::lower_bound(db_masses_.begin(), db_masses_.end(), neutral_query_mass - diff_mass); // first element equal or larger
+    std::vector<double>::const_iterator upper_it = std::upper_bound(lower_it, db_masses_.end(), neutral_query_mass + diff_mass); // first element greater than
 
     //std::cout << *lower_it << " " << *upper_it << "idx: " << lower_it - masskey_table_.begin() << " " << upper_it - masskey_table_.begin() << std::endl;
-    Size start_idx = std::distance(mass_mappings_.begin(), lower_it);
-    Size end_idx = std::distance(mass_mappings_.begin(), upper_it);
+    Size start_idx = std::distance(db_masses_.begin(), lower_it);
+    Size end_idx = std::distance(db_masses_.begin(), upper_it);
 
     hit_indices.first = start_idx;
     hit_indices.second = end_idx;
@@ -1478,6 +1556,54 @@ namespace OpenMS
     return;
   }
 
+  void AccurateMassSearchEngine::buildCompatibilityIndex_()
+  {
+    const Size n_entries = mass_mappings_.size();
+
+    db_masses_.resize(n_entries);
+    db_formulas_.resize(n_entries);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (SignedSize i = 0; i < (SignedSize)n_entries; ++i)
+    {
+      db_masses_[i] = mass_mappings_[i].mass;
+      db_formulas_[i] = EmpiricalFormula(mass_mappings_[i].formula);
+    }
+
+    // one bit per (adduct, entry); each adduct row is written by a single thread
+    std::vector<const std::vector<AdductInfo>*> adducts = {&pos_adducts_, &neg_adducts_};
+    std::vector<std::vector<std::vector<bool> >*> compatible = {&pos_adducts_compatible_, &neg_adducts_compatible_};
+    for (Size mode = 0; mode < adducts.size(); ++mode)
+    {
+      const std::vector<AdductInfo>& mode_adducts = *adducts[mode];
+      std::vector<std::vector<bool> >& mode_compatible = *compatible[mode];
+      mode_compatible.assign(mode_adducts.size(), std::vector<bool>(n_entries, false));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize a = 0; a < (SignedSize)mode_adducts.size(); ++a)
+      {
+        for (Size i = 0; i < n_entries; ++i)
+        {
+          mode_compatible[a][i] = mode_adducts[a].isCompatible(db_formulas_[i]);
+        }
+      }
+    }
+  }
+
+  void AccurateMassSearchEngine::checkQueryPreconditions_(const String& ion_mode) const
+  {
+    if (ion_mode != "positive" && ion_mode != "negative")
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Ion mode cannot be set to '") + ion_mode + "'. Must be 'positive' or 'negative'!");
+    }
+    if (db_masses_.empty())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There are no entries found in mass-to-ids mapping file! Aborting... ", "0");
+    }
+  }
+
   double AccurateMassSearchEngine::computeCosineSim_( const std::vector<double>& x, const std::vector<double>& y ) const
   {
     if (x.size() != y.size())
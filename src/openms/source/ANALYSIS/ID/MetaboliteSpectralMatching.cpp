@@ -42,6 +42,12 @@
 
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/WindowMower.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <fstream>
 
 using namespace std;
 
@@ -441,12 +447,33 @@ namespace OpenMS
   {
     sort(spec_db.begin(), spec_db.end(), PrecursorMZLess);
 
-    vector<double> mz_keys;
+    bool fragment_error_unit_ppm(true);
+    if (mz_error_unit_ == "Da") { fragment_error_unit_ppm = false; }
 
-    // copy precursor m/z values to vector for searching
+    // prepare the library: precursor m/z values (for the binary search), charges and binned spectra (for candidate filtering)
+    vector<double> mz_keys(spec_db.size());
+    vector<Int> db_charges(spec_db.size());
+    double max_db_mz(0.0);
     for (Size spec_idx = 0; spec_idx < spec_db.size(); ++spec_idx)
     {
-      mz_keys.push_back(spec_db[spec_idx].getPrecursors()[0].getMZ());
+      mz_keys[spec_idx] = spec_db[spec_idx].getPrecursors()[0].getMZ();
+      db_charges[spec_idx] = spec_db[spec_idx].getPrecursors()[0].getCharge();
+      if (!spec_db[spec_idx].empty()) max_db_mz = max(max_db_mz, spec_db[spec_idx].back().getMZ());
+    }
+
+    // A DB peak matches an experimental peak if their distance is at most the fragment tolerance (evaluated at the DB peak).
+    // With bins of twice the largest possible tolerance and a bin spread of one, every matching pair thus shares a bin.
+    // (lower limit: keep the float rounding of BinnedSpectrum small compared to the bin size)
+    double max_fragment_tolerance = fragment_error_unit_ppm ? max_db_mz * fragment_mz_error_ * 1e-6 : fragment_mz_error_;
+    float bin_size = max(2.0 * max_fragment_tolerance, max(max_db_mz * 1e-5, 1e-4));
+    const BinnedSpectrum binning(MSSpectrum(), bin_size, false, 1, 0.0); // only used for getBinIndex()
+    vector<BinnedSpectrum> db_bins(spec_db.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize spec_idx = 0; spec_idx < (SignedSize)spec_db.size(); ++spec_idx)
+    {
+      db_bins[spec_idx] = BinnedSpectrum(spec_db[spec_idx], bin_size, false, 1, 0.0);
     }
 
     // remove potential noise peaks by selecting the ten most intense peak per 100 Da window
@@ -466,15 +493,24 @@ namespace OpenMS
     wm.filterPeakMap(msexp);
 
 
-    // container storing results
-    vector<SpectralMatch> matching_results;
-
-    bool fragment_error_unit_ppm(true);
-    if (mz_error_unit_ == "Da") { fragment_error_unit_ppm = false; }
+    // container storing results (per query spectrum, concatenated in input order below)
+    vector<vector<SpectralMatch> > spectrum_results(msexp.size());
 
-    for (Size spec_idx = 0; spec_idx < msexp.size(); ++spec_idx)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize spec_idx = 0; spec_idx < (SignedSize)msexp.size(); ++spec_idx)
     {
       // cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << endl;
+      vector<SpectralMatch>& matching_results = spectrum_results[spec_idx];
+
+      // bin indices of the query peaks (non-decreasing, since peaks are sorted by m/z)
+      vector<BinnedSpectrum::SparseVectorIndexType> exp_bin_indices;
+      exp_bin_indices.reserve(msexp[spec_idx].size());
+      for (const auto& peak : msexp[spec_idx])
+      {
+        exp_bin_indices.push_back(binning.getBinIndex(peak.getMZ()));
+      }
 
       // iterate over all precursor masses
       for (Size prec_idx = 0; prec_idx < msexp[spec_idx].getPrecursors().size(); ++prec_idx)
@@ -502,7 +538,7 @@ namespace OpenMS
         // cout << "upper mz: " << prec_mz_upperbound << endl;
 
         vector<double>::const_iterator lower_it = lower_bound(mz_keys.begin(), mz_keys.end(), prec_mz_lowerbound);
-        vector<double>::const_iterator upper_it = upper_bound(mz_keys.begin(), mz_keys.end(), prec_mz_upperbound);
+        vector<double>::const_iterator upper_it = upper_bound(lower_it, mz_keys.cend(), prec_mz_upperbound);
 
         Size start_idx(lower_it - mz_keys.begin());
         Size end_idx(upper_it - mz_keys.begin());
@@ -517,7 +553,13 @@ namespace OpenMS
           // cout << "scanning " << spec_db[search_idx].getPrecursors()[0].getMZ() << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << endl;
 
           // check for charge state of precursor ions: do they match?
-          if ( (ion_mode_ == "positive" && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (ion_mode_ == "negative" && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
+          if ( (ion_mode_ == "positive" && db_charges[search_idx] < 0) || (ion_mode_ == "negative" && db_charges[search_idx] > 0))
+          {
+            continue;
+          }
+
+          // the hyperscore is zero for less than three matching peaks
+          if (countPotentialMatches_(exp_bin_indices, db_bins[search_idx]) < 3)
           {
             continue;
           }
@@ -580,11 +622,250 @@ namespace OpenMS
       } // end precursor loop
     } // end spectra loop
 
+    vector<SpectralMatch> matching_results;
+    for (const auto& results : spectrum_results)
+    {
+      matching_results.insert(matching_results.end(), results.begin(), results.end());
+    }
+
     // write final results to MzTab
     exportMzTab_(matching_results, mztab_out);
   }
 
 
+  Size MetaboliteSpectralMatching::countPotentialMatches_(const vector<BinnedSpectrum::SparseVectorIndexType>& exp_bin_indices, const BinnedSpectrum& db_bins)
+  {
+    // merge the (sorted) bin indices of the query peaks with the (sorted) filled bins of the DB spectrum
+    Size count(0);
+    BinnedSpectrum::SparseVectorIteratorType db_it(db_bins.getBins());
+    for (auto exp_index : exp_bin_indices)
+    {
+      while (db_it && db_it.index() < exp_index) ++db_it;
+      if (!db_it) break;
+      if (db_it.index() == exp_index) ++count;
+    }
+    return count;
+  }
+
+
+  namespace
+  {
+    const String LIBRARY_CACHE_MAGIC = "OpenMS_MetaboliteSpectralLibraryCache";
+    const UInt LIBRARY_CACHE_VERSION = 2;
+
+    template <typename T>
+    void writeValue_(ofstream& ofs, const T& value)
+    {
+      ofs.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeString_(ofstream& ofs, const String& value)
+    {
+      writeValue_(ofs, (UInt64)value.size());
+      ofs.write(value.c_str(), value.size());
+    }
+
+    template <typename T>
+    void readValue_(ifstream& ifs, T& value)
+    {
+      ifs.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    void readString_(ifstream& ifs, String& value)
+    {
+      UInt64 size(0);
+      readValue_(ifs, size);
+      value.resize(ifs ? size : 0);
+      if (size > 0) ifs.read(&value[0], size);
+    }
+
+    /// identifies the file a library cache was created from (path, size and modification time)
+    struct LibrarySource_
+    {
+      String path;
+      UInt64 size = 0;
+      Int64 modified = 0; // ms since epoch
+
+      explicit LibrarySource_(const String& source = "")
+      {
+        if (source.empty()) return;
+        path = File::absolutePath(source);
+        QFileInfo fi(source.toQString());
+        if (fi.exists())
+        {
+          size = (UInt64)fi.size();
+          modified = (Int64)fi.lastModified().toMSecsSinceEpoch();
+        }
+      }
+
+      bool operator==(const LibrarySource_& rhs) const
+      {
+        return path == rhs.path && size == rhs.size && modified == rhs.modified;
+      }
+    };
+
+    /// reads the header of a library cache; returns false if the file is not a (compatible) library cache
+    bool readLibraryCacheHeader_(ifstream& ifs, LibrarySource_& source)
+    {
+      String magic(LIBRARY_CACHE_MAGIC.size(), ' ');
+      UInt version(0);
+      ifs.read(&magic[0], magic.size());
+      readValue_(ifs, version);
+      if (!ifs || magic != LIBRARY_CACHE_MAGIC || version != LIBRARY_CACHE_VERSION)
+      {
+        return false;
+      }
+      readString_(ifs, source.path);
+      readValue_(ifs, source.size);
+      readValue_(ifs, source.modified);
+      return bool(ifs);
+    }
+  }
+
+
+  void MetaboliteSpectralMatching::storeLibraryCache(const String& filename, const PeakMap& spec_db, const String& source)
+  {
+    ofstream ofs(filename.c_str(), ios::out | ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    ofs.write(LIBRARY_CACHE_MAGIC.c_str(), LIBRARY_CACHE_MAGIC.size());
+    writeValue_(ofs, LIBRARY_CACHE_VERSION);
+    const LibrarySource_ library_source(source);
+    writeString_(ofs, library_source.path);
+    writeValue_(ofs, library_source.size);
+    writeValue_(ofs, library_source.modified);
+    writeValue_(ofs, (UInt64)spec_db.size());
+
+    vector<String> keys;
+    for (const MSSpectrum& spec : spec_db)
+    {
+      writeValue_(ofs, spec.getRT());
+      writeValue_(ofs, spec.getMSLevel());
+
+      writeValue_(ofs, (UInt64)spec.getPrecursors().size());
+      for (const Precursor& prec : spec.getPrecursors())
+      {
+        writeValue_(ofs, prec.getMZ());
+        writeValue_(ofs, prec.getCharge());
+        writeValue_(ofs, prec.getIntensity());
+      }
+
+      spec.getKeys(keys);
+      writeValue_(ofs, (UInt64)keys.size());
+      for (const String& key : keys)
+      {
+        writeString_(ofs, key);
+        writeString_(ofs, spec.getMetaValue(key).toString());
+      }
+
+      writeValue_(ofs, (UInt64)spec.size());
+      for (const Peak1D& peak : spec)
+      {
+        writeValue_(ofs, peak.getMZ());
+        writeValue_(ofs, peak.getIntensity());
+      }
+    }
+
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+
+  void MetaboliteSpectralMatching::loadLibraryCache(const String& filename, PeakMap& spec_db)
+  {
+    ifstream ifs(filename.c_str(), ios::in | ios::binary);
+    if (!ifs)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    LibrarySource_ library_source;
+    if (!readLibraryCacheHeader_(ifs, library_source))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "not a spectral library cache (version " + String(LIBRARY_CACHE_VERSION) + ")");
+    }
+
+    UInt64 n_spectra(0);
+    readValue_(ifs, n_spectra);
+
+    spec_db.clear(true);
+    vector<MSSpectrum> spectra(ifs ? n_spectra : 0);
+    for (MSSpectrum& spec : spectra)
+    {
+      double rt(0.0);
+      UInt ms_level(0);
+      readValue_(ifs, rt);
+      readValue_(ifs, ms_level);
+      spec.setRT(rt);
+      spec.setMSLevel(ms_level);
+
+      UInt64 n_precursors(0);
+      readValue_(ifs, n_precursors);
+      spec.getPrecursors().resize(ifs ? n_precursors : 0);
+      for (Precursor& prec : spec.getPrecursors())
+      {
+        double mz(0.0);
+        Int charge(0);
+        float intensity(0.0);
+        readValue_(ifs, mz);
+        readValue_(ifs, charge);
+        readValue_(ifs, intensity);
+        prec.setMZ(mz);
+        prec.setCharge(charge);
+        prec.setIntensity(intensity);
+      }
+
+      UInt64 n_meta(0);
+      readValue_(ifs, n_meta);
+      for (UInt64 i = 0; ifs && i < n_meta; ++i)
+      {
+        String key, value;
+        readString_(ifs, key);
+        readString_(ifs, value);
+        spec.setMetaValue(key, value);
+      }
+
+      UInt64 n_peaks(0);
+      readValue_(ifs, n_peaks);
+      spec.resize(ifs ? n_peaks : 0);
+      for (Peak1D& peak : spec)
+      {
+        double mz(0.0);
+        float intensity(0.0);
+        readValue_(ifs, mz);
+        readValue_(ifs, intensity);
+        peak.setMZ(mz);
+        peak.setIntensity(intensity);
+      }
+
+      if (!ifs) break;
+    }
+
+    if (!ifs)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "unexpected end of spectral library cache");
+    }
+
+    spec_db.setSpectra(spectra);
+  }
+
+  bool MetaboliteSpectralMatching::isLibraryCacheCurrent(const String& filename, const String& source)
+  {
+    ifstream ifs(filename.c_str(), ios::in | ios::binary);
+    LibrarySource_ cached_source;
+    if (!ifs || !readLibraryCacheHeader_(ifs, cached_source))
+    {
+      return false;
+    }
+    return cached_source == LibrarySource_(source);
+  }
+
+
   /// protected methods
 
   void MetaboliteSpectralMatching::updateMembers_()
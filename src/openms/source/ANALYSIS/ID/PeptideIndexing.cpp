@@ -126,6 +126,11 @@ bool PeptideIndexing::isPrefix() const
   return prefix_;
 }
 
+void PeptideIndexing::setProteinIndex(std::shared_ptr<const ProteinIndex> index)
+{
+  protein_index_ = index;
+}
+
 
 /// @endcond
 
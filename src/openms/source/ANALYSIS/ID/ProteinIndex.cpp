@@ -0,0 +1,358 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/ProteinIndex.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// fixed size header of an index file, followed by starts (UInt32[protein_count + 1]), suffix array (UInt32[text_length]) and text (char[text_length])
+    struct FileHeader
+    {
+      char magic[8];
+      UInt32 version;
+      UInt32 flags; ///< bit 0: IL_equivalent
+      UInt64 protein_count;
+      UInt64 text_length;
+    };
+
+    const char MAGIC[8] = {'O', 'M', 'S', 'P', 'R', 'I', 'D', 'X'};
+    const UInt32 VERSION = 1;
+    const char SEPARATOR = '$';
+
+    /// does the ambiguous amino acid @p protein_aa (in a protein) stand for @p peptide_aa?
+    inline bool isAmbiguousMatch(char protein_aa, char peptide_aa)
+    {
+      switch (protein_aa)
+      {
+        case 'B': return peptide_aa == 'D' || peptide_aa == 'N';
+        case 'J': return peptide_aa == 'I' || peptide_aa == 'L';
+        case 'Z': return peptide_aa == 'E' || peptide_aa == 'Q';
+        case 'X': return true;
+        default: return false;
+      }
+    }
+  }
+
+  ProteinIndex::ProteinIndex() :
+    IL_equivalent_(false),
+    text_(nullptr),
+    starts_(nullptr),
+    sa_(nullptr),
+    text_length_(0),
+    protein_count_(0)
+  {
+  }
+
+  ProteinIndex::~ProteinIndex()
+  {
+  }
+
+  void ProteinIndex::clear()
+  {
+    region_.reset();
+    file_.reset();
+    text_buffer_.clear();
+    starts_buffer_.clear();
+    sa_buffer_.clear();
+    text_ = nullptr;
+    starts_ = nullptr;
+    sa_ = nullptr;
+    text_length_ = 0;
+    protein_count_ = 0;
+  }
+
+  void ProteinIndex::normalizeSequence(String& sequence, bool IL_equivalent)
+  {
+    sequence.remove('*');
+    if (IL_equivalent)
+    {
+      sequence.substitute('L', 'I');
+      sequence.substitute('J', 'I');
+    }
+  }
+
+  void ProteinIndex::appendProtein_(const String& sequence)
+  {
+    String seq(sequence);
+    normalizeSequence(seq, IL_equivalent_);
+    if (text_buffer_.size() + seq.size() + 1 >= std::numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, text_buffer_.size() + seq.size() + 1);
+    }
+    starts_buffer_.push_back(UInt32(text_buffer_.size()));
+    text_buffer_.insert(text_buffer_.end(), seq.begin(), seq.end());
+    text_buffer_.push_back(SEPARATOR);
+  }
+
+  void ProteinIndex::buildSuffixArray_()
+  {
+    protein_count_ = starts_buffer_.size();
+    text_length_ = text_buffer_.size();
+    starts_buffer_.push_back(UInt32(text_length_));
+
+    const Size n = text_length_;
+    std::vector<UInt32>& sa = sa_buffer_;
+    sa.resize(n);
+    if (n > 0)
+    {
+      // initial order and ranks (starting at 1; 0 denotes 'past the end') by first character
+      std::vector<UInt32> rank(n), tmp(n), cnt(256, 0);
+      for (Size i = 0; i < n; ++i) ++cnt[(unsigned char)text_buffer_[i]];
+      for (Size c = 1; c < 256; ++c) cnt[c] += cnt[c - 1];
+      for (Size i = n; i > 0; --i) sa[--cnt[(unsigned char)text_buffer_[i - 1]]] = UInt32(i - 1);
+      UInt32 ranks = 1;
+      rank[sa[0]] = 1;
+      for (Size j = 1; j < n; ++j)
+      {
+        if (text_buffer_[sa[j]] != text_buffer_[sa[j - 1]]) ++ranks;
+        rank[sa[j]] = ranks;
+      }
+
+      // prefix doubling: order by (rank[i], rank[i + k]) until all ranks are unique
+      std::vector<UInt32>& sa2 = tmp;
+      std::vector<UInt32> new_rank(n);
+      for (Size k = 1; ranks < n; k <<= 1)
+      {
+        // order by second key: suffixes without a second half first, then in order of the current suffix array
+        Size p = 0;
+        for (Size i = n - std::min(k, n); i < n; ++i) sa2[p++] = UInt32(i);
+        for (Size j = 0; j < n; ++j)
+        {
+          if (sa[j] >= k) sa2[p++] = UInt32(sa[j] - k);
+        }
+        // stable counting sort by first key
+        cnt.assign(ranks + 1, 0);
+        for (Size i = 0; i < n; ++i) ++cnt[rank[i]];
+        for (Size r = 1; r <= ranks; ++r) cnt[r] += cnt[r - 1];
+        for (Size j = n; j > 0; --j) sa[--cnt[rank[sa2[j - 1]]]] = sa2[j - 1];
+        // new ranks
+        ranks = 1;
+        new_rank[sa[0]] = 1;
+        for (Size j = 1; j < n; ++j)
+        {
+          const Size a = sa[j - 1], b = sa[j];
+          const UInt32 second_a = (a + k < n) ? rank[a + k] : 0;
+          const UInt32 second_b = (b + k < n) ? rank[b + k] : 0;
+          if (rank[a] != rank[b] || second_a != second_b) ++ranks;
+          new_rank[b] = ranks;
+        }
+        rank.swap(new_rank);
+      }
+    }
+
+    text_ = text_buffer_.data();
+    starts_ = starts_buffer_.data();
+    sa_ = sa_buffer_.data();
+  }
+
+  void ProteinIndex::store(const String& filename) const
+  {
+    std::ofstream os(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.flags = IL_equivalent_ ? 1 : 0;
+    header.protein_count = protein_count_;
+    header.text_length = text_length_;
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const UInt32 empty_start(0);
+    os.write(reinterpret_cast<const char*>(starts_ ? starts_ : &empty_start), (protein_count_ + 1) * sizeof(UInt32));
+    os.write(reinterpret_cast<const char*>(sa_), text_length_ * sizeof(UInt32));
+    os.write(text_, text_length_);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Error while writing the protein index.");
+    }
+  }
+
+  void ProteinIndex::load(const String& filename)
+  {
+    clear();
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    try
+    {
+      file_.reset(new boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only));
+      region_.reset(new boost::interprocess::mapped_region(*file_, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& e)
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, String("Unable to map protein index: ") + e.what());
+    }
+
+    const char* data = static_cast<const char*>(region_->get_address());
+    const Size size = region_->get_size();
+    FileHeader header;
+    if (size < sizeof(header))
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "File is too small to be a protein index.");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Not a protein index (or written by an incompatible version).");
+    }
+    const Size expected = sizeof(header) + (header.protein_count + 1) * sizeof(UInt32) + header.text_length * (sizeof(UInt32) + 1);
+    if (size != expected)
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Protein index is truncated or corrupt (size " + String(size) + " instead of " + String(expected) + " bytes).");
+    }
+
+    IL_equivalent_ = (header.flags & 1) != 0;
+    protein_count_ = header.protein_count;
+    text_length_ = header.text_length;
+    starts_ = reinterpret_cast<const UInt32*>(data + sizeof(header));
+    sa_ = starts_ + protein_count_ + 1;
+    text_ = reinterpret_cast<const char*>(sa_ + text_length_);
+  }
+
+  Size ProteinIndex::size() const
+  {
+    return protein_count_;
+  }
+
+  bool ProteinIndex::empty() const
+  {
+    return protein_count_ == 0;
+  }
+
+  bool ProteinIndex::isILEquivalent() const
+  {
+    return IL_equivalent_;
+  }
+
+  Size ProteinIndex::getProteinLength(Size index) const
+  {
+    return starts_[index + 1] - starts_[index] - 1; // without separator
+  }
+
+  String ProteinIndex::getProteinSequence(Size index) const
+  {
+    return String(text_ + starts_[index], text_ + starts_[index] + getProteinLength(index));
+  }
+
+  std::pair<Size, Size> ProteinIndex::narrow_(Size lo, Size hi, Size depth, char c) const
+  {
+    const unsigned char uc = (unsigned char)c;
+    const UInt32* first = std::lower_bound(sa_ + lo, sa_ + hi, uc, [this, depth](UInt32 suffix, unsigned char v)
+    {
+      return (unsigned char)text_[suffix + depth] < v;
+    });
+    const UInt32* last = std::upper_bound(first, sa_ + hi, uc, [this, depth](unsigned char v, UInt32 suffix)
+    {
+      return v < (unsigned char)text_[suffix + depth];
+    });
+    return std::make_pair(Size(first - sa_), Size(last - sa_));
+  }
+
+  void ProteinIndex::search(const String& peptide, Size aaa_max, Size mm_max, std::vector<Hit>& hits) const
+  {
+    hits.clear();
+    if (peptide.empty() || text_length_ == 0) return;
+    search_(peptide, 0, 0, text_length_, aaa_max, mm_max, hits);
+    std::sort(hits.begin(), hits.end());
+  }
+
+  void ProteinIndex::search_(const String& peptide, Size depth, Size lo, Size hi, Size aaa_left, Size mm_left, std::vector<Hit>& hits) const
+  {
+    if (depth == peptide.size())
+    { // all suffixes in [lo, hi) start with a match
+      for (Size j = lo; j < hi; ++j)
+      {
+        const UInt32* prot = std::upper_bound(starts_, starts_ + protein_count_ + 1, sa_[j]) - 1;
+        Hit hit;
+        hit.protein_index = prot - starts_;
+        hit.position = sa_[j] - *prot;
+        hits.push_back(hit);
+      }
+      return;
+    }
+
+    const char aa = peptide[depth];
+    if (aaa_left == 0 && mm_left == 0)
+    { // exact matching only
+      const std::pair<Size, Size> range = narrow_(lo, hi, depth, aa);
+      if (range.first < range.second) search_(peptide, depth + 1, range.first, range.second, 0, 0, hits);
+      return;
+    }
+
+    // visit every distinct protein residue at this depth once; use the cheapest way to match it
+    for (Size j = lo; j < hi; )
+    {
+      const char c = text_[sa_[j] + depth];
+      const Size next = narrow_(j, hi, depth, c).second;
+      if (c == aa)
+      {
+        search_(peptide, depth + 1, j, next, aaa_left, mm_left, hits);
+      }
+      else if (c != SEPARATOR)
+      {
+        if (aaa_left > 0 && isAmbiguousMatch(c, aa))
+        {
+          search_(peptide, depth + 1, j, next, aaa_left - 1, mm_left, hits);
+        }
+        else if (mm_left > 0)
+        {
+          search_(peptide, depth + 1, j, next, aaa_left, mm_left - 1, hits);
+        }
+      }
+      j = next;
+    }
+  }
+
+} // namespace OpenMS
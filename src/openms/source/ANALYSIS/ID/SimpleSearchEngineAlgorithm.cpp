@@ -392,7 +392,6 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     TheoreticalSpectrumGenerator spectrum_generator;
     Param param(spectrum_generator.getParameters());
     param.setValue("add_first_prefix_ion", "true");
-    param.setValue("add_metainfo", "true");
     spectrum_generator.setParameters(param);
 
     // preallocate storage for PSMs
@@ -433,6 +432,10 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
         setProgress(count_proteins);
       }
 
+      // theoretical spectra are generated into flat arrays that are reused for all candidates of this protein
+      vector<double> prefix_masses, theo_mzs;
+      vector<char> theo_ion_types;
+
       vector<StringView> current_digest;
       digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, peptide_min_size_, peptide_max_size_);
 
@@ -496,21 +499,16 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
           // no matching precursor in data
           if (low_it == up_it) { continue; }
 
-          // create theoretical spectrum
-          PeakSpectrum theo_spectrum;
-
-          // add peaks for b and y ions with charge 1
-          spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
-
-          // sort by mz
-          theo_spectrum.sortByPosition();
+          // create theoretical spectrum: b and y ions with charge 1, sorted by mz
+          TheoreticalSpectrumGenerator::getPrefixMasses(candidate, prefix_masses);
+          spectrum_generator.getFragmentMZs(prefix_masses, 1, 1, theo_mzs, theo_ion_types);
 
           for (; low_it != up_it; ++low_it)
           {
             const Size& scan_index = low_it->second;
             const PeakSpectrum& exp_spectrum = spectra[scan_index];
             // const int& charge = exp_spectrum.getPrecursors()[0].getCharge();
-            const double& score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
+            const double& score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_mzs, theo_ion_types);
 
             if (score == 0) { continue; } // no hit?
 
@@ -0,0 +1,162 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCompact.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  SpectrumAccessOpenMSCompact::SpectrumAccessOpenMSCompact(boost::shared_ptr<MSExperimentType> ms_experiment) :
+    ms_experiment_(ms_experiment)
+  {
+  }
+
+  SpectrumAccessOpenMSCompact::~SpectrumAccessOpenMSCompact()
+  {
+  }
+
+  SpectrumAccessOpenMSCompact::SpectrumAccessOpenMSCompact(const SpectrumAccessOpenMSCompact & rhs) :
+    ms_experiment_(rhs.ms_experiment_)
+  {
+  }
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessOpenMSCompact::lightClone() const
+  {
+    return boost::shared_ptr<SpectrumAccessOpenMSCompact>(new SpectrumAccessOpenMSCompact(*this));
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessOpenMSCompact::getSpectrumById(int id)
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    // decode the peaks directly into the data arrays (no intermediate MSSpectrum)
+    const CompactSpectrum& spectrum = ms_experiment_->getCompactSpectrum(id);
+    OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
+    mz_array->data.reserve(spectrum.size());
+    intensity_array->data.reserve(spectrum.size());
+    for (Size i = 0; i < spectrum.size(); ++i)
+    {
+      mz_array->data.push_back(spectrum.getMZ(i));
+      intensity_array->data.push_back(spectrum.getIntensity(i));
+    }
+
+    OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+    sptr->setMZArray(mz_array);
+    sptr->setIntensityArray(intensity_array);
+
+    for (const auto& fda : spectrum.getSettings().getFloatDataArrays())
+    {
+      OpenSwath::BinaryDataArrayPtr tmp(new OpenSwath::BinaryDataArray);
+      tmp->data.assign(fda.begin(), fda.end());
+      tmp->description = fda.getName();
+      sptr->getDataArrays().push_back(tmp);
+    }
+
+    for (const auto& ida : spectrum.getSettings().getIntegerDataArrays())
+    {
+      OpenSwath::BinaryDataArrayPtr tmp(new OpenSwath::BinaryDataArray);
+      tmp->data.assign(ida.begin(), ida.end());
+      tmp->description = ida.getName();
+      sptr->getDataArrays().push_back(tmp);
+    }
+
+    return sptr;
+  }
+
+  OpenSwath::SpectrumMeta SpectrumAccessOpenMSCompact::getSpectrumMetaById(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    const CompactSpectrum& spectrum = ms_experiment_->getCompactSpectrum(id);
+    OpenSwath::SpectrumMeta meta;
+    meta.RT = spectrum.getRT();
+    meta.ms_level = spectrum.getMSLevel();
+    return meta;
+  }
+
+  std::vector<std::size_t> SpectrumAccessOpenMSCompact::getSpectraByRT(double RT, double deltaRT) const
+  {
+    OPENMS_PRECONDITION(deltaRT >= 0, "Delta RT needs to be a positive number");
+
+    // same as SpectrumAccessOpenMS: the first spectrum at or after RT - deltaRT,
+    // followed by all spectra up to RT + deltaRT (spectra are sorted by RT)
+    std::vector<std::size_t> result;
+    const std::vector<CompactSpectrum>& spectra = ms_experiment_->getSpectra();
+    auto spectrum = std::lower_bound(spectra.begin(), spectra.end(), RT - deltaRT,
+      [](const CompactSpectrum& s, double rt) { return s.getRT() < rt; });
+    if (spectrum == spectra.end()) return result;
+
+    result.push_back(spectrum - spectra.begin());
+    ++spectrum;
+
+    while (spectrum != spectra.end() && spectrum->getRT() <= RT + deltaRT)
+    {
+      result.push_back(spectrum - spectra.begin());
+      ++spectrum;
+    }
+    return result;
+  }
+
+  size_t SpectrumAccessOpenMSCompact::getNrSpectra() const
+  {
+    return ms_experiment_->getNrSpectra();
+  }
+
+  OpenSwath::ChromatogramPtr SpectrumAccessOpenMSCompact::getChromatogramById(int id)
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+
+    return OpenSwathDataAccessHelper::convertToChromatogramPtr(ms_experiment_->getChromatogram(id));
+  }
+
+  size_t SpectrumAccessOpenMSCompact::getNrChromatograms() const
+  {
+    return ms_experiment_->getNrChromatograms();
+  }
+
+  std::string SpectrumAccessOpenMSCompact::getChromatogramNativeID(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+    return ms_experiment_->getChromatogram(id).getNativeID();
+  }
+
+} //end namespace OpenMS
@@ -0,0 +1,237 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SwathMapPrefetcher.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+
+  SwathMapPrefetcher::SwathMapPrefetcher(const std::vector<OpenSwath::SwathMap>& swath_maps, Size max_maps,
+                                         double max_memory_mb, Size nr_threads) :
+    swath_maps_(swath_maps),
+    state_(swath_maps.size(), PENDING),
+    loaded_maps_(swath_maps.size()),
+    map_bytes_(swath_maps.size(), 0),
+    next_map_(0),
+    nr_in_memory_(0),
+    nr_loading_(0),
+    nr_loaded_total_(0),
+    bytes_loaded_total_(0),
+    bytes_in_memory_(0),
+    peak_bytes_(0),
+    max_maps_(std::max(max_maps, Size(1))),
+    max_bytes_(max_memory_mb > 0.0 ? static_cast<Size>(max_memory_mb * 1024 * 1024) : 0),
+    stop_(false)
+  {
+    // MS1 maps are accessed directly and never loaded
+    for (Size i = 0; i < swath_maps_.size(); ++i)
+    {
+      if (swath_maps_[i].ms1) state_[i] = RELEASED;
+    }
+
+    nr_threads = std::max(nr_threads, Size(1));
+    for (Size i = 0; i < nr_threads; ++i)
+    {
+      threads_.emplace_back(&SwathMapPrefetcher::loadMaps_, this);
+    }
+  }
+
+  SwathMapPrefetcher::~SwathMapPrefetcher()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    state_changed_.notify_all();
+    for (std::thread& t : threads_)
+    {
+      t.join();
+    }
+  }
+
+  OpenSwath::SpectrumAccessPtr SwathMapPrefetcher::acquire(Size index)
+  {
+    if (swath_maps_[index].ms1) return swath_maps_[index].sptr;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    state_changed_.wait(lock, [this, index]
+    {
+      return state_[index] == LOADED || state_[index] == RELEASED || error_;
+    });
+    if (error_) std::rethrow_exception(error_);
+    if (state_[index] == RELEASED)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "SWATH map " + String(index) + " was already released.");
+    }
+    return loaded_maps_[index];
+  }
+
+  void SwathMapPrefetcher::release(Size index)
+  {
+    if (swath_maps_[index].ms1) return;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (state_[index] == LOADED)
+      {
+        loaded_maps_[index].reset();
+        bytes_in_memory_ -= map_bytes_[index];
+        --nr_in_memory_;
+      }
+      // maps that are currently being loaded are discarded by the loading thread
+      state_[index] = RELEASED;
+    }
+    state_changed_.notify_all();
+  }
+
+  Size SwathMapPrefetcher::getPeakMemoryUsage() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_bytes_;
+  }
+
+  Size SwathMapPrefetcher::getNrLoadedMaps() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nr_loaded_total_;
+  }
+
+  Size SwathMapPrefetcher::estimateMemoryUsage(OpenSwath::ISpectrumAccess& map)
+  {
+    Size bytes = 0;
+    for (Size i = 0; i < map.getNrSpectra(); ++i)
+    {
+      OpenSwath::SpectrumPtr spectrum = map.getSpectrumById(static_cast<int>(i));
+      for (const OpenSwath::BinaryDataArrayPtr& array : spectrum->getDataArrays())
+      {
+        bytes += sizeof(OpenSwath::OSBinaryDataArray) + array->data.capacity() * sizeof(double);
+      }
+      bytes += sizeof(OpenSwath::OSSpectrum) + sizeof(OpenSwath::OSSpectrumMeta);
+    }
+    for (Size i = 0; i < map.getNrChromatograms(); ++i)
+    {
+      OpenSwath::ChromatogramPtr chromatogram = map.getChromatogramById(static_cast<int>(i));
+      for (const OpenSwath::BinaryDataArrayPtr& array : chromatogram->getDataArrays())
+      {
+        bytes += sizeof(OpenSwath::OSBinaryDataArray) + array->data.capacity() * sizeof(double);
+      }
+      bytes += sizeof(OpenSwath::OSChromatogram);
+    }
+    return bytes;
+  }
+
+  bool SwathMapPrefetcher::canStartLoading_() const
+  {
+    if (nr_in_memory_ >= max_maps_) return false;
+    if (max_bytes_ == 0 || nr_in_memory_ == 0 || nr_loaded_total_ == 0) return true;
+
+    // account for the maps currently being loaded with the average map size
+    Size average_bytes = bytes_loaded_total_ / nr_loaded_total_;
+    return bytes_in_memory_ + (nr_loading_ + 1) * average_bytes <= max_bytes_;
+  }
+
+  void SwathMapPrefetcher::loadMaps_()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      // skip maps that were released before being loaded (or are MS1 maps)
+      while (next_map_ < swath_maps_.size() && state_[next_map_] != PENDING) ++next_map_;
+      if (stop_ || error_ || next_map_ >= swath_maps_.size()) break;
+
+      if (!canStartLoading_())
+      {
+        state_changed_.wait(lock);
+        continue;
+      }
+
+      Size index = next_map_++;
+      state_[index] = LOADING;
+      ++nr_in_memory_;
+      ++nr_loading_;
+      OpenSwath::SpectrumAccessPtr source = swath_maps_[index].sptr;
+      lock.unlock();
+
+      OpenSwath::SpectrumAccessPtr loaded;
+      Size bytes = 0;
+      std::exception_ptr error;
+      try
+      {
+        // use a light clone since the original map may be used concurrently
+        OpenSwath::SpectrumAccessPtr clone = source->lightClone();
+        loaded = OpenSwath::SpectrumAccessPtr(new SpectrumAccessOpenMSInMemory(*clone));
+        bytes = estimateMemoryUsage(*loaded);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+
+      lock.lock();
+      --nr_loading_;
+      if (error)
+      {
+        error_ = error;
+        --nr_in_memory_;
+      }
+      else
+      {
+        ++nr_loaded_total_;
+        bytes_loaded_total_ += bytes;
+        if (state_[index] == RELEASED)
+        {
+          // no longer needed
+          --nr_in_memory_;
+        }
+        else
+        {
+          state_[index] = LOADED;
+          loaded_maps_[index] = loaded;
+          map_bytes_[index] = bytes;
+          bytes_in_memory_ += bytes;
+          peak_bytes_ = std::max(peak_bytes_, bytes_in_memory_);
+        }
+      }
+      state_changed_.notify_all();
+    }
+  }
+
+} // namespace OpenMS
+
@@ -36,6 +36,7 @@
 
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternTable.h>
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithm.h>
@@ -398,8 +399,7 @@ namespace OpenMS
     else
     {
       // create the theoretical distribution from the peptide weight
-      CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
-      isotope_dist = solver.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
+      isotope_dist = CoarseIsotopePatternTable::getDefaultTable().estimateFromWeight(std::fabs(product_mz * putative_fragment_charge), dia_nr_isotopes_ + 1);
     }
 
 
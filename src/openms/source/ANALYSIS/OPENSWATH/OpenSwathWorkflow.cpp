@@ -33,6 +33,12 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SwathMapPrefetcher.h>
+
+#include <OpenMS/SYSTEM/Profiler.h>
+
+#include <exception>
+#include <memory>
 
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
@@ -78,7 +84,9 @@ namespace OpenMS
     OPENMS_LOG_DEBUG << "performRTNormalization method starting" << std::endl;
     std::vector< OpenMS::MSChromatogram > irt_chromatograms;
     TransformationDescription trafo; // dummy
+    Profiler::Stage extraction_stage("OpenSwathCalibrationWorkflow::extractIRTChromatograms");
     this->simpleExtractChromatograms_(swath_maps, irt_transitions, irt_chromatograms, trafo, cp_irt, sonar, load_into_memory);
+    extraction_stage.stop();
 
     // debug output of the iRT chromatograms
     if (irt_mzml_out.empty() && debug_level > 1)
@@ -105,6 +113,7 @@ namespace OpenMS
     OPENMS_LOG_DEBUG << "Extracted number of chromatograms from iRT files: " << irt_chromatograms.size() <<  std::endl;
 
     // perform RT and m/z correction on the data
+    Profiler::Stage normalization_stage("OpenSwathCalibrationWorkflow::doDataNormalization");
     TransformationDescription tr = doDataNormalization_(irt_transitions,
         irt_chromatograms, im_trafo, swath_maps,
         min_rsq, min_coverage, feature_finder_param,
@@ -454,6 +463,10 @@ namespace OpenMS
     int ms1_isotopes,
     bool load_into_memory)
   {
+    Profiler::Stage stage("OpenSwathWorkflow::performExtraction");
+    Profiler::addCount("OpenSwathWorkflow::performExtraction:swath_maps", swath_maps.size());
+    Profiler::addCount("OpenSwathWorkflow::performExtraction:transitions", transition_exp.transitions.size());
+
     tsv_writer.writeHeader();
     osw_writer.writeHeader();
 
@@ -537,6 +550,19 @@ namespace OpenMS
       }
     }
 
+    // Load the upcoming SWATH maps into memory in the background while the
+    // current ones are processed (maps are loaded in the order in which the
+    // dynamically scheduled loop below requests them)
+    std::unique_ptr<SwathMapPrefetcher> prefetcher;
+    if (prefetch_maps_ > 0 && !ms1_only)
+    {
+      std::cout << "Prefetch up to " << prefetch_maps_ << " SWATH maps in the background." << std::endl;
+      prefetcher.reset(new SwathMapPrefetcher(swath_maps, prefetch_maps_, prefetch_memory_mb_));
+    }
+
+    // errors while loading a map in the background (rethrown after the parallel region)
+    std::exception_ptr omp_exception;
+
     // (iii) Perform extraction and scoring of fragment ion chromatograms (MS2)
     // We set dynamic scheduling such that the maps are worked on in the order
     // in which they were given to the program / acquired. This gives much
@@ -606,11 +632,32 @@ namespace OpenMS
           }
         }
 
+        if (prefetcher && transition_exp_used_all.getTransitions().empty())
+        {
+          prefetcher->release(i); // map is not needed
+        }
+
         if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
         {
 
           OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
-          if (load_into_memory)
+          if (prefetcher)
+          {
+            // This waits until the map has been loaded into memory in the background
+            try
+            {
+              current_swath_map = prefetcher->acquire(i);
+            }
+            catch (...) // e.g. corrupt or missing map; rethrown after the parallel region
+            {
+#ifdef _OPENMP
+#pragma omp critical (OpenSwathWorkflow_exception)
+#endif
+              if (!omp_exception) omp_exception = std::current_exception();
+              continue;
+            }
+          }
+          else if (load_into_memory)
           {
             // This creates an InMemory object that keeps all data in memory
             current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
@@ -721,6 +768,12 @@ namespace OpenMS
             }
           }
 
+          if (prefetcher)
+          {
+            current_swath_map.reset();
+            prefetcher->release(i);
+          }
+
         } // continue 2 (no continue due to OpenMP)
       } // continue 1 (no continue due to OpenMP)
 
@@ -729,6 +782,13 @@ namespace OpenMS
 
     }
     this->endProgress();
+
+    if (prefetcher)
+    {
+      std::cout << "Prefetched " << prefetcher->getNrLoadedMaps() << " SWATH maps (at most "
+                << prefetcher->getPeakMemoryUsage() / (1024 * 1024) << " MB in memory at once)." << std::endl;
+      Profiler::addCount("OpenSwathWorkflow::performExtraction:prefetched_maps", prefetcher->getNrLoadedMaps());
+    }
     
 #ifdef _OPENMP
 #ifdef MT_ENABLE_NESTED_OPENMP
@@ -738,6 +798,8 @@ namespace OpenMS
     }
 #endif    
 #endif    
+
+    if (omp_exception) std::rethrow_exception(omp_exception);
   }
 
   void OpenSwathWorkflow::writeOutFeaturesAndChroms_(
@@ -1094,6 +1156,9 @@ namespace OpenMS
            int batchSize,
            bool load_into_memory)
     {
+      Profiler::Stage stage("OpenSwathWorkflowSonar::performExtractionSonar");
+      Profiler::addCount("OpenSwathWorkflowSonar::performExtractionSonar:transitions", transition_exp.transitions.size());
+
       tsv_writer.writeHeader();
       osw_writer.writeHeader();
 
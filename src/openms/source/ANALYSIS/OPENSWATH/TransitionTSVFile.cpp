@@ -35,6 +35,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVFile.h>
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
+#include <OpenMS/CHEMISTRY/AASequenceCache.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/CONCEPT/LogStream.h>
@@ -225,6 +226,8 @@ namespace OpenMS
     std::vector<std::string>   tmp_line;
     std::map<std::string, int> header_dict;
     char delimiter = ',';
+    // each peptide occurs once per transition
+    AASequenceCache sequence_cache;
 
     // SpectraST MRM Files do not have a header
     if (filetype == FileTypes::MRM)
@@ -419,7 +422,7 @@ namespace OpenMS
       {
         std::vector<String> substrings;
         String(tmp_line[header_dict["SpectraSTFullPeptideName"]]).split("/", substrings);
-        AASequence peptide = AASequence::fromString(substrings[0]);
+        AASequence peptide = sequence_cache.parse(substrings[0]);
 
         mytransition.FullPeptideName = peptide.toString();
         mytransition.PeptideSequence = peptide.toUnmodifiedString();
@@ -445,7 +448,7 @@ namespace OpenMS
             !extractName(mytransition.group_id, "TransitionGroupId", tmp_line, header_dict) &&
             !extractName(mytransition.group_id, "TransitionGroupName", tmp_line, header_dict))
         {
-          mytransition.group_id = AASequence::fromString(mytransition.FullPeptideName).toString() + String("_") + String(mytransition.precursor_charge);
+          mytransition.group_id = sequence_cache.parse(mytransition.FullPeptideName).toString() + String("_") + String(mytransition.precursor_charge);
         }
       }
 
@@ -36,6 +36,7 @@
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/DATASTRUCTURES/MatchedIterator.h>
+#include <OpenMS/MATH/MISC/MathFunctions.h>
 
 using std::vector;
 
@@ -125,5 +126,65 @@ namespace OpenMS
     return hyperScore;
   }
 
+  double HyperScore::compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const std::vector<double>& theo_mzs, const std::vector<char>& theo_ion_types)
+  {
+    if (exp_spectrum.size() < 1 || theo_mzs.size() < 1)
+    {
+      std::cout << "Warning: HyperScore: One of the given spectra is empty." << std::endl;
+      return 0.0;
+    }
+
+    int y_ion_count = 0;
+    int b_ion_count = 0;
+    double dot_product = 0.0;
+
+    // for each theoretical peak, find the closest experimental peak (same matching as MatchedIterator)
+    const float tolerance = fragment_mass_tolerance;
+    Size exp_index = 0;
+    for (Size theo_index = 0; theo_index < theo_mzs.size(); ++theo_index)
+    {
+      const double mz = theo_mzs[theo_index];
+      const double max_dist = fragment_mass_tolerance_unit_ppm ? Math::ppmToMass(tolerance, (float)mz) : tolerance;
+
+      // forward iterate over the experimental peaks until the distance gets worse
+      float diff = std::numeric_limits<float>::max();
+      do
+      {
+        const float d = fabs(mz - exp_spectrum[exp_index].getMZ());
+        if (diff > d) // getting better
+        {
+          diff = d;
+        }
+        else // getting worse (overshot)
+        {
+          --exp_index;
+          break;
+        }
+        ++exp_index;
+      } while (exp_index != exp_spectrum.size());
+
+      if (exp_index == exp_spectrum.size())
+      { // reset to last valid entry
+        --exp_index;
+      }
+      if (diff > max_dist) continue; // no match
+
+      dot_product += exp_spectrum[exp_index].getIntensity();
+      if (theo_ion_types[theo_index] == 'y')
+      {
+        ++y_ion_count;
+      }
+      else if (theo_ion_types[theo_index] == 'b')
+      {
+        ++b_ion_count;
+      }
+    }
+
+    const int i_min = std::min(y_ion_count, b_ion_count);
+    const int i_max = std::max(y_ion_count, b_ion_count);
+    const double hyperScore = log1p(dot_product) + 2*logfactorial_(i_min) + logfactorial_(i_max, i_min + 1);
+    return hyperScore;
+  }
+
 }
 
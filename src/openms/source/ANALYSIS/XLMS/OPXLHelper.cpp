@@ -52,10 +52,71 @@ using namespace std;
 
 namespace OpenMS
 {
-  vector<OPXLDataStructs::XLPrecursor> OPXLHelper::enumerateCrossLinksAndMasses(const vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const vector< double >& spectrum_precursors, vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm)
+  namespace
+  {
+    /**
+     * @brief Thread-local candidate buffers for enumerateCrossLinksAndMasses
+     *
+     * Each thread appends to its own buffer, so no synchronization is needed while enumerating.
+     * The loops use a static schedule, which assigns contiguous index ranges to the threads in thread order,
+     * so appending the buffers in thread order restores the order of a sequential enumeration.
+     */
+    class CandidateBuffers_
+    {
+    public:
+      CandidateBuffers_() :
+#ifdef _OPENMP
+        candidates_(omp_get_max_threads()),
+        positions_(omp_get_max_threads())
+#else
+        candidates_(1),
+        positions_(1)
+#endif
+      {
+      }
+
+      void add(const OPXLDataStructs::XLPrecursor& precursor, int precursor_position)
+      {
+#ifdef _OPENMP
+        const Size thread = omp_get_thread_num();
+#else
+        const Size thread = 0;
+#endif
+        candidates_[thread].push_back(precursor);
+        positions_[thread].push_back(precursor_position);
+      }
+
+      /// moves the buffered candidates to the results and empties the buffers
+      void flush(vector<OPXLDataStructs::XLPrecursor>& mass_to_candidates, vector< int >& precursor_correction_positions)
+      {
+        for (Size t = 0; t < candidates_.size(); ++t)
+        {
+          mass_to_candidates.insert(mass_to_candidates.end(), candidates_[t].begin(), candidates_[t].end());
+          precursor_correction_positions.insert(precursor_correction_positions.end(), positions_[t].begin(), positions_[t].end());
+          candidates_[t].clear();
+          positions_[t].clear();
+        }
+      }
+
+    private:
+      vector< vector<OPXLDataStructs::XLPrecursor> > candidates_;
+      vector< vector< int > > positions_;
+    };
+  }
+
+  vector<OPXLDataStructs::XLPrecursor> OPXLHelper::enumerateCrossLinksAndMasses(const vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const vector< double >& spectrum_precursors, vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size alpha_begin, Size alpha_end)
   {
     // initialize empty vector for the results
     vector<OPXLDataStructs::XLPrecursor> mass_to_candidates;
+    CandidateBuffers_ buffers;
+
+    // the range of alpha peptides (as int, like the loop indices below)
+    const int first_alpha = static_cast<int>(std::min(alpha_begin, peptides.size()));
+    const int end_alpha = static_cast<int>(std::min(alpha_end, peptides.size()));
+    if (first_alpha >= end_alpha || spectrum_precursors.empty())
+    {
+      return mass_to_candidates;
+    }
 
     double max_precursor = spectrum_precursors[spectrum_precursors.size()-1];
 
@@ -98,10 +159,10 @@ namespace OpenMS
       first_loop = lower_bound(first_loop, conservative_upper_bound, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
       last_loop = upper_bound(last_loop, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
 
-      int first_index = first_loop - peptides.cbegin();
-      int last_index = last_loop - peptides.cbegin();
+      int first_index = std::max(static_cast<int>(first_loop - peptides.cbegin()), first_alpha);
+      int last_index = std::min(static_cast<int>(last_loop - peptides.cbegin()), end_alpha);
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
       for (int p1 = first_index; p1 < last_index; ++p1)
       {
         const String& seq_first = peptides[p1].unmodified_seq;
@@ -140,13 +201,10 @@ namespace OpenMS
          precursor.alpha_seq = seq_first;
          precursor.beta_seq = "";
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+         buffers.add(precursor, pm);
         }
       } // end of parallel loop over loop-link candidates
+      buffers.flush(mass_to_candidates, precursor_correction_positions);
 
       // ################################ Enumerate Mono-Links #################
       for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
@@ -161,10 +219,10 @@ namespace OpenMS
         first_mono = lower_bound(first_mono, conservative_upper_bound, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
         last_mono = upper_bound(last_mono, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
 
-        first_index = first_mono - peptides.cbegin();
-        last_index = last_mono - peptides.cbegin();
+        first_index = std::max(static_cast<int>(first_mono - peptides.cbegin()), first_alpha);
+        last_index = std::min(static_cast<int>(last_mono - peptides.cbegin()), end_alpha);
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
         for (int p1 = first_index; p1 < last_index; ++p1)
         {
           // Monoisotopic weight of the peptide + cross-linker
@@ -178,12 +236,9 @@ namespace OpenMS
           precursor.alpha_seq = peptides[p1].unmodified_seq;
           precursor.beta_seq = "";
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+          buffers.add(precursor, pm);
         } // end of loop over candidates for a specific mono-link mass
+        buffers.flush(mass_to_candidates, precursor_correction_positions);
       } // end of loop over mono-link masses
 
       // ################################ Enumerate Cross-Links #################
@@ -192,10 +247,10 @@ namespace OpenMS
       // maximal mass: difference between precursor mass and the smallest peptide + cross-linker
       max_peptide_mass = precursor_mass - cross_link_mass - peptides[0].peptide_mass + allowed_error;
       last_alpha = upper_bound(last_alpha, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      int last_alpha_index = last_alpha - peptides.cbegin();
+      int last_alpha_index = std::min(static_cast<int>(last_alpha - peptides.cbegin()), end_alpha);
 
-#pragma omp parallel for
-      for (int p1 = 0; p1 < last_alpha_index; ++p1)
+#pragma omp parallel for schedule(static)
+      for (int p1 = first_alpha; p1 < last_alpha_index; ++p1)
       {
         // Constrain search for beta
         double min_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
@@ -226,13 +281,10 @@ namespace OpenMS
           precursor.alpha_seq = peptides[p1].unmodified_seq;
           precursor.beta_seq = peptides[p2].unmodified_seq;
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+          buffers.add(precursor, pm);
         } // end of loop over betas
       } // end of parallel loop over alphas
+      buffers.flush(mass_to_candidates, precursor_correction_positions);
     } // end of loop over precursor masses
     return mass_to_candidates;
   }
@@ -1324,7 +1376,9 @@ namespace OpenMS
                                                                                                 StringList cross_link_residue2,
                                                                                                 String cross_link_name,
                                                                                                 bool use_sequence_tags,
-                                                                                                const std::vector<std::string>& tags)
+                                                                                                const std::vector<std::string>& tags,
+                                                                                                Size alpha_begin,
+                                                                                                Size alpha_end)
   {
     // determine candidates
     std::vector< OPXLDataStructs::XLPrecursor > candidates;
@@ -1356,7 +1410,7 @@ namespace OpenMS
     if ( (use_sequence_tags && tags.size() > 0) ||
          !use_sequence_tags)
     {
-      candidates = OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+      candidates = OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, alpha_begin, alpha_end);
     }
 
     // an empty vector of sequence tags implies no filtering should be done in this case
@@ -1382,6 +1436,36 @@ namespace OpenMS
     return cross_link_candidates;
   }
 
+  Size OPXLHelper::prescoreCandidatesInBlocks(Size peptide_count,
+                                              Size block_size,
+                                              Size number_top_hits,
+                                              const std::function<std::vector<OPXLDataStructs::ProteinProteinCrossLink>(Size, Size)>& collect_candidates,
+                                              const std::function<void(const std::vector<OPXLDataStructs::ProteinProteinCrossLink>&, std::vector<OPXLDataStructs::CrossLinkSpectrumMatch>&)>& prescore_candidates,
+                                              std::vector<OPXLDataStructs::CrossLinkSpectrumMatch>& prescored_csms)
+  {
+    if (block_size == 0)
+    {
+      block_size = std::max(peptide_count, Size(1));
+    }
+
+    Size candidates_count(0);
+    for (Size alpha_begin = 0; alpha_begin < peptide_count; alpha_begin += block_size)
+    {
+      // every candidate has exactly one alpha peptide, so the blocks do not overlap
+      vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = collect_candidates(alpha_begin, std::min(alpha_begin + block_size, peptide_count));
+      candidates_count += cross_link_candidates.size();
+
+      prescore_candidates(cross_link_candidates, prescored_csms);
+
+      if (prescored_csms.size() > number_top_hits)
+      {
+        std::sort(prescored_csms.rbegin(), prescored_csms.rend(), OPXLDataStructs::CLSMScoreComparator());
+        prescored_csms.resize(number_top_hits);
+      }
+    }
+    return candidates_count;
+  }
+
   double OPXLHelper::computePrecursorError(OPXLDataStructs::CrossLinkSpectrumMatch csm, double precursor_mz, int precursor_charge)
   {
     // Error calculation
@@ -111,6 +111,8 @@ using namespace OpenMS;
     defaults_.setSectionDescription("cross_linker", "Description of the cross-linker reagent");
 
     defaults_.setValue("algorithm:number_top_hits", 5, "Number of top hits reported for each spectrum pair");
+    defaults_.setValue("algorithm:candidate_block_size", 5000, "Candidates for each spectrum are enumerated and pre-scored in blocks of this many (alpha) peptides of the mass-sorted database, only the best pre-scored candidates are kept between blocks. Smaller values reduce the memory usage with large databases. 0 enumerates all candidates of a spectrum at once.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("algorithm:candidate_block_size", 0);
     StringList deisotope_strings = ListUtils::create<String>("true,false,auto");
     defaults_.setValue("algorithm:deisotope", "auto", "Set to true, if the input spectra should be deisotoped before any other processing steps. If set to auto the spectra will be deisotoped, if the fragment mass tolerance is < 0.1 Da or < 100 ppm (0.1 Da at a mass of 1000)", ListUtils::create<String>("advanced"));
     defaults_.setValidStrings("algorithm:deisotope", deisotope_strings);
@@ -169,6 +171,7 @@ using namespace OpenMS;
     enzyme_name_ = static_cast<String>(param_.getValue("peptide:enzyme"));
 
     number_top_hits_ = static_cast<Int>(param_.getValue("algorithm:number_top_hits"));
+    candidate_block_size_ = static_cast<Size>(param_.getValue("algorithm:candidate_block_size"));
     deisotope_mode_ = static_cast<String>(param_.getValue("algorithm:deisotope"));
 
     add_y_ions_ = param_.getValue("ions:y_ions");
@@ -432,43 +435,9 @@ using namespace OpenMS;
     progresslogger.startProgress(0, 1, "Matching to theoretical spectra and scoring...");
     Size spectrum_counter = 0;
 
-    for (SignedSize pair_index = 0; pair_index < static_cast<SignedSize>(spectrum_pairs.size()); ++pair_index)
+    // pre-scores the candidates of one spectrum, called for each block of candidates (see OPXLHelper::prescoreCandidatesInBlocks)
+    auto prescore_candidates = [&](const vector< OPXLDataStructs::ProteinProteinCrossLink >& cross_link_candidates, const PeakSpectrum& linear_peaks, const PeakSpectrum& xlink_peaks, const double precursor_charge, const double precursor_mz, const double precursor_mass, vector< OPXLDataStructs::CrossLinkSpectrumMatch >& mainscore_csms_spectrum)
     {
-      Size scan_index = spectrum_pairs[pair_index].first;
-      Size scan_index_heavy = spectrum_pairs[pair_index].second;
-
-#ifdef DEBUG_OPENPEPXLALGO
-      OPENMS_LOG_DEBUG << "New scan indices: " << scan_index << "\t" << scan_index_heavy << endl;
-#endif
-      const PeakSpectrum& spectrum_light = spectra[scan_index];
-      const double precursor_charge = spectrum_light.getPrecursors()[0].getCharge();
-      const double precursor_mz = spectrum_light.getPrecursors()[0].getMZ();
-      const double precursor_mass = precursor_mz * static_cast<double>(precursor_charge) - static_cast<double>(precursor_charge) * Constants::PROTON_MASS_U;
-
-      const PeakSpectrum& linear_peaks = preprocessed_pair_spectra.spectra_linear_peaks[pair_index];
-      const PeakSpectrum& xlink_peaks = preprocessed_pair_spectra.spectra_xlink_peaks[pair_index];
-      const PeakSpectrum& all_peaks = preprocessed_pair_spectra.spectra_all_peaks[pair_index];
-
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
-
-      // ignore this spectrum pair, if they have less paired peaks than the minimal peptide size
-      if (all_peaks.size() < peptide_min_size_)
-      {
-        continue;
-      }
-
-      vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_);
-
-      spectrum_counter++;
-      cout << "Processing spectrum pair " << spectrum_counter << " / " << spectrum_pairs.size() << endl;
-      cout << "Light Spectrum ID: " << spectrum_light.getNativeID() << " |\tHeavy Spectrum ID: " << spectra[scan_index_heavy].getNativeID() << "\t| at: " << DateTime::now().getTime() << endl;
-      cout << "Number of peaks in light spectrum: " << spectrum_light.size() << " |\tNumber of candidates: " << cross_link_candidates.size() << endl;
-
-      // lists for one spectrum, to determine best match to the spectrum
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > all_csms_spectrum;
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > mainscore_csms_spectrum;
-
-
 #pragma omp parallel for schedule(guided)
       for (SignedSize i = 0; i < static_cast<SignedSize>(cross_link_candidates.size()); ++i)
       {
@@ -598,6 +567,56 @@ using namespace OpenMS;
 #pragma omp critical (mainscore_csms_spectrum_access)
         mainscore_csms_spectrum.push_back(csm);
       }
+    };
+
+    for (SignedSize pair_index = 0; pair_index < static_cast<SignedSize>(spectrum_pairs.size()); ++pair_index)
+    {
+      Size scan_index = spectrum_pairs[pair_index].first;
+      Size scan_index_heavy = spectrum_pairs[pair_index].second;
+
+#ifdef DEBUG_OPENPEPXLALGO
+      OPENMS_LOG_DEBUG << "New scan indices: " << scan_index << "\t" << scan_index_heavy << endl;
+#endif
+      const PeakSpectrum& spectrum_light = spectra[scan_index];
+      const double precursor_charge = spectrum_light.getPrecursors()[0].getCharge();
+      const double precursor_mz = spectrum_light.getPrecursors()[0].getMZ();
+      const double precursor_mass = precursor_mz * static_cast<double>(precursor_charge) - static_cast<double>(precursor_charge) * Constants::PROTON_MASS_U;
+
+      const PeakSpectrum& linear_peaks = preprocessed_pair_spectra.spectra_linear_peaks[pair_index];
+      const PeakSpectrum& xlink_peaks = preprocessed_pair_spectra.spectra_xlink_peaks[pair_index];
+      const PeakSpectrum& all_peaks = preprocessed_pair_spectra.spectra_all_peaks[pair_index];
+
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
+
+      // ignore this spectrum pair, if they have less paired peaks than the minimal peptide size
+      if (all_peaks.size() < peptide_min_size_)
+      {
+        continue;
+      }
+
+      // lists for one spectrum, to determine best match to the spectrum
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch > all_csms_spectrum;
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch > mainscore_csms_spectrum;
+
+      // enumerate and pre-score the candidates in blocks of alpha peptides of the mass-sorted database to bound memory usage,
+      // only the best pre-scored candidates are kept between blocks
+      Size candidates_count = OPXLHelper::prescoreCandidatesInBlocks(filtered_peptide_masses.size(), candidate_block_size_, number_top_hits_,
+        [&](Size alpha_begin, Size alpha_end)
+        {
+          vector< OPXLDataStructs::ProteinProteinCrossLink > cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, false, std::vector<std::string>(), alpha_begin, alpha_end);
+          return cross_link_candidates;
+        },
+        [&](const vector< OPXLDataStructs::ProteinProteinCrossLink >& cross_link_candidates, vector< OPXLDataStructs::CrossLinkSpectrumMatch >& prescored_csms)
+        {
+          prescore_candidates(cross_link_candidates, linear_peaks, xlink_peaks, precursor_charge, precursor_mz, precursor_mass, prescored_csms);
+        },
+        mainscore_csms_spectrum);
+
+      spectrum_counter++;
+      cout << "Processing spectrum pair " << spectrum_counter << " / " << spectrum_pairs.size() << endl;
+      cout << "Light Spectrum ID: " << spectrum_light.getNativeID() << " |\tHeavy Spectrum ID: " << spectra[scan_index_heavy].getNativeID() << "\t| at: " << DateTime::now().getTime() << endl;
+      cout << "Number of peaks in light spectrum: " << spectrum_light.size() << " |\tNumber of candidates: " << candidates_count << endl;
+
       // progresslogger.endProgress();
       std::sort(mainscore_csms_spectrum.rbegin(), mainscore_csms_spectrum.rend(), OPXLDataStructs::CLSMScoreComparator());
 
@@ -108,6 +108,8 @@ using namespace OpenMS;
     defaults_.setSectionDescription("cross_linker", "Description of the cross-linker reagent");
 
     defaults_.setValue("algorithm:number_top_hits", 5, "Number of top hits reported for each spectrum pair");
+    defaults_.setValue("algorithm:candidate_block_size", 5000, "Candidates for each spectrum are enumerated and pre-scored in blocks of this many (alpha) peptides of the mass-sorted database, only the best pre-scored candidates are kept between blocks. Smaller values reduce the memory usage with large databases. 0 enumerates all candidates of a spectrum at once.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("algorithm:candidate_block_size", 0);
     StringList deisotope_strings = ListUtils::create<String>("true,false,auto");
     defaults_.setValue("algorithm:deisotope", "auto", "Set to true, if the input spectra should be deisotoped before any other processing steps. If set to auto the spectra will be deisotoped, if the fragment mass tolerance is < 0.1 Da or < 100 ppm (0.1 Da at a mass of 1000)", ListUtils::create<String>("advanced"));
     defaults_.setValidStrings("algorithm:deisotope", deisotope_strings);
@@ -168,6 +170,7 @@ using namespace OpenMS;
     enzyme_name_ = static_cast<String>(param_.getValue("peptide:enzyme"));
 
     number_top_hits_ = static_cast<Int>(param_.getValue("algorithm:number_top_hits"));
+    candidate_block_size_ = static_cast<Size>(param_.getValue("algorithm:candidate_block_size"));
     deisotope_mode_ = static_cast<String>(param_.getValue("algorithm:deisotope"));
     use_sequence_tags_ = param_.getValue("algorithm:use_sequence_tags") == "true";
     sequence_tag_min_length_ = static_cast<Size>(param_.getValue("algorithm:sequence_tag_min_length"));
@@ -398,42 +401,9 @@ using namespace OpenMS;
 
     Size spectrum_counter(0);
 
-    for (SignedSize scan_index = 0; scan_index < static_cast<SignedSize>(spectra.size()); ++scan_index)
+    // pre-scores the candidates of one spectrum, called for each block of candidates (see OPXLHelper::prescoreCandidatesInBlocks)
+    auto prescore_candidates = [&](const vector< OPXLDataStructs::ProteinProteinCrossLink >& cross_link_candidates, const PeakSpectrum& spectrum, const double precursor_charge, const double precursor_mz, const double precursor_mass, vector< OPXLDataStructs::CrossLinkSpectrumMatch >& mainscore_csms_spectrum)
     {
-      const PeakSpectrum& spectrum = spectra[scan_index];
-
-      const double precursor_charge = spectrum.getPrecursors()[0].getCharge();
-      const double precursor_mz = spectrum.getPrecursors()[0].getMZ();
-      const double precursor_mass = (precursor_mz * static_cast<double>(precursor_charge)) - (static_cast<double>(precursor_charge) * Constants::PROTON_MASS_U);
-
-      std::vector<std::string> tags;
-      if (use_sequence_tags_)
-      {
-        tagger.setMaxCharge(precursor_charge-1);
-        tagger.getTag(spectrum, tags);
-      }
-
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
-      vector< OPXLDataStructs::ProteinProteinCrossLink > cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, use_sequence_tags_, tags);
-      all_candidates_count += cross_link_candidates.size();
-
-#ifdef DEBUG_OPENPEPXLLFALGO
-      OPENMS_LOG_DEBUG << "Size of enumerated candidates: " << double(cross_link_candidates.size()) * sizeof(OPXLDataStructs::ProteinProteinCrossLink) / 1024.0 / 1024.0 << " mb" << endl;
-#endif
-
-      spectrum_counter++;
-      cout << "Processing spectrum " << spectrum_counter << " / " << spectra.size() << " |\tSpectrum ID: " << spectrum.getNativeID() << "\t| at: " << DateTime::now().getTime() << endl;
-      cout << "Number of peaks: " << spectrum.size() << " |\tNumber of candidates: " << cross_link_candidates.size() << endl;
-
-      if (cross_link_candidates.empty())
-      {
-        continue;
-      }
-
-      // lists for one spectrum, to determine best match to the spectrum
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > all_csms_spectrum;
-      vector< OPXLDataStructs::CrossLinkSpectrumMatch > mainscore_csms_spectrum;
-
 #pragma omp parallel for schedule(guided)
       for (SignedSize i = 0; i < static_cast<SignedSize>(cross_link_candidates.size()); ++i)
       {
@@ -554,6 +524,56 @@ using namespace OpenMS;
         mainscore_csms_spectrum.push_back(csm);
 
       }
+    };
+
+    for (SignedSize scan_index = 0; scan_index < static_cast<SignedSize>(spectra.size()); ++scan_index)
+    {
+      const PeakSpectrum& spectrum = spectra[scan_index];
+
+      const double precursor_charge = spectrum.getPrecursors()[0].getCharge();
+      const double precursor_mz = spectrum.getPrecursors()[0].getMZ();
+      const double precursor_mass = (precursor_mz * static_cast<double>(precursor_charge)) - (static_cast<double>(precursor_charge) * Constants::PROTON_MASS_U);
+
+      std::vector<std::string> tags;
+      if (use_sequence_tags_)
+      {
+        tagger.setMaxCharge(precursor_charge-1);
+        tagger.getTag(spectrum, tags);
+      }
+
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
+      // lists for one spectrum, to determine best match to the spectrum
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch > all_csms_spectrum;
+      vector< OPXLDataStructs::CrossLinkSpectrumMatch > mainscore_csms_spectrum;
+
+      // enumerate and pre-score the candidates in blocks of alpha peptides of the mass-sorted database to bound memory usage,
+      // only the best pre-scored candidates are kept between blocks
+      Size candidates_count = OPXLHelper::prescoreCandidatesInBlocks(filtered_peptide_masses.size(), candidate_block_size_, number_top_hits_,
+        [&](Size alpha_begin, Size alpha_end)
+        {
+          vector< OPXLDataStructs::ProteinProteinCrossLink > cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, use_sequence_tags_, tags, alpha_begin, alpha_end);
+#ifdef DEBUG_OPENPEPXLLFALGO
+          OPENMS_LOG_DEBUG << "Size of enumerated candidates: " << double(cross_link_candidates.size()) * sizeof(OPXLDataStructs::ProteinProteinCrossLink) / 1024.0 / 1024.0 << " mb" << endl;
+#endif
+          return cross_link_candidates;
+        },
+        [&](const vector< OPXLDataStructs::ProteinProteinCrossLink >& cross_link_candidates, vector< OPXLDataStructs::CrossLinkSpectrumMatch >& prescored_csms)
+        {
+          prescore_candidates(cross_link_candidates, spectrum, precursor_charge, precursor_mz, precursor_mass, prescored_csms);
+        },
+        mainscore_csms_spectrum);
+
+      all_candidates_count += candidates_count;
+
+      spectrum_counter++;
+      cout << "Processing spectrum " << spectrum_counter << " / " << spectra.size() << " |\tSpectrum ID: " << spectrum.getNativeID() << "\t| at: " << DateTime::now().getTime() << endl;
+      cout << "Number of peaks: " << spectrum.size() << " |\tNumber of candidates: " << candidates_count << endl;
+
+      if (candidates_count == 0)
+      {
+        continue;
+      }
+
       std::sort(mainscore_csms_spectrum.rbegin(), mainscore_csms_spectrum.rend(), OPXLDataStructs::CLSMScoreComparator());
 
       int last_candidate_index = static_cast<int>(mainscore_csms_spectrum.size());
@@ -35,6 +35,7 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 #include <OpenMS/SYSTEM/UpdateCheck.h>
@@ -109,6 +110,63 @@ namespace OpenMS
 #endif
   }
 
+  TOPPBase::ExitCodes TOPPBase::getExitCode(const BaseException& e, String& message)
+  {
+    // Errors caused by the user
+    if (dynamic_cast<const UnableToCreateFile*>(&e))
+    {
+      message = String("Error: Unable to write file (") + e.what() + ")";
+      return CANNOT_WRITE_OUTPUT_FILE;
+    }
+    if (dynamic_cast<const FileNotFound*>(&e))
+    {
+      message = String("Error: File not found (") + e.what() + ")";
+      return INPUT_FILE_NOT_FOUND;
+    }
+    if (dynamic_cast<const FileNotReadable*>(&e))
+    {
+      message = String("Error: File not readable (") + e.what() + ")";
+      return INPUT_FILE_NOT_READABLE;
+    }
+    if (dynamic_cast<const FileEmpty*>(&e))
+    {
+      message = String("Error: File empty (") + e.what() + ")";
+      return INPUT_FILE_EMPTY;
+    }
+    if (dynamic_cast<const ParseError*>(&e))
+    {
+      message = String("Error: Unable to read file (") + e.what() + ")";
+      return INPUT_FILE_CORRUPT;
+    }
+    if (dynamic_cast<const RequiredParameterNotGiven*>(&e))
+    {
+      String what = e.what();
+      if (!what.hasPrefix("'"))
+        what = "'" + what + "'";
+      message = String("Error: The required parameter ") + what + " was not given or is empty!";
+      return MISSING_PARAMETERS;
+    }
+    if (dynamic_cast<const InvalidParameter*>(&e))
+    {
+      message = String("Invalid parameter: ") + e.what();
+      return ILLEGAL_PARAMETERS;
+    }
+    // Internal errors because of wrong use of this class
+    if (dynamic_cast<const UnregisteredParameter*>(&e))
+    {
+      message = String("Internal error: Request for unregistered parameter '") + e.what() + "'";
+      return INTERNAL_ERROR;
+    }
+    if (dynamic_cast<const WrongParameterType*>(&e))
+    {
+      message = String("Internal error: Request for parameter with wrong type '") + e.what() + "'";
+      return INTERNAL_ERROR;
+    }
+    // All other errors
+    message = String("Error: Unexpected internal error (") + e.what() + ")";
+    return UNKNOWN_ERROR;
+  }
+
   TOPPBase::TOPPBase(const String& tool_name, const String& tool_description, bool official, const std::vector<Citation>& citations) :
     tool_name_(tool_name),
     tool_description_(tool_description),
@@ -170,6 +228,7 @@ namespace OpenMS
     registerIntOption_("instance", "<n>", 1, "Instance number for the TOPP INI file", false, true);
     registerIntOption_("debug", "<n>", 0, "Sets the debug level", false, true);
     registerIntOption_("threads", "<n>", 1, "Sets the number of threads allowed to be used by the TOPP tool", false);
+    registerStringOption_("profile", "<file>", "", "Writes run time and memory usage of the processing stages to the given JSON file (created only when specified)", false, true);
     registerStringOption_("write_ini", "<file>", "", "Writes the default configuration file", false);
     registerStringOption_("write_ctd", "<out_dir>", "", "Writes the common tool description file(s) (Toolname(s).ctd) to <out_dir>", false, true);
     registerFlag_("no_progress", "Disables progress logging to command line", true);
@@ -412,12 +471,24 @@ namespace OpenMS
       //----------------------------------------------------------
       //main
       //----------------------------------------------------------
+      // profiling (command line only, not stored in the INI file)
+      String profile = param_cmdline_.exists("profile") ? String(param_cmdline_.getValue("profile")) : "";
+      Profiler::setEnabled(!profile.empty());
+      Profiler::Stage profile_stage(tool_name_);
+
       StopWatch sw;
       sw.start();
       result = main_(argc, argv);
       sw.stop();
       OPENMS_LOG_INFO << this->tool_name_ << " took " << sw.toString() << "." << std::endl;
 
+      if (!profile.empty())
+      {
+        profile_stage.stop();
+        Profiler::storeJSON(profile, tool_name_);
+        writeLog_("Profiling report written to '" + profile + "'.");
+      }
+
       // useful for benchmarking
       if (debug_level_ >= 1)
       {
@@ -428,71 +499,13 @@ namespace OpenMS
     //----------------------------------------------------------
     //error handling
     //----------------------------------------------------------
-    // Errors caused by the user
-    catch (UnableToCreateFile& e)
-    {
-      writeLog_(String("Error: Unable to write file (") + e.what() + ")");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ")!", 1);
-      return CANNOT_WRITE_OUTPUT_FILE;
-    }
-    catch (FileNotFound& e)
-    {
-      writeLog_(String("Error: File not found (") + e.what() + ")");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return INPUT_FILE_NOT_FOUND;
-    }
-    catch (FileNotReadable& e)
-    {
-      writeLog_(String("Error: File not readable (") + e.what() + ")");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return INPUT_FILE_NOT_READABLE;
-    }
-    catch (FileEmpty& e)
-    {
-      writeLog_(String("Error: File empty (") + e.what() + ")");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return INPUT_FILE_EMPTY;
-    }
-    catch (ParseError& e)
-    {
-      writeLog_(String("Error: Unable to read file (") + e.what() + ")");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return INPUT_FILE_CORRUPT;
-    }
-    catch (RequiredParameterNotGiven& e)
-    {
-      String what = e.what();
-      if (!what.hasPrefix("'"))
-        what = "'" + what + "'";
-      writeLog_(String("Error: The required parameter ") + what + " was not given or is empty!");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return MISSING_PARAMETERS;
-    }
-    catch (InvalidParameter& e)
-    {
-      writeLog_(String("Invalid parameter: ") + e.what());
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return ILLEGAL_PARAMETERS;
-    }
-    // Internal errors because of wrong use of this class
-    catch (UnregisteredParameter& e)
-    {
-      writeLog_(String("Internal error: Request for unregistered parameter '") + e.what() + "'");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return INTERNAL_ERROR;
-    }
-    catch (WrongParameterType& e)
-    {
-      writeLog_(String("Internal error: Request for parameter with wrong type '") + e.what() + "'");
-      writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return INTERNAL_ERROR;
-    }
-    // All other errors
     catch (BaseException& e)
     {
-      writeLog_(String("Error: Unexpected internal error (") + e.what() + ")");
+      String message;
+      ExitCodes exit_code = getExitCode(e, message);
+      writeLog_(message);
       writeDebug_(String("Error occurred in line ") + e.getLine() + " of file " + e.getFile() + " (in function: " + e.getFunction() + ") !", 1);
-      return UNKNOWN_ERROR;
+      return exit_code;
     }
     log_.close();
 
@@ -1961,7 +1974,7 @@ namespace OpenMS
     //parameters
     for (vector<ParameterInformation>::const_iterator it = parameters_.begin(); it != parameters_.end(); ++it)
     {
-      if (it->name == "ini" || it->name == "-help" || it->name == "-helphelp" || it->name == "instance" || it->name == "write_ini" || it->name == "write_ctd") // do not store those params in ini file
+      if (it->name == "ini" || it->name == "-help" || it->name == "-helphelp" || it->name == "instance" || it->name == "write_ini" || it->name == "write_ctd" || it->name == "profile") // do not store those params in ini file
       {
         continue;
       }
@@ -2156,14 +2169,19 @@ namespace OpenMS
   }
 
   DataProcessing TOPPBase::getProcessingInfo_(const std::set<DataProcessing::ProcessingAction>& actions) const
+  {
+    return getProcessingInfo(tool_name_, getParam_(), test_mode_, actions);
+  }
+
+  DataProcessing TOPPBase::getProcessingInfo(const String& tool_name, const Param& param, bool test_mode, const std::set<DataProcessing::ProcessingAction>& actions)
   {
     DataProcessing p;
     //actions
     p.setProcessingActions(actions);
     //software
-    p.getSoftware().setName(tool_name_);
+    p.getSoftware().setName(tool_name);
 
-    if (test_mode_)
+    if (test_mode)
     {
       //version
       p.getSoftware().setVersion("version_string");
@@ -2179,11 +2197,10 @@ namespace OpenMS
     else
     {
       //version
-      p.getSoftware().setVersion(version_);
+      p.getSoftware().setVersion(VersionInfo::getVersion());
       //time
       p.setCompletionTime(DateTime::now());
       //parameters
-      const Param& param = getParam_();
       for (Param::ParamIterator it = param.begin(); it != param.end(); ++it)
       {
         p.setMetaValue(String("parameter: ") + it.getName(), it->value);
@@ -2194,11 +2211,26 @@ namespace OpenMS
   }
 
   void TOPPBase::addDataProcessing_(ConsensusMap& map, const DataProcessing& dp) const
+  {
+    addDataProcessing(map, dp, test_mode_);
+  }
+
+  void TOPPBase::addDataProcessing_(FeatureMap& map, const DataProcessing& dp) const
+  {
+    addDataProcessing(map, dp);
+  }
+
+  void TOPPBase::addDataProcessing_(PeakMap& map, const DataProcessing& dp) const
+  {
+    addDataProcessing(map, dp);
+  }
+
+  void TOPPBase::addDataProcessing(ConsensusMap& map, const DataProcessing& dp, bool test_mode)
   {
     map.getDataProcessing().push_back(dp);
 
     //remove absolute map paths
-    if (test_mode_)
+    if (test_mode)
     {
       for (Size d = 0; d < map.getColumnHeaders().size(); ++d)
       {
@@ -2206,15 +2238,15 @@ namespace OpenMS
       }
     }
   }
-  
-  void TOPPBase::addDataProcessing_(FeatureMap& map, const DataProcessing& dp) const
+
+  void TOPPBase::addDataProcessing(FeatureMap& map, const DataProcessing& dp)
   {
     map.getDataProcessing().push_back(dp);
   }
 
   ///Data processing setter for peak maps
 
-  void TOPPBase::addDataProcessing_(PeakMap& map, const DataProcessing& dp) const
+  void TOPPBase::addDataProcessing(PeakMap& map, const DataProcessing& dp)
   {
     boost::shared_ptr< DataProcessing > dp_(new DataProcessing(dp));
     for (Size i = 0; i < map.size(); ++i)
@@ -0,0 +1,310 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
+
+#include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
+#include <OpenMS/ANALYSIS/ID/ProteinIndex.h>
+#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmMedian.h>
+#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmQuantile.h>
+#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmThreshold.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
+#include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
+#include <OpenMS/FORMAT/MzQuantMLFile.h>
+#include <OpenMS/METADATA/MSQuantifications.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinder.h>
+#include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPicked.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// checks the input of the tools processing spectra (there must be data, sorted by position)
+    TOPPBase::ExitCodes checkPeakMap(const PeakMap& exp)
+    {
+      if (exp.empty() && exp.getChromatograms().size() == 0)
+      {
+        OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                    " contain chromatograms. This tool currently cannot handle them, sorry.";
+        return TOPPBase::INCOMPATIBLE_INPUT_DATA;
+      }
+
+      //check if spectra are sorted
+      for (Size i = 0; i < exp.size(); ++i)
+      {
+        if (!exp[i].isSorted())
+        {
+          OPENMS_LOG_INFO << "Error: Not all spectra are sorted according to peak m/z positions. Use FileFilter to sort the input!" << std::endl;
+          return TOPPBase::INCOMPATIBLE_INPUT_DATA;
+        }
+      }
+
+      //check if chromatograms are sorted
+      for (Size i = 0; i < exp.getChromatograms().size(); ++i)
+      {
+        if (!exp.getChromatograms()[i].isSorted())
+        {
+          OPENMS_LOG_INFO << "Error: Not all chromatograms are sorted according to peak m/z positions. Use FileFilter to sort the input!" << std::endl;
+          return TOPPBase::INCOMPATIBLE_INPUT_DATA;
+        }
+      }
+      return TOPPBase::EXECUTION_OK;
+    }
+
+    /// checks the input of the noise filters (profile data expected)
+    TOPPBase::ExitCodes checkProfileData(const PeakMap& exp)
+    {
+      //check for peak type (profile data required)
+      if (!exp.empty() && exp[0].getType(true) == SpectrumSettings::CENTROID)
+      {
+        OPENMS_LOG_INFO << "Warning: OpenMS peak type estimation indicates that this is not profile data!" << std::endl;
+      }
+      return checkPeakMap(exp);
+    }
+  }
+
+  TOPPBase::ExitCodes TOPPToolCores::smooth(GaussFilter& filter, PeakMap& exp)
+  {
+    TOPPBase::ExitCodes check = checkProfileData(exp);
+    if (check != TOPPBase::EXECUTION_OK) return check;
+
+    try
+    {
+      filter.filterExperiment(exp);
+    }
+    catch (Exception::IllegalArgument& e)
+    {
+      OPENMS_LOG_INFO << "Error: " << e.getMessage() << std::endl;
+      return TOPPBase::INCOMPATIBLE_INPUT_DATA;
+    }
+    return TOPPBase::EXECUTION_OK;
+  }
+
+  TOPPBase::ExitCodes TOPPToolCores::smooth(SavitzkyGolayFilter& filter, PeakMap& exp)
+  {
+    TOPPBase::ExitCodes check = checkProfileData(exp);
+    if (check != TOPPBase::EXECUTION_OK) return check;
+
+    filter.filterExperiment(exp);
+    return TOPPBase::EXECUTION_OK;
+  }
+
+  TOPPBase::ExitCodes TOPPToolCores::pickPeaks(const PeakPickerHiRes& picker, const PeakMap& input, PeakMap& output, bool check_spectrum_type)
+  {
+    TOPPBase::ExitCodes check = checkPeakMap(input);
+    if (check != TOPPBase::EXECUTION_OK) return check;
+
+    picker.pickExperiment(input, output, check_spectrum_type);
+    return TOPPBase::EXECUTION_OK;
+  }
+
+  void TOPPToolCores::findFeatures(PeakMap& exp, const String& in, const FeatureMap& seeds, const Param& algorithm_param, bool force, bool test_mode, Int debug_level, ProgressLogger::LogType log_type, FeatureMap& features)
+  {
+    // only MS1 spectra are used (the tool does not even load fragment spectra)
+    exp.getSpectra().erase(std::remove_if(exp.getSpectra().begin(), exp.getSpectra().end(),
+                                          [](const MSSpectrum& s) { return s.getMSLevel() != 1; }),
+                           exp.getSpectra().end());
+    exp.updateRanges();
+
+    if (exp.getSpectra().empty())
+    {
+      throw OpenMS::Exception::FileEmpty(__FILE__, __LINE__, __FUNCTION__, "Error: No MS1 spectra in input file.");
+    }
+
+    // determine type of spectral data (profile or centroided)
+    if (exp[0].getType() == SpectrumSettings::PROFILE && !force)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Profile data provided but centroided spectra expected. To enforce processing of the data set the -force flag.");
+    }
+
+    //setup of FeatureFinder
+    FeatureFinder ff;
+    ff.setLogType(log_type);
+
+    if (test_mode)
+    {
+      // if test mode set, add file without path so we can compare it
+      features.setPrimaryMSRunPath({"file://" + File::basename(in)}, exp);
+    }
+    else
+    {
+      features.setPrimaryMSRunPath({in}, exp);
+    }
+
+    // Apply the feature finder
+    ff.run(FeatureFinderAlgorithmPicked::getProductName(), exp, features, algorithm_param, seeds);
+    features.applyMemberFunction(&UniqueIdInterface::setUniqueId);
+
+    // DEBUG
+    if (debug_level > 10)
+    {
+      for (FeatureMap::Iterator it = features.begin(); it != features.end(); ++it)
+      {
+        if (!it->isMetaEmpty())
+        {
+          std::vector<String> keys;
+          it->getKeys(keys);
+          OPENMS_LOG_INFO << "Feature " << it->getUniqueId() << std::endl;
+          for (Size i = 0; i < keys.size(); i++)
+          {
+            OPENMS_LOG_INFO << "  " << keys[i] << " = " << it->getMetaValue(keys[i]) << std::endl;
+          }
+        }
+      }
+    }
+
+    // Remove detailed convex hull information and subordinate features
+    // (unless requested otherwise) to reduce file size of feature files
+    // unless debugging is turned on.
+    if (debug_level < 5)
+    {
+      for (FeatureMap::Iterator it = features.begin(); it != features.end(); ++it)
+      {
+        it->getConvexHull().expandToBoundingBox();
+        for (Size i = 0; i < it->getConvexHulls().size(); ++i)
+        {
+          it->getConvexHulls()[i].expandToBoundingBox();
+        }
+        it->getSubordinates().clear();
+      }
+    }
+  }
+
+  void TOPPToolCores::storeMzQuantML(const String& filename, const FeatureMap& features, const PeakMap& exp)
+  {
+    std::vector<DataProcessing> tmp;
+    for (Size i = 0; i < exp[0].getDataProcessing().size(); i++)
+    {
+      tmp.push_back(*exp[0].getDataProcessing()[i].get());
+    }
+    ExperimentalSettings settings = exp.getExperimentalSettings();
+    MSQuantifications msq(features, settings, tmp);
+    msq.assignUIDs();
+    MzQuantMLFile().store(filename, msq);
+  }
+
+  TOPPBase::ExitCodes TOPPToolCores::normalize(ConsensusMap& map, const String& algorithm_type, double ratio_threshold, const String& accession_filter, const String& description_filter)
+  {
+    if (algorithm_type == "robust_regression")
+    {
+      map.sortBySize();
+      std::vector<double> results = ConsensusMapNormalizerAlgorithmThreshold::computeCorrelation(map, ratio_threshold, accession_filter, description_filter);
+      ConsensusMapNormalizerAlgorithmThreshold::normalizeMaps(map, results);
+    }
+    else if (algorithm_type == "median")
+    {
+      ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(map, ConsensusMapNormalizerAlgorithmMedian::NM_SCALE, accession_filter, description_filter);
+    }
+    else if (algorithm_type == "median_shift")
+    {
+      ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(map, ConsensusMapNormalizerAlgorithmMedian::NM_SHIFT, accession_filter, description_filter);
+    }
+    else if (algorithm_type == "quantile")
+    {
+      if (accession_filter != "" || description_filter != "")
+      {
+        OPENMS_LOG_WARN << std::endl << "NOTE: Accession / description filtering is not supported in quantile normalization mode. Ignoring filters." << std::endl << std::endl;
+      }
+      ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(map);
+    }
+    else
+    {
+      OPENMS_LOG_ERROR << "Unknown algorithm type  '" << algorithm_type << "'." << std::endl;
+      return TOPPBase::ILLEGAL_PARAMETERS;
+    }
+    return TOPPBase::EXECUTION_OK;
+  }
+
+  bool TOPPToolCores::findDatabase(String& db_name)
+  {
+    if (File::readable(db_name)) return true;
+    try
+    {
+      db_name = File::findDatabase(db_name);
+    }
+    catch (...)
+    {
+      return false;
+    }
+    return true;
+  }
+
+  TOPPBase::ExitCodes TOPPToolCores::indexPeptides(PeptideIndexing& indexer, const String& db_name, const String& index_name, bool compute_coverage, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids)
+  {
+    if (!index_name.empty())
+    {
+      std::shared_ptr<ProteinIndex> index(new ProteinIndex());
+      index->load(index_name);
+      indexer.setProteinIndex(index);
+    }
+
+    // we stream the Fasta file
+    FASTAContainer<TFI_File> proteins(db_name);
+    PeptideIndexing::ExitCodes indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    if (indexer_exit == PeptideIndexing::ILLEGAL_PARAMETERS)
+    { // e.g. the protein index does not match the database; no output is written
+      return TOPPBase::ILLEGAL_PARAMETERS;
+    }
+
+    // calculate protein coverage
+    if (compute_coverage)
+    {
+      for (Size i = 0; i < prot_ids.size(); ++i)
+      {
+        prot_ids[i].computeCoverage(pep_ids);
+      }
+    }
+
+    if (indexer_exit == PeptideIndexing::DATABASE_EMPTY)
+    {
+      return TOPPBase::INPUT_FILE_EMPTY;
+    }
+    else if (indexer_exit == PeptideIndexing::UNEXPECTED_RESULT)
+    {
+      return TOPPBase::UNEXPECTED_RESULT;
+    }
+    else if ((indexer_exit != PeptideIndexing::EXECUTION_OK) &&
+             (indexer_exit != PeptideIndexing::PEPTIDE_IDS_EMPTY))
+    {
+      return TOPPBase::UNKNOWN_ERROR;
+    }
+    return TOPPBase::EXECUTION_OK;
+  }
+
+} //namespace OpenMS
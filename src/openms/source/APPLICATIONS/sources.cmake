@@ -6,6 +6,7 @@ set(sources_list
 INIUpdater.cpp
 ToolHandler.cpp
 TOPPBase.cpp
+TOPPToolCores.cpp
 ParameterInformation.cpp
 ConsoleUtils.cpp
 )
@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/AASequenceCache.h>
 
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
@@ -1570,8 +1571,20 @@ namespace OpenMS
     return c_term_mod_ != nullptr;
   }
 
+  /// process-wide cache used by fromString() (disabled by default)
+  static AASequenceCache& getParseCache_()
+  {
+    static AASequenceCache cache(0);
+    return cache;
+  }
+
   AASequence AASequence::fromString(const String& s, bool permissive)
   {
+    AASequenceCache& cache = getParseCache_();
+    if (cache.getMaxSize() > 0)
+    {
+      return cache.parse(s, permissive);
+    }
     AASequence aas;
     parseString_(s, aas, permissive);
     return aas;
@@ -1579,9 +1592,17 @@ namespace OpenMS
 
   AASequence AASequence::fromString(const char* s, bool permissive)
   {
-    AASequence aas;
-    parseString_(String(s), aas, permissive);
-    return aas;
+    return fromString(String(s), permissive);
+  }
+
+  void AASequence::setParseCacheSize(Size max_entries)
+  {
+    getParseCache_().setMaxSize(max_entries);
+  }
+
+  Size AASequence::getParseCacheSize()
+  {
+    return getParseCache_().getMaxSize();
   }
 
 }
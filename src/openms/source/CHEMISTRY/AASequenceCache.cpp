@@ -0,0 +1,194 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/AASequenceCache.h>
+
+#include <functional>
+
+using namespace std;
+
+namespace OpenMS
+{
+  const Size AASequenceCache::nr_shards_;
+
+  AASequenceCache::AASequenceCache(Size max_entries) :
+    shards_(),
+    max_entries_(max_entries),
+    hits_(0),
+    misses_(0)
+  {
+    for (Size i = 0; i < nr_shards_; ++i)
+    {
+      shards_.push_back(unique_ptr<Shard_>(new Shard_));
+    }
+  }
+
+  AASequenceCache::~AASequenceCache()
+  {
+  }
+
+  AASequenceCache::Shard_& AASequenceCache::getShard_(const String& s)
+  {
+    return *shards_[std::hash<String>()(s) & (nr_shards_ - 1)];
+  }
+
+  Size AASequenceCache::getShardCapacity_() const
+  {
+    // two generations per shard
+    return std::max(max_entries_.load() / (2 * nr_shards_), Size(1));
+  }
+
+  AASequence AASequenceCache::parse(const String& s, bool permissive)
+  {
+    AASequence aas;
+    if (max_entries_.load() == 0)
+    {
+      AASequence::parseString_(s, aas, permissive);
+      return aas;
+    }
+
+    Shard_& shard = getShard_(s);
+    {
+      lock_guard<mutex> lock(shard.mutex);
+      unordered_map<String, AASequence>& current = shard.current[permissive];
+      unordered_map<String, AASequence>::const_iterator it = current.find(s);
+      if (it != current.end())
+      {
+        ++hits_;
+        return it->second;
+      }
+      unordered_map<String, AASequence>& previous = shard.previous[permissive];
+      unordered_map<String, AASequence>::iterator old_it = previous.find(s);
+      if (old_it != previous.end() && current.size() < getShardCapacity_())
+      {
+        // still in use: keep it in the current generation
+        ++hits_;
+        aas = old_it->second;
+        current.insert(make_pair(s, aas));
+        previous.erase(old_it);
+        return aas;
+      }
+      else if (old_it != previous.end())
+      {
+        ++hits_;
+        return old_it->second;
+      }
+    }
+
+    // parse outside of the lock (may throw, may add modifications to ModificationsDB)
+    ++misses_;
+    AASequence::parseString_(s, aas, permissive);
+
+    lock_guard<mutex> lock(shard.mutex);
+    unordered_map<String, AASequence>& current = shard.current[permissive];
+    if (current.size() >= getShardCapacity_())
+    {
+      // drop the older generation
+      shard.previous[permissive].swap(current);
+      current.clear();
+    }
+    current.insert(make_pair(s, aas));
+    return aas;
+  }
+
+  void AASequenceCache::parse(const vector<String>& s, vector<AASequence>& aas, bool permissive)
+  {
+    aas.clear();
+    aas.reserve(s.size());
+    // parse each distinct string only once, even if it does not fit into the cache
+    unordered_map<String, Size> first_occurrence;
+    for (const String& seq : s)
+    {
+      unordered_map<String, Size>::const_iterator it = first_occurrence.find(seq);
+      if (it != first_occurrence.end())
+      {
+        aas.push_back(aas[it->second]);
+      }
+      else
+      {
+        first_occurrence.insert(make_pair(seq, aas.size()));
+        aas.push_back(parse(seq, permissive));
+      }
+    }
+  }
+
+  Size AASequenceCache::getMaxSize() const
+  {
+    return max_entries_.load();
+  }
+
+  void AASequenceCache::setMaxSize(Size max_entries)
+  {
+    max_entries_ = max_entries;
+    clear();
+  }
+
+  Size AASequenceCache::size() const
+  {
+    Size n = 0;
+    for (const unique_ptr<Shard_>& shard : shards_)
+    {
+      lock_guard<mutex> lock(shard->mutex);
+      for (Size i = 0; i < 2; ++i)
+      {
+        n += shard->current[i].size() + shard->previous[i].size();
+      }
+    }
+    return n;
+  }
+
+  void AASequenceCache::clear()
+  {
+    for (unique_ptr<Shard_>& shard : shards_)
+    {
+      lock_guard<mutex> lock(shard->mutex);
+      for (Size i = 0; i < 2; ++i)
+      {
+        shard->current[i].clear();
+        shard->previous[i].clear();
+      }
+    }
+  }
+
+  Size AASequenceCache::getHits() const
+  {
+    return hits_.load();
+  }
+
+  Size AASequenceCache::getMisses() const
+  {
+    return misses_.load();
+  }
+
+} // namespace OpenMS
@@ -356,6 +356,8 @@ namespace OpenMS
         }
       }
     }
+    // make the new cross-linkers visible to queries
+    publishSnapshot_();
   }
 
   void CrossLinksDB::getAllSearchModifications(vector<String>& modifications) const
@@ -46,35 +46,111 @@
 
 #include <boost/math/special_functions/binomial.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
 
 namespace OpenMS
 {
+  const Size EmpiricalFormula::NUMBER_OF_FIXED_ELEMENTS;
+
   EmpiricalFormula::EmpiricalFormula() :
+    fixed_counts_(),
     charge_(0)
   {}
 
-  EmpiricalFormula::EmpiricalFormula(const String& formula)
+  EmpiricalFormula::EmpiricalFormula(const String& formula) :
+    fixed_counts_()
   {
-    charge_ = parseFormula_(formula_, formula);
+    charge_ = parseFormula_(formula);
   }
 
-  EmpiricalFormula::EmpiricalFormula(SignedSize number, const Element* element, SignedSize charge)
+  EmpiricalFormula::EmpiricalFormula(SignedSize number, const Element* element, SignedSize charge) :
+    fixed_counts_()
   {
-    formula_[element] = number;
+    addElement_(element, number);
+    removeZeroedElements_();
     charge_ = charge;
   }
 
+  EmpiricalFormula::EmpiricalFormula(EmpiricalFormula&& rhs) noexcept :
+    others_(std::move(rhs.others_)),
+    charge_(rhs.charge_)
+  {
+    std::copy(rhs.fixed_counts_, rhs.fixed_counts_ + NUMBER_OF_FIXED_ELEMENTS, fixed_counts_);
+    std::fill(rhs.fixed_counts_, rhs.fixed_counts_ + NUMBER_OF_FIXED_ELEMENTS, 0);
+    rhs.others_.clear();
+    rhs.charge_ = 0;
+  }
+
+  EmpiricalFormula& EmpiricalFormula::operator=(EmpiricalFormula&& rhs) &
+  {
+    if (this == &rhs) return *this;
+    std::copy(rhs.fixed_counts_, rhs.fixed_counts_ + NUMBER_OF_FIXED_ELEMENTS, fixed_counts_);
+    std::fill(rhs.fixed_counts_, rhs.fixed_counts_ + NUMBER_OF_FIXED_ELEMENTS, 0);
+    others_ = std::move(rhs.others_);
+    rhs.others_.clear();
+    charge_ = rhs.charge_;
+    rhs.charge_ = 0;
+    return *this;
+  }
+
   EmpiricalFormula::~EmpiricalFormula()
   {
   }
 
+  const EmpiricalFormula::FixedElements_& EmpiricalFormula::getFixedElements_()
+  {
+    // thread safe initialization (C++11)
+    static const FixedElements_ fixed = []()
+    {
+      const char* symbols[NUMBER_OF_FIXED_ELEMENTS] = {"C", "H", "N", "O", "P", "S", "Na", "K", "Cl"};
+      const ElementDB* db = ElementDB::getInstance();
+      FixedElements_ f;
+      for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i)
+      {
+        f.elements[i] = db->getElement(symbols[i]);
+        f.mono_weights[i] = f.elements[i]->getMonoWeight();
+        f.average_weights[i] = f.elements[i]->getAverageWeight();
+      }
+      return f;
+    }();
+    return fixed;
+  }
+
+  Size EmpiricalFormula::getFixedSlot_(const Element* element)
+  {
+    const FixedElements_& fixed = getFixedElements_();
+    for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i)
+    {
+      if (fixed.elements[i] == element) return i;
+    }
+    return NUMBER_OF_FIXED_ELEMENTS;
+  }
+
+  void EmpiricalFormula::addElement_(const Element* element, SignedSize number)
+  {
+    Size slot = getFixedSlot_(element);
+    if (slot < NUMBER_OF_FIXED_ELEMENTS)
+    {
+      fixed_counts_[slot] += number;
+    }
+    else
+    {
+      others_[element] += number;
+    }
+  }
+
   double EmpiricalFormula::getMonoWeight() const
   {
     double weight = Constants::PROTON_MASS_U * charge_;
-    for (const auto& it : formula_)
+    const FixedElements_& fixed = getFixedElements_();
+    for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i)
+    {
+      weight += fixed.mono_weights[i] * (double)fixed_counts_[i];
+    }
+    for (const auto& it : others_)
     {
       weight += it.first->getMonoWeight() * (double)it.second;
     }
@@ -84,7 +160,12 @@ namespace OpenMS
   double EmpiricalFormula::getAverageWeight() const
   {
     double weight = Constants::PROTON_MASS_U * charge_;
-    for (const auto& it : formula_)
+    const FixedElements_& fixed = getFixedElements_();
+    for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i)
+    {
+      weight += fixed.average_weights[i] * (double)fixed_counts_[i];
+    }
+    for (const auto& it : others_)
     {
       weight += it.first->getAverageWeight() * (double)it.second;
     }
@@ -94,7 +175,7 @@ namespace OpenMS
   double EmpiricalFormula::calculateTheoreticalIsotopesNumber() const
   {
     double total = 1;
-    for (const auto& element : formula_)
+    for (const auto& element : *this)
     {
       UInt non_trace_isotopes = 0;
       const auto& distr = element.first->getIsotopeDistribution();
@@ -128,7 +209,7 @@ namespace OpenMS
     // without requesting a negative number of hydrogens.
     bool ret = estimateFromWeightAndComp(remaining_weight, C, H, N, O, 0.0, P);
 
-    formula_.at(db->getElement("S")) = S;
+    fixed_counts_[getFixedSlot_(db->getElement("S"))] = S;
 
     return ret;
   }
@@ -146,13 +227,14 @@ namespace OpenMS
 
     double factor = average_weight / avgTotal;
 
-    formula_.clear();
+    std::fill(fixed_counts_, fixed_counts_ + NUMBER_OF_FIXED_ELEMENTS, 0);
+    others_.clear();
 
-    formula_.insert(make_pair(db->getElement("C"), (SignedSize) Math::round(C * factor)));
-    formula_.insert(make_pair(db->getElement("N"), (SignedSize) Math::round(N * factor)));
-    formula_.insert(make_pair(db->getElement("O"), (SignedSize) Math::round(O * factor)));
-    formula_.insert(make_pair(db->getElement("S"), (SignedSize) Math::round(S * factor)));
-    formula_.insert(make_pair(db->getElement("P"), (SignedSize) Math::round(P * factor)));
+    addElement_(db->getElement("C"), (SignedSize) Math::round(C * factor));
+    addElement_(db->getElement("N"), (SignedSize) Math::round(N * factor));
+    addElement_(db->getElement("O"), (SignedSize) Math::round(O * factor));
+    addElement_(db->getElement("S"), (SignedSize) Math::round(S * factor));
+    addElement_(db->getElement("P"), (SignedSize) Math::round(P * factor));
 
     double remaining_mass = average_weight-getAverageWeight();
     SignedSize adjusted_H = Math::round(remaining_mass / db->getElement("H")->getAverageWeight());
@@ -165,7 +247,7 @@ namespace OpenMS
     }
 
     // Only insert hydrogens if their number is not negative.
-    formula_.insert(make_pair(db->getElement("H"), adjusted_H));
+    addElement_(db->getElement("H"), adjusted_H);
     // The approximation had no issues.
     return true;
   }
@@ -198,8 +280,13 @@ namespace OpenMS
 
   SignedSize EmpiricalFormula::getNumberOf(const Element* element) const
   {
-    const auto& it  = formula_.find(element);
-    if (it != formula_.end())
+    Size slot = getFixedSlot_(element);
+    if (slot < NUMBER_OF_FIXED_ELEMENTS)
+    {
+      return fixed_counts_[slot];
+    }
+    const auto& it  = others_.find(element);
+    if (it != others_.end())
     {
       return it->second;
     }
@@ -209,7 +296,8 @@ namespace OpenMS
   SignedSize EmpiricalFormula::getNumberOfAtoms() const
   {
     SignedSize num_atoms(0);
-    for (const auto& it : formula_) num_atoms += it.second;
+    for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i) num_atoms += fixed_counts_[i];
+    for (const auto& it : others_) num_atoms += it.second;
     return num_atoms;
   }
 
@@ -228,7 +316,7 @@ namespace OpenMS
     String formula;
     std::map<String, SignedSize> new_formula;
 
-    for (const auto& it : formula_)
+    for (const auto& it : *this)
     {
       new_formula[it.first->getSymbol()] = it.second;
     }
@@ -244,7 +332,7 @@ namespace OpenMS
   {
     std::map<std::string, int> new_formula;
 
-    for (const auto & it : formula_)
+    for (const auto & it : *this)
     {
       new_formula[it.first->getSymbol()] = it.second;
     }
@@ -254,7 +342,8 @@ namespace OpenMS
   EmpiricalFormula EmpiricalFormula::operator*(const SignedSize& times) const
   {
     EmpiricalFormula ef(*this);
-    for (const auto& it : formula_) ef.formula_[it.first] *= times;
+    for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i) ef.fixed_counts_[i] *= times;
+    for (auto& it : ef.others_) it.second *= times;
     ef.charge_ *= times;
     ef.removeZeroedElements_();
     return ef;
@@ -262,83 +351,39 @@ namespace OpenMS
 
   EmpiricalFormula EmpiricalFormula::operator+(const EmpiricalFormula& formula) const
   {
-    EmpiricalFormula ef;
-    ef.formula_ = formula.formula_;
-    for (const auto& it : formula_)
-    {
-      auto ef_it  = ef.formula_.find(it.first);
-      if (ef_it != ef.formula_.end())
-      {
-        ef_it->second += it.second;
-      }
-      else
-      {
-        ef.formula_.insert(it);
-      }
-    }
-    ef.charge_ = charge_ + formula.charge_;
-    ef.removeZeroedElements_();
+    EmpiricalFormula ef(*this);
+    ef += formula;
     return ef;
   }
 
   EmpiricalFormula& EmpiricalFormula::operator+=(const EmpiricalFormula& formula)
   {
-    for (const auto& it : formula.formula_)
+    for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i) fixed_counts_[i] += formula.fixed_counts_[i];
+    if (!formula.others_.empty())
     {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second += it.second;
-      }
-      else
-      {
-        formula_.insert(it);
-      }
+      for (const auto& it : formula.others_) others_[it.first] += it.second;
+      removeZeroedElements_();
     }
     charge_ += formula.charge_;
-    removeZeroedElements_();
     return *this;
   }
 
   EmpiricalFormula EmpiricalFormula::operator-(const EmpiricalFormula& formula) const
   {
     EmpiricalFormula ef(*this);
-    for (const auto& it : formula.formula_)
-    {
-      const Element* e = it.first;
-      SignedSize num = it.second;
-      auto ef_it  = ef.formula_.find(e);
-      if (ef_it != ef.formula_.end())
-      {
-        ef_it->second -= num;
-      }
-      else
-      {
-        ef.formula_[e] = -num;
-      }
-    }
-
-    ef.charge_ = charge_ - formula.charge_;
-    ef.removeZeroedElements_();
+    ef -= formula;
     return ef;
   }
 
   EmpiricalFormula& EmpiricalFormula::operator-=(const EmpiricalFormula& formula)
   {
-    for (const auto& it : formula.formula_)
+    for (Size i = 0; i < NUMBER_OF_FIXED_ELEMENTS; ++i) fixed_counts_[i] -= formula.fixed_counts_[i];
+    if (!formula.others_.empty())
     {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second -= it.second;
-      }
-      else
-      {
-        formula_[it.first] = -it.second;
-      }
+      for (const auto& it : formula.others_) others_[it.first] -= it.second;
+      removeZeroedElements_();
     }
     charge_ -= formula.charge_;
-    removeZeroedElements_();
     return *this;
   }
 
@@ -349,12 +394,12 @@ namespace OpenMS
 
   bool EmpiricalFormula::isEmpty() const
   {
-    return formula_.empty();
+    return begin() == end();
   }
 
   bool EmpiricalFormula::hasElement(const Element* element) const
   {
-    return formula_.find(element) != formula_.end();
+    return getNumberOf(element) != 0;
   }
 
   bool EmpiricalFormula::contains(const EmpiricalFormula& ef)
@@ -371,18 +416,19 @@ namespace OpenMS
 
   bool EmpiricalFormula::operator==(const EmpiricalFormula& formula) const
   {
-    return formula_ == formula.formula_ && charge_ == formula.charge_;
+    return std::equal(fixed_counts_, fixed_counts_ + NUMBER_OF_FIXED_ELEMENTS, formula.fixed_counts_) &&
+           others_ == formula.others_ && charge_ == formula.charge_;
   }
 
   bool EmpiricalFormula::operator!=(const EmpiricalFormula& formula) const
   {
-    return formula_ != formula.formula_ || charge_ != formula.charge_;
+    return !(*this == formula);
   }
 
   ostream& operator<<(ostream& os, const EmpiricalFormula& formula)
   {
     std::map<String, SignedSize> new_formula;
-    for (const auto& it : formula.formula_)
+    for (const auto& it : formula)
     {
       new_formula[it.first->getSymbol()] = it.second;
     }
@@ -422,7 +468,7 @@ namespace OpenMS
     return os;
   }
 
-  Int EmpiricalFormula::parseFormula_(std::map<const Element*, SignedSize>& ef, const String& input_formula) const
+  Int EmpiricalFormula::parseFormula_(const String& input_formula)
   {
     Int charge = 0;
     String formula(input_formula);
@@ -585,16 +631,7 @@ namespace OpenMS
       {
         if (num != 0)
         {
-          const Element* e = db->getElement(symbol);
-          std::map<const Element*, SignedSize>::iterator it = ef.find(e);
-          if (it != ef.end())
-          {
-            it->second += num;
-          }
-          else
-          {
-            ef.insert(std::make_pair(e, num));
-          }
+          addElement_(db->getElement(symbol), num);
         }
       }
       else
@@ -604,30 +641,19 @@ namespace OpenMS
     }
 
     // remove elements with 0 counts
-    std::map<const Element*, SignedSize>::iterator it = ef.begin();
-    while (it != ef.end())
-    {
-      if (it->second == 0)
-      {
-        ef.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
-      }
-      else
-      {
-        ++it;
-      }
-    }
+    removeZeroedElements_();
 
     return charge;
   }
 
   void EmpiricalFormula::removeZeroedElements_()
   {
-    MapType_::iterator it = formula_.begin();
-    while (it != formula_.end())
+    MapType_::iterator it = others_.begin();
+    while (it != others_.end())
     {
       if (it->second == 0)
       {
-        formula_.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
+        others_.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
       }
       else
       {
@@ -638,15 +664,17 @@ namespace OpenMS
 
   bool EmpiricalFormula::operator<(const EmpiricalFormula& rhs) const
   {
-    if (formula_.size() != rhs.formula_.size())
+    const auto size = std::distance(begin(), end());
+    const auto rhs_size = std::distance(rhs.begin(), rhs.end());
+    if (size != rhs_size)
     {
-      return formula_.size() < rhs.formula_.size();
+      return size < rhs_size;
     }
 
-    // both maps have same size
-    auto it = formula_.begin();
-    auto rhs_it = rhs.formula_.begin();
-    for (; it != formula_.end(); ++it, ++rhs_it)
+    // both formulas have the same number of elements
+    auto it = begin();
+    auto rhs_it = rhs.begin();
+    for (; it != end(); ++it, ++rhs_it)
     {
       if (*(it->first) != *(rhs_it->first)) return *(it->first) < *(rhs_it->first); // element
       if (it->second != rhs_it->second) return it->second < rhs_it->second; // count
@@ -37,10 +37,38 @@
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <random>
+
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// residue code used by the cleavage site table: 0 = none (range boundary), 1-26 = 'A'-'Z', 27 = any other character
+    inline unsigned residueCode(char c)
+    {
+      const unsigned u = (unsigned char)c - (unsigned char)'A';
+      return (u < 26) ? u + 1 : 27;
+    }
+
+    /// regex based tokenization of [begin + start, begin + end) as documented for EnzymaticDigestion::tokenize_()
+    void tokenizeRegEx(const boost::regex& re, const char* begin, int start, int end, std::vector<int>& positions)
+    {
+      boost::cregex_token_iterator i(begin + start, begin + end, re, -1);
+      boost::cregex_token_iterator j;
+      while (i != j)
+      {
+        positions.push_back(start); // first push 'start' (usually 0), then all the real cleavage sites
+        start += (int)i->length();
+        ++i;
+      }
+    }
+  }
+
   const std::string EnzymaticDigestion::NamesOfSpecificity[] = {"full", "semi", "none"};
   const std::string EnzymaticDigestion::NoCleavage = "no cleavage";
   const std::string EnzymaticDigestion::UnspecificCleavage = "unspecific cleavage";
@@ -49,6 +77,7 @@ namespace OpenMS
     missed_cleavages_(0),
     enzyme_(ProteaseDB::getInstance()->getEnzyme("Trypsin")), // @TODO: keep trypsin as default?
     re_(enzyme_->getRegEx()),
+    cleavage_table_(getCleavageTable_(enzyme_->getRegEx())),
     specificity_(SPEC_FULL)
   {
   }
@@ -71,6 +100,7 @@ namespace OpenMS
   {
     enzyme_ = enzyme;
     re_ = boost::regex(enzyme_->getRegEx());
+    cleavage_table_ = getCleavageTable_(enzyme_->getRegEx());
   }
 
   String EnzymaticDigestion::getEnzymeName() const
@@ -97,6 +127,88 @@ namespace OpenMS
     specificity_ = spec;
   }
 
+  std::shared_ptr<const EnzymaticDigestion::CleavageTable> EnzymaticDigestion::getCleavageTable_(const String& regex)
+  {
+    static std::mutex mutex;
+    static std::map<String, std::shared_ptr<const CleavageTable> > tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<String, std::shared_ptr<const CleavageTable> >::const_iterator it = tables.find(regex);
+    if (it != tables.end()) return it->second;
+
+    std::shared_ptr<const CleavageTable> result;
+    if (regex != "()") // "no cleavage" is handled by tokenize_() directly
+    {
+      const boost::regex re(regex);
+      // representative characters of the residue codes (see residueCode())
+      std::string code_chars(1, '\0');
+      for (char c = 'A'; c <= 'Z'; ++c) code_chars += c;
+      code_chars += '*';
+
+      // evaluate the regex for every context 'l2 l1 | r1' (l2/l1 may be missing at the start of a range)
+      std::shared_ptr<CleavageTable> table(new CleavageTable());
+      std::vector<int> positions;
+      for (unsigned l2 = 0; l2 < 28; ++l2)
+      {
+        for (unsigned l1 = (l2 == 0 ? 0 : 1); l1 < 28; ++l1)
+        {
+          for (unsigned r1 = 1; r1 < 28; ++r1)
+          {
+            std::string window;
+            if (l2 != 0) window += code_chars[l2];
+            if (l1 != 0) window += code_chars[l1];
+            const int site = (int)window.size();
+            window += code_chars[r1];
+
+            positions.clear();
+            tokenizeRegEx(re, window.c_str(), 0, (int)window.size(), positions);
+            // a match at the range start shows up as a duplicate of the start position
+            const bool cleave = std::find(positions.begin() + std::min<size_t>(1, positions.size()), positions.end(), site) != positions.end();
+            (*table)[(l2 << 10) | (l1 << 5) | r1] = cleave;
+          }
+        }
+      }
+
+      // verify on random sequences and ranges; this rejects expressions with a wider context or non-empty matches
+      const std::string alphabet = "ACDEFGHIKLMNPQRSTVWYBZXJUOKRKRDEPPW*ak-";
+      std::mt19937 rng(42);
+      std::vector<int> expected;
+      bool valid = true;
+      for (Size n = 0; n < 2000 && valid; ++n)
+      {
+        std::string seq(rng() % 24, ' ');
+        for (char& c : seq) c = alphabet[rng() % alphabet.size()];
+        const int start = (seq.empty() ? 0 : (int)(rng() % seq.size()));
+        const int end = start + (int)(rng() % (seq.size() - start + 1));
+        expected.clear();
+        positions.clear();
+        tokenizeRegEx(re, seq.c_str(), start, end, expected);
+        scanCleavageSites_(*table, seq.c_str(), start, end, positions);
+        valid = (expected == positions);
+      }
+      if (valid) result = table;
+    }
+
+    tables[regex] = result;
+    return result;
+  }
+
+  void EnzymaticDigestion::scanCleavageSites_(const CleavageTable& table, const char* sequence, int start, int end, std::vector<int>& positions)
+  {
+    if (start >= end) return; // an empty range yields no tokens
+
+    positions.push_back(start);
+    unsigned l1 = 0, r1 = residueCode(sequence[start]);
+    if (table[r1]) positions.push_back(start); // site at the range start (no residues before it)
+    for (int p = start + 1; p < end; ++p)
+    {
+      const unsigned l2 = l1;
+      l1 = r1;
+      r1 = residueCode(sequence[p]);
+      if (table[(l2 << 10) | (l1 << 5) | r1]) positions.push_back(p);
+    }
+  }
+
   std::vector<int> EnzymaticDigestion::tokenize_(const String& sequence, int start, int end) const
   {
     std::vector<int> positions;
@@ -104,24 +216,38 @@ namespace OpenMS
     start = std::max(0, start);
     if (end < 0 || end > (int)sequence.size()) end = (int)sequence.size();
 
-    if (enzyme_->getRegEx() != "()") // if it's not "no cleavage"
+    if (enzyme_->getRegEx() == "()") // "no cleavage"
     {
-      boost::sregex_token_iterator i(sequence.begin() + start, sequence.begin() + end, re_, -1);
-      boost::sregex_token_iterator j;
-      while (i != j)
-      {
-        positions.push_back(start); // first push 'start' (usually 0), then all the real cleavage sites
-        start += (int)i->length();
-        ++i;
-      }
+      positions.push_back(start);
+    }
+    else if (cleavage_table_)
+    {
+      scanCleavageSites_(*cleavage_table_, sequence.c_str(), start, end, positions);
     }
     else
     {
-      positions.push_back(start);
+      tokenizeRegEx(re_, sequence.c_str(), start, end, positions);
     }
     return positions;
   }
 
+  void EnzymaticDigestion::tokenize_(const StringView& sequence, std::vector<int>& positions) const
+  {
+    if (enzyme_->getRegEx() == "()") // "no cleavage"
+    {
+      positions.push_back(0);
+    }
+    else if (cleavage_table_)
+    {
+      scanCleavageSites_(*cleavage_table_, sequence.data(), 0, (int)sequence.size(), positions);
+    }
+    else
+    {
+      const String seq = sequence.getString();
+      tokenizeRegEx(re_, seq.c_str(), 0, (int)seq.size(), positions);
+    }
+  }
+
   bool EnzymaticDigestion::isValidProduct(const String& sequence,
                                           int pos,
                                           int length,
@@ -378,7 +504,8 @@ namespace OpenMS
     }
 
     // naive cleavage sites
-    std::vector<int> fragment_positions = tokenize_(sequence.getString());
+    std::vector<int> fragment_positions;
+    tokenize_(sequence, fragment_positions);
     return digestAfterTokenize_(fragment_positions, sequence, output, min_length, max_length);
   }
 
@@ -411,7 +538,101 @@ namespace OpenMS
     }
 
     // naive cleavage sites
-    std::vector<int> fragment_positions = tokenize_(sequence.getString());
+    std::vector<int> fragment_positions;
+    tokenize_(sequence, fragment_positions);
+    return digestAfterTokenize_(fragment_positions, sequence, output, min_length, max_length);
+  }
+
+  Size EnzymaticDigestion::digestAfterTokenize_(const std::vector<int>& fragment_positions, const StringView& sequence, std::vector<DigestionProduct>& output, Size min_length, Size max_length) const
+  {
+    Size count = fragment_positions.size();
+    Size wrong_size(0);
+    Size l(0); //length
+
+    // no cleavage sites? return full string
+    if (count == 0)
+    {
+      if (sequence.size() >= min_length && sequence.size() <= max_length)
+      {
+        output.emplace_back(0, sequence.size(), 0);
+      }
+      return wrong_size;
+    }
+
+    for (Size i = 1; i != count; ++i)
+    {
+      // add if cleavage product larger than min length
+      l = fragment_positions[i] - fragment_positions[i - 1];
+      if (l >= min_length && l <= max_length)
+      {
+        output.emplace_back(fragment_positions[i - 1], l, 0);
+      }
+      else ++wrong_size;
+    }
+
+    // add last cleavage product (need to add because end is not a cleavage site) if larger than min length
+    l = sequence.size() - fragment_positions[count - 1];
+    if (l >= min_length && l <= max_length)
+    {
+      output.emplace_back(fragment_positions[count - 1], l, 0);
+    }
+    else ++wrong_size;
+
+    // generate fragments with missed cleavages
+    for (Size i = 1; ((i <= missed_cleavages_) && (i < count)); ++i)
+    {
+      for (Size j = 1; j < count - i; ++j)
+      {
+        l = fragment_positions[j + i] - fragment_positions[j - 1];
+        if (l >= min_length && l <= max_length)
+        {
+          output.emplace_back(fragment_positions[j - 1], l, i);
+        }
+        else ++wrong_size;
+      }
+
+      // add last cleavage product (need to add because end is not a cleavage site)
+      l = sequence.size() - fragment_positions[count - i - 1];
+      if (l >= min_length && l <= max_length)
+      {
+        output.emplace_back(fragment_positions[count - i - 1], l, i);
+      }
+      else ++wrong_size;
+    }
+    return wrong_size;
+  }
+
+  Size EnzymaticDigestion::digestUnmodified(const StringView& sequence, std::vector<DigestionProduct>& output, Size min_length, Size max_length) const
+  {
+    // initialization
+    output.clear();
+
+    // disable max length filter by setting to maximum length
+    if (max_length == 0 || max_length > sequence.size())
+    {
+      max_length = sequence.size();
+    }
+
+    // Unspecific cleavage:
+    // For unspecific cleavage every site is a cutting position.
+    // All substrings of length min_size..max_size are generated.
+    if (enzyme_->getName() == UnspecificCleavage)
+    {
+      output.reserve(sequence.size() * (max_length - min_length + 1));
+      for (Size i = 0; i <= sequence.size() - min_length; ++i)
+      {
+        const Size right = std::min(i + max_length, sequence.size());
+        for (Size j = i + min_length; j <= right; ++j)
+        {
+          output.emplace_back(i, j - i, 0);
+        }
+      }
+      return 0;
+    }
+
+    // naive cleavage sites
+    std::vector<int> fragment_positions;
+    tokenize_(sequence, fragment_positions);
     return digestAfterTokenize_(fragment_positions, sequence, output, min_length, max_length);
   }
 
@@ -0,0 +1,449 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternTable.h>
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/MATH/MISC/MathFunctions.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace OpenMS
+{
+  const std::string CoarseIsotopePatternTable::NamesOfAveragineModel[] = {"peptide", "RNA", "DNA"};
+
+  // distance of the outermost nodes of a segment to the segment boundaries (where one of the rounded atom counts changes)
+  const double SEGMENT_MARGIN = 1e-6;
+
+  CoarseIsotopePatternTable::CoarseIsotopePatternTable(double max_mass, Size max_isotope, double max_error,
+                                                       AveragineModel model, double min_node_distance) :
+    max_mass_(max_mass),
+    max_isotope_(max_isotope),
+    max_error_(0.0),
+    model_(model)
+  {
+    if (max_mass <= 0 || max_isotope == 0 || max_error < 0 || min_node_distance <= 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid settings for the isotope pattern table "
+                                    "(maximal mass, maximal isotope and minimal node distance need to be positive, the maximal error must not be negative)", String(max_mass));
+    }
+
+    // the same compositions as used by CoarseIsotopePatternGenerator (C, H, N, O, S, P)
+    const double compositions[SIZE_OF_AVERAGINEMODEL][6] =
+    {
+      {4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0}, // Senko
+      {9.75, 12.25, 3.75, 7, 0, 1},                // Zubarev, RNA
+      {9.75, 12.25, 3.75, 6, 0, 1}                 // Zubarev, DNA
+    };
+    std::copy(compositions[model], compositions[model] + 6, composition_);
+
+    const ElementDB* db = ElementDB::getInstance();
+    const char* symbols[6] = {"C", "H", "N", "O", "S", "P"};
+    average_total_ = 0.0;
+    for (Size i = 0; i < 6; ++i)
+    {
+      average_weights_[i] = db->getElement(symbols[i])->getAverageWeight();
+      mono_weights_[i] = db->getElement(symbols[i])->getMonoWeight();
+      average_total_ += composition_[i] * average_weights_[i];
+      const IsotopeDistribution& isotopes = db->getElement(symbols[i])->getIsotopeDistribution();
+      isotope_spans_[i] = Math::round(isotopes.getMax()) - Math::round(isotopes.getMin());
+    }
+
+    // segment boundaries: the weights at which the rounded count of C, N, O, S or P changes
+    // (see EmpiricalFormula::estimateFromWeightAndComp)
+    std::vector<double> boundaries;
+    for (Size i = 0; i < 6; ++i)
+    {
+      if (i == 1 || composition_[i] <= 0) continue; // hydrogen fills up the remaining mass
+      for (Size k = 0; (k + 0.5) * average_total_ / composition_[i] < max_mass_; ++k)
+      {
+        boundaries.push_back((k + 0.5) * average_total_ / composition_[i]);
+      }
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.push_back(max_mass_ + SEGMENT_MARGIN);
+
+    if (max_error == 0.0)
+    {
+      // exact table: also split where the number of hydrogens changes, so that the formula is constant within each segment
+      std::vector<double> hydrogen_boundaries;
+      for (Size i = 0; i + 1 < boundaries.size(); ++i)
+      {
+        double counts[6];
+        estimateCounts_((boundaries[i] + boundaries[i + 1]) / 2, counts);
+        double heavy_weight = 0.0;
+        for (Size j = 0; j < 6; ++j)
+        {
+          if (j != 1) heavy_weight += counts[j] * average_weights_[j];
+        }
+        for (Size k = 0; heavy_weight + (k + 0.5) * average_weights_[1] < boundaries[i + 1]; ++k)
+        {
+          double boundary = heavy_weight + (k + 0.5) * average_weights_[1];
+          if (boundary > boundaries[i]) hydrogen_boundaries.push_back(boundary);
+        }
+      }
+      boundaries.insert(boundaries.end(), hydrogen_boundaries.begin(), hydrogen_boundaries.end());
+      std::sort(boundaries.begin(), boundaries.end());
+    }
+
+    std::vector<std::pair<double, double> > segments;
+    for (Size i = 0; i + 1 < boundaries.size(); ++i)
+    {
+      if (boundaries[i + 1] - boundaries[i] > 2 * SEGMENT_MARGIN)
+      {
+        double left = boundaries[i] + SEGMENT_MARGIN;
+        // a single node suffices if the formula is constant within the segment
+        double right = (max_error == 0.0 ? left : boundaries[i + 1] - SEGMENT_MARGIN);
+        segments.push_back(std::make_pair(left, right));
+      }
+    }
+
+    // compute the segments independently ...
+    std::vector<std::vector<double> > segment_weights(segments.size()), segment_intensities(segments.size());
+    std::vector<double> segment_errors(segments.size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)segments.size(); ++i)
+    {
+      computeSegment_(segments[i].first, segments[i].second, max_error, min_node_distance,
+                      segment_weights[i], segment_intensities[i], segment_errors[i]);
+    }
+
+    // ... and concatenate them
+    for (Size i = 0; i < segments.size(); ++i)
+    {
+      for (Size j = 0; j < segment_weights[i].size(); ++j)
+      {
+        Node node = {segment_weights[i][j], j + 1 < segment_weights[i].size()};
+        nodes_.push_back(node);
+      }
+      intensities_.insert(intensities_.end(), segment_intensities[i].begin(), segment_intensities[i].end());
+      max_error_ = std::max(max_error_, segment_errors[i]);
+    }
+  }
+
+  const CoarseIsotopePatternTable& CoarseIsotopePatternTable::getDefaultTable(AveragineModel model)
+  {
+    // thread safe initialization (C++11), each table is only built when it is first needed
+    switch (model)
+    {
+      case RNA:
+      {
+        static const CoarseIsotopePatternTable* rna_table_ = new CoarseIsotopePatternTable(10000.0, 10, 0.0, RNA);
+        return *rna_table_;
+      }
+      case DNA:
+      {
+        static const CoarseIsotopePatternTable* dna_table_ = new CoarseIsotopePatternTable(10000.0, 10, 0.0, DNA);
+        return *dna_table_;
+      }
+      default:
+      {
+        static const CoarseIsotopePatternTable* peptide_table_ = new CoarseIsotopePatternTable();
+        return *peptide_table_;
+      }
+    }
+  }
+
+  double CoarseIsotopePatternTable::getMinMass() const
+  {
+    return nodes_.empty() ? 0.0 : nodes_.front().weight;
+  }
+
+  double CoarseIsotopePatternTable::getMaxMass() const
+  {
+    return max_mass_;
+  }
+
+  Size CoarseIsotopePatternTable::getMaxIsotope() const
+  {
+    return max_isotope_;
+  }
+
+  Size CoarseIsotopePatternTable::getNumberOfNodes() const
+  {
+    return nodes_.size();
+  }
+
+  double CoarseIsotopePatternTable::getMaxError() const
+  {
+    return max_error_;
+  }
+
+  CoarseIsotopePatternTable::AveragineModel CoarseIsotopePatternTable::getModel() const
+  {
+    return model_;
+  }
+
+  bool CoarseIsotopePatternTable::isTabulated(double average_weight) const
+  {
+    Size node;
+    double fraction;
+    return locate_(average_weight, node, fraction);
+  }
+
+  IsotopeDistribution CoarseIsotopePatternTable::estimateFromWeight(double average_weight, Size max_isotope) const
+  {
+    Size n = (max_isotope == 0 ? max_isotope_ : max_isotope);
+    Size node;
+    double fraction;
+    if (n > max_isotope_ || !locate_(average_weight, node, fraction))
+    {
+      CoarseIsotopePatternGenerator solver(n);
+      return solver.estimateFromWeightAndComp(average_weight, composition_[0], composition_[1], composition_[2],
+                                              composition_[3], composition_[4], composition_[5]);
+    }
+
+    double mono_weight;
+    finalize_(average_weight, n, mono_weight);
+    std::vector<double> intensities(n);
+    interpolate_(node, fraction, n, &intensities[0]);
+
+    IsotopeDistribution::ContainerType container(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      container[i] = Peak1D(mono_weight + i * Constants::C13C12_MASSDIFF_U, intensities[i]);
+    }
+    IsotopeDistribution result;
+    result.set(std::move(container));
+    return result;
+  }
+
+  void CoarseIsotopePatternTable::getIntensities(double average_weight, Size max_isotope, std::vector<double>& intensities) const
+  {
+    Size n = (max_isotope == 0 ? max_isotope_ : max_isotope);
+    intensities.resize(n);
+    Size node;
+    double fraction;
+    if (n > max_isotope_ || !locate_(average_weight, node, fraction))
+    {
+      IsotopeDistribution dist = estimateFromWeight(average_weight, n);
+      for (Size i = 0; i < n; ++i)
+      {
+        intensities[i] = (i < dist.size() ? dist[i].getIntensity() : 0.0);
+      }
+      return;
+    }
+    interpolate_(node, fraction, n, &intensities[0]);
+  }
+
+  IsotopeDistribution CoarseIsotopePatternTable::estimateForFragmentFromWeight(double average_weight_precursor, double average_weight_fragment, const std::set<UInt>& precursor_isotopes) const
+  {
+    Size depth = *precursor_isotopes.rbegin() + 1;
+
+    Size node_fragment, node_comp;
+    double fraction_fragment, fraction_comp;
+    if (depth > max_isotope_ ||
+        !locate_(average_weight_fragment, node_fragment, fraction_fragment) ||
+        !locate_(average_weight_precursor - average_weight_fragment, node_comp, fraction_comp))
+    {
+      CoarseIsotopePatternGenerator solver;
+      return solver.estimateForFragmentFromWeightAndComp(average_weight_precursor, average_weight_fragment, precursor_isotopes,
+                                                         composition_[0], composition_[1], composition_[2],
+                                                         composition_[3], composition_[4], composition_[5]);
+    }
+
+    Size n_fragment = depth, n_comp = depth;
+    double mono_weight, mono_weight_comp;
+    finalize_(average_weight_fragment, n_fragment, mono_weight);
+    finalize_(average_weight_precursor - average_weight_fragment, n_comp, mono_weight_comp);
+    std::vector<double> fragment(n_fragment), comp_fragment(n_comp);
+    interpolate_(node_fragment, fraction_fragment, n_fragment, &fragment[0]);
+    interpolate_(node_comp, fraction_comp, n_comp, &comp_fragment[0]);
+
+    // see CoarseIsotopePatternGenerator::calcFragmentIsotopeDist_ for the derivation
+    Size n = n_fragment;
+    IsotopeDistribution::ContainerType container(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      double comp_sum = 0.0;
+      for (std::set<UInt>::const_iterator it = precursor_isotopes.begin(); it != precursor_isotopes.end(); ++it)
+      {
+        if (*it >= i && *it - i < n_comp)
+        {
+          comp_sum += comp_fragment[*it - i];
+        }
+      }
+      container[i] = Peak1D(mono_weight + i * Constants::C13C12_MASSDIFF_U, comp_sum * fragment[i]);
+    }
+    IsotopeDistribution result;
+    result.set(std::move(container));
+    return result;
+  }
+
+  void CoarseIsotopePatternTable::computeExact_(double average_weight, double* intensities) const
+  {
+    EmpiricalFormula ef;
+    ef.estimateFromWeightAndComp(average_weight, composition_[0], composition_[1], composition_[2],
+                                 composition_[3], composition_[4], composition_[5]);
+    IsotopeDistribution dist = ef.getIsotopeDistribution(CoarseIsotopePatternGenerator(max_isotope_));
+    for (Size j = 0; j < max_isotope_; ++j)
+    {
+      intensities[j] = (j < dist.size() ? dist[j].getIntensity() : 0.0);
+    }
+  }
+
+  void CoarseIsotopePatternTable::computeSegment_(double left, double right, double max_error, double min_node_distance,
+                                                  std::vector<double>& weights, std::vector<double>& intensities, double& error) const
+  {
+    const Size n = max_isotope_;
+    std::vector<double> exact(n), interpolated(n);
+
+    weights.assign(1, left);
+    intensities.resize(n);
+    computeExact_(left, &intensities[0]);
+    if (right <= left)
+    {
+      return;
+    }
+
+    // depth-first refinement: the top of the stack is the next node to the right of the last accepted node
+    std::vector<double> open_weights(1, right);
+    std::vector<double> open_intensities(n);
+    computeExact_(right, &open_intensities[0]);
+    while (!open_weights.empty())
+    {
+      double last = weights.back();
+      double next = open_weights.back();
+      const double* last_intensities = &intensities[intensities.size() - n];
+      const double* next_intensities = &open_intensities[open_intensities.size() - n];
+
+      double center = (last + next) / 2;
+      computeExact_(center, &exact[0]);
+      double center_error = 0.0;
+      for (Size j = 0; j < n; ++j)
+      {
+        interpolated[j] = (last_intensities[j] + next_intensities[j]) / 2;
+        center_error = std::max(center_error, std::fabs(interpolated[j] - exact[j]));
+      }
+
+      if (center_error <= max_error || (next - last) / 2 < min_node_distance)
+      {
+        // accept the node
+        error = std::max(error, center_error);
+        weights.push_back(next);
+        intensities.insert(intensities.end(), next_intensities, next_intensities + n);
+        open_weights.pop_back();
+        open_intensities.resize(open_intensities.size() - n);
+      }
+      else
+      {
+        // refine
+        open_weights.push_back(center);
+        open_intensities.insert(open_intensities.end(), exact.begin(), exact.end());
+      }
+    }
+  }
+
+  bool CoarseIsotopePatternTable::locate_(double average_weight, Size& node, double& fraction) const
+  {
+    if (nodes_.empty() || !(average_weight >= nodes_.front().weight) || !(average_weight <= max_mass_))
+    {
+      return false; // also catches NaN
+    }
+
+    std::vector<Node>::const_iterator it = std::upper_bound(nodes_.begin(), nodes_.end(), average_weight,
+                                                            [](double weight, const Node& n) { return weight < n.weight; });
+    node = (it - nodes_.begin()) - 1;
+    if (nodes_[node].connected)
+    {
+      fraction = (average_weight - nodes_[node].weight) / (nodes_[node + 1].weight - nodes_[node].weight);
+    }
+    else // between two segments, or behind the last node
+    {
+      fraction = 0.0;
+    }
+    return true;
+  }
+
+  void CoarseIsotopePatternTable::interpolate_(Size node, double fraction, Size n, double* intensities) const
+  {
+    const double* left = &intensities_[node * max_isotope_];
+    double sum = 0.0;
+    for (Size j = 0; j < n; ++j)
+    {
+      // the right node only exists within a segment
+      intensities[j] = (fraction == 0.0 ? left[j] : (1.0 - fraction) * left[j] + fraction * left[j + max_isotope_]);
+      sum += intensities[j];
+    }
+    // renormalize the prefix, like CoarseIsotopePatternGenerator does for a smaller maximal isotope
+    if (n < max_isotope_ && sum > 0.0)
+    {
+      for (Size j = 0; j < n; ++j)
+      {
+        intensities[j] /= sum;
+      }
+    }
+  }
+
+  void CoarseIsotopePatternTable::estimateCounts_(double average_weight, double* counts) const
+  {
+    // same rounding as EmpiricalFormula::estimateFromWeightAndComp
+    double factor = average_weight / average_total_;
+    double average = 0.0;
+    for (Size i = 0; i < 6; ++i)
+    {
+      if (i == 1) continue;
+      counts[i] = Math::round(composition_[i] * factor);
+      average += counts[i] * average_weights_[i];
+    }
+    counts[1] = std::max(0.0, Math::round((average_weight - average) / average_weights_[1]));
+  }
+
+  void CoarseIsotopePatternTable::finalize_(double average_weight, Size& n, double& mono_weight) const
+  {
+    double counts[6];
+    estimateCounts_(average_weight, counts);
+    mono_weight = 0.0;
+    double span = 0.0;
+    for (Size i = 0; i < 6; ++i)
+    {
+      mono_weight += counts[i] * mono_weights_[i];
+      span += counts[i] * isotope_spans_[i];
+    }
+    // the exact generator does not report isotopes which cannot occur (small molecules)
+    n = std::min(n, static_cast<Size>(span) + 1);
+  }
+
+} // namespace OpenMS
+
@@ -84,6 +84,7 @@ namespace OpenMS
     {
       readFromOBOFile(xlmod_file);
     }
+    publishSnapshot_();
     is_instantiated_ = true;
   }
 
@@ -101,21 +102,34 @@ namespace OpenMS
     return is_instantiated_;
   }
 
-  Size ModificationsDB::getNumberOfModifications() const
+  void ModificationsDB::publishSnapshot_()
   {
-    Size s;
-    #pragma omp critical (OpenMS_ModificationsDB)
+    std::shared_ptr<Snapshot> snapshot(new Snapshot);
+    snapshot->mods.assign(mods_.begin(), mods_.end());
+    snapshot->index.reserve(mods_.size());
+    for (Size i = 0; i != mods_.size(); ++i)
+    {
+      snapshot->index.insert(make_pair(mods_[i], i)); // keeps the first occurrence
+    }
+    snapshot->names.reserve(modification_names_.size());
+    for (const auto& name : modification_names_)
     {
-      s = mods_.size();
+      snapshot->names[name.first].assign(name.second.begin(), name.second.end());
     }
-    return s;
+    snapshot_.publish(snapshot);
+  }
+
+  Size ModificationsDB::getNumberOfModifications() const
+  {
+    return snapshot_.load()->mods.size();
   }
 
 
   const ResidueModification* ModificationsDB::getModification(Size index) const
   {
-    OPENMS_PRECONDITION(index < mods_.size(), "Index out of bounds in ModificationsDB::getModification(Size index)." );
-    return mods_[index];
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    OPENMS_PRECONDITION(index < snapshot->mods.size(), "Index out of bounds in ModificationsDB::getModification(Size index)." );
+    return snapshot->mods[index];
   }
 
 
@@ -128,38 +142,33 @@ namespace OpenMS
 
     String mod_name = mod_name_;
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    auto entry = snapshot->names.find(mod_name);
+    if (entry == snapshot->names.end())
     {
-      bool found = true;
-      if (!modification_names_.has(mod_name))
+      // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
+      if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
       {
-        // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
-        if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
-        {
-          mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
-        }
+        mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
+        entry = snapshot->names.find(mod_name);
+      }
 
-        if (!modification_names_.has(mod_name))
-        {
-          OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
-          found = false; 
-        }
+      if (entry == snapshot->names.end())
+      {
+        OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
+        return;
       }
+    }
 
-      if (found)
+    for (const ResidueModification* it : entry->second)
+    {
+      if (residuesMatch_(residue, it) &&
+           (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
+           (term_spec == it->getTermSpecificity())))
       {
-        const set<const ResidueModification*>& temp = modification_names_[mod_name];
-        for (const auto& it : temp)
-        {
-          if (residuesMatch_(residue, it) &&
-               (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
-               (term_spec == it->getTermSpecificity())))
-          {
-            mods.insert(it);
-          }
-        }
+        mods.insert(it);
       }
-    } 
+    }
   }
 
   const ResidueModification* ModificationsDB::getModification(const String& mod_name, const String& residue, ResidueModification::TermSpecificity term_spec) const
@@ -196,70 +205,45 @@ namespace OpenMS
 
   bool ModificationsDB::has(String modification) const
   {
-    bool has_mod;
-    #pragma omp critical(OpenMS_ModificationsDB)
-    {
-      has_mod = modification_names_.has(modification);
-    }
-    return has_mod;
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    return snapshot->names.find(modification) != snapshot->names.end();
   }
 
   Size ModificationsDB::findModificationIndex(const String & mod_name) const
   {
-    if (!has(mod_name))
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    auto entry = snapshot->names.find(mod_name);
+    if (entry == snapshot->names.end())
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: " + mod_name);
     }
 
-    bool one_mod(true);
-    #pragma omp critical(OpenMS_ModificationsDB)
-    {
-      if (modification_names_[mod_name].size() > 1)
-      {
-        one_mod = false;
-      }
-    }
-    if (!one_mod) 
+    if (entry->second.size() > 1)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "More than one modification with name: " + mod_name);
     }
 
-    Size index(numeric_limits<Size>::max());
-    #pragma omp critical(OpenMS_ModificationsDB)
-    {
-      const ResidueModification* mod = *modification_names_[mod_name].begin();
-      for (Size i = 0; i != mods_.size(); ++i)
-      {
-        if (mods_[i] == mod)
-        {
-          index = i;
-          break;
-        }
-      }
-    }
-
-    if (index == numeric_limits<Size>::max())
+    auto index = snapshot->index.find(entry->second.front());
+    if (index == snapshot->index.end())
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification name found but modification not found: " + mod_name);
     }
-    return index;
+    return index->second;
   }
 
 
   void ModificationsDB::searchModificationsByDiffMonoMass(vector<String>& mods, double mass, double max_error, const String& residue, ResidueModification::TermSpecificity term_spec)
   {
     mods.clear();
-    #pragma omp critical(OpenMS_ModificationsDB)
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
+          residuesMatch_(residue, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
-            residuesMatch_(residue, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          mods.push_back(m->getFullId());
-        }
+        mods.push_back(m->getFullId());
       }
     }
   }
@@ -269,22 +253,20 @@ namespace OpenMS
   {
     double min_error = max_error;
     const ResidueModification* mod = nullptr;
-    #pragma omp critical(OpenMS_ModificationsDB)
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      // using less instead of less-or-equal will pick the first matching
+      // modification of equally heavy modifications (in our case this is the
+      // first matching UniMod entry)
+      double mass_error = fabs(m->getDiffMonoMass() - mass);
+      if ((mass_error < min_error) &&
+          residuesMatch_(residue, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        // using less instead of less-or-equal will pick the first matching
-        // modification of equally heavy modifications (in our case this is the
-        // first matching UniMod entry)
-        double mass_error = fabs(m->getDiffMonoMass() - mass);
-        if ((mass_error < min_error) &&
-            residuesMatch_(residue, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          min_error = mass_error;
-          mod = m;
-        }
+        min_error = mass_error;
+        mod = m;
       }
     }
     return mod;
@@ -295,13 +277,13 @@ namespace OpenMS
     vector<ResidueModification*> new_mods;
     UnimodXMLFile().load(filename, new_mods);
 
-    for (auto & m : new_mods)
+    #pragma omp critical(OpenMS_ModificationsDB)
     {
-      // create full ID based on other information:
-      m->setFullId();
-
-      #pragma omp critical(OpenMS_ModificationsDB)
+      for (auto & m : new_mods)
       {
+        // create full ID based on other information:
+        m->setFullId();
+
         // e.g. Oxidation (M)
         modification_names_[m->getFullId()].insert(m);
         // e.g. Oxidation
@@ -312,24 +294,30 @@ namespace OpenMS
         modification_names_[m->getUniModAccession()].insert(m);
         mods_.push_back(m);
       }
+      publishSnapshot_();
     }
   }
 
   void ModificationsDB::addModification(ResidueModification* new_mod)
   {
-    if (has(new_mod->getFullId()))
+    bool exists = false;
+    #pragma omp critical(OpenMS_ModificationsDB)
     {
-      OPENMS_LOG_WARN << "Modification already exists in ModificationsDB. Skipping." << new_mod->getFullId() << endl;
-      return;
+      // check under the write lock, another thread might just have added the same modification
+      exists = modification_names_.has(new_mod->getFullId());
+      if (!exists)
+      {
+        modification_names_[new_mod->getFullId()].insert(new_mod);
+        modification_names_[new_mod->getId()].insert(new_mod);
+        modification_names_[new_mod->getFullName()].insert(new_mod);
+        modification_names_[new_mod->getUniModAccession()].insert(new_mod);
+        mods_.push_back(new_mod); // we probably want that
+        publishSnapshot_();
+      }
     }
-
-    #pragma omp critical(OpenMS_ModificationsDB)
+    if (exists)
     {
-      modification_names_[new_mod->getFullId()].insert(new_mod);
-      modification_names_[new_mod->getId()].insert(new_mod);
-      modification_names_[new_mod->getFullName()].insert(new_mod);
-      modification_names_[new_mod->getUniModAccession()].insert(new_mod);
-      mods_.push_back(new_mod); // we probably want that
+      OPENMS_LOG_WARN << "Modification already exists in ModificationsDB. Skipping." << new_mod->getFullId() << endl;
     }
   }
 
@@ -632,6 +620,7 @@ namespace OpenMS
           }
         }
       }
+      publishSnapshot_();
     }
   }
 
@@ -639,14 +628,12 @@ namespace OpenMS
   {
     modifications.clear();
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      if (m->getUniModRecordId() > 0)
       {
-        if (m->getUniModRecordId() > 0)
-        {
-          modifications.push_back(m->getFullId());
-        }
+        modifications.push_back(m->getFullId());
       }
     }
 
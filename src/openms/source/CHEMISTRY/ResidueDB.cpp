@@ -55,6 +55,7 @@ namespace OpenMS
   {
     readResiduesFromFile_("CHEMISTRY/Residues.xml");
     buildResidueNames_();
+    publishSnapshot_();
   }
 
   ResidueDB* ResidueDB::getInstance()
@@ -68,6 +69,21 @@ namespace OpenMS
     clear_();
   }
 
+  void ResidueDB::publishSnapshot_()
+  {
+    std::shared_ptr<Snapshot> snapshot(new Snapshot);
+    snapshot->residue_names.insert(residue_names_.begin(), residue_names_.end());
+    for (const auto& res : residue_mod_names_)
+    {
+      snapshot->residue_mod_names[res.first].insert(res.second.begin(), res.second.end());
+    }
+    snapshot->residues = const_residues_;
+    snapshot->modified_residues = const_modified_residues_;
+    snapshot->residues_by_set = residues_by_set_;
+    snapshot->residue_sets = residue_sets_;
+    snapshot_.publish(snapshot);
+  }
+
   const Residue* ResidueDB::getResidue(const String& name) const
   {
     if (name.empty())
@@ -75,17 +91,13 @@ namespace OpenMS
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No residue specified.", "");
     }
 
-    Residue* r(nullptr);
-    #pragma omp critical (ResidueDB)
-    {   
-      auto it = residue_names_.find(name);
-      if (it != residue_names_.end()) r = it->second;
-    }
-    if (r == nullptr)
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    auto it = snapshot->residue_names.find(name);
+    if (it == snapshot->residue_names.end())
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", name);
     }
-    return r;
+    return it->second;
   }
 
   const Residue* ResidueDB::getResidue(const unsigned char& one_letter_code) const
@@ -96,34 +108,22 @@ namespace OpenMS
 
   Size ResidueDB::getNumberOfResidues() const
   {
-    Size s;
-    #pragma omp critical (ResidueDB)
-    {
-      s = residues_.size();
-    } 
-    return s;
+    return snapshot_.load()->residues.size();
   }
 
   Size ResidueDB::getNumberOfModifiedResidues() const
   {
-    Size s;
-    #pragma omp critical (ResidueDB)
-    {
-      s = modified_residues_.size();
-    } 
-    return s;
+    return snapshot_.load()->modified_residues.size();
   }
 
   const set<const Residue*> ResidueDB::getResidues(const String& residue_set) const
   {
     set<const Residue*> s;
-    #pragma omp critical (ResidueDB)
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    if (snapshot->residues_by_set.has(residue_set))
     {
-      if (residues_by_set_.has(residue_set))
-      {
-        s = residues_by_set_[residue_set];
-      }
-    } 
+      s = snapshot->residues_by_set[residue_set];
+    }
 
     if (s.empty()) 
     {
@@ -138,6 +138,7 @@ namespace OpenMS
     {
       readResiduesFromFile_(file_name);
       buildResidueNames_();
+      publishSnapshot_();
     }     
   }
 
@@ -201,23 +202,15 @@ namespace OpenMS
 
   bool ResidueDB::hasResidue(const String& res_name) const
   {
-    bool found = false;
-    #pragma omp critical (ResidueDB)
-    {
-      found = residue_names_.find(res_name) != residue_names_.end();
-    }  
-    return found;
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    return snapshot->residue_names.find(res_name) != snapshot->residue_names.end();
   }
 
   bool ResidueDB::hasResidue(const Residue* residue) const
   {
-    bool found = false;
-    #pragma omp critical (ResidueDB)
-    {
-      found = (const_residues_.find(residue) != const_residues_.end() ||
-          const_modified_residues_.find(residue) != const_modified_residues_.end());
-    } 
-    return found;
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    return (snapshot->residues.find(residue) != snapshot->residues.end() ||
+        snapshot->modified_residues.find(residue) != snapshot->modified_residues.end());
   }
 
   void ResidueDB::readResiduesFromFile_(const String& file_name)
@@ -459,12 +452,7 @@ namespace OpenMS
 
   const set<String> ResidueDB::getResidueSets() const
   {
-    set<String> rs;
-    #pragma omp critical (ResidueDB)
-    {
-      rs = residue_sets_; 
-    }
-    return rs;
+    return snapshot_.load()->residue_sets;
   }
 
   void ResidueDB::buildResidueNames_()
@@ -510,58 +498,49 @@ namespace OpenMS
     OPENMS_PRECONDITION(!modification.empty(), "Modification cannot be empty")
     // search if the mod already exists
     const String & res_name = residue->getName();
+    AtomicSnapshot<Snapshot>::Pointer snapshot = snapshot_.load();
+    if (snapshot->residue_names.find(res_name) == snapshot->residue_names.end())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", res_name);
+    }
+
+    const ResidueModification* mod;
+    try
+    {
+      // terminal modifications don't apply to residues (side chain), so only consider internal ones
+      mod = ModificationsDB::getInstance()->getModification(modification, residue->getOneLetterCode(), ResidueModification::ANYWHERE);
+    }
+    catch (...)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: ", modification);
+    }
+
+    // check if modified residue is already present in ResidueDB (common case, no locking)
+    const String& id = mod->getId().empty() ? mod->getFullId() : mod->getId();
+    auto res_mods = snapshot->residue_mod_names.find(res_name);
+    if (res_mods != snapshot->residue_mod_names.end())
+    {
+      auto res_mod = res_mods->second.find(id);
+      if (res_mod != res_mods->second.end()) return res_mod->second;
+    }
+
     Residue* res(nullptr);
-    bool residue_found(true), mod_found(true);
     #pragma omp critical (ResidueDB)
     {
-      if (residue_names_.find(res_name) == residue_names_.end())
+      // check again, another thread might have added it in the meantime
+      if (residue_mod_names_.has(res_name) && residue_mod_names_[res_name].has(id))
       {
-        residue_found = false;
+        res = residue_mod_names_[res_name][id];
       }
       else
       {
-        const ResidueModification* mod;
-        try
-        {
-          // terminal modifications don't apply to residues (side chain), so only consider internal ones
-          mod = ModificationsDB::getInstance()->getModification(modification, residue->getOneLetterCode(), ResidueModification::ANYWHERE);
-        }
-        catch (...)
-        {
-          mod_found = false;
-        }
-
-        // check if modification in ResidueDB
-        if (mod_found)
-        {
-          const String& id = mod->getId().empty() ? mod->getFullId() : mod->getId();
-
-          // check if modified residue is already present in ResidueDB
-          if (residue_mod_names_.has(res_name) && residue_mod_names_[res_name].has(id))
-          {
-            res = residue_mod_names_[res_name][id];
-          }
-          else
-          {
-            // create and register this modified residue
-            res = new Residue(*residue_names_[res_name]);
-            res->setModification_(*mod);
-            addResidue_(res);
-          }
-        }
+        // create and register this modified residue
+        res = new Residue(*residue_names_[res_name]);
+        res->setModification_(*mod);
+        addResidue_(res);
+        publishSnapshot_();
       }
     }
-
-    // throwing (uncaught) exceptions needs to happen outside of critical section (see OpenMP reference manual)
-    if (!residue_found)
-    {
-      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", res_name);
-    }
-    else if (!mod_found)
-    {
-      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: ", modification);
-    }
-    
     return res;
   }
 
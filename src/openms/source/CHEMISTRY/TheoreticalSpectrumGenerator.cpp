@@ -213,6 +213,107 @@ namespace OpenMS
   }
 
 
+  void TheoreticalSpectrumGenerator::getPrefixMasses(const AASequence& peptide, std::vector<double>& prefix_masses)
+  {
+    prefix_masses.resize(peptide.size() + 1);
+    double mass = peptide.hasNTerminalModification() ? peptide.getNTerminalModification()->getDiffMonoMass() : 0.0;
+    prefix_masses[0] = mass;
+    for (Size i = 0; i < peptide.size(); ++i)
+    {
+      mass += peptide[i].getMonoWeight(Residue::Internal);
+      prefix_masses[i + 1] = mass;
+    }
+    if (peptide.hasCTerminalModification())
+    {
+      prefix_masses.back() += peptide.getCTerminalModification()->getDiffMonoMass();
+    }
+  }
+
+
+  void TheoreticalSpectrumGenerator::getFragmentMZs(const std::vector<double>& prefix_masses, Int min_charge, Int max_charge, std::vector<double>& mzs, std::vector<char>& ion_types) const
+  {
+    mzs.clear();
+    ion_types.clear();
+    if (prefix_masses.size() < 2) // empty peptide
+    {
+      return;
+    }
+    if ((add_c_ions_ || add_x_ions_) && prefix_masses.size() < 3)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 1);
+    }
+
+    for (Int z = min_charge; z <= max_charge; ++z)
+    {
+      if (add_b_ions_) mergeIonSeries_(prefix_masses, Residue::BIon, z, mzs, ion_types);
+      if (add_y_ions_) mergeIonSeries_(prefix_masses, Residue::YIon, z, mzs, ion_types);
+      if (add_a_ions_) mergeIonSeries_(prefix_masses, Residue::AIon, z, mzs, ion_types);
+      if (add_c_ions_) mergeIonSeries_(prefix_masses, Residue::CIon, z, mzs, ion_types);
+      if (add_x_ions_) mergeIonSeries_(prefix_masses, Residue::XIon, z, mzs, ion_types);
+      if (add_z_ions_) mergeIonSeries_(prefix_masses, Residue::ZIon, z, mzs, ion_types);
+    }
+  }
+
+
+  void TheoreticalSpectrumGenerator::mergeIonSeries_(const std::vector<double>& prefix_masses, Residue::ResidueType res_type, Int charge, std::vector<double>& mzs, std::vector<char>& ion_types) const
+  {
+    static const double stat_a = Residue::getInternalToAIon().getMonoWeight();
+    static const double stat_b = Residue::getInternalToBIon().getMonoWeight();
+    static const double stat_c = Residue::getInternalToCIon().getMonoWeight();
+    static const double stat_x = Residue::getInternalToXIon().getMonoWeight();
+    static const double stat_y = Residue::getInternalToYIon().getMonoWeight();
+    static const double stat_z = Residue::getInternalToZIon().getMonoWeight();
+
+    double ion_offset(0);
+    switch (res_type)
+    {
+      case Residue::AIon: ion_offset = stat_a; break;
+      case Residue::BIon: ion_offset = stat_b; break;
+      case Residue::CIon: ion_offset = stat_c; break;
+      case Residue::XIon: ion_offset = stat_x; break;
+      case Residue::YIon: ion_offset = stat_y; break;
+      case Residue::ZIon: ion_offset = stat_z; break;
+      default: break;
+    }
+    const bool prefix_ion = (res_type == Residue::AIon || res_type == Residue::BIon || res_type == Residue::CIon);
+    const char ion_letter = Residue::residueTypeToIonLetter(res_type);
+    const double shift = Constants::PROTON_MASS_U * charge + ion_offset;
+
+    // ions from the smallest fragment (length 1, or 2 for prefix ions without the first prefix ion)
+    // to the largest fragment (length n - 1), i.e. in ascending m/z
+    const Size n = prefix_masses.size() - 1;
+    const Size first_length = (prefix_ion && !add_first_prefix_ion_) ? 2 : 1;
+    if (first_length >= n) return;
+    const SignedSize count = n - first_length;
+
+    // merge from the back, so the new ion series can be computed on the fly
+    SignedSize i = (SignedSize)mzs.size() - 1; // last old element
+    SignedSize j = count - 1; // last new element
+    SignedSize k = (SignedSize)mzs.size() + count - 1; // last output position
+    mzs.resize(mzs.size() + count);
+    ion_types.resize(mzs.size());
+    while (j >= 0)
+    {
+      const Size length = first_length + j;
+      const double mass = prefix_ion ? prefix_masses[length] : prefix_masses[n] - prefix_masses[n - length];
+      const double mz = (mass + shift) / charge;
+      if (i >= 0 && mzs[i] > mz)
+      {
+        mzs[k] = mzs[i];
+        ion_types[k] = ion_types[i];
+        --i;
+      }
+      else
+      {
+        mzs[k] = mz;
+        ion_types[k] = ion_letter;
+        --j;
+      }
+      --k;
+    }
+  }
+
+
   void TheoreticalSpectrumGenerator::addAbundantImmoniumIons_(PeakSpectrum& spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges) const
   {
     Peak1D p;
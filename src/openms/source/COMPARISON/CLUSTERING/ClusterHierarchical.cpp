@@ -35,10 +35,235 @@
 
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterHierarchical.h>
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+
 //using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// union-find with the smallest element as representative of each set
+    struct MinRepresentativeSets_
+    {
+      explicit MinRepresentativeSets_(Size size) :
+        parent(size)
+      {
+        std::iota(parent.begin(), parent.end(), 0);
+      }
+
+      Size find(Size x)
+      {
+        while (parent[x] != x)
+        {
+          parent[x] = parent[parent[x]];
+          x = parent[x];
+        }
+        return x;
+      }
+
+      /// joins the sets of @p a and @p b (which must be representatives), returns the new representative
+      Size join(Size a, Size b)
+      {
+        if (b < a)
+        {
+          std::swap(a, b);
+        }
+        parent[b] = a;
+        return a;
+      }
+
+      std::vector<Size> parent;
+    };
+
+    /// connects all clusters not merged below the threshold by dummy steps (distance -1), as the ClusterFunctor s do
+    void addDummyNodes_(MinRepresentativeSets_& sets, std::vector<BinaryTreeNode>& cluster_tree)
+    {
+      const Size element_count = sets.parent.size();
+      Size first = sets.find(0);
+      for (Size i = 1; i < element_count && cluster_tree.size() < element_count - 1; ++i)
+      {
+        if (sets.find(i) == i)
+        {
+          cluster_tree.push_back(BinaryTreeNode(first, i, -1.0));
+        }
+      }
+    }
+  }
+
+  void ClusterHierarchical::clusterSparse(const Size element_count, std::vector<SparseDistance>& distances, const LinkageMethod linkage, std::vector<BinaryTreeNode>& cluster_tree) const
+  {
+    // input MUST have >= 2 elements!
+    if (element_count < 2)
+    {
+      throw ClusterFunctor::InsufficientInput(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Distance matrix to start from only contains one element");
+    }
+    const float threshold = threshold_;
+    for (std::vector<SparseDistance>::const_iterator it = distances.begin(); it != distances.end(); ++it)
+    {
+      if (it->first >= element_count || it->second >= element_count)
+      {
+        throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, std::max(it->first, it->second), element_count);
+      }
+    }
+
+    cluster_tree.clear();
+    cluster_tree.reserve(element_count - 1);
+    MinRepresentativeSets_ sets(element_count);
+
+    if (linkage == SINGLE_LINKAGE)
+    {
+      // Kruskal: the edges of the minimum spanning tree, in increasing order, are the single linkage merges
+      std::stable_sort(distances.begin(), distances.end(),
+                       [](const SparseDistance& a, const SparseDistance& b) { return a.distance < b.distance; });
+      for (std::vector<SparseDistance>::const_iterator it = distances.begin(); it != distances.end() && it->distance < threshold; ++it)
+      {
+        Size a = sets.find(it->first), b = sets.find(it->second);
+        if (a != b)
+        {
+          cluster_tree.push_back(BinaryTreeNode(std::min(a, b), std::max(a, b), it->distance));
+          sets.join(a, b);
+        }
+      }
+      addDummyNodes_(sets, cluster_tree);
+      return;
+    }
+
+    // nearest-neighbour chain on the sparse distance graph; clusters are identified by their smallest element
+    std::vector<std::map<Size, float> > neighbours(element_count);
+    for (std::vector<SparseDistance>::const_iterator it = distances.begin(); it != distances.end(); ++it)
+    {
+      if (it->first != it->second && it->distance < threshold)
+      {
+        neighbours[it->first][it->second] = it->distance;
+        neighbours[it->second][it->first] = it->distance;
+      }
+    }
+    std::vector<Size> cluster_size(element_count, 1);
+    std::vector<SparseDistance> merges; // in order of NN-chain, not necessarily by distance
+    merges.reserve(element_count - 1);
+
+    std::vector<Size> chain;
+    Size start = 0;
+    while (true)
+    {
+      if (chain.empty())
+      {
+        // clusters without neighbours below the threshold never get any, so we can move on
+        while (start < element_count && neighbours[start].empty())
+        {
+          ++start;
+        }
+        if (start == element_count)
+        {
+          break;
+        }
+        chain.push_back(start);
+      }
+
+      Size a = chain.back();
+      if (neighbours[a].empty()) // lost its neighbours in a (complete linkage) merge
+      {
+        chain.pop_back();
+        continue;
+      }
+
+      // nearest neighbour of a; ties are resolved in favour of the previous chain element
+      Size prev = chain.size() > 1 ? chain[chain.size() - 2] : element_count;
+      Size b = element_count;
+      float best = std::numeric_limits<float>::max();
+      std::map<Size, float>::const_iterator prev_it = neighbours[a].find(prev);
+      if (prev_it != neighbours[a].end())
+      {
+        b = prev;
+        best = prev_it->second;
+      }
+      for (std::map<Size, float>::const_iterator it = neighbours[a].begin(); it != neighbours[a].end(); ++it)
+      {
+        if (it->second < best)
+        {
+          b = it->first;
+          best = it->second;
+        }
+      }
+
+      if (b != prev)
+      {
+        chain.push_back(b);
+        continue;
+      }
+
+      // a and b are reciprocal nearest neighbours: merge them
+      chain.pop_back();
+      chain.pop_back();
+      merges.push_back(SparseDistance(a, b, best));
+
+      const float size_a = cluster_size[a], size_b = cluster_size[b];
+      std::map<Size, float> merged;
+      for (std::map<Size, float>::const_iterator it = neighbours[a].begin(); it != neighbours[a].end(); ++it)
+      {
+        if (it->first == b)
+        {
+          continue;
+        }
+        std::map<Size, float>::const_iterator other = neighbours[b].find(it->first);
+        if (linkage == COMPLETE_LINKAGE)
+        {
+          // a missing distance is at least the threshold, so is the maximum
+          if (other != neighbours[b].end())
+          {
+            merged[it->first] = std::max(it->second, other->second);
+          }
+        }
+        else
+        {
+          float d_b = (other != neighbours[b].end()) ? other->second : threshold;
+          merged[it->first] = (size_a * it->second + size_b * d_b) / (size_a + size_b);
+        }
+        neighbours[it->first].erase(a);
+      }
+      for (std::map<Size, float>::const_iterator it = neighbours[b].begin(); it != neighbours[b].end(); ++it)
+      {
+        if (it->first == a)
+        {
+          continue;
+        }
+        if (linkage == AVERAGE_LINKAGE && neighbours[a].find(it->first) == neighbours[a].end())
+        {
+          merged[it->first] = (size_a * threshold + size_b * it->second) / (size_a + size_b);
+        }
+        neighbours[it->first].erase(b);
+      }
+
+      Size merged_id = std::min(a, b);
+      neighbours[a].clear();
+      neighbours[b].clear();
+      for (std::map<Size, float>::const_iterator it = merged.begin(); it != merged.end(); ++it)
+      {
+        if (it->second < threshold)
+        {
+          neighbours[merged_id][it->first] = it->second;
+          neighbours[it->first][merged_id] = it->second;
+        }
+      }
+      cluster_size[merged_id] = size_a + size_b;
+    }
+
+    // NN-chain merges are not ordered, but the dendrogram is monotone for these linkages
+    std::stable_sort(merges.begin(), merges.end(),
+                     [](const SparseDistance& a, const SparseDistance& b) { return a.distance < b.distance; });
+    for (std::vector<SparseDistance>::const_iterator it = merges.begin(); it != merges.end(); ++it)
+    {
+      Size a = sets.find(it->first), b = sets.find(it->second);
+      cluster_tree.push_back(BinaryTreeNode(std::min(a, b), std::max(a, b), it->distance));
+      sets.join(a, b);
+    }
+    addDummyNodes_(sets, cluster_tree);
+  }
+
   UnnormalizedComparator::UnnormalizedComparator(const char * file, int line, const char * function, const char * message) throw() :
     BaseException(file, line, function, "ClusterHierarchical::UnnormalizedComparator", message)
   {
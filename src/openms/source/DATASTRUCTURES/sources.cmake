@@ -4,6 +4,7 @@ set(directory source/DATASTRUCTURES)
 ### list all filenames of the directory here
 set(sources_list
 Adduct.cpp
+AtomicSnapshot.cpp
 BinaryTreeNode.cpp
 CalibrationData.cpp
 ChargePair.cpp
@@ -33,7 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternTable.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 
@@ -370,11 +370,10 @@ namespace OpenMS
 
   double FeatureFindingMetabo::computeAveragineSimScore_(const std::vector<double>& hypo_ints, const double& mol_weight) const
   {
-    CoarseIsotopePatternGenerator solver(hypo_ints.size());
-    auto isodist = solver.estimateFromPeptideWeight(mol_weight);
-    // isodist.renormalize();
+    // precomputed averagine patterns (impossible isotopes of small molecules are reported as zero)
+    std::vector<double> averagine_dist;
+    CoarseIsotopePatternTable::getDefaultTable().getIntensities(mol_weight, hypo_ints.size(), averagine_dist);
 
-    IsotopeDistribution::ContainerType averagine_dist = isodist.getContainer();
     double max_int(0.0), theo_max_int(0.0);
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
@@ -383,9 +382,9 @@ namespace OpenMS
         max_int = hypo_ints[i];
       }
 
-      if (averagine_dist[i].getIntensity() > theo_max_int)
+      if (averagine_dist[i] > theo_max_int)
       {
-        theo_max_int = averagine_dist[i].getIntensity();
+        theo_max_int = averagine_dist[i];
       }
     }
 
@@ -393,7 +392,7 @@ namespace OpenMS
     std::vector<double> averagine_ratios, hypo_isos;
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
-      averagine_ratios.push_back(averagine_dist[i].getIntensity() / theo_max_int);
+      averagine_ratios.push_back(averagine_dist[i] / theo_max_int);
       hypo_isos.push_back(hypo_ints[i] / max_int);
     }
 
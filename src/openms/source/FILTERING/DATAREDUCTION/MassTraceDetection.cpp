@@ -41,7 +41,8 @@
 namespace OpenMS
 {
     MassTraceDetection::MassTraceDetection() :
-            DefaultParamHandler("MassTraceDetection"), ProgressLogger()
+            DefaultParamHandler("MassTraceDetection"), ProgressLogger(),
+            stream_peak_count_(0)
     {
       defaults_.setValue("mass_error_ppm", 20.0, "Allowed mass deviation (in ppm).");
       defaults_.setValue("noise_threshold_int", 10.0, "Intensity threshold below which peaks are removed as noise.");
@@ -200,51 +201,15 @@ namespace OpenMS
 
       Size total_peak_count(0);
       std::vector<Size> spec_offsets;
-      spec_offsets.push_back(0);
-
-      Size spectra_count(0);
 
       // *********************************************************** //
       //  Step 1: Detecting potential chromatographic apices
       // *********************************************************** //
       for (PeakMap::ConstIterator it = input_exp.begin(); it != input_exp.end(); ++it)
       {
-        // check if this is a MS1 survey scan
-        if (it->getMSLevel() != 1) continue;
-
-        std::vector<Size> indices_passing;
-        for (Size peak_idx = 0; peak_idx < it->size(); ++peak_idx)
-        {
-          double tmp_peak_int((*it)[peak_idx].getIntensity());
-          if (tmp_peak_int > noise_threshold_int_)
-          {
-            // Assume that noise_threshold_int_ contains the noise level of the
-            // data and we want to be chrom_peak_snr times above the noise level
-            // --> add this peak as possible chromatographic apex
-            if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
-            {
-              chrom_apices.insert(std::make_pair(tmp_peak_int, std::make_pair(spectra_count, indices_passing.size())));
-            }
-            indices_passing.push_back(peak_idx);
-            ++total_peak_count;
-          }
-        }
-        PeakMap::SpectrumType tmp_spec(*it);
-        tmp_spec.select(indices_passing);
-        work_exp.addSpectrum(tmp_spec);
-        spec_offsets.push_back(spec_offsets.back() + tmp_spec.size());
-        ++spectra_count;
-      }
-
-      if (spectra_count < 3)
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                      "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(spectra_count));
+        addSpectrum_(*it, chrom_apices, total_peak_count, work_exp, spec_offsets);
       }
 
-      // discard last spectrum's offset
-      spec_offsets.pop_back();
-
       // *********************************************************************
       // Step 2: start extending mass traces beginning with the apex peak (go
       // through all peaks in order of decreasing intensity)
@@ -254,6 +219,75 @@ namespace OpenMS
       return;
     } // end of MassTraceDetection::run
 
+    void MassTraceDetection::addSpectrum(const MSSpectrum& spectrum)
+    {
+      addSpectrum_(spectrum, stream_apices_, stream_peak_count_, stream_exp_, stream_offsets_);
+    }
+
+    void MassTraceDetection::run(std::vector<MassTrace>& found_masstraces, const Size max_traces)
+    {
+      found_masstraces.clear();
+
+      // discard the collected data also if run_ throws:
+      MapIdxSortedByInt chrom_apices;
+      PeakMap work_exp;
+      std::vector<Size> spec_offsets;
+      Size total_peak_count = stream_peak_count_;
+      chrom_apices.swap(stream_apices_);
+      work_exp.swap(stream_exp_);
+      spec_offsets.swap(stream_offsets_);
+      stream_peak_count_ = 0;
+
+      // spectra may have been added out of RT order - sort and collect again:
+      if (!work_exp.isSorted(false))
+      {
+        PeakMap unsorted;
+        unsorted.swap(work_exp);
+        unsorted.sortSpectra(false);
+        chrom_apices.clear();
+        spec_offsets.clear();
+        total_peak_count = 0;
+        for (PeakMap::ConstIterator it = unsorted.begin(); it != unsorted.end(); ++it)
+        {
+          addSpectrum_(*it, chrom_apices, total_peak_count, work_exp, spec_offsets);
+        }
+      }
+
+      run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces, max_traces);
+    }
+
+    void MassTraceDetection::addSpectrum_(const MSSpectrum& spectrum,
+                                          MapIdxSortedByInt& chrom_apices,
+                                          Size& peak_count,
+                                          PeakMap& work_exp,
+                                          std::vector<Size>& spec_offsets) const
+    {
+      // check if this is a MS1 survey scan
+      if (spectrum.getMSLevel() != 1) return;
+
+      std::vector<Size> indices_passing;
+      for (Size peak_idx = 0; peak_idx < spectrum.size(); ++peak_idx)
+      {
+        double tmp_peak_int(spectrum[peak_idx].getIntensity());
+        if (tmp_peak_int > noise_threshold_int_)
+        {
+          // Assume that noise_threshold_int_ contains the noise level of the
+          // data and we want to be chrom_peak_snr times above the noise level
+          // --> add this peak as possible chromatographic apex
+          if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
+          {
+            chrom_apices.insert(std::make_pair(tmp_peak_int, std::make_pair(work_exp.size(), indices_passing.size())));
+          }
+          indices_passing.push_back(peak_idx);
+        }
+      }
+      PeakMap::SpectrumType tmp_spec(spectrum);
+      tmp_spec.select(indices_passing);
+      spec_offsets.push_back(peak_count);
+      peak_count += tmp_spec.size();
+      work_exp.addSpectrum(std::move(tmp_spec));
+    }
+
     void MassTraceDetection::run_(const MapIdxSortedByInt& chrom_apices,
                                   const Size total_peak_count,
                                   const PeakMap& work_exp,
@@ -261,6 +295,12 @@ namespace OpenMS
                                   std::vector<MassTrace>& found_masstraces,
                                   const Size max_traces)
     {
+      if (work_exp.size() < 3)
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                      "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(work_exp.size()));
+      }
+
       boost::dynamic_bitset<> peak_visited(total_peak_count);
       Size trace_number(1);
 
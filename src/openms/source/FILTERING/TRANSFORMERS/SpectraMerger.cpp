@@ -35,6 +35,9 @@
 
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 
+#include <algorithm>
+#include <numeric>
+
 using namespace std;
 namespace OpenMS
 {
@@ -112,4 +115,84 @@ namespace OpenMS
     return *this;
   }
 
+  void SpectraMerger::clusterPrecursors_(const vector<BaseFeature>& data, vector<vector<Size> >& clusters) const
+  {
+    clusters.clear();
+    if (data.empty())
+    {
+      return;
+    }
+
+    SpectraDistance_ llc;
+    llc.setParameters(param_.copy("precursor_method:", true));
+    const double rt_max = param_.getValue("precursor_method:rt_tolerance");
+
+    // sweep over the precursors in RT order; only pairs within the RT tolerance can be similar
+    vector<Size> by_rt(data.size());
+    iota(by_rt.begin(), by_rt.end(), 0);
+    stable_sort(by_rt.begin(), by_rt.end(), [&data](Size a, Size b) { return data[a].getRT() < data[b].getRT(); });
+
+    // neighbours[k]: later elements (in RT order) linked to by_rt[k]
+    vector<vector<Size> > neighbours(by_rt.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+    for (SignedSize k = 0; k < (SignedSize)by_rt.size(); ++k)
+    {
+      const BaseFeature& first = data[by_rt[k]];
+      for (Size l = k + 1; l < by_rt.size(); ++l)
+      {
+        const BaseFeature& second = data[by_rt[l]];
+        if (second.getRT() - first.getRT() > rt_max)
+        {
+          break;
+        }
+        // same criterion as the dense clustering: linked if the (float) distance is below 1
+        float distance = 1 - llc(first, second);
+        if (distance < 1)
+        {
+          neighbours[k].push_back(by_rt[l]);
+        }
+      }
+    }
+
+    // connected components (union-find) == single linkage clusters cut at distance 1
+    vector<Size> parent(data.size());
+    iota(parent.begin(), parent.end(), 0);
+    auto find_root = [&parent](Size x)
+    {
+      while (parent[x] != x)
+      {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+      }
+      return x;
+    };
+    for (Size k = 0; k < by_rt.size(); ++k)
+    {
+      for (Size n : neighbours[k])
+      {
+        Size root_a = find_root(by_rt[k]), root_b = find_root(n);
+        if (root_a != root_b)
+        {
+          parent[max(root_a, root_b)] = min(root_a, root_b);
+        }
+      }
+      vector<Size>().swap(neighbours[k]);
+    }
+
+    // the root of each component is its smallest element, so clusters come out ordered by first element
+    vector<Size> cluster_of_root(data.size(), data.size());
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      Size root = find_root(i);
+      if (cluster_of_root[root] == data.size())
+      {
+        cluster_of_root[root] = clusters.size();
+        clusters.push_back(vector<Size>());
+      }
+      clusters[cluster_of_root[root]].push_back(i);
+    }
+  }
+
 }
@@ -0,0 +1,77 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataCompactingConsumer.h>
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <utility>
+
+namespace OpenMS
+{
+  MSDataCompactingConsumer::MSDataCompactingConsumer() {}
+
+  void MSDataCompactingConsumer::setExperimentalSettings(const ExperimentalSettings & settings)
+  {
+    exp_.setExperimentalSettings(settings); // only override the settings, keep the data
+  }
+
+  void MSDataCompactingConsumer::setExpectedSize(Size s_size, Size c_size)
+  {
+    exp_.reserve(s_size, c_size);
+  }
+
+  void MSDataCompactingConsumer::consumeSpectrum(SpectrumType & s)
+  {
+    exp_.addSpectrum(s);
+  }
+
+  void MSDataCompactingConsumer::consumeChromatogram(ChromatogramType & c)
+  {
+    exp_.addChromatogram(c);
+  }
+
+  const CompactMSExperiment& MSDataCompactingConsumer::getData() const
+  {
+    return exp_;
+  }
+
+  void MSDataCompactingConsumer::swapData(CompactMSExperiment& exp)
+  {
+    std::swap(exp_, exp);
+    exp_.clear();
+  }
+} // namespace OpenMS
+
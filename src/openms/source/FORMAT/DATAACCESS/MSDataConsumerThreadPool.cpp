@@ -0,0 +1,163 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataConsumerThreadPool.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace OpenMS
+{
+
+  MSDataConsumerThreadPool::MSDataConsumerThreadPool(Size nr_threads, Size max_queued_spectra) :
+    queued_(0),
+    max_queued_(0),
+    stop_(false)
+  {
+    nr_threads = std::max(nr_threads, Size(1));
+    max_queued_ = max_queued_spectra > 0 ? max_queued_spectra : 64 * nr_threads;
+    for (Size i = 0; i < nr_threads; ++i)
+    {
+      threads_.emplace_back(&MSDataConsumerThreadPool::work_, this);
+    }
+  }
+
+  MSDataConsumerThreadPool::~MSDataConsumerThreadPool()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_done_.wait(lock, [this] { return queued_ == 0; });
+      stop_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& t : threads_)
+    {
+      t.join();
+    }
+  }
+
+  void MSDataConsumerThreadPool::consumeSpectrum(Interfaces::IMSDataConsumer* consumer, const MSSpectrum& s)
+  {
+    MSSpectrum copy(s); // copy outside of the lock
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this] { return queued_ < max_queued_ || error_; });
+    if (error_) std::rethrow_exception(error_);
+
+    std::map<Interfaces::IMSDataConsumer*, Size>::const_iterator it = target_index_.find(consumer);
+    if (it == target_index_.end())
+    {
+      it = target_index_.insert(std::make_pair(consumer, targets_.size())).first;
+      targets_.push_back(Target());
+      targets_.back().consumer = consumer;
+      targets_.back().scheduled = false;
+    }
+
+    Target& target = targets_[it->second];
+    target.queue.push_back(std::move(copy));
+    ++queued_;
+    if (!target.scheduled)
+    {
+      target.scheduled = true;
+      ready_.push_back(it->second);
+      lock.unlock();
+      work_available_.notify_one();
+    }
+  }
+
+  void MSDataConsumerThreadPool::finish()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this] { return queued_ == 0; });
+    if (error_) std::rethrow_exception(error_);
+  }
+
+  Size MSDataConsumerThreadPool::getNrThreads() const
+  {
+    return threads_.size();
+  }
+
+  void MSDataConsumerThreadPool::work_()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      work_available_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+      if (ready_.empty()) break; // stopped and nothing left to do
+
+      Size index = ready_.front();
+      ready_.pop_front();
+      Interfaces::IMSDataConsumer* consumer = targets_[index].consumer;
+      std::deque<MSSpectrum> batch;
+      batch.swap(targets_[index].queue);
+      bool skip = bool(error_);
+      lock.unlock();
+
+      // write all spectra queued for this consumer so far (in order)
+      std::exception_ptr error;
+      if (!skip)
+      {
+        try
+        {
+          for (MSSpectrum& s : batch)
+          {
+            consumer->consumeSpectrum(s);
+          }
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+        }
+      }
+      Size nr_written = batch.size();
+      batch.clear();
+
+      lock.lock();
+      queued_ -= nr_written;
+      if (error && !error_) error_ = error;
+      if (targets_[index].queue.empty())
+      {
+        targets_[index].scheduled = false;
+      }
+      else
+      {
+        ready_.push_back(index); // more spectra arrived in the meantime
+        work_available_.notify_one();
+      }
+      work_done_.notify_all();
+    }
+  }
+
+} // namespace OpenMS
+
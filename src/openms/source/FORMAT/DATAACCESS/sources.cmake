@@ -9,6 +9,8 @@ set(sources_list
   MSDataAggregatingConsumer.cpp
   MSDataCachedConsumer.cpp
   MSDataChainingConsumer.cpp
+  MSDataCompactingConsumer.cpp
+  MSDataConsumerThreadPool.cpp
   MSDataStoringConsumer.cpp
   MSDataSqlConsumer.cpp
   MSDataTransformingConsumer.cpp
@@ -42,6 +42,7 @@
 #include <OpenMS/CONCEPT/UniqueIdGenerator.h>
 #include <OpenMS/CONCEPT/VersionInfo.h>
 #include <OpenMS/CHEMISTRY/CrossLinksDB.h>
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
@@ -58,7 +59,11 @@ namespace OpenMS
       logger_(logger),
       //~ ms_exp_(0),
       id_(nullptr),
-      cid_(&id)
+      pro_id_(nullptr),
+      pep_id_(nullptr),
+      cid_(&id),
+      cpro_id_(nullptr),
+      cpep_id_(nullptr)
     {
       cv_.loadFromOBO("PSI-MS", File::find("/CV/psi-ms.obo"));
       unimod_.loadFromOBO("PSI-MS", File::find("/CV/unimod.obo"));
@@ -69,7 +74,11 @@ namespace OpenMS
       logger_(logger),
       //~ ms_exp_(0),
       id_(&id),
-      cid_(nullptr)
+      pro_id_(nullptr),
+      pep_id_(nullptr),
+      cid_(nullptr),
+      cpro_id_(nullptr),
+      cpep_id_(nullptr)
     {
       cv_.loadFromOBO("PSI-MS", File::find("/CV/psi-ms.obo"));
       unimod_.loadFromOBO("PSI-MS", File::find("/CV/unimod.obo"));
@@ -79,8 +88,10 @@ namespace OpenMS
       XMLHandler(filename, version),
       logger_(logger),
       //~ ms_exp_(0),
+      id_(nullptr),
       pro_id_(nullptr),
       pep_id_(nullptr),
+      cid_(nullptr),
       cpro_id_(&pro_id),
       cpep_id_(&pep_id)
     {
@@ -92,8 +103,10 @@ namespace OpenMS
       XMLHandler(filename, version),
       logger_(logger),
       //~ ms_exp_(0),
+      id_(nullptr),
       pro_id_(&pro_id),
       pep_id_(&pep_id),
+      cid_(nullptr),
       cpro_id_(nullptr),
       cpep_id_(nullptr)
     {
@@ -124,6 +137,17 @@ namespace OpenMS
       tag_ = sm_.convert(qname);
       open_tags_.push_back(tag_);
 
+      if (pep_id_ != nullptr)
+      {
+        String parent_tag;
+        if (open_tags_.size() > 1)
+        {
+          parent_tag = *(open_tags_.end() - 2);
+        }
+        startInternalElement_(parent_tag, attributes);
+        return;
+      }
+
       static set<String> to_ignore;
       if (to_ignore.empty())
       {
@@ -266,6 +290,16 @@ namespace OpenMS
 
     void MzIdentMLHandler::characters(const XMLCh* const chars, const XMLSize_t /*length*/)
     {
+      if (pep_id_ != nullptr)
+      {
+        // character data is only of interest inside of Seq and PeptideSequence (lower case in mzIdentML 1.0), which may come in several chunks
+        if (!open_tags_.empty() && (open_tags_.back() == "Seq" || open_tags_.back() == "PeptideSequence" || open_tags_.back() == "peptideSequence"))
+        {
+          current_text_ += sm_.convert(chars);
+        }
+        return;
+      }
+
       if (tag_ == "Customizations")
       {
         String customizations = sm_.convert(chars);
@@ -302,6 +336,12 @@ namespace OpenMS
       tag_ = sm_.convert(qname);
       open_tags_.pop_back();
 
+      if (pep_id_ != nullptr)
+      {
+        endInternalElement_();
+        return;
+      }
+
       if (to_ignore.find(tag_) != to_ignore.end())
       {
         return;
@@ -383,181 +423,1315 @@ namespace OpenMS
       }
     }
 
-    void MzIdentMLHandler::writeTo(std::ostream& os)
+    bool MzIdentMLHandler::isCrossLinkingSearch() const
     {
-      String cv_ns = cv_.name();
-      String inputs_element;
-      std::map<String,String> /* peps, pepevis, */ sil_map, sil_2_date;
-      std::set<String> sen_set, sof_set, sip_set;
-      std::map<String, String> sdb_ids, sen_ids, sof_ids, sdat_ids, pep_ids;
-      //std::map<String, String> pep_pairs_ppxl;
-      std::map<String, double> pp_identifier_2_thresh;
-      //std::vector< std::pair<String, String> > pepid_pairs_ppxl;
+      return xl_ms_search_;
+    }
 
-      // file type-specific definitions needed for SpectraData element:
-      std::map<FileTypes::Type, std::pair<String, String> > formats_map;
-      formats_map[FileTypes::MZML] = make_pair("mzML format", "mzML unique identifier");
-      formats_map[FileTypes::MZXML] = make_pair("ISB mzXML format", "scan number only nativeID format");
-      formats_map[FileTypes::MZDATA] = make_pair("PSI mzData format", "spectrum identifier nativeID format");
-      formats_map[FileTypes::MGF] = make_pair("Mascot MGF format", "multiple peak list nativeID format");
+    void MzIdentMLHandler::startInternalElement_(const String& parent_tag, const xercesc::Attributes& attributes)
+    {
+      if (tag_ == "cvParam")
+      {
+        handleInternalCVParam_(parent_tag, parseCvParam_(attributes));
+        return;
+      }
 
+      if (tag_ == "userParam")
+      {
+        pair<String, DataValue> up = parseUserParam_(attributes);
+        handleInternalUserParam_(parent_tag, up.first, up.second);
+        return;
+      }
 
-      //TODO if constructed with a msexperiment - not yet implemented
-      //~ if(ms_exp_ == 0)
-      //~ {
-      //~ synthesize spectrum references
-      //~ }
-      //~ else
-      //~ {
-      //~ extract peptide and proteinid from msexperiment
-      //~ genereate spectrum references from msexperiment foreach peptideidentification
-      //~ }
+      if (tag_ == "MzIdentML")
+      {
+        cv_.getAllChildTerms(software_terms_, "MS:1000531"); // analysis software
+        cv_.getAllChildTerms(enzyme_terms_, "MS:1001045"); // cleavage agent name
+        cv_.getAllChildTerms(threshold_terms_, "MS:1002482"); // statistical threshold
+        cv_.getAllChildTerms(q_score_terms_, "MS:1002354"); // q-value for peptides
+        cv_.getAllChildTerms(e_score_terms_, "MS:1001872");
+        cv_.getAllChildTerms(e_score_terms_, "MS:1002353"); // E-value for peptides
+        cv_.getAllChildTerms(specific_score_terms_, "MS:1001143"); // search engine specific score for PSMs
+        return;
+      }
 
-      /*---------------------------------------------------------------------
-      DataCollection:
-      +Inputs
-      -AnalysisData collected in sidlist --> unclosed element string
-      ---------------------------------------------------------------------*/
-      inputs_element += String("\t<Inputs>\n");
-      String spectra_data, search_database;
+      // AnalysisSoftwareList
+      if (tag_ == "AnalysisSoftware")
+      {
+        current_id_ = attributeAsString_(attributes, "id");
+        current_version_ = "";
+        optionalAttributeAsString_(current_version_, attributes, "version");
+        current_name_ = "";
+        current_user_name_ = "";
+        current_user_name_final_ = false;
+        return;
+      }
 
-      /*
-      1st: iterate over proteinidentification vector
-      */
-      //TODO read type of crosslink reagens from settings
-      bool is_ppxl = false;
-      for (std::vector<ProteinIdentification>::const_iterator it = cpro_id_->begin(); it != cpro_id_->end(); ++it)
+      // SequenceCollection
+      if (tag_ == "DBSequence")
       {
-        //~ collect analysissoftware in this loop - does not go into inputelement
-        String sof_id;
-        String sof_name = String(it->getSearchEngine());
-        std::map<String, String>::iterator soit = sof_ids.find(sof_name);
-        String osecv;
-        if (sof_name == "OMSSA")
-        {
-          osecv = "OMSSA";
-        }
-        else if (sof_name == "Mascot")
+        current_id_ = attributeAsString_(attributes, "id");
+        current_name_ = "";
+        optionalAttributeAsString_(current_name_, attributes, "accession");
+        current_text_ = "";
+        return;
+      }
+
+      if (tag_ == "Peptide")
+      {
+        current_id_ = attributeAsString_(attributes, "id");
+        current_name_ = "";
+        optionalAttributeAsString_(current_name_, attributes, "name");
+        current_text_ = "";
+        current_substitutions_.clear();
+        current_modifications_.clear();
+        return;
+      }
+
+      if (tag_ == "Modification" && parent_tag == "Peptide")
+      {
+        PeptideModificationRecord mod;
+        mod.location = -2;
+        String location;
+        optionalAttributeAsString_(location, attributes, "location");
+        try
         {
-          osecv = "Mascot";
+          mod.location = static_cast<SignedSize>(location.toInt());
         }
-        else if (sof_name == "XTandem")
+        catch (...)
         {
-          osecv = "X\\!Tandem";
+          OPENMS_LOG_WARN << "Found unreadable modification location." << endl;
         }
-        else if (sof_name == "SEQUEST")
+        optionalAttributeAsString_(mod.mass_delta, attributes, "monoisotopicMassDelta");
+        current_modifications_.push_back(mod);
+        return;
+      }
+
+      if (tag_ == "SubstitutionModification")
+      {
+        SubstitutionRecord sub;
+        String original, replacement;
+        optionalAttributeAsString_(sub.location, attributes, "location");
+        optionalAttributeAsString_(original, attributes, "originalResidue");
+        optionalAttributeAsString_(replacement, attributes, "replacementResidue");
+        sub.original = original.empty() ? '\0' : original[0];
+        sub.replacement = replacement.empty() ? '\0' : replacement[0];
+        current_substitutions_.push_back(sub);
+        return;
+      }
+
+      if (tag_ == "PeptideEvidence")
+      {
+        // <PeptideEvidence peptide_ref="peptide_1_1" id="PE_1_1_HSP70_ECHGR_0" start="161" end="172" pre="K" post="I" isDecoy="false" dBSequence_ref="DBSeq_HSP70_ECHGR"/>
+        String peptide_ref, db_sequence_ref;
+        optionalAttributeAsString_(peptide_ref, attributes, "peptide_ref");
+        optionalAttributeAsString_(db_sequence_ref, attributes, "dBSequence_ref");
+
+        PeptideEvidenceRecord pev;
+        // Peptide elements precede the PeptideEvidence elements; keep unknown references resolvable with an empty sequence
+        pair<unordered_map<String, Size>::iterator, bool> pep_it = peptide_index_.insert(make_pair(peptide_ref, peptides_.size()));
+        if (pep_it.second)
         {
-          osecv = "Sequest";
+          peptides_.push_back(AASequence());
         }
-        else if (sof_name == "MS-GF+")
+        pev.peptide = pep_it.first->second;
+
+        unordered_map<String, Size>::const_iterator db_it = db_sequence_index_.find(db_sequence_ref);
+        pev.db_sequence = (db_it != db_sequence_index_.end()) ? db_it->second : numeric_limits<Size>::max();
+
+        //rest is optional !!
+        pev.start = PeptideEvidence::UNKNOWN_POSITION;
+        pev.end = PeptideEvidence::UNKNOWN_POSITION;
+        String start, end;
+        optionalAttributeAsString_(start, attributes, "start");
+        optionalAttributeAsString_(end, attributes, "end");
+        try
         {
-          osecv = "MS-GF+";
+          pev.start = start.toInt();
+          pev.end = end.toInt();
         }
-        else if (sof_name == "Percolator")
+        catch (...)
         {
-          osecv = "Percolator";
+          OPENMS_LOG_WARN << "'PeptideEvidence' without reference to the position in the originating sequence found." << endl;
         }
-        else if (sof_name == "OpenPepXL")
+
+        String aa;
+        pev.pre = (optionalAttributeAsString_(aa, attributes, "pre") && !aa.empty()) ? aa[0] : '-';
+        pev.post = (optionalAttributeAsString_(aa, attributes, "post") && !aa.empty()) ? aa[0] : '-';
+
+        String decoy;
+        optionalAttributeAsString_(decoy, attributes, "isDecoy");
+        pev.is_decoy = decoy.hasPrefix('t') || decoy.hasPrefix('1');
+
+        evidences_.push_back(pev);
+        return;
+      }
+
+      // AnalysisCollection
+      if (tag_ == "SpectrumIdentification")
+      {
+        current_si_ = SpectrumIdentificationRecord();
+        current_si_.protocol_ref = attributeAsString_(attributes, "spectrumIdentificationProtocol_ref");
+        current_ref_ = attributeAsString_(attributes, "spectrumIdentificationList_ref");
+        current_date_ = "";
+        optionalAttributeAsString_(current_date_, attributes, "activityDate");
+        return;
+      }
+
+      if (tag_ == "InputSpectra")
+      {
+        optionalAttributeAsString_(current_si_.spectra_data_ref, attributes, "spectraData_ref");
+        return;
+      }
+
+      if (tag_ == "SearchDatabaseRef")
+      {
+        optionalAttributeAsString_(current_si_.search_database_ref, attributes, "searchDatabase_ref");
+        return;
+      }
+
+      // AnalysisProtocolCollection
+      if (tag_ == "SpectrumIdentificationProtocol")
+      {
+        current_id_ = attributeAsString_(attributes, "id");
+        current_ref_ = "";
+        optionalAttributeAsString_(current_ref_, attributes, "analysisSoftware_ref");
+        current_search_parameters_ = ProteinIdentification::SearchParameters();
+        current_threshold_ = CVTermList();
+        current_precursor_tolerance_ = 0.0;
+        current_fragment_tolerance_ = 0.0;
+        return;
+      }
+
+      if (tag_ == "SearchModification")
+      {
+        current_mod_residues_ = "";
+        optionalAttributeAsString_(current_mod_residues_, attributes, "residues");
+        String fixed;
+        optionalAttributeAsString_(fixed, attributes, "fixedMod");
+        current_mod_fixed_ = (fixed == "true" || fixed == "1");
+        current_name_ = "";
+        current_mod_specificities_.clear();
+        return;
+      }
+
+      if (tag_ == "Enzyme")
+      {
+        String missed_cleavages_string;
+        optionalAttributeAsString_(missed_cleavages_string, attributes, "missedCleavages");
+        int missed_cleavages = -1;
+        try
         {
-          osecv = "OpenPepXL";
+          missed_cleavages = boost::lexical_cast<int>(std::string(missed_cleavages_string));
         }
-        else if (cv_.hasTermWithName(sof_name))
+        catch (exception& e)
         {
-          osecv = sof_name;
+          OPENMS_LOG_WARN << "Search engine enzyme settings for 'missedCleavages' unreadable: " << e.what() << missed_cleavages_string << endl;
         }
-        else
+        current_search_parameters_.missed_cleavages = missed_cleavages;
+        current_name_ = "UNKNOWN";
+        return;
+      }
+
+      // DataCollection - Inputs
+      if (tag_ == "SearchDatabase")
+      {
+        current_id_ = attributeAsString_(attributes, "id");
+        current_ref_ = "";
+        optionalAttributeAsString_(current_ref_, attributes, "location");
+        current_version_ = "";
+        optionalAttributeAsString_(current_version_, attributes, "version");
+        current_name_ = "";
+        return;
+      }
+
+      if (tag_ == "SpectraData")
+      {
+        String location;
+        optionalAttributeAsString_(location, attributes, "location");
+        spectra_data_map_.insert(make_pair(attributeAsString_(attributes, "id"), location));
+        return;
+      }
+
+      // DataCollection - AnalysisData
+      if (tag_ == "SpectrumIdentificationList")
+      {
+        String id = attributeAsString_(attributes, "id");
+        map<String, Size>::const_iterator sil_it = sil_protein_index_.find(id);
+        if (sil_it != sil_protein_index_.end())
         {
-          osecv = "analysis software";
+          current_protein_index_ = sil_it->second;
         }
-
-        if (soit == sof_ids.end())
+        else if (!spectrum_identifications_.empty())
         {
-          sof_id = "SOF_" + String(UniqueIdGenerator::getUniqueId());
-          //~ TODO consider not only searchengine but also version!
-          String sost = String("\t<AnalysisSoftware version=\"") + String(it->getSearchEngineVersion()) + String("\" name=\"") + sof_name +  String("\" id=\"") + sof_id + String("\">\n") + String("\t\t<SoftwareName>\n");
-          sost += "\t\t\t" + cv_.getTermByName(osecv).toXMLString(cv_ns);
-          sost += String("\n\t\t</SoftwareName>\n\t</AnalysisSoftware>\n");
-          sof_set.insert(sost);
-          sof_ids.insert(make_pair(sof_name, sof_id));
+          warning(LOAD, String("No SpectrumIdentification references SpectrumIdentificationList '") + id + "', assigning its results to the first one.");
+          current_protein_index_ = spectrum_identifications_.front().protein_index;
         }
         else
         {
-          sof_id = soit->second;
+          fatalError(LOAD, "No SpectrumIdentification nodes");
         }
+        return;
+      }
 
-        if (it->metaValueExists("is_cross_linking_experiment") ||
-                (it->metaValueExists("SpectrumIdentificationProtocol") &&
-                it->getMetaValue("SpectrumIdentificationProtocol") == "MS:1002494"))
+      if (tag_ == "SpectrumIdentificationResult")
+      {
+        pep_id_->push_back(PeptideIdentification());
+        pep_id_->back().setHigherScoreBetter(false); //either a q-value or an e-value, only if neither available there will be another
+        pep_id_->back().setMetaValue("spectrum_reference", attributeAsString_(attributes, "spectrumID"));
+        current_result_cvs_ = CVTermList();
+        current_result_ups_.clear();
+        return;
+      }
+
+      if (tag_ == "SpectrumIdentificationItem")
+      {
+        //  <SpectrumIdentificationItem id="SII_1_1"  calculatedMassToCharge="670.86261" chargeState="2" experimentalMassToCharge="671.9" Peptide_ref="peptide_1_1" rank="1" passThreshold="true">
+        current_ref_ = "";
+        optionalAttributeAsString_(current_ref_, attributes, "peptide_ref");
+
+        current_item_calc_mz_ = 0.0;
+        optionalAttributeAsDouble_(current_item_calc_mz_, attributes, "calculatedMassToCharge");
+        current_item_exp_mz_ = 0.0;
+        optionalAttributeAsDouble_(current_item_exp_mz_, attributes, "experimentalMassToCharge");
+
+        String value;
+        current_item_charge_ = 0;
+        optionalAttributeAsString_(value, attributes, "chargeState");
+        try
         {
-          is_ppxl = true;  //needed as incoming data is structured differently and output deviates as well for ppxl
-          // ppxl is like (1PeptideIdentification, 1-2 PeptideHits) but there might be more PeptideIdentifications for one spectrum
+          current_item_charge_ = value.toInt();
+        }
+        catch (...)
+        {
+          OPENMS_LOG_WARN << "Found unreadable 'chargeState'." << endl;
         }
 
-        String thcv;
-        pp_identifier_2_thresh.insert(make_pair(it->getIdentifier(),it->getSignificanceThreshold()));
-        if (it->getSignificanceThreshold() != 0.0)
+        value = "";
+        current_item_rank_ = 0;
+        optionalAttributeAsString_(value, attributes, "rank");
+        try
         {
-          thcv = cv_.getTermByName("PSM-level statistical threshold").toXMLString(cv_ns, String(it->getSignificanceThreshold()));
+          current_item_rank_ = value.toInt();
         }
-        else
+        catch (...)
         {
-          thcv = cv_.getTermByName("no threshold").toXMLString(cv_ns);
+          OPENMS_LOG_WARN << "Found unreadable PSM rank." << endl;
         }
-        // TODO add other software than searchengine for evidence trace
 
-        // get a map from identifier to match OpenMS Protein/PeptideIdentification match string;
-        String sil_id =  "SIL_" + String(UniqueIdGenerator::getUniqueId());
-        pp_identifier_2_sil_.insert(make_pair(it->getIdentifier(), sil_id));
+        value = "";
+        optionalAttributeAsString_(value, attributes, "passThreshold");
+        current_item_pass_ = (value == "true" || value == "1");
 
-        //~ collect SpectrumIdentificationProtocol for analysisprotocol in this loop - does not go into inputelement
-        String sip_id = "SIP_" + String(UniqueIdGenerator::getUniqueId());
-        sil_2_sip_.insert(make_pair(sil_id, sip_id));
+        current_item_cvs_ = CVTermList();
+        current_item_ups_.clear();
+        return;
+      }
 
-        String sip = "\t<SpectrumIdentificationProtocol id=\"" + String(sip_id) + "\" analysisSoftware_ref=\"" + String(sof_id) + "\">\n";
-        sip += "\t\t<SearchType>\n\t\t\t" + cv_.getTermByName("ms-ms search").toXMLString(cv_ns) + "\n\t\t</SearchType>\n";
-        sip += "\t\t<AdditionalSearchParams>\n";
-        if (is_ppxl)
+      if (tag_ == "ProteinDetectionHypothesis")
+      {
+        if (pro_id_->empty())
         {
-          sip += "\n\t\t\t" + cv_.getTermByName("cross-linking search").toXMLString(cv_ns) + "\n";
+          return;
         }
-        //remove MS:1001029 written if present in <SearchDatabase> as of SearchDatabase_may rule
-        ProteinIdentification::SearchParameters search_params = it->getSearchParameters();
-        search_params.removeMetaValue("MS:1001029");
-        writeMetaInfos_(sip, search_params, 3);
-        sip += String(3, '\t') + "<userParam name=\"charges\" unitName=\"xsd:string\" value=\"" + search_params.charges + "\"/>\n";
-//        sip += String(3, '\t') + "<userParam name=\"" + "missed_cleavages" + "\" unitName=\"" + "xsd:integer" + "\" value=\"" + String(it->getSearchParameters().missed_cleavages) + "\"/>" + "\n";
-        sip += "\t\t</AdditionalSearchParams>\n";
-        // modifications:
-        if (search_params.fixed_modifications.empty() &&
-            search_params.variable_modifications.empty()
-            && (!is_ppxl)) // TODO some OpenPepXL modifications are not covered by the unimod.obo and cause problems in the search_params
+        String db_sequence_ref;
+        optionalAttributeAsString_(db_sequence_ref, attributes, "dBSequence_ref");
+        ProteinHit hit;
+        unordered_map<String, Size>::const_iterator db_it = db_sequence_index_.find(db_sequence_ref);
+        if (db_it != db_sequence_index_.end())
         {
-          // no modifications used or are they just missing from the parameters?
-          ModificationDefinitionsSet mod_defs;
-          mod_defs.inferFromPeptides(*cpep_id_);
-          mod_defs.getModificationNames(search_params.fixed_modifications,
-                                        search_params.variable_modifications);
+          hit.setSequence(db_sequences_[db_it->second].sequence);
+          hit.setAccession(db_sequences_[db_it->second].accession);
         }
-        if (!search_params.fixed_modifications.empty() ||
-            !search_params.variable_modifications.empty())
+        pro_id_->back().insertHit(hit);
+        return;
+      }
+
+      // all other elements carry no information for the internal identification structures
+    }
+
+    void MzIdentMLHandler::endInternalElement_()
+    {
+      if (tag_ == "AnalysisSoftware")
+      {
+        String name = current_name_.empty() ? current_user_name_ : current_name_;
+        if (!name.empty() && !current_version_.empty())
         {
-          sip += "\t\t<ModificationParams>\n";
-          writeModParam_(sip, search_params.fixed_modifications, true, 2);
-          writeModParam_(sip, search_params.variable_modifications, false, 2);
-          sip += "\t\t</ModificationParams>\n";
+          software_map_.insert(make_pair(current_id_, make_pair(name, current_version_)));
         }
-        writeEnzyme_(sip, search_params.digestion_enzyme, search_params.missed_cleavages, 2);
-        // TODO MassTable section
-        sip += String("\t\t<FragmentTolerance>\n");
-        String unit_str = "unitCvRef=\"UO\" unitName=\"dalton\" unitAccession=\"UO:0000221\"";
-        if (search_params.fragment_mass_tolerance_ppm)
+        else
         {
-          unit_str = "unitCvRef=\"UO\" unitName=\"parts per million\" unitAccession=\"UO:0000169\"";
+          OPENMS_LOG_ERROR << "No name/version found for 'AnalysisSoftware':" << current_id_ << "." << endl;
         }
-        sip += String(3, '\t') + "<cvParam accession=\"MS:1001412\" name=\"search tolerance plus value\" " + unit_str + " cvRef=\"PSI-MS\" value=\"" + String(search_params.fragment_mass_tolerance) + "\"/>\n";
-        sip += String(3, '\t') + "<cvParam accession=\"MS:1001413\" name=\"search tolerance minus value\" " + unit_str + " cvRef=\"PSI-MS\" value=\"" + String(search_params.fragment_mass_tolerance) + "\"/>\n";
-        sip += String("\t\t</FragmentTolerance>\n");
-        sip += String("\t\t<ParentTolerance>\n");
+        return;
+      }
+
+      if (tag_ == "DBSequence")
+      {
+        if (!current_name_.empty() && db_sequence_index_.insert(make_pair(current_id_, db_sequences_.size())).second)
+        {
+          DBSequenceRecord db;
+          db.accession = current_name_;
+          db.sequence = current_text_;
+          db_sequences_.push_back(db);
+        }
+        current_text_ = "";
+        return;
+      }
+
+      if (tag_ == "Peptide")
+      {
+        AASequence aas;
+        try
+        {
+          try
+          {
+            aas = buildPeptideSequence_();
+          }
+          catch (Exception::MissingInformation&)
+          {
+            // We found an unknown modification, we could try to rescue this
+            // situation. The "name" attribute, if present, may be parsable:
+            //   The potentially ambiguous common identifier, such as a
+            //   human-readable name for the instance.
+            if (!current_name_.empty()) aas = AASequence::fromString(current_name_);
+          }
+        }
+        catch (...)
+        {
+          OPENMS_LOG_ERROR << "No amino acid sequence readable from 'Peptide'" << endl;
+        }
+        if (peptide_index_.insert(make_pair(current_id_, peptides_.size())).second)
+        {
+          peptides_.push_back(aas);
+        }
+        current_text_ = "";
+        return;
+      }
+
+      if (tag_ == "SequenceCollection")
+      {
+        indexPeptideEvidences_();
+        return;
+      }
+
+      if (tag_ == "SpectrumIdentification")
+      {
+        // SpectrumIdentification will be the new identification runs (ProteinIdentification)
+        current_si_.protein_index = pro_id_->size();
+        pro_id_->push_back(ProteinIdentification());
+        if (!current_date_.empty())
+        {
+          pro_id_->back().setDateTime(DateTime::fromString(current_date_.toQString(), "yyyy-MM-ddThh:mm:ss"));
+        }
+        else
+        {
+          pro_id_->back().setDateTime(DateTime::now());
+        }
+        pro_id_->back().setIdentifier(UniqueIdGenerator::getUniqueId()); // no more identification wit engine/date/time!
+        sil_protein_index_.insert(make_pair(current_ref_, current_si_.protein_index));
+        spectrum_identifications_.push_back(current_si_);
+        return;
+      }
+
+      if (tag_ == "SearchModification")
+      {
+        if (!current_name_.empty())
+        {
+          String mod;
+          String r = (current_mod_residues_ != ".") ? current_mod_residues_ : "";
+          if (!current_mod_specificities_.empty())
+          {
+            for (set<String>::const_iterator spec = current_mod_specificities_.begin(); spec != current_mod_specificities_.end(); ++spec)
+            {
+              if (*spec == "MS:1001189") // nterm
+              {
+                mod = ModificationsDB::getInstance()->getModification(current_name_, r, ResidueModification::N_TERM)->getFullId();
+              }
+              else if (*spec == "MS:1001190") // cterm
+              {
+                mod = ModificationsDB::getInstance()->getModification(current_name_, r, ResidueModification::C_TERM)->getFullId();
+              }
+              else if (*spec == "MS:1002057") // pro nterm
+              {
+                // TODO: add support for protein N-terminal modifications in unimod
+                mod = ModificationsDB::getInstance()->getModification(current_name_, r, ResidueModification::N_TERM)->getFullId();
+              }
+              else if (*spec == "MS:1002058") // pro cterm
+              {
+                // TODO: add support for protein C-terminal modifications in unimod
+                mod = ModificationsDB::getInstance()->getModification(current_name_, r, ResidueModification::C_TERM)->getFullId();
+              }
+            }
+          }
+          else // anywhere
+          {
+            mod = ModificationsDB::getInstance()->getModification(current_name_, r)->getFullId();
+          }
+
+          if (current_mod_fixed_)
+          {
+            current_search_parameters_.fixed_modifications.push_back(mod);
+          }
+          else
+          {
+            current_search_parameters_.variable_modifications.push_back(mod);
+          }
+        }
+        return;
+      }
+
+      if (tag_ == "Enzyme")
+      {
+        if (ProteaseDB::getInstance()->hasEnzyme(current_name_))
+        {
+          current_search_parameters_.digestion_enzyme = *(ProteaseDB::getInstance()->getEnzyme(current_name_));
+        }
+        return;
+      }
+
+      if (tag_ == "SpectrumIdentificationProtocol")
+      {
+        double thresh = 0.0;
+        bool use_thresh = false;
+        for (Map<String, vector<CVTerm> >::const_iterator thit = current_threshold_.getCVTerms().begin(); thit != current_threshold_.getCVTerms().end(); ++thit)
+        {
+          if (threshold_terms_.find(thit->first) != threshold_terms_.end())
+          {
+            if (thit->first != "MS:1001494") // no threshold
+            {
+              thresh = thit->second.front().getValue().toString().toDouble();
+              use_thresh = true;
+            }
+            break;
+          }
+        }
+
+        String search_engine, search_engine_version;
+        map<String, pair<String, String> >::const_iterator sw_it = software_map_.find(current_ref_);
+        if (sw_it != software_map_.end())
+        {
+          search_engine = sw_it->second.first;
+          search_engine_version = sw_it->second.second;
+        }
+
+        // the SpectrumIdentification elements (and with them the ProteinIdentifications) precede the protocols
+        for (vector<SpectrumIdentificationRecord>::const_iterator si_it = spectrum_identifications_.begin(); si_it != spectrum_identifications_.end(); ++si_it)
+        {
+          if (si_it->protocol_ref != current_id_)
+          {
+            continue;
+          }
+          ProteinIdentification& protein_id = (*pro_id_)[si_it->protein_index];
+          protein_id.setSearchEngine(search_engine);
+          protein_id.setSearchEngineVersion(search_engine_version);
+          ProteinIdentification::SearchParameters sp = current_search_parameters_;
+          sp.db = protein_id.getSearchParameters().db;
+          sp.db_version = protein_id.getSearchParameters().db_version;
+          protein_id.setSearchParameters(sp);
+          if (use_thresh)
+          {
+            protein_id.setSignificanceThreshold(thresh);
+          }
+        }
+        return;
+      }
+
+      if (tag_ == "SearchDatabase")
+      {
+        if (current_name_.empty())
+        {
+          OPENMS_LOG_WARN << "No DatabaseName element found, use read in results at own risk." << endl;
+        }
+        database_map_.insert(make_pair(current_id_, make_pair(current_ref_, current_version_)));
+        return;
+      }
+
+      if (tag_ == "Inputs")
+      {
+        // the input references of the SpectrumIdentification elements can only be resolved now
+        for (vector<SpectrumIdentificationRecord>::const_iterator si_it = spectrum_identifications_.begin(); si_it != spectrum_identifications_.end(); ++si_it)
+        {
+          ProteinIdentification& protein_id = (*pro_id_)[si_it->protein_index];
+          ProteinIdentification::SearchParameters sp = protein_id.getSearchParameters();
+          const pair<String, String>& db = database_map_[si_it->search_database_ref];
+          sp.db = db.first;
+          sp.db_version = db.second;
+          protein_id.setSearchParameters(sp);
+
+          // internally we store a list of files so convert the mzIdentML file String to a StringList
+          StringList spectra_data_list;
+          spectra_data_list.push_back(spectra_data_map_[si_it->spectra_data_ref]);
+          protein_id.setMetaValue("spectra_data", spectra_data_list);
+        }
+        return;
+      }
+
+      if (tag_ == "SpectrumIdentificationItem")
+      {
+        buildPeptideHit_();
+        return;
+      }
+
+      if (tag_ == "SpectrumIdentificationResult")
+      {
+        PeptideIdentification& pep_id = pep_id_->back();
+        pep_id.setIdentifier((*pro_id_)[current_protein_index_].getIdentifier());
+        pep_id.sortByRank();
+
+        //adopt cv s
+        for (Map<String, vector<CVTerm> >::const_iterator cvit = current_result_cvs_.getCVTerms().begin(); cvit != current_result_cvs_.getCVTerms().end(); ++cvit)
+        {
+          // check for retention time or scan time entry
+          if (cvit->first == "MS:1000894" || cvit->first == "MS:1000016") //TODO use subordinate terms which define units
+          {
+            double rt = cvit->second.front().getValue().toString().toDouble();
+            if (cvit->second.front().getUnit().accession == "UO:0000031") // minutes
+            {
+              rt *= 60.0;
+            }
+            pep_id.setRT(rt);
+          }
+          else
+          {
+            pep_id.setMetaValue(cvit->first, cvit->second.front().getValue());
+          }
+        }
+        //adopt up s
+        for (map<String, DataValue>::const_iterator upit = current_result_ups_.begin(); upit != current_result_ups_.end(); ++upit)
+        {
+          pep_id.setMetaValue(upit->first, upit->second);
+        }
+        if (pep_id.getRT() != pep_id.getRT())
+        {
+          OPENMS_LOG_WARN << "No retention time found for 'SpectrumIdentificationResult'" << endl;
+        }
+        return;
+      }
+
+      if (tag_ == "MzIdentML")
+      {
+        if (spectrum_identifications_.empty())
+        {
+          fatalError(LOAD, "No SpectrumIdentification nodes");
+        }
+        for (vector<ProteinIdentification>::iterator it = pro_id_->begin(); it != pro_id_->end(); ++it)
+        {
+          it->sort();
+        }
+        return;
+      }
+    }
+
+    void MzIdentMLHandler::handleInternalCVParam_(const String& parent_tag, const CVTerm& term)
+    {
+      if (parent_tag == "SpectrumIdentificationItem")
+      {
+        current_item_cvs_.addCVTerm(term);
+      }
+      else if (parent_tag == "SpectrumIdentificationResult")
+      {
+        current_result_cvs_.addCVTerm(term);
+      }
+      else if (parent_tag == "Modification")
+      {
+        if (!current_modifications_.empty())
+        {
+          current_modifications_.back().cvs.push_back(term);
+        }
+      }
+      else if (parent_tag == "SearchModification")
+      {
+        current_name_ = term.getName();
+        if (current_name_ == "unknown modification")
+        {
+          // e.g. <cvParam cvRef="MS" accession="MS:1001460" name="unknown modification" value="N-Glycan"/>
+          current_name_ = term.getValue().toString();
+        }
+      }
+      else if (parent_tag == "SpecificityRules")
+      {
+        current_mod_specificities_.insert(term.getAccession());
+      }
+      else if (parent_tag == "AdditionalSearchParams")
+      {
+        if (term.getAccession() == "MS:1002494") // cross-linking search
+        {
+          xl_ms_search_ = true;
+          throw EndParsingSoftly(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+        }
+        current_search_parameters_.setMetaValue(term.getAccession(), term.getValue());
+      }
+      else if (parent_tag == "EnzymeName")
+      {
+        if (enzyme_terms_.find(term.getAccession()) != enzyme_terms_.end())
+        {
+          current_name_ = term.getName();
+        }
+        else
+        {
+          OPENMS_LOG_WARN << "Additional parameters for enzyme settings not readable." << endl;
+        }
+      }
+      else if (parent_tag == "FragmentTolerance")
+      {
+        //+- take the numerically greater
+        current_fragment_tolerance_ = max(current_fragment_tolerance_, term.getValue().toString().toDouble());
+        current_search_parameters_.fragment_mass_tolerance = current_fragment_tolerance_;
+        if (term.getUnit().name == "parts per million")
+        {
+          current_search_parameters_.fragment_mass_tolerance_ppm = true;
+        }
+      }
+      else if (parent_tag == "ParentTolerance")
+      {
+        //+- take the numerically greater
+        current_precursor_tolerance_ = max(current_precursor_tolerance_, term.getValue().toString().toDouble());
+        current_search_parameters_.precursor_mass_tolerance = current_precursor_tolerance_;
+        if (term.getUnit().name == "parts per million")
+        {
+          current_search_parameters_.precursor_mass_tolerance_ppm = true;
+        }
+      }
+      else if (parent_tag == "Threshold")
+      {
+        current_threshold_.addCVTerm(term);
+      }
+      else if (parent_tag == "SoftwareName")
+      {
+        if (current_name_.empty() && software_terms_.find(term.getAccession()) != software_terms_.end())
+        {
+          current_name_ = term.getName();
+        }
+      }
+      else if (parent_tag == "DatabaseName")
+      {
+        current_name_ = term.getValue().toString();
+      }
+    }
+
+    void MzIdentMLHandler::handleInternalUserParam_(const String& parent_tag, const String& name, const DataValue& value)
+    {
+      if (parent_tag == "SpectrumIdentificationItem")
+      {
+        current_item_ups_.insert(make_pair(name, value));
+      }
+      else if (parent_tag == "SpectrumIdentificationResult")
+      {
+        current_result_ups_.insert(make_pair(name, value));
+      }
+      else if (parent_tag == "AdditionalSearchParams")
+      {
+        if (name == "taxonomy")
+        {
+          current_search_parameters_.taxonomy = value.toString();
+        }
+        else if (name == "charges")
+        {
+          current_search_parameters_.charges = value.toString();
+        }
+        else
+        {
+          current_search_parameters_.setMetaValue(name, value);
+        }
+      }
+      else if (parent_tag == "SoftwareName")
+      {
+        if (!current_user_name_final_)
+        {
+          if (name.hasSubstring("name"))
+          {
+            current_user_name_ = value.toString();
+            current_user_name_final_ = true;
+          }
+          else
+          {
+            current_user_name_ = name;
+          }
+        }
+      }
+      else if (parent_tag == "DatabaseName")
+      {
+        current_name_ = value.toString();
+      }
+    }
+
+    CVTerm MzIdentMLHandler::parseCvParam_(const xercesc::Attributes& attributes) const
+    {
+      //      <cvParam accession="MS:1001469" name="taxonomy: scientific name" cvRef="PSI-MS"  value="Drosophila melanogaster"/>
+      String accession, name, cv_ref, value, unit_accession, unit_name, unit_cv_ref;
+      optionalAttributeAsString_(accession, attributes, "accession");
+      optionalAttributeAsString_(name, attributes, "name");
+      optionalAttributeAsString_(cv_ref, attributes, "cvRef");
+      optionalAttributeAsString_(value, attributes, "value");
+      optionalAttributeAsString_(unit_accession, attributes, "unitAccession");
+      optionalAttributeAsString_(unit_name, attributes, "unitName");
+      optionalAttributeAsString_(unit_cv_ref, attributes, "unitCvRef");
+
+      CVTerm::Unit unit;
+      if (!unit_accession.empty() && !unit_name.empty())
+      {
+        unit = CVTerm::Unit(unit_accession, unit_name, unit_cv_ref);
+        if (unit_cv_ref.empty())
+        {
+          OPENMS_LOG_WARN << "This mzid file uses a cv term with units, but without "
+                   << "unit cv reference (required)! Please notify the mzid "
+                   << "producer of this file. \"" << name << "\" will be read as \""
+                   << unit_name << "\" but further actions on this unit may fail."
+                   << endl;
+        }
+      }
+      return CVTerm(accession, name, cv_ref, value, unit);
+    }
+
+    pair<String, DataValue> MzIdentMLHandler::parseUserParam_(const xercesc::Attributes& attributes) const
+    {
+      //      <userParam name="Mascot User Comment" value="Example Mascot MS-MS search for PSI mzIdentML"/>
+      String name, value, unit_accession, type;
+      optionalAttributeAsString_(name, attributes, "name");
+      optionalAttributeAsString_(value, attributes, "value");
+      optionalAttributeAsString_(unit_accession, attributes, "unitAccession");
+      optionalAttributeAsString_(type, attributes, "type");
+
+      DataValue dv;
+      if (type == "xsd:float" || type == "xsd:double")
+      {
+        try
+        {
+          dv = value.toDouble();
+        }
+        catch (...)
+        {
+          OPENMS_LOG_ERROR << "Found float parameter not convertible to float type." << endl;
+        }
+      }
+      else if (type == "xsd:int" || type == "xsd:unsignedInt")
+      {
+        try
+        {
+          dv = value.toInt();
+        }
+        catch (...)
+        {
+          OPENMS_LOG_ERROR << "Found integer parameter not convertible to integer type." << endl;
+        }
+      }
+      else
+      {
+        dv = value;
+      }
+
+      // Add unit *after* creating the term
+      if (!unit_accession.empty())
+      {
+        if (unit_accession.hasPrefix("UO:"))
+        {
+          dv.setUnit(unit_accession.suffix(unit_accession.size() - 3).toInt());
+          dv.setUnitType(DataValue::UnitType::UNIT_ONTOLOGY);
+        }
+        else if (unit_accession.hasPrefix("MS:"))
+        {
+          dv.setUnit(unit_accession.suffix(unit_accession.size() - 3).toInt());
+          dv.setUnitType(DataValue::UnitType::MS_ONTOLOGY);
+        }
+        else
+        {
+          OPENMS_LOG_WARN << String("Unhandled unit '") + unit_accession + "' in tag '" + name + "'." << endl;
+        }
+      }
+      return make_pair(name, dv);
+    }
+
+    AASequence MzIdentMLHandler::buildPeptideSequence_() const
+    {
+      //1. Sequence
+      String as = current_text_;
+      as.trim();
+
+      //2. Substitutions
+      for (vector<SubstitutionRecord>::const_iterator sub = current_substitutions_.begin(); sub != current_substitutions_.end(); ++sub)
+      {
+        if (!sub->location.empty())
+        {
+          Int location = sub->location.toInt();
+          if (location < 1 || location > static_cast<Int>(as.size()))
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, sub->location, "'SubstitutionModification' location outside of the peptide sequence.");
+          }
+          as[location - 1] = sub->replacement;
+        }
+        else if (as.has(sub->original)) //no location - every occurrence will be replaced
+        {
+          as.substitute(sub->original, sub->replacement);
+        }
+        else
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, as, "'SubstitutionModification' residue not found in the peptide sequence.");
+        }
+      }
+
+      //3. Modifications
+      AASequence aas = AASequence::fromString(as);
+      for (vector<PeptideModificationRecord>::const_iterator mod_it = current_modifications_.begin(); mod_it != current_modifications_.end(); ++mod_it)
+      {
+        const SignedSize index = mod_it->location;
+        for (vector<CVTerm>::const_iterator cv = mod_it->cvs.begin(); cv != mod_it->cvs.end(); ++cv)
+        {
+          if (cv->getAccession() == "MS:1001460") // unknown modification
+          {
+            const String cvvalue = cv->getValue().toString();
+            if (cv->hasValue() && !cvvalue.empty() && ModificationsDB::getInstance()->has(cvvalue))
+            {
+              // Case 1: unknown (to e.g., thid-party tool) modification known to OpenMS (see value)
+              //  <Modification location="0" monoisotopicMassDelta="17.031558">
+              //  <cvParam cvRef="PSI-MS" accession="MS:1001460" name="unknown modification" value="Methyl:2H(2)13C"/>
+              if (index == 0)
+              {
+                aas.setNTerminalModification(cvvalue);
+              }
+              else if (index == static_cast<SignedSize>(aas.size() + 1))
+              {
+                aas.setCTerminalModification(cvvalue);
+              }
+              else if (index > 0 && index <= static_cast<SignedSize>(aas.size()))
+              {
+                aas.setModification(index - 1, cvvalue);
+              }
+              continue;
+            }
+
+            // Case 2: unknown modification (needs to be added to ModificationsDB)
+            // note, this is optional
+            const String& mass_delta_string = mod_it->mass_delta;
+            double mass_delta = 0;
+            try
+            {
+              mass_delta = mass_delta_string.toDouble();
+            }
+            catch (...)
+            {
+              OPENMS_LOG_WARN << "Found unreadable modification location." << endl;
+              throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown modification");
+            }
+
+            // Parse this and add a new modification of mass "monoisotopicMassDelta" to the AASequence
+            // compare with String::ConstIterator AASequence::parseModSquareBrackets_
+            ModificationsDB* mod_db = ModificationsDB::getInstance();
+            if (index == 0)
+            {
+              // n-terminal
+              String residue_name = ".[+" + mass_delta_string + "]";
+              String residue_id = ".n[" + mass_delta_string + "]";
+
+              // Check if it already exists, if not create new modification, transfer
+              // ownership to ModDB
+              if (!mod_db->has(residue_id))
+              {
+                ResidueModification* new_mod = new ResidueModification();
+                new_mod->setFullId(residue_id); // setting FullId but not Id makes it a user-defined mod
+                new_mod->setFullName(residue_name); // display name
+                new_mod->setDiffMonoMass(mass_delta);
+                new_mod->setMonoMass(mass_delta + Residue::getInternalToNTerm().getMonoWeight());
+                new_mod->setTermSpecificity(ResidueModification::N_TERM);
+                mod_db->addModification(new_mod);
+              }
+              aas.setNTerminalModification(residue_id);
+            }
+            else if (index == static_cast<SignedSize>(aas.size() + 1))
+            {
+              // c-terminal
+              String residue_name = ".[" + mass_delta_string + "]";
+              String residue_id = ".c[" + mass_delta_string + "]";
+
+              if (!mod_db->has(residue_id))
+              {
+                ResidueModification* new_mod = new ResidueModification();
+                new_mod->setFullId(residue_id); // setting FullId but not Id makes it a user-defined mod
+                new_mod->setFullName(residue_name); // display name
+                new_mod->setDiffMonoMass(mass_delta);
+                new_mod->setMonoMass(mass_delta + Residue::getInternalToCTerm().getMonoWeight());
+                new_mod->setTermSpecificity(ResidueModification::C_TERM);
+                mod_db->addModification(new_mod);
+              }
+              aas.setCTerminalModification(residue_id);
+            }
+            else if (index > 0 && index <= static_cast<SignedSize>(aas.size()))
+            {
+              // internal modification
+              const Residue& residue = aas[index - 1];
+              String residue_name = residue.getOneLetterCode() + "[" + mass_delta_string + "]"; // e.g. N[12345.6]
+              String modification_name = "[" + mass_delta_string + "]";
+
+              if (!mod_db->has(residue_name))
+              {
+                // create new modification
+                ResidueModification* new_mod = new ResidueModification();
+                new_mod->setFullId(residue_name); // setting FullId but not Id makes it a user-defined mod
+                new_mod->setFullName(modification_name); // display name
+
+                // We will set origin to make sure the same modifcation will be used
+                // for the same AA
+                new_mod->setOrigin(residue.getOneLetterCode()[0]);
+
+                new_mod->setMonoMass(mass_delta + residue.getMonoWeight());
+                new_mod->setAverageMass(mass_delta + residue.getAverageWeight());
+                new_mod->setDiffMonoMass(mass_delta);
+
+                mod_db->addModification(new_mod);
+              }
+
+              // now use the new modification
+              Size mod_idx = mod_db->findModificationIndex(residue_name);
+              const ResidueModification* res_mod = mod_db->getModification(mod_idx);
+              aas.setModification(index - 1, res_mod->getFullId());
+            }
+            continue;
+          }
+
+          if (cv->getCVIdentifierRef() != "UNIMOD")
+          {
+            // e.g.  <cvParam accession="MS:1001524" name="fragment neutral loss" cvRef="PSI-MS" value="0" unitAccession="UO:0000221" unitName="dalton" unitCvRef="UO"/>
+            continue;
+          }
+
+          if (index == 0)
+          {
+            aas.setNTerminalModification(cv->getName());
+          }
+          else if (index == static_cast<SignedSize>(aas.size() + 1))
+          {
+            aas.setCTerminalModification(cv->getName());
+          }
+          else
+          {
+            try
+            {
+              aas.setModification(index - 1, cv->getName()); //TODO @mths,Timo : do this via UNIMOD accessions
+            }
+            catch (Exception::BaseException& e)
+            {
+              OPENMS_LOG_WARN << e.getName() << ": " << e.getMessage() << " Sequence: " << aas.toUnmodifiedString() << ", position " << String(index) << "\n";
+            }
+          }
+        }
+      }
+      return aas;
+    }
+
+    void MzIdentMLHandler::buildPeptideHit_()
+    {
+      PeptideIdentification& spectrum_identification = pep_id_->back();
+
+      double score = 0;
+      bool scoretype = false;
+      const Map<String, vector<CVTerm> >& cv_terms = current_item_cvs_.getCVTerms();
+      for (Map<String, vector<CVTerm> >::const_iterator scoreit = cv_terms.begin(); scoreit != cv_terms.end(); ++scoreit)
+      {
+        if (q_score_terms_.find(scoreit->first) != q_score_terms_.end() || scoreit->first == "MS:1002354")
+        {
+          if (scoreit->first != "MS:1002055") // do not use peptide-level q-values for now
+          {
+            score = scoreit->second.front().getValue().toString().toDouble();
+            spectrum_identification.setHigherScoreBetter(false);
+            spectrum_identification.setScoreType("q-value"); //higherIsBetter = false
+            scoretype = true;
+            break;
+          }
+        }
+        else if (specific_score_terms_.find(scoreit->first) != specific_score_terms_.end() || scoreit->first == "MS:1001143")
+        {
+          score = scoreit->second.front().getValue().toString().toDouble();
+          spectrum_identification.setHigherScoreBetter(ControlledVocabulary::CVTerm::isHigherBetterScore(cv_.getTerm(scoreit->first)));
+          spectrum_identification.setScoreType(scoreit->second.front().getName());
+          scoretype = true;
+          break;
+        }
+        else if (e_score_terms_.find(scoreit->first) != e_score_terms_.end())
+        {
+          score = scoreit->second.front().getValue().toString().toDouble();
+          spectrum_identification.setHigherScoreBetter(false);
+          spectrum_identification.setScoreType("E-value"); //higherIsBetter = false
+          scoretype = true;
+        }
+      }
+      if (!scoretype) // no q/E/raw score: no hit will be read
+      {
+        return;
+      }
+
+      //build the PeptideHit from a SpectrumIdentificationItem
+      unordered_map<String, Size>::const_iterator pep_it = peptide_index_.find(current_ref_);
+      PeptideHit hit(score, current_item_rank_, current_item_charge_, (pep_it != peptide_index_.end()) ? peptides_[pep_it->second] : AASequence());
+      for (Map<String, vector<CVTerm> >::const_iterator cvs = cv_terms.begin(); cvs != cv_terms.end(); ++cvs)
+      {
+        for (vector<CVTerm>::const_iterator cv = cvs->second.begin(); cv != cvs->second.end(); ++cv)
+        {
+          if (cvs->first == "MS:1002540")
+          {
+            hit.setMetaValue(cvs->first, cv->getValue().toString());
+          }
+          else
+          {
+            hit.setMetaValue(cvs->first, cv->getValue().toString().toDouble());
+          }
+        }
+      }
+      for (map<String, DataValue>::const_iterator up = current_item_ups_.begin(); up != current_item_ups_.end(); ++up)
+      {
+        hit.setMetaValue(up->first, up->second);
+      }
+      hit.setMetaValue("calcMZ", current_item_calc_mz_);
+      spectrum_identification.setMZ(current_item_exp_mz_);
+      hit.setMetaValue("pass_threshold", current_item_pass_); //TODO @ mths do not write metavalue pass_threshold
+
+      //connect the PeptideHit with PeptideEvidences (for AABefore/After) and subsequently with DBSequence (for ProteinAccession)
+      if (pep_it != peptide_index_.end() && pep_it->second + 1 < evidence_offsets_.size())
+      {
+        ProteinIdentification& protein_id = (*pro_id_)[current_protein_index_];
+        if (protein_accessions_.size() <= current_protein_index_)
+        {
+          protein_accessions_.resize(current_protein_index_ + 1);
+        }
+        unordered_set<String>& accessions = protein_accessions_[current_protein_index_];
+
+        for (Size i = evidence_offsets_[pep_it->second]; i < evidence_offsets_[pep_it->second + 1]; ++i)
+        {
+          const PeptideEvidenceRecord& pv = evidences_[i];
+          PeptideEvidence pev;
+          if (pv.pre != '-') pev.setAABefore(pv.pre);
+          if (pv.post != '-') pev.setAAAfter(pv.post);
+
+          if (pv.start != PeptideEvidence::UNKNOWN_POSITION && pv.end != PeptideEvidence::UNKNOWN_POSITION)
+          {
+            hit.setMetaValue("start", pv.start);
+            hit.setMetaValue("end", pv.end);
+            pev.setStart(pv.start);
+            pev.setEnd(pv.end);
+          }
+
+          String target_decoy = pv.is_decoy ? "decoy" : "target";
+          if (hit.metaValueExists(Constants::UserParam::TARGET_DECOY) && hit.getMetaValue(Constants::UserParam::TARGET_DECOY) != target_decoy)
+          {
+            target_decoy = "target+decoy";
+          }
+          hit.setMetaValue(Constants::UserParam::TARGET_DECOY, target_decoy);
+
+          if (pv.db_sequence < db_sequences_.size())
+          {
+            const DBSequenceRecord& db = db_sequences_[pv.db_sequence];
+            pev.setProteinAccession(db.accession);
+            if (accessions.insert(db.accession).second)
+            {
+              ProteinHit protein_hit;
+              protein_hit.setSequence(db.sequence);
+              protein_hit.setAccession(db.accession);
+              protein_hit.setMetaValue("isDecoy", pv.is_decoy ? "true" : "false");
+              protein_id.insertHit(protein_hit);
+            }
+          }
+          hit.addPeptideEvidence(pev);
+        }
+      }
+      spectrum_identification.insertHit(hit);
+    }
+
+    void MzIdentMLHandler::indexPeptideEvidences_()
+    {
+      // counting sort by Peptide index, keeping the document order of PeptideEvidences of the same Peptide
+      evidence_offsets_.assign(peptides_.size() + 1, 0);
+      for (vector<PeptideEvidenceRecord>::const_iterator it = evidences_.begin(); it != evidences_.end(); ++it)
+      {
+        ++evidence_offsets_[it->peptide + 1];
+      }
+      for (Size i = 1; i < evidence_offsets_.size(); ++i)
+      {
+        evidence_offsets_[i] += evidence_offsets_[i - 1];
+      }
+      vector<Size> next(evidence_offsets_.begin(), evidence_offsets_.end() - 1);
+      vector<PeptideEvidenceRecord> sorted(evidences_.size());
+      for (vector<PeptideEvidenceRecord>::const_iterator it = evidences_.begin(); it != evidences_.end(); ++it)
+      {
+        sorted[next[it->peptide]++] = *it;
+      }
+      evidences_.swap(sorted);
+    }
+
+    void MzIdentMLHandler::writeTo(std::ostream& os)
+    {
+      String cv_ns = cv_.name();
+      String inputs_element;
+      std::map<String,String> /* peps, pepevis, */ sil_map, sil_2_date;
+      std::set<String> sen_set, sof_set, sip_set;
+      std::map<String, String> sdb_ids, sen_ids, sof_ids, sdat_ids, pep_ids;
+      std::vector<String> run_sdb_ids; // SearchDatabase of each ProteinIdentification
+      //std::map<String, String> pep_pairs_ppxl;
+      std::map<String, double> pp_identifier_2_thresh;
+      //std::vector< std::pair<String, String> > pepid_pairs_ppxl;
+
+      // file type-specific definitions needed for SpectraData element:
+      std::map<FileTypes::Type, std::pair<String, String> > formats_map;
+      formats_map[FileTypes::MZML] = make_pair("mzML format", "mzML unique identifier");
+      formats_map[FileTypes::MZXML] = make_pair("ISB mzXML format", "scan number only nativeID format");
+      formats_map[FileTypes::MZDATA] = make_pair("PSI mzData format", "spectrum identifier nativeID format");
+      formats_map[FileTypes::MGF] = make_pair("Mascot MGF format", "multiple peak list nativeID format");
+
+
+      //TODO if constructed with a msexperiment - not yet implemented
+      //~ if(ms_exp_ == 0)
+      //~ {
+      //~ synthesize spectrum references
+      //~ }
+      //~ else
+      //~ {
+      //~ extract peptide and proteinid from msexperiment
+      //~ genereate spectrum references from msexperiment foreach peptideidentification
+      //~ }
+
+      /*---------------------------------------------------------------------
+      DataCollection:
+      +Inputs
+      -AnalysisData collected in sidlist --> unclosed element string
+      ---------------------------------------------------------------------*/
+      inputs_element += String("\t<Inputs>\n");
+      String spectra_data, search_database;
+
+      /*
+      1st: iterate over proteinidentification vector
+      */
+      //TODO read type of crosslink reagens from settings
+      bool is_ppxl = false;
+      for (std::vector<ProteinIdentification>::const_iterator it = cpro_id_->begin(); it != cpro_id_->end(); ++it)
+      {
+        //~ collect analysissoftware in this loop - does not go into inputelement
+        String sof_id;
+        String sof_name = String(it->getSearchEngine());
+        std::map<String, String>::iterator soit = sof_ids.find(sof_name);
+        String osecv;
+        if (sof_name == "OMSSA")
+        {
+          osecv = "OMSSA";
+        }
+        else if (sof_name == "Mascot")
+        {
+          osecv = "Mascot";
+        }
+        else if (sof_name == "XTandem")
+        {
+          osecv = "X\\!Tandem";
+        }
+        else if (sof_name == "SEQUEST")
+        {
+          osecv = "Sequest";
+        }
+        else if (sof_name == "MS-GF+")
+        {
+          osecv = "MS-GF+";
+        }
+        else if (sof_name == "Percolator")
+        {
+          osecv = "Percolator";
+        }
+        else if (sof_name == "OpenPepXL")
+        {
+          osecv = "OpenPepXL";
+        }
+        else if (cv_.hasTermWithName(sof_name))
+        {
+          osecv = sof_name;
+        }
+        else
+        {
+          osecv = "analysis software";
+        }
+
+        if (soit == sof_ids.end())
+        {
+          sof_id = "SOF_" + String(UniqueIdGenerator::getUniqueId());
+          //~ TODO consider not only searchengine but also version!
+          String sost = String("\t<AnalysisSoftware version=\"") + String(it->getSearchEngineVersion()) + String("\" name=\"") + sof_name +  String("\" id=\"") + sof_id + String("\">\n") + String("\t\t<SoftwareName>\n");
+          sost += "\t\t\t" + cv_.getTermByName(osecv).toXMLString(cv_ns);
+          sost += String("\n\t\t</SoftwareName>\n\t</AnalysisSoftware>\n");
+          sof_set.insert(sost);
+          sof_ids.insert(make_pair(sof_name, sof_id));
+        }
+        else
+        {
+          sof_id = soit->second;
+        }
+
+        if (it->metaValueExists("is_cross_linking_experiment") ||
+                (it->metaValueExists("SpectrumIdentificationProtocol") &&
+                it->getMetaValue("SpectrumIdentificationProtocol") == "MS:1002494"))
+        {
+          is_ppxl = true;  //needed as incoming data is structured differently and output deviates as well for ppxl
+          // ppxl is like (1PeptideIdentification, 1-2 PeptideHits) but there might be more PeptideIdentifications for one spectrum
+        }
+
+        String thcv;
+        pp_identifier_2_thresh.insert(make_pair(it->getIdentifier(),it->getSignificanceThreshold()));
+        if (it->getSignificanceThreshold() != 0.0)
+        {
+          thcv = cv_.getTermByName("PSM-level statistical threshold").toXMLString(cv_ns, String(it->getSignificanceThreshold()));
+        }
+        else
+        {
+          thcv = cv_.getTermByName("no threshold").toXMLString(cv_ns);
+        }
+        // TODO add other software than searchengine for evidence trace
+
+        // get a map from identifier to match OpenMS Protein/PeptideIdentification match string;
+        String sil_id =  "SIL_" + String(UniqueIdGenerator::getUniqueId());
+        pp_identifier_2_sil_.insert(make_pair(it->getIdentifier(), sil_id));
+
+        //~ collect SpectrumIdentificationProtocol for analysisprotocol in this loop - does not go into inputelement
+        String sip_id = "SIP_" + String(UniqueIdGenerator::getUniqueId());
+        sil_2_sip_.insert(make_pair(sil_id, sip_id));
+
+        String sip = "\t<SpectrumIdentificationProtocol id=\"" + String(sip_id) + "\" analysisSoftware_ref=\"" + String(sof_id) + "\">\n";
+        sip += "\t\t<SearchType>\n\t\t\t" + cv_.getTermByName("ms-ms search").toXMLString(cv_ns) + "\n\t\t</SearchType>\n";
+        sip += "\t\t<AdditionalSearchParams>\n";
+        if (is_ppxl)
+        {
+          sip += "\n\t\t\t" + cv_.getTermByName("cross-linking search").toXMLString(cv_ns) + "\n";
+        }
+        //remove MS:1001029 written if present in <SearchDatabase> as of SearchDatabase_may rule
+        ProteinIdentification::SearchParameters search_params = it->getSearchParameters();
+        search_params.removeMetaValue("MS:1001029");
+        writeMetaInfos_(sip, search_params, 3);
+        sip += String(3, '\t') + "<userParam name=\"charges\" unitName=\"xsd:string\" value=\"" + search_params.charges + "\"/>\n";
+//        sip += String(3, '\t') + "<userParam name=\"" + "missed_cleavages" + "\" unitName=\"" + "xsd:integer" + "\" value=\"" + String(it->getSearchParameters().missed_cleavages) + "\"/>" + "\n";
+        sip += "\t\t</AdditionalSearchParams>\n";
+        // modifications:
+        if (search_params.fixed_modifications.empty() &&
+            search_params.variable_modifications.empty()
+            && (!is_ppxl)) // TODO some OpenPepXL modifications are not covered by the unimod.obo and cause problems in the search_params
+        {
+          // no modifications used or are they just missing from the parameters?
+          ModificationDefinitionsSet mod_defs;
+          mod_defs.inferFromPeptides(*cpep_id_);
+          mod_defs.getModificationNames(search_params.fixed_modifications,
+                                        search_params.variable_modifications);
+        }
+        if (!search_params.fixed_modifications.empty() ||
+            !search_params.variable_modifications.empty())
+        {
+          sip += "\t\t<ModificationParams>\n";
+          writeModParam_(sip, search_params.fixed_modifications, true, 2);
+          writeModParam_(sip, search_params.variable_modifications, false, 2);
+          sip += "\t\t</ModificationParams>\n";
+        }
+        writeEnzyme_(sip, search_params.digestion_enzyme, search_params.missed_cleavages, 2);
+        // TODO MassTable section
+        sip += String("\t\t<FragmentTolerance>\n");
+        String unit_str = "unitCvRef=\"UO\" unitName=\"dalton\" unitAccession=\"UO:0000221\"";
+        if (search_params.fragment_mass_tolerance_ppm)
+        {
+          unit_str = "unitCvRef=\"UO\" unitName=\"parts per million\" unitAccession=\"UO:0000169\"";
+        }
+        sip += String(3, '\t') + "<cvParam accession=\"MS:1001412\" name=\"search tolerance plus value\" " + unit_str + " cvRef=\"PSI-MS\" value=\"" + String(search_params.fragment_mass_tolerance) + "\"/>\n";
+        sip += String(3, '\t') + "<cvParam accession=\"MS:1001413\" name=\"search tolerance minus value\" " + unit_str + " cvRef=\"PSI-MS\" value=\"" + String(search_params.fragment_mass_tolerance) + "\"/>\n";
+        sip += String("\t\t</FragmentTolerance>\n");
+        sip += String("\t\t<ParentTolerance>\n");
         unit_str = "unitCvRef=\"UO\" unitName=\"dalton\" unitAccession=\"UO:0000221\"";
         if (search_params.precursor_mass_tolerance_ppm)
         {
@@ -645,40 +1819,14 @@ namespace OpenMS
           sdb_id = dbit->second;
         }
         sil_2_sdb_.insert(make_pair(sil_id, sdb_id));
+        run_sdb_ids.push_back(sdb_id);
 
-
+        // DBSequence elements are written with the SequenceCollection
         for (std::vector<ProteinHit>::const_iterator jt = it->getHits().begin(); jt != it->getHits().end(); ++jt)
         {
-          String enid;
-          std::map<String, String>::iterator enit = sen_ids.find(String(jt->getAccession()));
-          if (enit == sen_ids.end())
-          {
-            String entry;
-            enid = "PROT_" + String(UniqueIdGenerator::getUniqueId()); //TODO IDs from metadata or where its stored at read in;
-            String enst(jt->getAccession());
-
-            entry += "\t<DBSequence accession=\"" + enst + "\" ";
-            entry += "searchDatabase_ref=\"" + sdb_id + "\" ";
-            String s = String(jt->getSequence());
-            if (!s.empty())
-            {
-              entry += "length=\"" + String(jt->getSequence().length()) + "\" ";
-            }
-            entry += String("id=\"") + String(enid) + String("\">\n");
-            if (!s.empty())
-            {
-              entry += "\t<Seq>" + s + "</Seq>\n";
-            }
-            entry += "\t\t" + cv_.getTermByName("protein description").toXMLString(cv_ns, enst);
-            entry += "\n\t</DBSequence>\n";
-
-            sen_ids.insert(std::pair<String, String>(enst, enid));
-            sen_set.insert(entry);
-
-          }
-          else
+          if (sen_ids.find(jt->getAccession()) == sen_ids.end())
           {
-            enid = enit->second;
+            sen_ids.insert(std::make_pair(jt->getAccession(), "PROT_" + String(UniqueIdGenerator::getUniqueId()))); //TODO IDs from metadata or where its stored at read in;
           }
         }
       }
@@ -689,123 +1837,61 @@ namespace OpenMS
       /*
       2nd: iterate over peptideidentification vector
       */
+      // Peptide, PeptideEvidence and SpectrumIdentificationResult elements are written to the stream
+      // directly (in separate passes over the peptide ids, see below). Only XL-MS results, which
+      // combine several PeptideIdentifications per spectrum, are collected in memory first.
       //TODO ppxl - write here "MS:1002511" Cross-linked spectrum identification item linking the other spectrum
       //          PeptideIdentification repräsentiert xl paar.
       //          PeptideHit score_type ist dann final score von xQuest_cpp.
       //          top5 ids -> 5 PeptideIdentification für ein (paar) spectra. SIR with 5 entries and ranks
       std::map<String, String> ppxl_specref_2_element; //where the SII will get added for one spectrum reference
       std::map<String, std::vector<String> > pep_evis; //maps the sequence to the corresponding evidence elements for the next scope
+      std::set<String> sil_ids; // SpectrumIdentificationLists with results
       for (std::vector<PeptideIdentification>::const_iterator it = cpep_id_->begin(); it != cpep_id_->end(); ++it)
       {
-        String emz(it->getMZ());
-        const double rt = it->getRT();
-        String ert = rt == rt ? String(rt) : "nan";
-
-        String sid = it->getMetaValue(Constants::UserParam::SPECTRUM_REFERENCE);
-        if (sid.empty())
+        if (!is_ppxl)
         {
-          sid = String(it->getMetaValue("spectrum_id"));
-          if (sid.empty())
+          std::map<String, String>::const_iterator ps_it = pp_identifier_2_sil_.find(it->getIdentifier());
+          if (ps_it != pp_identifier_2_sil_.end())
           {
-              if (it->getMZ() != it->getMZ())
-            {
-              emz = "nan";
-              OPENMS_LOG_WARN << "Found no spectrum reference and no m/z position of identified spectrum! You are probably converting from an old format with insufficient data provision. Setting 'nan' - downstream applications might fail unless you set the references right." << std::endl;
-            }
-            if (it->getRT() != it->getRT())
-            {
-              ert = "nan";
-              OPENMS_LOG_WARN << "Found no spectrum reference and no RT position of identified spectrum! You are probably converting from an old format with insufficient data provision. Setting 'nan' - downstream applications might fail unless you set the references right." << std::endl;
-            }
-            sid = String("MZ:") + emz + String("@RT:") + ert;
+            sil_ids.insert(ps_it->second);
+          }
+          else
+          {
+            //encountered a PeptideIdentification which is not linked to any ProteinIdentification
+            OPENMS_LOG_ERROR << "encountered a PeptideIdentification which is not linked to any ProteinIdentification" << std::endl;
           }
+          continue;
         }
-        if (is_ppxl && it->metaValueExists(Constants::UserParam::OPENPEPXL_HEAVY_SPEC_REF))
+
+        String sid = getSpectrumReference_(*it);
+        if (it->metaValueExists(Constants::UserParam::OPENPEPXL_HEAVY_SPEC_REF))
         {
           sid.append("," + String(it->getMetaValue(Constants::UserParam::OPENPEPXL_HEAVY_SPEC_REF)));
         }
-        String sidres;
         String sir = "SIR_" + String(UniqueIdGenerator::getUniqueId());
-        String sdr = sdat_ids.begin()->second;
-        std::map<String, String>::iterator pfo = ph_2_sdat_.find(it->getIdentifier());
-        if (pfo != ph_2_sdat_.end())
-        {
-          sdr = pfo->second;
-        }
-        else
-        {
-          OPENMS_LOG_WARN << "Falling back to referencing first spectrum file given because file or identifier could not be mapped." << std::endl;
-        }
-
-        sidres += String("\t\t\t<SpectrumIdentificationResult spectraData_ref=\"")
-        //multi identification runs lookup from file_origin here
-                + sdr + String("\" spectrumID=\"")
-                + sid + String("\" id=\"") + sir + String("\">\n");
-
-        if (is_ppxl)
+        if (ppxl_specref_2_element.find(sid) == ppxl_specref_2_element.end())
         {
-          if (ppxl_specref_2_element.find(sid)==ppxl_specref_2_element.end())
-          {
-            ppxl_specref_2_element[sid] = sidres;
-          }
+          ppxl_specref_2_element[sid] = String("\t\t\t<SpectrumIdentificationResult spectraData_ref=\"")
+                                        + getSpectraDataRef_(*it, sdat_ids.begin()->second) + String("\" spectrumID=\"")
+                                        + sid + String("\" id=\"") + sir + String("\">\n");
         }
 
         //map.begin access ok here because make sure at least one "UNKOWN" element is in the sdats_ids map
 
-        double ppxl_crosslink_mass(0);
-        if (is_ppxl)
-        {
-          ProteinIdentification::SearchParameters search_params = cpro_id_->front().getSearchParameters();
-          ppxl_crosslink_mass = String(search_params.getMetaValue("cross_link:mass")).toDouble();
-        }
+        ProteinIdentification::SearchParameters search_params = cpro_id_->front().getSearchParameters();
+        double ppxl_crosslink_mass = String(search_params.getMetaValue("cross_link:mass")).toDouble();
 
         for (std::vector<PeptideHit>::const_iterator jt = it->getHits().begin(); jt != it->getHits().end(); ++jt)
         {
-          if (!is_ppxl)
-          {
-            MzIdentMLHandler::writePeptideHit(*jt, it, pep_ids, cv_ns, sen_set, sen_ids, pep_evis, pp_identifier_2_thresh, sidres);
-          }
-          else
-          {
-            String ppxl_linkid = UniqueIdGenerator::getUniqueId();
-            MzIdentMLHandler::writeXLMSPeptideHit(*jt, it, ppxl_linkid, pep_ids, cv_ns, sen_set, sen_ids, pep_evis, pp_identifier_2_thresh, ppxl_crosslink_mass, ppxl_specref_2_element, sid, true);
-            // XL-MS IDs from OpenPepXL can have two Peptides and SpectrumIdentifications, but with practically the same data except for the sequence and its modifications
-            if (jt->metaValueExists(Constants::UserParam::OPENPEPXL_XL_TYPE) && jt->getMetaValue(Constants::UserParam::OPENPEPXL_XL_TYPE) == "cross-link")
-            {
-              MzIdentMLHandler::writeXLMSPeptideHit(*jt, it, ppxl_linkid, pep_ids, cv_ns, sen_set, sen_ids, pep_evis, pp_identifier_2_thresh, ppxl_crosslink_mass, ppxl_specref_2_element, sid, false);
-            }
-          }
-        }
-        if (!ert.empty() && ert != "nan" && ert != "NaN" && !is_ppxl)
-        {
-          DataValue rtcv(ert);
-          rtcv.setUnit(10); // id: UO:0000010 name: second
-          rtcv.setUnitType(DataValue::UnitType::UNIT_ONTOLOGY);
-          sidres +=  "\t\t\t\t" + cv_.getTermByName("retention time").toXMLString(cv_ns, rtcv) + "\n";
-        }
-        if (!is_ppxl)
-        {
-          sidres += "\t\t\t</SpectrumIdentificationResult>\n";
-          std::map<String, String>::const_iterator ps_it = pp_identifier_2_sil_.find(it->getIdentifier());
-          if (ps_it != pp_identifier_2_sil_.end())
-          {
-            std::map<String, String>::iterator sil_it = sil_map.find(ps_it->second);
-            if (sil_it != sil_map.end())
-            {
-              sil_it->second.append(sidres);
-            }
-            else
-            {
-              sil_map.insert(make_pair(ps_it->second,sidres));
-            }
-          }
-          else
+          String ppxl_linkid = UniqueIdGenerator::getUniqueId();
+          MzIdentMLHandler::writeXLMSPeptideHit(*jt, it, ppxl_linkid, pep_ids, cv_ns, sen_set, sen_ids, pep_evis, pp_identifier_2_thresh, ppxl_crosslink_mass, ppxl_specref_2_element, sid, true);
+          // XL-MS IDs from OpenPepXL can have two Peptides and SpectrumIdentifications, but with practically the same data except for the sequence and its modifications
+          if (jt->metaValueExists(Constants::UserParam::OPENPEPXL_XL_TYPE) && jt->getMetaValue(Constants::UserParam::OPENPEPXL_XL_TYPE) == "cross-link")
           {
-            //encountered a PeptideIdentification which is not linked to any ProteinIdentification
-            OPENMS_LOG_ERROR << "encountered a PeptideIdentification which is not linked to any ProteinIdentification" << std::endl;
+            MzIdentMLHandler::writeXLMSPeptideHit(*jt, it, ppxl_linkid, pep_ids, cv_ns, sen_set, sen_ids, pep_evis, pp_identifier_2_thresh, ppxl_crosslink_mass, ppxl_specref_2_element, sid, false);
           }
         }
-
       }
       // ppxl - write spectrumidentificationresult closing tags!
       if (is_ppxl)
@@ -825,6 +1911,7 @@ namespace OpenMS
             else
             {
               sil_map.insert(make_pair(ps_it->second,it->second));
+              sil_ids.insert(ps_it->second);
             }
           }
           else
@@ -890,9 +1977,69 @@ namespace OpenMS
       // SequenceCollection
       //--------------------------------------------------------------------------------------------
       os << "<SequenceCollection>\n";
-      for (std::set<String>::const_iterator sen = sen_set.begin(); sen != sen_set.end(); ++sen)
+      std::set<String> written_accessions;
+      for (Size i = 0; i < cpro_id_->size(); ++i)
+      {
+        for (std::vector<ProteinHit>::const_iterator jt = (*cpro_id_)[i].getHits().begin(); jt != (*cpro_id_)[i].getHits().end(); ++jt)
+        {
+          String enst(jt->getAccession());
+          if (!written_accessions.insert(enst).second) continue;
+
+          String entry;
+          entry += "\t<DBSequence accession=\"" + enst + "\" ";
+          entry += "searchDatabase_ref=\"" + run_sdb_ids[i] + "\" ";
+          String s = String(jt->getSequence());
+          if (!s.empty())
+          {
+            entry += "length=\"" + String(jt->getSequence().length()) + "\" ";
+          }
+          entry += String("id=\"") + sen_ids[enst] + String("\">\n");
+          if (!s.empty())
+          {
+            entry += "\t<Seq>" + s + "</Seq>\n";
+          }
+          entry += "\t\t" + cv_.getTermByName("protein description").toXMLString(cv_ns, enst);
+          entry += "\n\t</DBSequence>\n";
+          os << entry;
+        }
+      }
+      if (is_ppxl)
+      {
+        for (std::set<String>::const_iterator sen = sen_set.begin(); sen != sen_set.end(); ++sen)
+        {
+          os << *sen;
+        }
+      }
+      else
       {
-        os << *sen;
+        // one Peptide element per sequence ...
+        for (std::vector<PeptideIdentification>::const_iterator it = cpep_id_->begin(); it != cpep_id_->end(); ++it)
+        {
+          for (std::vector<PeptideHit>::const_iterator jt = it->getHits().begin(); jt != it->getHits().end(); ++jt)
+          {
+            String pepi = jt->getSequence().toString();
+            if (pep_ids.find(pepi) != pep_ids.end()) continue;
+            String pepid = "PEP_" + String(UniqueIdGenerator::getUniqueId());
+            pep_ids.insert(std::make_pair(pepi, pepid));
+            String p;
+            writePeptide_(p, jt->getSequence(), pepid);
+            os << p;
+          }
+        }
+        // ... followed by the PeptideEvidence elements (taken from the first hit of each sequence)
+        for (std::vector<PeptideIdentification>::const_iterator it = cpep_id_->begin(); it != cpep_id_->end(); ++it)
+        {
+          for (std::vector<PeptideHit>::const_iterator jt = it->getHits().begin(); jt != it->getHits().end(); ++jt)
+          {
+            String pepi = jt->getSequence().toString();
+            if (pep_evis.find(pepi) != pep_evis.end()) continue;
+            String e;
+            std::vector<String> pevid_ids;
+            writePeptideEvidences_(e, *jt, pep_ids[pepi], sen_ids, pevid_ids);
+            pep_evis.insert(std::make_pair(pepi, pevid_ids));
+            os << e;
+          }
+        }
       }
       os << "</SequenceCollection>\n";
 
@@ -935,9 +2082,9 @@ namespace OpenMS
       os << "<DataCollection>\n"
          << inputs_element;
       os << "\t<AnalysisData>\n";
-      for (std::map<String,String>::const_iterator sil_it = sil_map.begin(); sil_it != sil_map.end(); ++sil_it)
+      for (std::set<String>::const_iterator sil_it = sil_ids.begin(); sil_it != sil_ids.end(); ++sil_it)
       {
-        os << "\t\t<SpectrumIdentificationList id=\"" << sil_it->first << String("\">\n");
+        os << "\t\t<SpectrumIdentificationList id=\"" << *sil_it << String("\">\n");
         os << "\t\t\t<FragmentationTable>\n"
            << "\t\t\t\t<Measure id=\"Measure_mz\">\n"
            << "\t\t\t\t\t<cvParam accession=\"MS:1001225\" cvRef=\"PSI-MS\" unitCvRef=\"PSI-MS\" unitName=\"m/z\" unitAccession=\"MS:1000040\" name=\"product ion m/z\"/>\n"
@@ -950,11 +2097,45 @@ namespace OpenMS
            << "\t\t\t\t</Measure>\n";
         if (is_ppxl)
         {
-            os << "<!-- userParam cross-link_chain will contain a list of chain type corresponding to the indexed ion [alpha|beta] -->\n";
-            os << "<!-- userParam cross-link_ioncategory will contain a list of ion category corresponding to the indexed ion [xi|ci] -->\n";
+            os << "<!-- userParam cross-link_chain will contain a list of chain type corresponding to the indexed ion [alpha|beta] -->\n";
+            os << "<!-- userParam cross-link_ioncategory will contain a list of ion category corresponding to the indexed ion [xi|ci] -->\n";
+        }
+        os << "\t\t\t</FragmentationTable>\n";
+        if (is_ppxl)
+        {
+          os << sil_map[*sil_it];
+        }
+        else
+        {
+          for (std::vector<PeptideIdentification>::const_iterator it = cpep_id_->begin(); it != cpep_id_->end(); ++it)
+          {
+            std::map<String, String>::const_iterator ps_it = pp_identifier_2_sil_.find(it->getIdentifier());
+            if (ps_it == pp_identifier_2_sil_.end() || ps_it->second != *sil_it) continue;
+
+            //map.begin access ok here because make sure at least one "UNKOWN" element is in the sdats_ids map
+            String sidres;
+            String sir = "SIR_" + String(UniqueIdGenerator::getUniqueId());
+            sidres += String("\t\t\t<SpectrumIdentificationResult spectraData_ref=\"")
+                    + getSpectraDataRef_(*it, sdat_ids.begin()->second) + String("\" spectrumID=\"")
+                    + getSpectrumReference_(*it) + String("\" id=\"") + sir + String("\">\n");
+            for (std::vector<PeptideHit>::const_iterator jt = it->getHits().begin(); jt != it->getHits().end(); ++jt)
+            {
+              String pepi = jt->getSequence().toString();
+              writeSpectrumIdentificationItem_(sidres, *jt, *it, pep_ids[pepi], pep_evis[pepi], cv_ns, pp_identifier_2_thresh);
+            }
+            const double rt = it->getRT();
+            String ert = rt == rt ? String(rt) : "nan";
+            if (!ert.empty() && ert != "nan" && ert != "NaN")
+            {
+              DataValue rtcv(ert);
+              rtcv.setUnit(10); // id: UO:0000010 name: second
+              rtcv.setUnitType(DataValue::UnitType::UNIT_ONTOLOGY);
+              sidres +=  "\t\t\t\t" + cv_.getTermByName("retention time").toXMLString(cv_ns, rtcv) + "\n";
+            }
+            sidres += "\t\t\t</SpectrumIdentificationResult>\n";
+            os << sidres;
+          }
         }
-        os << "\t\t\t</FragmentationTable>\n";
-        os << sil_it->second;
         os << "\t\t</SpectrumIdentificationList>\n";
       }
       os << "\t</AnalysisData>\n</DataCollection>\n";
@@ -1194,302 +2375,308 @@ namespace OpenMS
       return r;
     }
 
-    void MzIdentMLHandler::writePeptideHit(const PeptideHit& hit,
-                                                std::vector<PeptideIdentification>::const_iterator& it,
-                                                std::map<String, String>& pep_ids,
-                                                String cv_ns, std::set<String>& sen_set,
-                                                std::map<String, String>& sen_ids,
-                                                std::map<String, std::vector<String> >& pep_evis,
-                                                std::map<String, double>& pp_identifier_2_thresh,
-                                                String& sidres)
+    String MzIdentMLHandler::getSpectrumReference_(const PeptideIdentification& pep_id) const
     {
-        String pepid =  "PEP_" + String(UniqueIdGenerator::getUniqueId());
-        String pepi = hit.getSequence().toString();
-
-        bool duplicate = false;
-        std::map<String, String>::iterator pit;
-
-        // avoid duplicates
-        pit = pep_ids.find(pepi);
-        if (pit != pep_ids.end())
+      String sid = pep_id.getMetaValue(Constants::UserParam::SPECTRUM_REFERENCE);
+      if (sid.empty())
+      {
+        sid = String(pep_id.getMetaValue("spectrum_id"));
+        if (sid.empty())
         {
-          duplicate = true;
+          String emz(pep_id.getMZ());
+          const double rt = pep_id.getRT();
+          String ert = rt == rt ? String(rt) : "nan";
+          if (pep_id.getMZ() != pep_id.getMZ())
+          {
+            emz = "nan";
+            OPENMS_LOG_WARN << "Found no spectrum reference and no m/z position of identified spectrum! You are probably converting from an old format with insufficient data provision. Setting 'nan' - downstream applications might fail unless you set the references right." << std::endl;
+          }
+          if (pep_id.getRT() != pep_id.getRT())
+          {
+            ert = "nan";
+            OPENMS_LOG_WARN << "Found no spectrum reference and no RT position of identified spectrum! You are probably converting from an old format with insufficient data provision. Setting 'nan' - downstream applications might fail unless you set the references right." << std::endl;
+          }
+          sid = String("MZ:") + emz + String("@RT:") + ert;
         }
+      }
+      return sid;
+    }
+
+    String MzIdentMLHandler::getSpectraDataRef_(const PeptideIdentification& pep_id, const String& default_ref) const
+    {
+      //multi identification runs lookup from file_origin here
+      std::map<String, String>::const_iterator pfo = ph_2_sdat_.find(pep_id.getIdentifier());
+      if (pfo != ph_2_sdat_.end())
+      {
+        return pfo->second;
+      }
+      OPENMS_LOG_WARN << "Falling back to referencing first spectrum file given because file or identifier could not be mapped." << std::endl;
+      return default_ref;
+    }
 
-        if (!duplicate)
+    void MzIdentMLHandler::writePeptide_(String& s, const AASequence& seq, const String& pepid) const
+    {
+      //~ TODO simplify mod cv param write
+      // write peptide id with conversion to universal, "human-readable" bracket string notation
+      s += String("\t<Peptide id=\"") + pepid + String("\" name=\"") +
+            seq.toBracketString(false) + String("\">\n\t\t<PeptideSequence>") + seq.toUnmodifiedString() + String("</PeptideSequence>\n");
+      if (seq.isModified())
+      {
+        const ResidueModification* n_term_mod = seq.getNTerminalModification();
+        if (n_term_mod != nullptr)
         {
-          String p;
-          //~ TODO simplify mod cv param write
-          // write peptide id with conversion to universal, "human-readable" bracket string notation
-          p += String("\t<Peptide id=\"") + pepid + String("\" name=\"") +
-                hit.getSequence().toBracketString(false) + String("\">\n\t\t<PeptideSequence>") + hit.getSequence().toUnmodifiedString() + String("</PeptideSequence>\n");
-          if (hit.getSequence().isModified())
-          {
-            const ResidueModification* n_term_mod = hit.getSequence().getNTerminalModification();
-            if (n_term_mod != nullptr)
-            {
-              p += "\t\t<Modification location=\"0\">\n";
-              String acc = n_term_mod->getUniModAccession();
-              p += "\t\t\t<cvParam accession=\"UNIMOD:" + acc.suffix(':');
-              p += "\" name=\"" + n_term_mod->getId();
-              p += "\" cvRef=\"UNIMOD\"/>";
-              p += "\n\t\t</Modification>\n";
-            }
-            const ResidueModification* c_term_mod = hit.getSequence().getCTerminalModification();
-            if (c_term_mod != nullptr)
-            {
-              p += "\t\t<Modification location=\"" + String(hit.getSequence().size()) + "\">\n";
-              String acc = c_term_mod->getUniModAccession();
-              p += "\t\t\t<cvParam accession=\"UNIMOD:" + acc.suffix(':');
-              p += "\" name=\"" + c_term_mod->getId();
-              p += "\" cvRef=\"UNIMOD\"/>";
-              p += "\n\t\t</Modification>\n";
-            }
-            for (Size i = 0; i < hit.getSequence().size(); ++i)
-            {
-              const ResidueModification* mod = hit.getSequence()[i].getModification(); // "UNIMOD:" prefix??
-              if (mod != nullptr)
-              {
-                //~ p += hit.getSequence()[i].getModification() + "\t" +  hit.getSequence()[i].getOneLetterCode()  + "\t" +  x +   "\n" ;
-                p += "\t\t<Modification location=\"" + String(i + 1);
-                p += "\" residues=\"" + hit.getSequence()[i].getOneLetterCode();
-                String acc = mod->getUniModAccession();
-                if (!acc.empty())
-                {
-                  p += "\">\n\t\t\t<cvParam accession=\"UNIMOD:" + acc.suffix(':'); //TODO @all: do not exclusively use unimod ...
-                  p += "\" name=\"" + mod->getId();
-                  p += "\" cvRef=\"UNIMOD\"/>";
-                  p += "\n\t\t</Modification>\n";
-                }
-                else
-                {
-                  // We have an unknown modification, so lets write unknown
-                  // and at least try to write down the delta mass.
-                  if (mod->getDiffMonoMass() != 0.0)
-                  {
-                    double diffmass = mod->getDiffMonoMass();
-                    p += "\" monoisotopicMassDelta=\"" + String(diffmass);
-                  }
-                  else if (mod->getMonoMass() > 0.0)
-                  {
-                    double diffmass = mod->getMonoMass() - hit.getSequence()[i].getMonoWeight();
-                    p += "\" monoisotopicMassDelta=\"" + String(diffmass);
-                  }
-                  p += "\">\n\t\t\t<cvParam cvRef=\"MS\" accession=\"MS:1001460\" name=\"unknown modification\"/>";
-                  p += "\n\t\t</Modification>\n";
-                }
-              }
-            }
-          }
-          p += "\t</Peptide>\n ";
-          sen_set.insert(p);
-          pep_ids.insert(std::make_pair(pepi, pepid));
+          s += "\t\t<Modification location=\"0\">\n";
+          String acc = n_term_mod->getUniModAccession();
+          s += "\t\t\t<cvParam accession=\"UNIMOD:" + acc.suffix(':');
+          s += "\" name=\"" + n_term_mod->getId();
+          s += "\" cvRef=\"UNIMOD\"/>";
+          s += "\n\t\t</Modification>\n";
         }
-        else
+        const ResidueModification* c_term_mod = seq.getCTerminalModification();
+        if (c_term_mod != nullptr)
         {
-          pepid = pit->second;
+          s += "\t\t<Modification location=\"" + String(seq.size()) + "\">\n";
+          String acc = c_term_mod->getUniModAccession();
+          s += "\t\t\t<cvParam accession=\"UNIMOD:" + acc.suffix(':');
+          s += "\" name=\"" + c_term_mod->getId();
+          s += "\" cvRef=\"UNIMOD\"/>";
+          s += "\n\t\t</Modification>\n";
         }
-
-        std::vector<String> pevid_ids;
-        if (!duplicate)
+        for (Size i = 0; i < seq.size(); ++i)
         {
-          std::vector<PeptideEvidence> peptide_evidences = hit.getPeptideEvidences();
-          // TODO idXML allows peptide hits without protein references! Fails in that case - run PeptideIndexer first
-          for (std::vector<PeptideEvidence>::const_iterator pe = peptide_evidences.begin(); pe != peptide_evidences.end(); ++pe)
+          const ResidueModification* mod = seq[i].getModification(); // "UNIMOD:" prefix??
+          if (mod != nullptr)
           {
-            String pevid =  "PEV_" + String(UniqueIdGenerator::getUniqueId());
-            String dBSequence_ref;
-            map<String, String>::const_iterator pos = sen_ids.find(pe->getProteinAccession());
-            if (pos != sen_ids.end())
-            {
-              dBSequence_ref = pos->second;
-            }
-            else
-            {
-              OPENMS_LOG_ERROR << "Error: Missing or invalid protein reference for peptide '" << pepi << "': '" << pe->getProteinAccession() << "' - skipping." << endl;
-              continue;
-            }
-            String idec;
-            if (hit.metaValueExists(Constants::UserParam::TARGET_DECOY))
-            {
-              idec = String(boost::lexical_cast<std::string>((String(hit.getMetaValue(Constants::UserParam::TARGET_DECOY))).hasSubstring("decoy")));
-            }
-
-            String e;
-            String nc_termini = "-";    // character for N- and C-termini as specified in mzIdentML
-            e += "\t<PeptideEvidence id=\"" + pevid + "\" peptide_ref=\"" + pepid + "\" dBSequence_ref=\"" + dBSequence_ref + "\"";
-
-            if (pe->getAAAfter() != PeptideEvidence::UNKNOWN_AA)
-            {
-              e += " post=\"" + (pe->getAAAfter() == PeptideEvidence::C_TERMINAL_AA ? nc_termini : String(pe->getAAAfter())) + "\"";
-            }
-            if (pe->getAABefore() != PeptideEvidence::UNKNOWN_AA)
-            {
-              e += " pre=\"" + (pe->getAABefore() == PeptideEvidence::N_TERMINAL_AA ? nc_termini : String(pe->getAABefore())) + "\"";
-            }
-            if (pe->getStart() != PeptideEvidence::UNKNOWN_POSITION)
-            {
-              e += " start=\"" + String(pe->getStart() + 1) + "\"";
-            }
-            else if (hit.metaValueExists("start"))
-            {
-              e += " start=\"" + String( int(hit.getMetaValue("start")) + 1) + "\"";
-            }
-            else
-            {
-              OPENMS_LOG_WARN << "Found no start position of peptide hit in protein sequence." << std::endl;
-            }
-            if (pe->getEnd() != PeptideEvidence::UNKNOWN_POSITION)
-            {
-              e += " end=\"" + String(pe->getEnd() + 1) + "\"";
-            }
-            else if (hit.metaValueExists("end"))
+            //~ s += seq[i].getModification() + "\t" +  seq[i].getOneLetterCode()  + "\t" +  x +   "\n" ;
+            s += "\t\t<Modification location=\"" + String(i + 1);
+            s += "\" residues=\"" + seq[i].getOneLetterCode();
+            String acc = mod->getUniModAccession();
+            if (!acc.empty())
             {
-              e += " end=\"" + String( int(hit.getMetaValue("end")) + 1) + "\"";
+              s += "\">\n\t\t\t<cvParam accession=\"UNIMOD:" + acc.suffix(':'); //TODO @all: do not exclusively use unimod ...
+              s += "\" name=\"" + mod->getId();
+              s += "\" cvRef=\"UNIMOD\"/>";
+              s += "\n\t\t</Modification>\n";
             }
             else
             {
-              OPENMS_LOG_WARN << "Found no end position of peptide hit in protein sequence." << std::endl;
-            }
-            if (!idec.empty())
-            {
-              e += " isDecoy=\"" + String(idec)+ "\"";
+              // We have an unknown modification, so lets write unknown
+              // and at least try to write down the delta mass.
+              if (mod->getDiffMonoMass() != 0.0)
+              {
+                double diffmass = mod->getDiffMonoMass();
+                s += "\" monoisotopicMassDelta=\"" + String(diffmass);
+              }
+              else if (mod->getMonoMass() > 0.0)
+              {
+                double diffmass = mod->getMonoMass() - seq[i].getMonoWeight();
+                s += "\" monoisotopicMassDelta=\"" + String(diffmass);
+              }
+              s += "\">\n\t\t\t<cvParam cvRef=\"MS\" accession=\"MS:1001460\" name=\"unknown modification\"/>";
+              s += "\n\t\t</Modification>\n";
             }
-            e += "/>\n";
-            sen_set.insert(e);
-            pevid_ids.push_back(pevid);
           }
-          pep_evis.insert(make_pair(pepi, pevid_ids));
-        }
-        else
-        {
-          pevid_ids =  pep_evis[pepi];
-        }
-
-        String cmz((hit.getSequence().getMonoWeight() +  hit.getCharge() * Constants::PROTON_MASS_U) / hit.getCharge()); //calculatedMassToCharge
-        String r(hit.getRank()); //rank
-        String sc(hit.getScore());
-
-        if (sc.empty())
-        {
-          sc = "NA";
-          OPENMS_LOG_WARN << "No score assigned to this PSM: " /*<< hit.getSequence().toString()*/ << std::endl;
         }
-        String c(hit.getCharge()); //charge
+      }
+      s += "\t</Peptide>\n ";
+    }
 
-        String pte;
-        if (hit.metaValueExists("pass_threshold"))
-        {
-          pte = boost::lexical_cast<std::string>(hit.getMetaValue("pass_threshold"));
-        }
-        else if (pp_identifier_2_thresh.find(it->getIdentifier())!= pp_identifier_2_thresh.end() && pp_identifier_2_thresh.find(it->getIdentifier())->second != 0.0)
+    void MzIdentMLHandler::writePeptideEvidences_(String& s, const PeptideHit& hit, const String& pepid, const std::map<String, String>& sen_ids, std::vector<String>& pevid_ids) const
+    {
+      std::vector<PeptideEvidence> peptide_evidences = hit.getPeptideEvidences();
+      // TODO idXML allows peptide hits without protein references! Fails in that case - run PeptideIndexer first
+      for (std::vector<PeptideEvidence>::const_iterator pe = peptide_evidences.begin(); pe != peptide_evidences.end(); ++pe)
+      {
+        String pevid =  "PEV_" + String(UniqueIdGenerator::getUniqueId());
+        String dBSequence_ref;
+        map<String, String>::const_iterator pos = sen_ids.find(pe->getProteinAccession());
+        if (pos != sen_ids.end())
         {
-          double th = pp_identifier_2_thresh.find(it->getIdentifier())->second;
-          //threshold was 'set' in proteinIdentification (!= default value of member, now check pass
-          pte = boost::lexical_cast<std::string>(it->isHigherScoreBetter() ? hit.getScore() > th : hit.getScore() < th); //passThreshold-eval
+          dBSequence_ref = pos->second;
         }
         else
         {
-          pte = true;
-        }
-
-        //write SpectrumIdentificationItem elements
-        String emz(it->getMZ());
-        String sii = "SII_" + String(UniqueIdGenerator::getUniqueId());
-        String sii_tmp;
-        sii_tmp += String("\t\t\t\t<SpectrumIdentificationItem passThreshold=\"")
-                + pte + String("\" rank=\"") + r + String("\" peptide_ref=\"")
-                + pepid + String("\" calculatedMassToCharge=\"") + cmz
-                + String("\" experimentalMassToCharge=\"") + emz
-                + String("\" chargeState=\"") + c +  String("\" id=\"")
-                + sii + String("\">\n");
-
-        if (pevid_ids.empty())
-        {
-          OPENMS_LOG_WARN << "PSM without peptide evidence registered in the given search database found. This will cause an invalid mzIdentML file (which OpenMS can still consume)." << std::endl;
-        }
-        for (std::vector<String>::const_iterator pevref = pevid_ids.begin(); pevref != pevid_ids.end(); ++pevref)
-        {
-          sii_tmp += "\t\t\t\t\t<PeptideEvidenceRef peptideEvidence_ref=\"" +  String(*pevref) + "\"/>\n";
+          OPENMS_LOG_ERROR << "Error: Missing or invalid protein reference for peptide '" << hit.getSequence().toString() << "': '" << pe->getProteinAccession() << "' - skipping." << endl;
+          continue;
         }
-
-        if (! hit.getPeakAnnotations().empty())
+        String idec;
+        if (hit.metaValueExists(Constants::UserParam::TARGET_DECOY))
         {
-          writeFragmentAnnotations_(sii_tmp, hit.getPeakAnnotations(), 5, false);
+          idec = String(boost::lexical_cast<std::string>((String(hit.getMetaValue(Constants::UserParam::TARGET_DECOY))).hasSubstring("decoy")));
         }
 
-        std::set<String> peptide_result_details;
-        cv_.getAllChildTerms(peptide_result_details, "MS:1001143"); // search engine specific score for PSMs
-        MetaInfoInterface copy_hit = hit;
-        String st(it->getScoreType()); //scoretype
+        String e;
+        String nc_termini = "-";    // character for N- and C-termini as specified in mzIdentML
+        e += "\t<PeptideEvidence id=\"" + pevid + "\" peptide_ref=\"" + pepid + "\" dBSequence_ref=\"" + dBSequence_ref + "\"";
 
-        if (cv_.hasTermWithName(st) && peptide_result_details.find(cv_.getTermByName(st).id) != peptide_result_details.end())
-        {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName(st).toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName(st).id);
-        }
-        else if (cv_.exists(st) && peptide_result_details.find(st) != peptide_result_details.end())
-        {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTerm(st).toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTerm(st).id);
-        }
-        else if (st == "q-value" || st == "FDR")
+        if (pe->getAAAfter() != PeptideEvidence::UNKNOWN_AA)
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("PSM-level q-value").toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName("PSM-level q-value").id);
+          e += " post=\"" + (pe->getAAAfter() == PeptideEvidence::C_TERMINAL_AA ? nc_termini : String(pe->getAAAfter())) + "\"";
         }
-        else if (st == "Posterior Error Probability")
+        if (pe->getAABefore() != PeptideEvidence::UNKNOWN_AA)
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("percolator:PEP").toXMLString(cv_ns, sc); // 'percolaror' was not a typo in the code but in the cv.
-          copy_hit.removeMetaValue(cv_.getTermByName("percolator:PEP").id);
+          e += " pre=\"" + (pe->getAABefore() == PeptideEvidence::N_TERMINAL_AA ? nc_termini : String(pe->getAABefore())) + "\"";
         }
-        else if (st == "OMSSA")
+        if (pe->getStart() != PeptideEvidence::UNKNOWN_POSITION)
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("OMSSA:evalue").toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName("OMSSA:evalue").id);
+          e += " start=\"" + String(pe->getStart() + 1) + "\"";
         }
-        else if (st == "Mascot")
+        else if (hit.metaValueExists("start"))
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("Mascot:score").toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName("Mascot:score").id);
+          e += " start=\"" + String( int(hit.getMetaValue("start")) + 1) + "\"";
         }
-        else if (st == "XTandem")
+        else
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("X\\!Tandem:hyperscore").toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName("X\\!Tandem:hyperscore").id);
+          OPENMS_LOG_WARN << "Found no start position of peptide hit in protein sequence." << std::endl;
         }
-        else if (st == "SEQUEST")
+        if (pe->getEnd() != PeptideEvidence::UNKNOWN_POSITION)
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("Sequest:xcorr").toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName("Sequest:xcorr").id);
+          e += " end=\"" + String(pe->getEnd() + 1) + "\"";
         }
-        else if (st == "MS-GF+")
+        else if (hit.metaValueExists("end"))
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("MS-GF:RawScore").toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName("MS-GF:RawScore").id);
+          e += " end=\"" + String( int(hit.getMetaValue("end")) + 1) + "\"";
         }
-        else if (st == Constants::UserParam::OPENPEPXL_SCORE)
+        else
         {
-          sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName(st).toXMLString(cv_ns, sc);
-          copy_hit.removeMetaValue(cv_.getTermByName(st).id);
+          OPENMS_LOG_WARN << "Found no end position of peptide hit in protein sequence." << std::endl;
         }
-        else
+        if (!idec.empty())
         {
-          String score_name_placeholder = st.empty()?"PSM-level search engine specific statistic":st;
-          sii_tmp += String(5, '\t') + cv_.getTermByName("PSM-level search engine specific statistic").toXMLString(cv_ns);
-          sii_tmp += "\n" + String(5, '\t') + "<userParam name=\"" + score_name_placeholder
-                       + "\" unitName=\"" + "xsd:double" + "\" value=\"" + sc + "\"/>";
-          OPENMS_LOG_WARN << "Converting unknown score type to PSM-level search engine specific statistic from PSI controlled vocabulary." << std::endl;
+          e += " isDecoy=\"" + String(idec)+ "\"";
         }
-        sii_tmp += "\n";
+        e += "/>\n";
+        s += e;
+        pevid_ids.push_back(pevid);
+      }
+    }
+
+    void MzIdentMLHandler::writeSpectrumIdentificationItem_(String& s, const PeptideHit& hit, const PeptideIdentification& pep_id, const String& pepid, const std::vector<String>& pevid_ids, const String& cv_ns, const std::map<String, double>& pp_identifier_2_thresh) const
+    {
+      String cmz((hit.getSequence().getMonoWeight() +  hit.getCharge() * Constants::PROTON_MASS_U) / hit.getCharge()); //calculatedMassToCharge
+      String r(hit.getRank()); //rank
+      String sc(hit.getScore());
+
+      if (sc.empty())
+      {
+        sc = "NA";
+        OPENMS_LOG_WARN << "No score assigned to this PSM: " /*<< hit.getSequence().toString()*/ << std::endl;
+      }
+      String c(hit.getCharge()); //charge
+
+      String pte;
+      if (hit.metaValueExists("pass_threshold"))
+      {
+        pte = boost::lexical_cast<std::string>(hit.getMetaValue("pass_threshold"));
+      }
+      else if (pp_identifier_2_thresh.find(pep_id.getIdentifier())!= pp_identifier_2_thresh.end() && pp_identifier_2_thresh.find(pep_id.getIdentifier())->second != 0.0)
+      {
+        double th = pp_identifier_2_thresh.find(pep_id.getIdentifier())->second;
+        //threshold was 'set' in proteinIdentification (!= default value of member, now check pass
+        pte = boost::lexical_cast<std::string>(pep_id.isHigherScoreBetter() ? hit.getScore() > th : hit.getScore() < th); //passThreshold-eval
+      }
+      else
+      {
+        pte = true;
+      }
+
+      //write SpectrumIdentificationItem elements
+      String emz(pep_id.getMZ());
+      String sii = "SII_" + String(UniqueIdGenerator::getUniqueId());
+      String sii_tmp;
+      sii_tmp += String("\t\t\t\t<SpectrumIdentificationItem passThreshold=\"")
+              + pte + String("\" rank=\"") + r + String("\" peptide_ref=\"")
+              + pepid + String("\" calculatedMassToCharge=\"") + cmz
+              + String("\" experimentalMassToCharge=\"") + emz
+              + String("\" chargeState=\"") + c +  String("\" id=\"")
+              + sii + String("\">\n");
+
+      if (pevid_ids.empty())
+      {
+        OPENMS_LOG_WARN << "PSM without peptide evidence registered in the given search database found. This will cause an invalid mzIdentML file (which OpenMS can still consume)." << std::endl;
+      }
+      for (std::vector<String>::const_iterator pevref = pevid_ids.begin(); pevref != pevid_ids.end(); ++pevref)
+      {
+        sii_tmp += "\t\t\t\t\t<PeptideEvidenceRef peptideEvidence_ref=\"" +  String(*pevref) + "\"/>\n";
+      }
+
+      if (! hit.getPeakAnnotations().empty())
+      {
+        writeFragmentAnnotations_(sii_tmp, hit.getPeakAnnotations(), 5, false);
+      }
+
+      std::set<String> peptide_result_details;
+      cv_.getAllChildTerms(peptide_result_details, "MS:1001143"); // search engine specific score for PSMs
+      MetaInfoInterface copy_hit = hit;
+      String st(pep_id.getScoreType()); //scoretype
+
+      if (cv_.hasTermWithName(st) && peptide_result_details.find(cv_.getTermByName(st).id) != peptide_result_details.end())
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName(st).toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName(st).id);
+      }
+      else if (cv_.exists(st) && peptide_result_details.find(st) != peptide_result_details.end())
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTerm(st).toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTerm(st).id);
+      }
+      else if (st == "q-value" || st == "FDR")
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("PSM-level q-value").toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName("PSM-level q-value").id);
+      }
+      else if (st == "Posterior Error Probability")
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("percolator:PEP").toXMLString(cv_ns, sc); // 'percolaror' was not a typo in the code but in the cv.
+        copy_hit.removeMetaValue(cv_.getTermByName("percolator:PEP").id);
+      }
+      else if (st == "OMSSA")
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("OMSSA:evalue").toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName("OMSSA:evalue").id);
+      }
+      else if (st == "Mascot")
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("Mascot:score").toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName("Mascot:score").id);
+      }
+      else if (st == "XTandem")
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("X\\!Tandem:hyperscore").toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName("X\\!Tandem:hyperscore").id);
+      }
+      else if (st == "SEQUEST")
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("Sequest:xcorr").toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName("Sequest:xcorr").id);
+      }
+      else if (st == "MS-GF+")
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName("MS-GF:RawScore").toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName("MS-GF:RawScore").id);
+      }
+      else if (st == Constants::UserParam::OPENPEPXL_SCORE)
+      {
+        sii_tmp +=  "\t\t\t\t\t" + cv_.getTermByName(st).toXMLString(cv_ns, sc);
+        copy_hit.removeMetaValue(cv_.getTermByName(st).id);
+      }
+      else
+      {
+        String score_name_placeholder = st.empty()?"PSM-level search engine specific statistic":st;
+        sii_tmp += String(5, '\t') + cv_.getTermByName("PSM-level search engine specific statistic").toXMLString(cv_ns);
+        sii_tmp += "\n" + String(5, '\t') + "<userParam name=\"" + score_name_placeholder
+                     + "\" unitName=\"" + "xsd:double" + "\" value=\"" + sc + "\"/>";
+        OPENMS_LOG_WARN << "Converting unknown score type to PSM-level search engine specific statistic from PSI controlled vocabulary." << std::endl;
+      }
+      sii_tmp += "\n";
 
-        copy_hit.removeMetaValue("calcMZ");
-        copy_hit.removeMetaValue(Constants::UserParam::TARGET_DECOY);
-        writeMetaInfos_(sii_tmp, copy_hit, 5);
+      copy_hit.removeMetaValue("calcMZ");
+      copy_hit.removeMetaValue(Constants::UserParam::TARGET_DECOY);
+      writeMetaInfos_(sii_tmp, copy_hit, 5);
 
-        //~ sidres += "<cvParam accession=\"MS:1000796\" cvRef=\"PSI-MS\" value=\"55.835.842.3.dta\" name=\"spectrum title\"/>";
-        sii_tmp += "\t\t\t\t</SpectrumIdentificationItem>\n";
-        sidres += sii_tmp;
+      //~ sidres += "<cvParam accession=\"MS:1000796\" cvRef=\"PSI-MS\" value=\"55.835.842.3.dta\" name=\"spectrum title\"/>";
+      sii_tmp += "\t\t\t\t</SpectrumIdentificationItem>\n";
+      s += sii_tmp;
     }
 
     void MzIdentMLHandler::writeXLMSPeptideHit(const PeptideHit& hit,
@@ -55,7 +55,8 @@ namespace OpenMS
     XMLFile("/SCHEMAS/IdXML_1_5.xsd", "1.5"),
     last_meta_(nullptr),
     document_id_(),
-    prot_id_in_run_(false)
+    prot_id_in_run_(false),
+    sequence_cache_(nullptr)
   {
   }
 
@@ -78,10 +79,14 @@ namespace OpenMS
     prot_ids_ = &protein_ids;
     pep_ids_ = &peptide_ids;
     document_id_ = &document_id;
+    // the same sequences typically occur in many peptide hits
+    AASequenceCache sequence_cache;
+    sequence_cache_ = &sequence_cache;
 
     parse_(filename, this);
 
     //reset members
+    sequence_cache_ = nullptr;
     prot_ids_ = nullptr;
     pep_ids_ = nullptr;
     last_meta_ = nullptr;
@@ -645,7 +650,8 @@ namespace OpenMS
 
       pep_hit_.setCharge(attributeAsInt_(attributes, "charge"));
       pep_hit_.setScore(attributeAsDouble_(attributes, "score"));
-      pep_hit_.setSequence(AASequence::fromString(String(attributeAsString_(attributes, "sequence"))));
+      String sequence = attributeAsString_(attributes, "sequence");
+      pep_hit_.setSequence(sequence_cache_ ? sequence_cache_->parse(sequence) : AASequence::fromString(sequence));
 
       //parse optional protein ids to determine accessions
       const XMLCh* refs = attributes.getValue(sm_.convert("protein_refs").c_str());
@@ -55,8 +55,20 @@ namespace OpenMS
 
   void MzIdentMLFile::load(const String& filename, std::vector<ProteinIdentification>& poid, std::vector<PeptideIdentification>& peid)
   {
-    Internal::MzIdentMLDOMHandler handler(poid, peid, schema_version_, *this);
-    handler.readMzIdentMLFile(filename);
+    // stream the file in a single pass; only cross-linking searches need the random access of the DOM reader
+    const Size pro_size = poid.size();
+    const Size pep_size = peid.size();
+    Internal::MzIdentMLHandler handler(poid, peid, filename, schema_version_, *this);
+    parse_(filename, &handler);
+
+    if (handler.isCrossLinkingSearch())
+    {
+      // the SAX reader stopped at the XL-MS protocol, discard whatever it produced so far
+      poid.resize(pro_size);
+      peid.resize(pep_size);
+      Internal::MzIdentMLDOMHandler dom_handler(poid, peid, schema_version_, *this);
+      dom_handler.readMzIdentMLFile(filename);
+    }
   }
 
   void MzIdentMLFile::store(const String& filename, const Identification& id) const
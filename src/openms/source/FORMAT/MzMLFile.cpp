@@ -40,6 +40,7 @@
 #include <OpenMS/FORMAT/VALIDATORS/MzMLValidator.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 #include <sstream>
 
@@ -165,6 +166,7 @@ namespace OpenMS
 
   void MzMLFile::load(const String& filename, PeakMap& map)
   {
+    Profiler::Stage stage("MzMLFile::load");
     map.reset();
 
     //set DocumentIdentifier
@@ -174,10 +176,13 @@ namespace OpenMS
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     safeParse_(filename, &handler);
+    Profiler::addCount("MzMLFile::load:spectra", map.size());
+    Profiler::addCount("MzMLFile::load:chromatograms", map.getChromatograms().size());
   }
 
   void MzMLFile::store(const String& filename, const PeakMap& map) const
   {
+    Profiler::Stage stage("MzMLFile::store");
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     save_(filename, &handler);
@@ -52,6 +52,7 @@ namespace OpenMS
     proteins_(nullptr),
     peptides_(nullptr),
     lookup_(nullptr),
+    sequence_cache_(nullptr),
     scan_map_(),
     analysis_summary_(false),
     keep_native_name_(false),
@@ -727,8 +728,14 @@ namespace OpenMS
     seen_experiment_ = exp_name_.empty();
     checked_base_name_ = exp_name_.empty();
 
+    // the same sequences typically occur in many search hits
+    AASequenceCache sequence_cache;
+    sequence_cache_ = &sequence_cache;
+
     parse_(filename, this);
 
+    sequence_cache_ = nullptr;
+
     if (!seen_experiment_)
     {
       fatalError(LOAD, "Found no experiment with name '" + experiment_name + "'");
@@ -1498,7 +1505,7 @@ namespace OpenMS
     }
     else if (element == "search_hit")
     {
-      AASequence temp_aa_sequence = AASequence::fromString(current_sequence_);
+      AASequence temp_aa_sequence = sequence_cache_ ? sequence_cache_->parse(current_sequence_) : AASequence::fromString(current_sequence_);
 
       // modification position is 1-based
       for (vector<pair<String, Size> >::const_iterator it = current_modifications_.begin(); it != current_modifications_.end(); ++it)
@@ -171,14 +171,25 @@ namespace OpenMS
     {
       dataConsumer = std::make_shared<RegularSwathFileConsumer>(known_window_boundaries);
     }
+    else if (readoptions == "compact")
+    {
+      dataConsumer = std::make_shared<CompactSwathFileConsumer>(known_window_boundaries);
+    }
     else if (readoptions == "cache")
     {
       dataConsumer = std::make_shared<CachedSwathFileConsumer>(known_window_boundaries, tmp, tmp_fname, nr_ms1_spectra, swath_counter);
+#ifdef _OPENMP
+      // encode and write the individual SWATH windows to disk in parallel
+      dataConsumer->setWriterThreads(omp_get_max_threads());
+#endif
     }
     else if (readoptions == "split")
     {
       // WARNING: swath_maps will be empty when querying retrieveSwathMaps()
       dataConsumer = std::make_shared<MzMLSwathFileConsumer>(known_window_boundaries, tmp, tmp_fname, nr_ms1_spectra, swath_counter);
+#ifdef _OPENMP
+      dataConsumer->setWriterThreads(omp_get_max_threads());
+#endif
     }
     else
     {
@@ -198,7 +209,8 @@ namespace OpenMS
     }
     consumer_list.push_back(dataConsumer.get());
     MSDataChainingConsumer chaining_consumer(consumer_list);
-    MzMLFile().transform(file, &chaining_consumer);
+    // the spectra were already counted above, no need for a full counting pass
+    MzMLFile().transform(file, &chaining_consumer, true);
 
     OPENMS_LOG_DEBUG << "Finished parsing Swath file " << std::endl;
     std::vector<OpenSwath::SwathMap> swath_maps;
@@ -241,14 +253,25 @@ namespace OpenMS
       dataConsumer = new RegularSwathFileConsumer(known_window_boundaries);
       MzXMLFile().transform(file, dataConsumer);
     }
+    else if (readoptions == "compact")
+    {
+      dataConsumer = new CompactSwathFileConsumer(known_window_boundaries);
+      MzXMLFile().transform(file, dataConsumer);
+    }
     else if (readoptions == "cache")
     {
       dataConsumer = new CachedSwathFileConsumer(known_window_boundaries, tmp, tmp_fname, nr_ms1_spectra, swath_counter);
+#ifdef _OPENMP
+      dataConsumer->setWriterThreads(omp_get_max_threads());
+#endif
       MzXMLFile().transform(file, dataConsumer);
     }
     else if (readoptions == "split")
     {
       dataConsumer = new MzMLSwathFileConsumer(known_window_boundaries, tmp, tmp_fname, nr_ms1_spectra, swath_counter);
+#ifdef _OPENMP
+      dataConsumer->setWriterThreads(omp_get_max_threads());
+#endif
       MzXMLFile().transform(file, dataConsumer);
     }
     else
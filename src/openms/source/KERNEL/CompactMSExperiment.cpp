@@ -0,0 +1,179 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/CompactMSExperiment.h>
+
+namespace OpenMS
+{
+  bool CompactMSExperiment::operator==(const CompactMSExperiment& rhs) const
+  {
+    return settings_ == rhs.settings_ &&
+           spectra_ == rhs.spectra_ &&
+           chromatograms_ == rhs.chromatograms_;
+  }
+
+  bool CompactMSExperiment::operator!=(const CompactMSExperiment& rhs) const
+  {
+    return !(operator==(rhs));
+  }
+
+  void CompactMSExperiment::fromExperiment(PeakMap& exp)
+  {
+    clear();
+    settings_ = exp.getExperimentalSettings();
+    chromatograms_ = exp.getChromatograms();
+
+    spectra_.reserve(exp.size());
+    for (MSSpectrum& spectrum : exp)
+    {
+      spectra_.emplace_back(spectrum);
+      spectrum.clear(true); // release the peak memory right away
+    }
+    exp.getSpectra().clear();
+    exp.getSpectra().shrink_to_fit();
+  }
+
+  void CompactMSExperiment::toExperiment(PeakMap& exp) const
+  {
+    exp.clear(true);
+    exp.getExperimentalSettings() = settings_;
+    exp.reserveSpaceSpectra(spectra_.size());
+    for (const CompactSpectrum& spectrum : spectra_)
+    {
+      exp.addSpectrum(spectrum.toSpectrum());
+    }
+    exp.setChromatograms(chromatograms_);
+    exp.updateRanges();
+  }
+
+  Size CompactMSExperiment::getNrSpectra() const
+  {
+    return spectra_.size();
+  }
+
+  Size CompactMSExperiment::getNrChromatograms() const
+  {
+    return chromatograms_.size();
+  }
+
+  Size CompactMSExperiment::size() const
+  {
+    return getNrSpectra();
+  }
+
+  bool CompactMSExperiment::empty() const
+  {
+    return spectra_.empty() && chromatograms_.empty();
+  }
+
+  MSSpectrum CompactMSExperiment::getSpectrum(Size id) const
+  {
+    return spectra_[id].toSpectrum();
+  }
+
+  MSSpectrum CompactMSExperiment::operator[](Size id) const
+  {
+    return getSpectrum(id);
+  }
+
+  const CompactSpectrum& CompactMSExperiment::getCompactSpectrum(Size id) const
+  {
+    return spectra_[id];
+  }
+
+  const MSChromatogram& CompactMSExperiment::getChromatogram(Size id) const
+  {
+    return chromatograms_[id];
+  }
+
+  const std::vector<CompactSpectrum>& CompactMSExperiment::getSpectra() const
+  {
+    return spectra_;
+  }
+
+  const std::vector<MSChromatogram>& CompactMSExperiment::getChromatograms() const
+  {
+    return chromatograms_;
+  }
+
+  void CompactMSExperiment::addSpectrum(const MSSpectrum& spectrum)
+  {
+    spectra_.emplace_back(spectrum);
+  }
+
+  void CompactMSExperiment::addSpectrum(CompactSpectrum&& spectrum)
+  {
+    spectra_.push_back(std::move(spectrum));
+  }
+
+  void CompactMSExperiment::addChromatogram(const MSChromatogram& chromatogram)
+  {
+    chromatograms_.push_back(chromatogram);
+  }
+
+  void CompactMSExperiment::reserve(Size s_size, Size c_size)
+  {
+    spectra_.reserve(s_size);
+    chromatograms_.reserve(c_size);
+  }
+
+  const ExperimentalSettings& CompactMSExperiment::getExperimentalSettings() const
+  {
+    return settings_;
+  }
+
+  void CompactMSExperiment::setExperimentalSettings(const ExperimentalSettings& settings)
+  {
+    settings_ = settings;
+  }
+
+  void CompactMSExperiment::clear()
+  {
+    settings_ = ExperimentalSettings();
+    spectra_.clear();
+    chromatograms_.clear();
+  }
+
+  Size CompactMSExperiment::getPeakDataSize() const
+  {
+    Size bytes = 0;
+    for (const CompactSpectrum& spectrum : spectra_)
+    {
+      bytes += spectrum.getPeakDataSize();
+    }
+    return bytes;
+  }
+
+} // namespace OpenMS
+
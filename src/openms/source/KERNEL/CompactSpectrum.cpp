@@ -0,0 +1,189 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/CompactSpectrum.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace OpenMS
+{
+  CompactSpectrum::CompactSpectrum() :
+    settings_(),
+    mz_offset_(0.0),
+    mz_step_(1.0),
+    mz_codes_(),
+    intensities_()
+  {
+  }
+
+  CompactSpectrum::CompactSpectrum(const MSSpectrum& spectrum) :
+    CompactSpectrum()
+  {
+    set(spectrum);
+  }
+
+  bool CompactSpectrum::operator==(const CompactSpectrum& rhs) const
+  {
+    return settings_ == rhs.settings_ &&
+           mz_offset_ == rhs.mz_offset_ &&
+           mz_step_ == rhs.mz_step_ &&
+           mz_codes_ == rhs.mz_codes_ &&
+           intensities_ == rhs.intensities_;
+  }
+
+  bool CompactSpectrum::operator!=(const CompactSpectrum& rhs) const
+  {
+    return !(operator==(rhs));
+  }
+
+  void CompactSpectrum::set(const MSSpectrum& spectrum)
+  {
+    // copy the meta data only (copying the full spectrum would temporarily duplicate the peaks)
+    settings_.clear(true);
+    settings_ = static_cast<const SpectrumSettings&>(spectrum);
+    settings_.setRT(spectrum.getRT());
+    settings_.setDriftTime(spectrum.getDriftTime());
+    settings_.setDriftTimeUnit(spectrum.getDriftTimeUnit());
+    settings_.setMSLevel(spectrum.getMSLevel());
+    settings_.setName(spectrum.getName());
+    settings_.setFloatDataArrays(spectrum.getFloatDataArrays());
+    settings_.setStringDataArrays(spectrum.getStringDataArrays());
+    settings_.setIntegerDataArrays(spectrum.getIntegerDataArrays());
+
+    mz_codes_.clear();
+    intensities_.clear();
+    mz_offset_ = 0.0;
+    mz_step_ = 1.0;
+    if (spectrum.empty())
+    {
+      mz_codes_.shrink_to_fit();
+      intensities_.shrink_to_fit();
+      return;
+    }
+
+    // the spectrum is not required to be sorted
+    double min_mz = spectrum[0].getMZ(), max_mz = spectrum[0].getMZ();
+    for (const Peak1D& p : spectrum)
+    {
+      min_mz = std::min(min_mz, p.getMZ());
+      max_mz = std::max(max_mz, p.getMZ());
+    }
+    const double max_code = static_cast<double>(std::numeric_limits<UInt32>::max());
+    mz_offset_ = min_mz;
+    if (max_mz > min_mz) mz_step_ = (max_mz - min_mz) / max_code;
+
+    mz_codes_.resize(spectrum.size());
+    intensities_.resize(spectrum.size());
+    for (Size i = 0; i < spectrum.size(); ++i)
+    {
+      double code = std::floor((spectrum[i].getMZ() - mz_offset_) / mz_step_ + 0.5);
+      mz_codes_[i] = static_cast<UInt32>(std::min(std::max(code, 0.0), max_code));
+      intensities_[i] = spectrum[i].getIntensity();
+    }
+    mz_codes_.shrink_to_fit();
+    intensities_.shrink_to_fit();
+  }
+
+  MSSpectrum CompactSpectrum::toSpectrum() const
+  {
+    MSSpectrum spectrum;
+    get(spectrum);
+    return spectrum;
+  }
+
+  void CompactSpectrum::get(MSSpectrum& spectrum) const
+  {
+    spectrum = settings_;
+    spectrum.resize(mz_codes_.size());
+    for (Size i = 0; i < mz_codes_.size(); ++i)
+    {
+      spectrum[i].setMZ(getMZ(i));
+      spectrum[i].setIntensity(intensities_[i]);
+    }
+  }
+
+  Size CompactSpectrum::size() const
+  {
+    return mz_codes_.size();
+  }
+
+  bool CompactSpectrum::empty() const
+  {
+    return mz_codes_.empty();
+  }
+
+  void CompactSpectrum::clear()
+  {
+    *this = CompactSpectrum();
+  }
+
+  double CompactSpectrum::getMZ(Size index) const
+  {
+    return mz_offset_ + mz_step_ * mz_codes_[index];
+  }
+
+  float CompactSpectrum::getIntensity(Size index) const
+  {
+    return intensities_[index];
+  }
+
+  double CompactSpectrum::getMZAccuracy() const
+  {
+    return mz_codes_.empty() ? 0.0 : mz_step_ / 2.0;
+  }
+
+  const MSSpectrum& CompactSpectrum::getSettings() const
+  {
+    return settings_;
+  }
+
+  double CompactSpectrum::getRT() const
+  {
+    return settings_.getRT();
+  }
+
+  UInt CompactSpectrum::getMSLevel() const
+  {
+    return settings_.getMSLevel();
+  }
+
+  Size CompactSpectrum::getPeakDataSize() const
+  {
+    return mz_codes_.size() * sizeof(UInt32) + intensities_.size() * sizeof(float);
+  }
+
+} // namespace OpenMS
+
@@ -8,6 +8,8 @@ BaseFeature.cpp
 ConsensusFeature.cpp
 ConsensusMap.cpp
 ConversionHelper.cpp
+CompactMSExperiment.cpp
+CompactSpectrum.cpp
 DPeak.cpp
 Feature.cpp
 FeatureHandle.cpp
@@ -0,0 +1,235 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/SYSTEM/Profiler.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/SysInfo.h>
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <iomanip>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  bool Profiler::enabled_ = false;
+  std::vector<String> Profiler::stage_names_;
+  std::map<String, Profiler::StageStatistics> Profiler::stages_;
+  std::map<String, Int64> Profiler::counts_;
+
+  Profiler::StageStatistics::StageStatistics() :
+    calls(0),
+    wall_time(0.0),
+    cpu_time(0.0),
+    peak_memory(0),
+    peak_memory_increase(0)
+  {
+  }
+
+  double Profiler::StageStatistics::getThreadUtilization() const
+  {
+    if (wall_time <= 0.0) return 0.0;
+    return cpu_time / wall_time;
+  }
+
+  Profiler::Stage::Stage(const String& name) :
+    name_(name),
+    active_(Profiler::isEnabled()),
+    watch_(),
+    peak_memory_before_(0)
+  {
+    if (!active_) return;
+    SysInfo::getProcessPeakMemoryConsumption(peak_memory_before_);
+    watch_.start();
+  }
+
+  Profiler::Stage::~Stage()
+  {
+    stop();
+  }
+
+  void Profiler::Stage::stop()
+  {
+    if (!active_) return;
+    active_ = false;
+    watch_.stop();
+    size_t peak_memory(0);
+    SysInfo::getProcessPeakMemoryConsumption(peak_memory);
+    size_t increase = (peak_memory > peak_memory_before_) ? peak_memory - peak_memory_before_ : 0;
+    Profiler::addStage(name_, watch_.getClockTime(), watch_.getCPUTime(), peak_memory, increase);
+  }
+
+  void Profiler::setEnabled(bool enabled)
+  {
+    enabled_ = enabled;
+  }
+
+  bool Profiler::isEnabled()
+  {
+    return enabled_;
+  }
+
+  void Profiler::clear()
+  {
+#ifdef _OPENMP
+#pragma omp critical (Profiler)
+#endif
+    {
+      stage_names_.clear();
+      stages_.clear();
+      counts_.clear();
+    }
+  }
+
+  void Profiler::addStage(const String& name, double wall_time, double cpu_time, size_t peak_memory, size_t peak_memory_increase)
+  {
+#ifdef _OPENMP
+#pragma omp critical (Profiler)
+#endif
+    {
+      std::map<String, StageStatistics>::iterator it = stages_.find(name);
+      if (it == stages_.end())
+      {
+        stage_names_.push_back(name);
+        it = stages_.insert(std::make_pair(name, StageStatistics())).first;
+      }
+      StageStatistics& stats = it->second;
+      ++stats.calls;
+      stats.wall_time += wall_time;
+      stats.cpu_time += cpu_time;
+      stats.peak_memory = std::max(stats.peak_memory, peak_memory);
+      stats.peak_memory_increase = std::max(stats.peak_memory_increase, peak_memory_increase);
+    }
+  }
+
+  void Profiler::addCount(const String& name, Int64 count)
+  {
+    if (!enabled_) return;
+#ifdef _OPENMP
+#pragma omp critical (Profiler)
+#endif
+    counts_[name] += count;
+  }
+
+  std::vector<String> Profiler::getStageNames()
+  {
+    std::vector<String> names;
+#ifdef _OPENMP
+#pragma omp critical (Profiler)
+#endif
+    names = stage_names_;
+    return names;
+  }
+
+  Profiler::StageStatistics Profiler::getStage(const String& name)
+  {
+    StageStatistics stats;
+#ifdef _OPENMP
+#pragma omp critical (Profiler)
+#endif
+    {
+      std::map<String, StageStatistics>::const_iterator it = stages_.find(name);
+      if (it != stages_.end()) stats = it->second;
+    }
+    return stats;
+  }
+
+  std::map<String, Int64> Profiler::getCounts()
+  {
+    std::map<String, Int64> counts;
+#ifdef _OPENMP
+#pragma omp critical (Profiler)
+#endif
+    counts = counts_;
+    return counts;
+  }
+
+  void Profiler::storeJSON(const String& filename, const String& name)
+  {
+    using json = nlohmann::json;
+
+    json out;
+    out["name"] = name;
+#ifdef _OPENMP
+    out["max_threads"] = omp_get_max_threads();
+#else
+    out["max_threads"] = 1;
+#endif
+    size_t peak_memory(0);
+    if (SysInfo::getProcessPeakMemoryConsumption(peak_memory))
+    {
+      out["peak_memory_kb"] = peak_memory;
+    }
+
+    json stages = json::array();
+    std::vector<String> names = getStageNames();
+    for (std::vector<String>::const_iterator it = names.begin(); it != names.end(); ++it)
+    {
+      StageStatistics stats = getStage(*it);
+      json stage;
+      stage["name"] = *it;
+      stage["calls"] = stats.calls;
+      stage["wall_time_s"] = stats.wall_time;
+      stage["cpu_time_s"] = stats.cpu_time;
+      stage["thread_utilization"] = stats.getThreadUtilization();
+      stage["peak_memory_kb"] = stats.peak_memory;
+      stage["peak_memory_increase_kb"] = stats.peak_memory_increase;
+      stages.push_back(stage);
+    }
+    out["stages"] = stages;
+
+    json counts = json::object();
+    std::map<String, Int64> all_counts = getCounts();
+    for (std::map<String, Int64>::const_iterator it = all_counts.begin(); it != all_counts.end(); ++it)
+    {
+      counts[it->first] = it->second;
+    }
+    out["counts"] = counts;
+
+    std::ofstream o(filename);
+    o << std::setw(2) << out << std::endl;
+    // check after writing, to include check for full disk
+    if (!o)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    o.close();
+  }
+
+}
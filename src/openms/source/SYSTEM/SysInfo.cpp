@@ -40,9 +40,11 @@
 #elif __APPLE__
 #include <mach/mach.h>
 #include <mach/mach_init.h>
+#include <sys/resource.h>
 #else
 #include <cstdio>
 #include <unistd.h>
+#include <sys/resource.h>
 
 #define OMS_USELINUXMEMORYPLATFORM
 #endif
@@ -141,12 +143,19 @@ namespace OpenMS
     }
     mem_virtual = pmc.PeakWorkingSetSize / 1024; // byte to KB
     return true;
-#elif __APPLE__
-    //todo: find a good API to do this
-    return false;
+#else
+    // maximum resident set size of the process
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+      return false;
+    }
+#ifdef __APPLE__
+    mem_virtual = (size_t)usage.ru_maxrss / 1024; // byte to KB
 #else // Linux
-    //todo: find a good API to do this
-    return false;
+    mem_virtual = (size_t)usage.ru_maxrss; // already in KB
+#endif
+    return true;
 #endif
   }
 
@@ -39,6 +39,12 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/EGHTraceFitter.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/GaussTraceFitter.h>
 
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -125,207 +131,266 @@ void ElutionModelFitter::fitElutionModels(FeatureMap& features)
   double asym_limit = (asymmetric ? 
                        double(param_.getValue("check:asymmetry")) : 0.0);
 
-  TraceFitter* fitter;
-  if (asymmetric)
-  {
-    fitter = new EGHTraceFitter();
-  }
-  else fitter = new GaussTraceFitter();
-  if (weighted)
-  {
-    Param params = fitter->getDefaults();
-    params.setValue("weighted", "true");
-    fitter->setParameters(params);
-  }
-
-  // store model parameters to find outliers later; store values redundantly -
-  // once aligned with the features in the map, once only for successful models:
-  vector<double> widths_all, widths_good, asym_all, asym_good;
+  // store model parameters (aligned with the features in the map) to find
+  // outliers later:
+  vector<double> widths_all, asym_all;
   if (width_limit > 0)
   {
     widths_all.resize(features.size(), numeric_limits<double>::quiet_NaN());
-    widths_good.reserve(features.size());
   }
   if (asym_limit > 0)
   {
     asym_all.resize(features.size(), numeric_limits<double>::quiet_NaN());
-    asym_good.reserve(features.size());
   }
 
-  // collect peaks that constitute mass traces:
-  OPENMS_LOG_DEBUG << "Fitting elution models to features:" << endl;
-  Size index = 0;
-  for (FeatureMap::Iterator feat_it = features.begin(); 
-       feat_it != features.end(); ++feat_it, ++index)
+  // check input first - exceptions must not be thrown inside the parallel
+  // region below:
+  for (FeatureMap::ConstIterator feat_it = features.begin();
+       feat_it != features.end(); ++feat_it)
   {
-    // OPENMS_LOG_DEBUG << String(feat_it->getMetaValue("PeptideRef")) << endl;
-    double region_start = double(feat_it->getMetaValue("leftWidth"));
-    double region_end = double(feat_it->getMetaValue("rightWidth"));
-
     if (feat_it->getSubordinates().empty())
     {
       throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No subordinate features for mass traces available.");
     }
-    const Feature& sub = feat_it->getSubordinates()[0];
-    if (sub.getConvexHulls().empty())
+    if (feat_it->getSubordinates()[0].getConvexHulls().empty())
     {
       throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No hull points for mass trace in subordinate feature available.");
     }
-
-    vector<Peak1D> peaks;
-    // reserve space once, to avoid copying and invalidating pointers:
-    Size points_per_hull = sub.getConvexHulls()[0].getHullPoints().size();
-    peaks.reserve(feat_it->getSubordinates().size() * points_per_hull +
-                  (add_zeros > 0.0)); // don't forget additional zero point
-    MassTraces traces;
-    traces.max_trace = 0;
-    // need a mass trace for every transition, plus maybe one for add. zeros:
-    traces.reserve(feat_it->getSubordinates().size() + (add_zeros > 0.0));
-    for (vector<Feature>::iterator sub_it = feat_it->getSubordinates().begin();
-         sub_it != feat_it->getSubordinates().end(); ++sub_it)
+    if (feat_it->getMetaValue("leftWidth").isEmpty() || feat_it->getMetaValue("rightWidth").isEmpty())
     {
-      MassTrace trace;
-      trace.peaks.reserve(points_per_hull);
-      trace.theoretical_int = sub_it->getMetaValue("isotope_probability");
-      const ConvexHull2D& hull = sub_it->getConvexHulls()[0];
-      for (ConvexHull2D::PointArrayTypeConstIterator point_it = 
-             hull.getHullPoints().begin(); point_it !=
-             hull.getHullPoints().end(); ++point_it)
-      {
-        double intensity = point_it->getY();
-        if (intensity > 0.0) // only use non-zero intensities for fitting
-        {
-          Peak1D peak;
-          peak.setMZ(sub_it->getMZ());
-          peak.setIntensity(intensity);
-          peaks.push_back(peak);
-          trace.peaks.push_back(make_pair(point_it->getX(), &peaks.back()));
-        }
-      }
-      trace.updateMaximum();
-      if (!trace.peaks.empty()) traces.push_back(trace);
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No RT region ('leftWidth'/'rightWidth') for feature available.");
     }
-
-    // find the trace with maximal intensity:
-    Size max_trace = 0;
-    double max_intensity = 0;
-    for (Size i = 0; i < traces.size(); ++i)
+    for (vector<Feature>::const_iterator sub_it = feat_it->getSubordinates().begin();
+         sub_it != feat_it->getSubordinates().end(); ++sub_it)
     {
-      if (traces[i].max_peak->getIntensity() > max_intensity)
+      if (sub_it->getMetaValue("isotope_probability").isEmpty())
       {
-        max_trace = i;
-        max_intensity = traces[i].max_peak->getIntensity();
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No 'isotope_probability' for mass trace in subordinate feature available.");
       }
     }
-    traces.max_trace = max_trace;
-    traces.baseline = 0.0;
-
-    if (add_zeros > 0.0)
-    {
-      MassTrace trace;
-      trace.peaks.reserve(2);
-      trace.theoretical_int = add_zeros;
-      Peak1D peak;
-      peak.setMZ(feat_it->getSubordinates()[0].getMZ());
-      peak.setIntensity(0.0);
-      peaks.push_back(peak);
-      double offset = 0.2 * (region_start - region_end);
-      trace.peaks.push_back(make_pair(region_start - offset, &peaks.back()));
-      trace.peaks.push_back(make_pair(region_end + offset, &peaks.back()));
-      traces.push_back(trace);
-    }
-
-    // fit the model:
-    bool fit_success = true;
-    try
-    {
-      fitter->fit(traces);
-    }
-    catch (Exception::UnableToFit& except)
-    {
-      OPENMS_LOG_ERROR << "Error fitting model to feature '" << feat_it->getUniqueId()
-                << "': " << except.getName() << " - " << except.getMessage()
-                << endl;
-      fit_success = false;
-    }
+  }
 
-    // record model parameters:
-    double center = fitter->getCenter(), height = fitter->getHeight();
-    feat_it->setMetaValue("model_height", height);
-    feat_it->setMetaValue("model_FWHM", fitter->getFWHM());
-    feat_it->setMetaValue("model_center", center);
-    feat_it->setMetaValue("model_lower", fitter->getLowerRTBound());
-    feat_it->setMetaValue("model_upper", fitter->getUpperRTBound());
+  // features are fitted independently (in parallel); fitters keep the state
+  // of the last fit, so every thread needs its own instance:
+  OPENMS_LOG_DEBUG << "Fitting elution models to features:" << endl;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    TraceFitter* fitter;
     if (asymmetric)
     {
-      EGHTraceFitter* egh = static_cast<EGHTraceFitter*>(fitter);
-      feat_it->setMetaValue("model_EGH_tau", egh->getTau());
-      feat_it->setMetaValue("model_EGH_sigma", egh->getSigma());
+      fitter = new EGHTraceFitter();
     }
-    else
+    else fitter = new GaussTraceFitter();
+    if (weighted)
     {
-      GaussTraceFitter* gauss = static_cast<GaussTraceFitter*>(fitter);
-      feat_it->setMetaValue("model_Gauss_sigma", gauss->getSigma());
+      Param params = fitter->getDefaults();
+      params.setValue("weighted", "true");
+      fitter->setParameters(params);
     }
 
-    // goodness of fit:
-    double mre = -1.0; // mean relative error
-    if (fit_success)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+    for (SignedSize index = 0; index < SignedSize(features.size()); ++index)
     {
-      mre = calculateFitQuality_(fitter, traces);
-    }
-    feat_it->setMetaValue("model_error", mre);
+      FeatureMap::Iterator feat_it = features.begin() + index;
+      // OPENMS_LOG_DEBUG << String(feat_it->getMetaValue("PeptideRef")) << endl;
+      double region_start = double(feat_it->getMetaValue("leftWidth"));
+      double region_end = double(feat_it->getMetaValue("rightWidth"));
+
+      // collect peaks that constitute mass traces:
+      const Feature& sub = feat_it->getSubordinates()[0];
+      vector<Peak1D> peaks;
+      // reserve space once, to avoid copying and invalidating pointers:
+      Size points_per_hull = sub.getConvexHulls()[0].getHullPoints().size();
+      peaks.reserve(feat_it->getSubordinates().size() * points_per_hull +
+                    (add_zeros > 0.0)); // don't forget additional zero point
+      MassTraces traces;
+      traces.max_trace = 0;
+      // need a mass trace for every transition, plus maybe one for add. zeros:
+      traces.reserve(feat_it->getSubordinates().size() + (add_zeros > 0.0));
+      for (vector<Feature>::iterator sub_it = feat_it->getSubordinates().begin();
+           sub_it != feat_it->getSubordinates().end(); ++sub_it)
+      {
+        MassTrace trace;
+        trace.peaks.reserve(points_per_hull);
+        trace.theoretical_int = sub_it->getMetaValue("isotope_probability");
+        const ConvexHull2D& hull = sub_it->getConvexHulls()[0];
+        for (ConvexHull2D::PointArrayTypeConstIterator point_it = 
+               hull.getHullPoints().begin(); point_it !=
+               hull.getHullPoints().end(); ++point_it)
+        {
+          double intensity = point_it->getY();
+          if (intensity > 0.0) // only use non-zero intensities for fitting
+          {
+            Peak1D peak;
+            peak.setMZ(sub_it->getMZ());
+            peak.setIntensity(intensity);
+            peaks.push_back(peak);
+            trace.peaks.push_back(make_pair(point_it->getX(), &peaks.back()));
+          }
+        }
+        trace.updateMaximum();
+        if (!trace.peaks.empty()) traces.push_back(trace);
+      }
 
-    // check model validity:
-    double area = fitter->getArea();
-    feat_it->setMetaValue("model_area", area);
-    if ((area != area) || (area <= area_limit)) // x != x: test for NaN
-    {
-      feat_it->setMetaValue("model_status", "1 (invalid area)");
-    }
-    else if ((center <= region_start) || (center >= region_end))
-    {
-      feat_it->setMetaValue("model_status", "2 (center out of bounds)");
-    }
-    else if (fitter->getValue(region_start) > check_boundaries * height)
-    {
-      feat_it->setMetaValue("model_status", "3 (left side out of bounds)");
-    }
-    else if (fitter->getValue(region_end) > check_boundaries * height)
-    {
-      feat_it->setMetaValue("model_status", "4 (right side out of bounds)");
-    }
-    else
-    {
-      feat_it->setMetaValue("model_status", "0 (valid)");
-      // store model parameters to find outliers later:
-      if (asymmetric)
+      // find the trace with maximal intensity:
+      Size max_trace = 0;
+      double max_intensity = 0;
+      for (Size i = 0; i < traces.size(); ++i)
       {
-        double sigma = feat_it->getMetaValue("model_EGH_sigma");
-        double abs_tau = fabs(double(feat_it->getMetaValue("model_EGH_tau")));
-        if (width_limit > 0)
+        if (traces[i].max_peak->getIntensity() > max_intensity)
         {
-          // see implementation of "EGHTraceFitter::getArea":
-          double width = sigma * 0.6266571 + abs_tau;
-          widths_all[index] = width;
-          widths_good.push_back(width);
+          max_trace = i;
+          max_intensity = traces[i].max_peak->getIntensity();
         }
-        if (asym_limit > 0)
+      }
+      traces.max_trace = max_trace;
+      traces.baseline = 0.0;
+
+      // no signal to fit to - reject without running the optimization:
+      if (traces.size() == 0)
+      {
+        feat_it->setMetaValue("model_height", 0.0);
+        feat_it->setMetaValue("model_FWHM", 0.0);
+        feat_it->setMetaValue("model_center", 0.0);
+        feat_it->setMetaValue("model_lower", 0.0);
+        feat_it->setMetaValue("model_upper", 0.0);
+        if (asymmetric)
         {
-          double asymmetry = abs_tau / sigma;
-          asym_all[index] = asymmetry;
-          asym_good.push_back(asymmetry);
+          feat_it->setMetaValue("model_EGH_tau", 0.0);
+          feat_it->setMetaValue("model_EGH_sigma", 0.0);
         }
+        else
+        {
+          feat_it->setMetaValue("model_Gauss_sigma", 0.0);
+        }
+        feat_it->setMetaValue("model_error", -1.0);
+        feat_it->setMetaValue("model_area", 0.0);
+        feat_it->setMetaValue("model_status", "1 (invalid area)");
+        continue;
+      }
+
+      if (add_zeros > 0.0)
+      {
+        MassTrace trace;
+        trace.peaks.reserve(2);
+        trace.theoretical_int = add_zeros;
+        Peak1D peak;
+        peak.setMZ(feat_it->getSubordinates()[0].getMZ());
+        peak.setIntensity(0.0);
+        peaks.push_back(peak);
+        double offset = 0.2 * (region_start - region_end);
+        trace.peaks.push_back(make_pair(region_start - offset, &peaks.back()));
+        trace.peaks.push_back(make_pair(region_end + offset, &peaks.back()));
+        traces.push_back(trace);
       }
-      else if (width_limit > 0)
+
+      // fit the model:
+      bool fit_success = true;
+      try
+      {
+        fitter->fit(traces);
+      }
+      catch (Exception::UnableToFit& except)
       {
-        double width = feat_it->getMetaValue("model_Gauss_sigma");
-        widths_all[index] = width;
-        widths_good.push_back(width);
+#ifdef _OPENMP
+#pragma omp critical (ElutionModelFitter_LOG)
+#endif
+        OPENMS_LOG_ERROR << "Error fitting model to feature '" << feat_it->getUniqueId()
+                  << "': " << except.getName() << " - " << except.getMessage()
+                  << endl;
+        fit_success = false;
+      }
+
+      // record model parameters:
+      double center = fitter->getCenter(), height = fitter->getHeight();
+      feat_it->setMetaValue("model_height", height);
+      feat_it->setMetaValue("model_FWHM", fitter->getFWHM());
+      feat_it->setMetaValue("model_center", center);
+      feat_it->setMetaValue("model_lower", fitter->getLowerRTBound());
+      feat_it->setMetaValue("model_upper", fitter->getUpperRTBound());
+      if (asymmetric)
+      {
+        EGHTraceFitter* egh = static_cast<EGHTraceFitter*>(fitter);
+        feat_it->setMetaValue("model_EGH_tau", egh->getTau());
+        feat_it->setMetaValue("model_EGH_sigma", egh->getSigma());
+      }
+      else
+      {
+        GaussTraceFitter* gauss = static_cast<GaussTraceFitter*>(fitter);
+        feat_it->setMetaValue("model_Gauss_sigma", gauss->getSigma());
+      }
+
+      // goodness of fit:
+      double mre = -1.0; // mean relative error
+      if (fit_success)
+      {
+        mre = calculateFitQuality_(fitter, traces);
+      }
+      feat_it->setMetaValue("model_error", mre);
+
+      // check model validity:
+      double area = fitter->getArea();
+      feat_it->setMetaValue("model_area", area);
+      if ((area != area) || (area <= area_limit)) // x != x: test for NaN
+      {
+        feat_it->setMetaValue("model_status", "1 (invalid area)");
+      }
+      else if ((center <= region_start) || (center >= region_end))
+      {
+        feat_it->setMetaValue("model_status", "2 (center out of bounds)");
+      }
+      else if (fitter->getValue(region_start) > check_boundaries * height)
+      {
+        feat_it->setMetaValue("model_status", "3 (left side out of bounds)");
+      }
+      else if (fitter->getValue(region_end) > check_boundaries * height)
+      {
+        feat_it->setMetaValue("model_status", "4 (right side out of bounds)");
+      }
+      else
+      {
+        feat_it->setMetaValue("model_status", "0 (valid)");
+        // store model parameters to find outliers later:
+        if (asymmetric)
+        {
+          double sigma = feat_it->getMetaValue("model_EGH_sigma");
+          double abs_tau = fabs(double(feat_it->getMetaValue("model_EGH_tau")));
+          if (width_limit > 0)
+          {
+            // see implementation of "EGHTraceFitter::getArea":
+            double width = sigma * 0.6266571 + abs_tau;
+            widths_all[index] = width;
+          }
+          if (asym_limit > 0)
+          {
+            double asymmetry = abs_tau / sigma;
+            asym_all[index] = asymmetry;
+          }
+        }
+        else if (width_limit > 0)
+        {
+          double width = feat_it->getMetaValue("model_Gauss_sigma");
+          widths_all[index] = width;
+        }
       }
     }
+    delete fitter;
+  } // end of parallel region
+
+  // parameters of successful models only:
+  vector<double> widths_good, asym_good;
+  for (Size i = 0; i < widths_all.size(); ++i)
+  {
+    if (!std::isnan(widths_all[i])) widths_good.push_back(widths_all[i]);
+  }
+  for (Size i = 0; i < asym_all.size(); ++i)
+  {
+    if (!std::isnan(asym_all[i])) asym_good.push_back(asym_all[i]);
   }
-  delete fitter;
 
   // find outliers in model parameters:
   if (width_limit > 0)
@@ -398,7 +463,7 @@ void ElutionModelFitter::fitElutionModels(FeatureMap& features)
   Size model_successes = 0, model_failures = 0;
 
   for (FeatureMap::Iterator feat_it = features.begin(); 
-       feat_it != features.end(); ++feat_it, ++index)
+       feat_it != features.end(); ++feat_it)
   {
     feat_it->setMetaValue("raw_intensity", feat_it->getIntensity());
     if (String(feat_it->getMetaValue("model_status"))[0] != '0')
@@ -34,6 +34,7 @@
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinder.h>
 #include <OpenMS/CONCEPT/Factory.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 namespace OpenMS
 {
@@ -113,12 +114,14 @@ namespace OpenMS
     // do the work
     if (algorithm_name != "none")
     {
+      Profiler::Stage stage("FeatureFinder::run:" + algorithm_name);
       FeatureFinderAlgorithm* algorithm = Factory<FeatureFinderAlgorithm>::create(algorithm_name);
       algorithm->setParameters(param);
       algorithm->setData(input_map, features, *this);
       algorithm->setSeeds(seeds);
       algorithm->run();
       delete(algorithm);
+      Profiler::addCount("FeatureFinder::run:" + algorithm_name + ":features", features.size());
     }
 
     if (algorithm_name != "mrm") // mrm  works on chromatograms; the next section is only for conventional data
@@ -54,6 +54,125 @@
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// Result of a successfully extended seed (collected per thread, merged in seed order)
+    struct SeedResult_
+    {
+      /// Index of the seed
+      Size seed;
+      /// Feature created from the seed
+      Feature feature;
+      /// Indices of (lower intensity) seeds that lie inside the feature
+      std::vector<Size> contained_seeds;
+
+      bool operator<(const SeedResult_& rhs) const
+      {
+        return seed < rhs.seed;
+      }
+    };
+
+    /**
+      @brief Coarse RT/m/z grid over the seeds
+
+      Used to look up the seeds that lie inside a feature without scanning
+      all seeds for every feature.
+    */
+    class SeedTiles_
+    {
+public:
+      SeedTiles_(const PeakMap& map, const std::vector<FeatureFinderAlgorithmPickedHelperStructs::Seed>& seeds) :
+        rt_(seeds.size()),
+        mz_(seeds.size()),
+        rt_min_(0.0),
+        mz_min_(0.0),
+        rt_width_(1.0),
+        mz_width_(1.0),
+        rt_tiles_(1),
+        mz_tiles_(1)
+      {
+        if (seeds.empty()) return;
+
+        double rt_max = map[seeds[0].spectrum].getRT(), mz_max = map[seeds[0].spectrum][seeds[0].peak].getMZ();
+        rt_min_ = rt_max;
+        mz_min_ = mz_max;
+        for (Size i = 0; i < seeds.size(); ++i)
+        {
+          rt_[i] = map[seeds[i].spectrum].getRT();
+          mz_[i] = map[seeds[i].spectrum][seeds[i].peak].getMZ();
+          rt_min_ = std::min(rt_min_, rt_[i]);
+          rt_max = std::max(rt_max, rt_[i]);
+          mz_min_ = std::min(mz_min_, mz_[i]);
+          mz_max = std::max(mz_max, mz_[i]);
+        }
+
+        // about 8 seeds per tile on average
+        Size tiles = std::max(Size(1), Size(std::sqrt(seeds.size() / 8.0)));
+        rt_tiles_ = tiles;
+        mz_tiles_ = tiles;
+        rt_width_ = std::max((rt_max - rt_min_) / rt_tiles_, 1e-6);
+        mz_width_ = std::max((mz_max - mz_min_) / mz_tiles_, 1e-6);
+
+        tiles_.resize(rt_tiles_ * mz_tiles_);
+        for (Size i = 0; i < seeds.size(); ++i)
+        {
+          tiles_[rtTile_(rt_[i]) * mz_tiles_ + mzTile_(mz_[i])].push_back(i);
+        }
+      }
+
+      /// Appends the (sorted) indices >= @p first of all seeds inside @p feature to @p result
+      void findContained(const Feature& feature, Size first, std::vector<Size>& result) const
+      {
+        if (tiles_.empty()) return;
+
+        DBoundingBox<2> bb = feature.getConvexHull().getBoundingBox();
+        if (bb.maxX() < bb.minX() || bb.maxY() < bb.minY()) return;
+
+        Size begin = result.size();
+        Size rt_end = rtTile_(bb.maxX()), mz_end = mzTile_(bb.maxY());
+        for (Size r = rtTile_(bb.minX()); r <= rt_end; ++r)
+        {
+          for (Size m = mzTile_(bb.minY()); m <= mz_end; ++m)
+          {
+            const std::vector<Size>& tile = tiles_[r * mz_tiles_ + m];
+            for (Size k = 0; k < tile.size(); ++k)
+            {
+              Size j = tile[k];
+              if (j >= first && bb.encloses(rt_[j], mz_[j]) && feature.encloses(rt_[j], mz_[j]))
+              {
+                result.push_back(j);
+              }
+            }
+          }
+        }
+        std::sort(result.begin() + begin, result.end());
+      }
+
+private:
+      Size rtTile_(double rt) const
+      {
+        double pos = std::floor((rt - rt_min_) / rt_width_);
+        return pos < 0.0 ? 0 : std::min(Size(pos), rt_tiles_ - 1);
+      }
+
+      Size mzTile_(double mz) const
+      {
+        double pos = std::floor((mz - mz_min_) / mz_width_);
+        return pos < 0.0 ? 0 : std::min(Size(pos), mz_tiles_ - 1);
+      }
+
+      std::vector<double> rt_;
+      std::vector<double> mz_;
+      double rt_min_;
+      double mz_min_;
+      double rt_width_;
+      double mz_width_;
+      Size rt_tiles_;
+      Size mz_tiles_;
+      std::vector<std::vector<Size> > tiles_;
+    };
+  }
+
   FeatureFinderAlgorithmPicked::FeatureFinderAlgorithmPicked() :
     FeatureFinderAlgorithm(),
     map_(),
@@ -600,20 +719,26 @@ namespace OpenMS
       //------------------------------------------------------------------
 
       // We do not want to store features whose seeds lie within other
-      // features with higher intensity. We thus store this information in
-      // the map seeds_in_features which contains for each seed i a vector
-      // of other seeds that are contained in the corresponding feature i.
+      // features with higher intensity. We thus store for each feature the
+      // (lower intensity) seeds that are contained in it.
       //
-      // The features are stored in an temporary feature map until it is
-      // decided whether they are contained within a seed of higher
-      // intensity.
-      std::map<Size, std::vector<Size> > seeds_in_features;
-      typedef std::map<Size, Feature> FeatureMapType;
-      FeatureMapType tmp_feature_map;
+      // Seeds are extended independently of each other. Each thread keeps
+      // its features, contained seeds and abort reasons in thread-local
+      // containers, which are merged in the order of the seeds afterwards
+      // (i.e. the result does not depend on the number of threads).
+      std::vector<SeedResult_> seed_results;
+      std::vector<std::pair<Size, String> > seed_aborts;
+      SeedTiles_ seed_tiles(map_, seeds);
       int gl_progress = 0;
       ff_->startProgress(0, seeds.size(), String("Extending seeds for charge ") + String(c));
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel
+#endif
+      {
+      std::vector<SeedResult_> local_results;
+      std::vector<std::pair<Size, String> > local_aborts;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16) nowait
 #endif
       for (SignedSize i = 0; i < (SignedSize)seeds.size(); ++i)
       {
@@ -646,7 +771,7 @@ namespace OpenMS
 
         if (isotope_fit_quality < min_isotope_fit_)
         {
-          abort_(seeds[i], "Could not find good enough isotope pattern containing the seed");
+          local_aborts.push_back(std::make_pair(Size(i), String("Could not find good enough isotope pattern containing the seed")));
           //continue;
         }
         else
@@ -662,7 +787,7 @@ namespace OpenMS
 
           if (!traces.isValid(seed_mz, trace_tolerance_))
           {
-            abort_(seeds[i], "Could not extend seed");
+            local_aborts.push_back(std::make_pair(Size(i), String("Could not extend seed")));
             //continue;
           }
           else
@@ -672,14 +797,8 @@ namespace OpenMS
             //Step 3.3.2:
             //Gauss/EGH fit (first fit to find the feature boundaries)
             //------------------------------------------------------------------
-            Int plot_nr = -1;
-
-#ifdef _OPENMP
-#pragma omp critical (FeatureFinderAlgorithmPicked_PLOTNR)
-#endif
-            {
-              plot_nr = ++plot_nr_global;
-            }
+            // numbered by seed, so plots do not depend on thread scheduling
+            Int plot_nr = plot_nr_global + 1 + Int(i);
 
             //------------------------------------------------------------------
 
@@ -750,7 +869,8 @@ namespace OpenMS
             //validity output
             if (!feature_ok)
             {
-              abort_(seeds[i], error_msg);
+              local_aborts.push_back(std::make_pair(Size(i), error_msg));
+              delete fitter;
               //continue;
             }
             else
@@ -820,62 +940,56 @@ namespace OpenMS
                 f.getConvexHulls().push_back(traces[j].getConvexhull());
               }
 
-#ifdef _OPENMP
-#pragma omp critical (FeatureFinderAlgorithmPicked_TMPFEATUREMAP)
-#endif
-              {
-                tmp_feature_map[i] = f;
-              }
-
               //----------------------------------------------------------------
-              //Remember all seeds that lie inside the convex hull of the new feature
-              DBoundingBox<2> bb = f.getConvexHull().getBoundingBox();
-              for (Size j = i + 1; j < seeds.size(); ++j)
-              {
-                double rt = map_[seeds[j].spectrum].getRT();
-                double mz = map_[seeds[j].spectrum][seeds[j].peak].getMZ();
-                if (bb.encloses(rt, mz) && f.encloses(rt, mz))
-                {
-#ifdef _OPENMP
-#pragma omp critical (FeatureFinderAlgorithmPicked_SEEDSINFEATURES)
-#endif
-                  {
-                    seeds_in_features[i].push_back(j);
-                  }
-                }
-              }
+              //Remember all seeds (of lower intensity) that lie inside the convex hull of the new feature
+              local_results.push_back(SeedResult_());
+              SeedResult_& result = local_results.back();
+              result.seed = i;
+              seed_tiles.findContained(f, i + 1, result.contained_seeds);
+              result.feature = f;
             }
           }
         } // three if/else statements instead of continue (disallowed in OpenMP)
       } // end of OPENMP over seeds
 
+      // merge thread-local results (once per thread)
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderAlgorithmPicked_SEEDRESULTS)
+#endif
+      {
+        seed_results.insert(seed_results.end(), local_results.begin(), local_results.end());
+        seed_aborts.insert(seed_aborts.end(), local_aborts.begin(), local_aborts.end());
+      }
+      } // end of OPENMP parallel region
+      plot_nr_global += Int(seeds.size());
+
+      // deterministic order: by seed, i.e. by decreasing seed intensity
+      std::sort(seed_results.begin(), seed_results.end());
+      std::sort(seed_aborts.begin(), seed_aborts.end());
+      for (Size i = 0; i < seed_aborts.size(); ++i)
+      {
+        abort_(seeds[seed_aborts[i].first], seed_aborts[i].second);
+      }
+
       // Here we have to evaluate which seeds are already contained in
       // features of seeds with higher intensities. Only if the seed is not
       // used in any feature with higher intensity, we can add it to the
       // features_ list.
-      std::vector<Size> seeds_contained;
-      for (std::map<Size, Feature>::iterator iter = tmp_feature_map.begin(); iter != tmp_feature_map.end(); ++iter)
+      std::vector<bool> seeds_contained(seeds.size(), false);
+      for (std::vector<SeedResult_>::iterator iter = seed_results.begin(); iter != seed_results.end(); ++iter)
       {
-        Size seed_nr = iter->first;
-        bool is_used = false;
-        for (Size i = 0; i < seeds_contained.size(); ++i)
-        {
-          if (seed_nr == seeds_contained[i]) { is_used = true; break; }
-        }
-        if (!is_used)
+        if (!seeds_contained[iter->seed])
         {
           ++feature_candidates;
 
           //re-set label
-          iter->second.setMetaValue(3, feature_nr_global);
+          iter->feature.setMetaValue(3, feature_nr_global);
           ++feature_nr_global;
-          features_->push_back(iter->second);
+          features_->push_back(iter->feature);
 
-          std::vector<Size> curr_seed = seeds_in_features[seed_nr];
-          for (Size k = 0; k < curr_seed.size(); ++k)
+          for (Size k = 0; k < iter->contained_seeds.size(); ++k)
           {
-            seeds_contained.push_back(curr_seed[k]);
-
+            seeds_contained[iter->contained_seeds[k]] = true;
           }
         }
       }
@@ -910,10 +1024,10 @@ namespace OpenMS
     //intersect
     for (Size i = 0; i < features_->size(); ++i)
     {
+      ff_->setProgress(i * features_->size());
       Feature& f1((*features_)[i]);
       for (Size j = i + 1; j < features_->size(); ++j)
       {
-        ff_->setProgress(i * features_->size() + j);
         Feature& f2((*features_)[j]);
         //features that are more than 2 times the maximum m/z span apart do not overlap => abort
         if (f2.getMZ() - f1.getMZ() > 2.0 * max_mz_span) break;
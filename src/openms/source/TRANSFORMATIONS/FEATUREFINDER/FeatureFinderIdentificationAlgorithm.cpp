@@ -40,6 +40,7 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractor.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessTransforming.h>
 #include <OpenMS/ANALYSIS/SVM/SimpleSVM.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmIdentification.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
@@ -61,6 +62,56 @@ using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// Access to a contiguous range of the spectra of another spectrum access (without copying)
+    class SpectrumRangeAccess_ :
+      public SpectrumAccessTransforming
+    {
+public:
+      SpectrumRangeAccess_(OpenSwath::SpectrumAccessPtr sptr, Size first, Size last) :
+        SpectrumAccessTransforming(sptr), first_(first), last_(last)
+      {}
+
+      ~SpectrumRangeAccess_() override {}
+
+      boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const override
+      {
+        return boost::make_shared<SpectrumRangeAccess_>(sptr_->lightClone(), first_, last_);
+      }
+
+      OpenSwath::SpectrumPtr getSpectrumById(int id) override
+      {
+        return sptr_->getSpectrumById(int(first_) + id);
+      }
+
+      OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const override
+      {
+        return sptr_->getSpectrumMetaById(int(first_) + id);
+      }
+
+      std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const override
+      {
+        std::vector<std::size_t> result;
+        std::vector<std::size_t> all = sptr_->getSpectraByRT(RT, deltaRT);
+        for (Size i = 0; i < all.size(); ++i)
+        {
+          if (all[i] >= first_ && all[i] < last_) result.push_back(all[i] - first_);
+        }
+        return result;
+      }
+
+      size_t getNrSpectra() const override
+      {
+        return last_ - first_;
+      }
+
+private:
+      Size first_;
+      Size last_;
+    };
+  }
+
   FeatureFinderIdentificationAlgorithm::FeatureFinderIdentificationAlgorithm() :
     DefaultParamHandler("FeatureFinderIdentificationAlgorithm")
   {
@@ -361,22 +412,7 @@ namespace OpenMS
     // run feature detection
     //-------------------------------------------------------------
     OPENMS_LOG_INFO << "Extracting chromatograms..." << endl;
-    ChromatogramExtractor extractor;
-    // extractor.setLogType(ProgressLogger::NONE);
-    {
-      vector<OpenSwath::ChromatogramPtr> chrom_temp;
-      vector<ChromatogramExtractor::ExtractionCoordinates> coords;
-      extractor.prepare_coordinates(chrom_temp, coords, library_,
-          numeric_limits<double>::quiet_NaN(), false);
-
-      boost::shared_ptr<PeakMap> shared = boost::make_shared<PeakMap>(ms_data_);
-      OpenSwath::SpectrumAccessPtr spec_temp =
-        SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(shared);
-      extractor.extractChromatograms(spec_temp, chrom_temp, coords, mz_window_,
-          mz_window_ppm_, "tophat");
-      extractor.return_chromatogram(chrom_temp, coords, library_, (*shared)[0],
-          chrom_data_.getChromatograms(), false);
-    }
+    extractChromatograms_();
 
     OPENMS_LOG_DEBUG << "Extracted " << chrom_data_.getNrChromatograms()
               << " chromatogram(s)." << endl;
@@ -458,6 +494,86 @@ namespace OpenMS
     features.ensureUniqueId();
   }
 
+  void FeatureFinderIdentificationAlgorithm::extractChromatograms_()
+  {
+    vector<OpenSwath::ChromatogramPtr> chrom_temp;
+    vector<ChromatogramExtractor::ExtractionCoordinates> coords;
+    ChromatogramExtractor::prepare_coordinates(chrom_temp, coords, library_,
+        numeric_limits<double>::quiet_NaN(), false);
+
+    // The extractor compares every spectrum to every coordinate. To avoid
+    // this, coordinates are processed in batches of similar RT, each using
+    // only the spectra in the RT range of its batch. Batches are independent
+    // and are extracted in parallel (all on the same, uncopied data).
+    if (!ms_data_.isSorted(false)) ms_data_.sortSpectra(false);
+    boost::shared_ptr<PeakMap> shared(&ms_data_, [](PeakMap*) {}); // not owned
+    OpenSwath::SpectrumAccessPtr spec_all =
+      SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(shared);
+
+    const Size batch_size = 2000;
+    vector<pair<double, Size> > order; // RT start -> coordinate index
+    order.reserve(coords.size());
+    for (Size i = 0; i < coords.size(); ++i)
+    {
+      // coordinates without RT range need all spectra - put them last:
+      bool rt_range = (coords[i].rt_end - coords[i].rt_start > 0);
+      order.push_back(make_pair(rt_range ? coords[i].rt_start :
+                                numeric_limits<double>::max(), i));
+    }
+    sort(order.begin(), order.end());
+    vector<vector<Size> > batches;
+    for (Size i = 0; i < order.size(); i += batch_size)
+    {
+      batches.push_back(vector<Size>());
+      for (Size j = i; j < min(i + batch_size, order.size()); ++j)
+      {
+        batches.back().push_back(order[j].second);
+      }
+      // the extractor expects coordinates sorted by m/z (as in 'coords'):
+      sort(batches.back().begin(), batches.back().end());
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < SignedSize(batches.size()); ++b)
+    {
+      const vector<Size>& batch = batches[b];
+      // chromatograms are shared pointers, so they are filled in place:
+      vector<OpenSwath::ChromatogramPtr> batch_chroms;
+      vector<ChromatogramExtractor::ExtractionCoordinates> batch_coords;
+      double rt_min = numeric_limits<double>::max();
+      double rt_max = -numeric_limits<double>::max();
+      for (Size i = 0; i < batch.size(); ++i)
+      {
+        const ChromatogramExtractor::ExtractionCoordinates& coord = coords[batch[i]];
+        batch_chroms.push_back(chrom_temp[batch[i]]);
+        batch_coords.push_back(coord);
+        if (coord.rt_end - coord.rt_start > 0)
+        {
+          rt_min = min(rt_min, coord.rt_start);
+          rt_max = max(rt_max, coord.rt_end);
+        }
+        else
+        {
+          rt_min = -numeric_limits<double>::max();
+          rt_max = numeric_limits<double>::max();
+        }
+      }
+
+      Size first = ms_data_.RTBegin(rt_min) - ms_data_.begin();
+      Size last = ms_data_.RTEnd(rt_max) - ms_data_.begin();
+      OpenSwath::SpectrumAccessPtr spec_batch =
+        boost::make_shared<SpectrumRangeAccess_>(spec_all, first, last);
+      ChromatogramExtractor extractor;
+      extractor.extractChromatograms(spec_batch, batch_chroms, batch_coords,
+          mz_window_, mz_window_ppm_, "tophat");
+    }
+
+    ChromatogramExtractor::return_chromatogram(chrom_temp, coords, library_,
+        ms_data_[0], chrom_data_.getChromatograms(), false);
+  }
+
   void FeatureFinderIdentificationAlgorithm::postProcess_(
    FeatureMap & features,
    bool with_external_ids)
@@ -37,7 +37,7 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternTable.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFiltering.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexIsotopicPeakPattern.h>
@@ -429,24 +429,24 @@ namespace OpenMS
   {
     // construct averagine distribution
     double mass = peak.getMZ() * pattern.getCharge();
-    CoarseIsotopePatternGenerator solver(isotopes_per_peptide_max_);
-    IsotopeDistribution distribution;
+    CoarseIsotopePatternTable::AveragineModel model;
     if (averagine_type_ == "peptide")
     {
-      distribution = solver.estimateFromPeptideWeight(mass);
+      model = CoarseIsotopePatternTable::PEPTIDE;
     }
     else if (averagine_type_ == "RNA")
     {
-      distribution = solver.estimateFromRNAWeight(mass);
+      model = CoarseIsotopePatternTable::RNA;
     }
     else if (averagine_type_ == "DNA")
     {
-      distribution = solver.estimateFromDNAWeight(mass);
+      model = CoarseIsotopePatternTable::DNA;
     }
     else
     {
       throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid averagine type.");
     }
+    IsotopeDistribution distribution = CoarseIsotopePatternTable::getDefaultTable(model).estimateFromWeight(mass, isotopes_per_peptide_max_);
     
     // loop over peptides
     for (size_t peptide = 0; peptide < pattern.getMassShiftCount(); ++peptide)
@@ -40,6 +40,7 @@
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 
 using namespace std;
@@ -414,6 +415,8 @@ namespace OpenMS
                                        std::vector<std::vector<PeakBoundary> >& boundaries_chrom,
                                        const bool check_spectrum_type) const
   {
+    Profiler::Stage stage("PeakPickerHiRes::pickExperiment");
+
     // make sure that output is clear
     output.clear(true);
 
@@ -490,6 +493,7 @@ namespace OpenMS
     for (const auto& info : pick_info)
     {
       OPENMS_LOG_INFO << "  MS-level " << info.first << ": " << info.second.picked << " / " << info.second.total << "\n";
+      Profiler::addCount("PeakPickerHiRes::pickExperiment:picked_spectra", info.second.picked);
     }
 
     return;
@@ -497,6 +501,8 @@ namespace OpenMS
 
   void PeakPickerHiRes::pickExperiment(/* const */ OnDiscMSExperiment& input, PeakMap& output, const bool check_spectrum_type) const
   {
+    Profiler::Stage stage("PeakPickerHiRes::pickExperiment");
+
     // make sure that output is clear
     output.clear(true);
 
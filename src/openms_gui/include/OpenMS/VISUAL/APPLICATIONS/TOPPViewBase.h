@@ -43,6 +43,7 @@
 #include <OpenMS/VISUAL/SpectrumCanvas.h>
 #include <OpenMS/VISUAL/SpectrumWidget.h>
 #include <OpenMS/SYSTEM/FileWatcher.h>
+#include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/VISUAL/SpectraViewWidget.h>
 #include <OpenMS/VISUAL/SpectraIdentificationViewWidget.h>
 
@@ -50,6 +51,7 @@
 #include <OpenMS/VISUAL/TOPPViewIdentificationViewBehavior.h>
 
 //STL
+#include <atomic>
 #include <map>
 
 //QT
@@ -162,6 +164,10 @@ public:
 
       Loads the data and adds it to the application by calling addData_()
 
+      Loading is done in a background thread while a progress dialog keeps the
+      application responsive. mzML files can be cancelled while loading. Indexed mzML files larger
+      than the 'preferences:on_disc_threshold' keep their MS2 spectra on disc.
+
       @param filename The file to open
       @param show_options If the options dialog should be shown (otherwise the defaults are used)
       @param caption Sets the layer name and window caption of the data. If unset the file name is used.
@@ -560,6 +566,36 @@ protected:
     /// Shows a log message in the log_ window
     void showLogMessage_(LogState state, const String& heading, const String& body);
 
+    /// Data and status of a file that is loaded in the background (see addDataFile())
+    struct DataFileLoad
+    {
+      DataFileLoad();
+
+      FeatureMapSharedPtrType feature_map;
+      ConsensusMapSharedPtrType consensus_map;
+      std::vector<PeptideIdentification> peptides;
+      ExperimentSharedPtrType peak_map;
+      ODExperimentSharedPtrType on_disc_peaks;
+      LayerData::DataType data_type;
+      /// non-fatal problems to show in the log window
+      StringList warnings;
+      /// error message, if loading failed
+      String error;
+      /// number of spectra and chromatograms read so far (mzML only)
+      std::atomic<Size> items_loaded;
+      /// number of spectra and chromatograms in the file (0 if unknown)
+      std::atomic<Size> items_expected;
+      /// set by the GUI thread to abort loading
+      std::atomic<bool> cancel;
+    };
+
+    /**
+      @brief Loads @p filename of type @p file_type into @p load (executed in a background thread)
+
+      Must not touch any widget; messages are returned in @p load.
+    */
+    static void loadDataFile_(boost::shared_ptr<DataFileLoad> load, const String& filename, FileTypes::Type file_type, bool cache_ms1_on_disc, bool cache_ms2_on_disc);
+
     ///Additional context menu for 2D layers
     QMenu* add_2d_context_;
 
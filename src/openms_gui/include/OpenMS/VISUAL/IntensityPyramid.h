@@ -0,0 +1,164 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+//OpenMS
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+//STL
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+      @brief Multi-resolution summary of the MS1 intensities of a peak map.
+
+      The RT x m/z plane covered by the MS1 spectra of a map is divided into a
+      grid of equally sized bins. For each bin the maximum and the summed
+      intensity of all peaks falling into it are stored. Level 0 is the finest
+      grid, every following level halves the number of bins in both
+      dimensions, until a minimal grid size is reached.
+
+      Spectrum2DCanvas uses the pyramid to paint zoomed-out views of large maps:
+      instead of visiting every peak in the visible area on each repaint, it picks
+      the coarsest level whose bins are still smaller than a pixel and reads the
+      bin maxima from there. Zoomed-in views are painted from the raw peaks.
+
+      The pyramid can be stored to and restored from a binary cache file. A
+      caller-defined stamp (e.g. size and modification time of the data file)
+      is stored along and has to match on loading.
+  */
+  class OPENMS_GUI_DLLAPI IntensityPyramid
+  {
+public:
+    /// One resolution level of the pyramid
+    struct OPENMS_GUI_DLLAPI Level
+    {
+      /// number of bins in RT dimension
+      Size rt_bins = 0;
+      /// number of bins in m/z dimension
+      Size mz_bins = 0;
+      /// width of one bin in RT dimension
+      double rt_bin_size = 0.0;
+      /// width of one bin in m/z dimension
+      double mz_bin_size = 0.0;
+      /// maximum intensity per bin (row major, RT first), -1 for empty bins
+      std::vector<float> max_intensity;
+      /// summed intensity per bin (row major, RT first)
+      std::vector<float> sum_intensity;
+
+      /// Maximum intensity of bin (@p rt, @p mz)
+      inline float getMax(Size rt, Size mz) const
+      {
+        return max_intensity[rt * mz_bins + mz];
+      }
+
+      /// Summed intensity of bin (@p rt, @p mz)
+      inline float getSum(Size rt, Size mz) const
+      {
+        return sum_intensity[rt * mz_bins + mz];
+      }
+    };
+
+    /// Default constructor (empty pyramid)
+    IntensityPyramid();
+
+    /**
+      @brief Builds the pyramid from the MS1 spectra of @p exp
+
+      @param exp The peak map
+      @param max_rt_bins Number of RT bins of the finest level (capped at the number of MS1 spectra)
+      @param max_mz_bins Number of m/z bins of the finest level
+      @param min_bins Levels are added until one dimension drops below this number of bins
+    */
+    void build(const PeakMap& exp, Size max_rt_bins = 2048, Size max_mz_bins = 4096, Size min_bins = 64);
+
+    /// Removes all levels
+    void clear();
+
+    /// Returns if the pyramid contains no levels
+    bool empty() const;
+
+    /// Returns the number of levels
+    Size getLevelCount() const;
+
+    /// Returns the level @p index (0 is the finest)
+    const Level& getLevel(Size index) const;
+
+    /// Lower RT bound of the binned area
+    double getMinRT() const;
+    /// Upper RT bound of the binned area
+    double getMaxRT() const;
+    /// Lower m/z bound of the binned area
+    double getMinMZ() const;
+    /// Upper m/z bound of the binned area
+    double getMaxMZ() const;
+
+    /**
+      @brief Returns the coarsest level whose bins are not larger than @p rt_extent x @p mz_extent
+
+      Returns getLevelCount() if even the finest level is too coarse, i.e. raw data should be used.
+    */
+    Size selectLevel(double rt_extent, double mz_extent) const;
+
+    /// Stores the pyramid in @p filename together with @p stamp. Returns false if the file could not be written.
+    bool store(const String& filename, UInt64 stamp) const;
+
+    /// Loads the pyramid from @p filename. Returns false (leaving the pyramid empty) if the file cannot be read or was written with a different @p stamp.
+    bool load(const String& filename, UInt64 stamp);
+
+    /// Name of the cache file that belongs to the data file @p filename
+    static String cacheFilename(const String& filename);
+
+protected:
+    /// Resolution levels, finest first
+    std::vector<Level> levels_;
+    /// Lower RT bound
+    double rt_min_;
+    /// Upper RT bound
+    double rt_max_;
+    /// Lower m/z bound
+    double mz_min_;
+    /// Upper m/z bound
+    double mz_max_;
+  };
+
+}
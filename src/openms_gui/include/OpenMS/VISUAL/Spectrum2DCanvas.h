@@ -40,9 +40,12 @@
 // OpenMS
 #include <OpenMS/VISUAL/SpectrumCanvas.h>
 #include <OpenMS/VISUAL/Spectrum1DCanvas.h>
+#include <OpenMS/VISUAL/IntensityPyramid.h>
 #include <OpenMS/KERNEL/PeakIndex.h>
 
 // QT
+#include <QtCore/QFutureWatcher>
+
 class QPainter;
 class QMouseEvent;
 class QAction;
@@ -140,6 +143,9 @@ protected slots:
     /// Reacts on changed layer parameters
     void currentLayerParametersChanged_();
 
+    /// Repaints once an intensity pyramid finished building in the background
+    void intensityPyramidReady_();
+
 protected:
     // Docu in base class
     bool finishAdding_() override;
@@ -192,6 +198,31 @@ protected:
     */
     void paintMaximumIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
 
+    /**
+      @brief Paints maximum intensities from a level of the layer's intensity pyramid.
+
+      Same output as paintMaximumIntensities_(), but reads precomputed bin maxima
+      instead of visiting all peaks in the visible area.
+
+      @param layer_index The index of the layer.
+      @param pyramid The intensity pyramid of the layer.
+      @param level The pyramid level to paint (bins must not be larger than one pixel).
+      @param rt_pixel_count
+      @param mz_pixel_count
+    */
+    void paintPyramidIntensities_(Size layer_index, const IntensityPyramid& pyramid, Size level, Size rt_pixel_count, Size mz_pixel_count);
+
+    /**
+      @brief Returns the intensity pyramid of peak layer @p layer_index, or nullptr if it is not available (yet).
+
+      The first call for a layer starts building the pyramid in a background thread (or
+      loads it from the cache file, see parameter 'dot:pyramid_cache').
+    */
+    const IntensityPyramid* getIntensityPyramid_(Size layer_index);
+
+    /// Drops pyramids of data that is not shown in any layer anymore
+    void releaseIntensityPyramids_();
+
     /**
       @brief Paints the precursor peaks.
 
@@ -389,6 +420,32 @@ protected:
     double pen_size_max_; ///< maximum number of pixels for one data point
     double canvas_coverage_min_; ///< minimum coverage of the canvas required; if lower, points are upscaled in size
 
+    /// Intensity pyramid of one peak map (shared with the thread building it)
+    struct IntensityPyramidEntry
+    {
+      /// the summarized data (kept alive while the pyramid is built)
+      LayerData::ConstExperimentSharedPtrType data;
+      /// the pyramid, valid once the build finished
+      IntensityPyramid pyramid;
+      /// cache file to load from/store to (empty if caching is disabled)
+      String cache_file;
+      /// stamp identifying the version of the data file in the cache
+      UInt64 cache_stamp;
+    };
+
+    /// Pyramid and build status of one peak map
+    struct IntensityPyramidBuild
+    {
+      boost::shared_ptr<IntensityPyramidEntry> entry;
+      boost::shared_ptr<QFutureWatcher<void> > watcher;
+    };
+
+    /// Builds (or loads) the pyramid of @p entry; executed in a background thread
+    static void buildIntensityPyramid_(boost::shared_ptr<IntensityPyramidEntry> entry);
+
+    /// intensity pyramids of the displayed peak maps
+    std::map<const ExperimentType*, IntensityPyramidBuild> intensity_pyramids_;
+
   private:
     /// Default C'tor hidden
     Spectrum2DCanvas();
@@ -0,0 +1,158 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <QtCore/QMutex>
+
+#include <map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+      @brief Holds the intermediate data of a TOPPAS workflow in memory
+
+      Tools which run inside the TOPPAS process (see TOPPASInProcessTools) hand their results
+      to the next tools through this store instead of writing and parsing intermediate files.
+      The data is filed under the name of the intermediate file it replaces, together with the
+      number of tools which will read it. The last reader takes the data out of the store.
+
+      Data which would exceed the memory limit (see setMemoryLimit()) is written to its file
+      instead. Reading data that is not held in memory loads it from the file, such that
+      readers do not need to know where their input comes from.
+
+      The store can be used by several tools running concurrently in different threads.
+
+      @ingroup TOPPAS_elements
+  */
+  class OPENMS_GUI_DLLAPI TOPPASInMemoryStore
+  {
+public:
+    /// Identification results, as stored in an idXML file
+    struct IdentificationData
+    {
+      std::vector<ProteinIdentification> proteins;
+      std::vector<PeptideIdentification> peptides;
+    };
+
+    /// Constructor
+    TOPPASInMemoryStore();
+
+    /// Sets the maximum memory (in MB) of the data held in memory (0 = unlimited)
+    void setMemoryLimit(double memory_mb);
+    /// Returns the maximum memory (in MB) of the data held in memory (0 = unlimited)
+    double getMemoryLimit() const;
+    /// Returns the estimated memory (in MB) of the data currently held in memory
+    double getMemoryUsage() const;
+
+    /// Returns whether data for the intermediate file @p filename is held in memory
+    bool contains(const String& filename) const;
+
+    /**
+      @name Storing data
+
+      The data is swapped into the store (@p data is empty afterwards) and kept until it was
+      read @p readers times. If @p readers is 0 or the memory limit would be exceeded, the data
+      is written to @p filename instead.
+
+      @exception Exception::UnableToCreateFile if the data needs to be written and @p filename cannot be created
+    */
+    //@{
+    void store(const String& filename, PeakMap& data, Size readers);
+    void store(const String& filename, FeatureMap& data, Size readers);
+    void store(const String& filename, ConsensusMap& data, Size readers);
+    void store(const String& filename, IdentificationData& data, Size readers);
+    //@}
+
+    /**
+      @name Loading data
+
+      Returns the data stored for @p filename (the last reader receives the data itself, all others
+      a copy). Data not held in memory is loaded from @p filename.
+
+      @exception Exception::FileNotFound if the data is neither held in memory nor stored in @p filename
+    */
+    //@{
+    void load(const String& filename, PeakMap& data);
+    void load(const String& filename, FeatureMap& data);
+    void load(const String& filename, ConsensusMap& data);
+    void load(const String& filename, IdentificationData& data);
+    //@}
+
+    /// Removes all data held in memory
+    void clear();
+
+protected:
+    /// Data stored for one intermediate file
+    template <typename DataType>
+    struct Entry_
+    {
+      DataType data;
+      Size readers;
+      double memory_mb;
+    };
+
+    /// Keeps @p data in memory, or writes it to @p filename (see store())
+    template <typename DataType>
+    void store_(std::map<String, Entry_<DataType> >& entries, const String& filename, DataType& data, Size readers);
+
+    /// Retrieves the data for @p filename from memory or from the file (see load())
+    template <typename DataType>
+    void load_(std::map<String, Entry_<DataType> >& entries, const String& filename, DataType& data);
+
+    /// maximum memory (in MB) of the data held in memory (0 = unlimited)
+    double memory_limit_mb_;
+    /// estimated memory (in MB) of the data held in memory
+    double memory_used_mb_;
+    /// guards the entries and the memory bookkeeping (file I/O is done without holding it)
+    mutable QMutex mutex_;
+
+    std::map<String, Entry_<PeakMap> > experiments_;
+    std::map<String, Entry_<FeatureMap> > feature_maps_;
+    std::map<String, Entry_<ConsensusMap> > consensus_maps_;
+    std::map<String, Entry_<IdentificationData> > identifications_;
+  };
+
+}
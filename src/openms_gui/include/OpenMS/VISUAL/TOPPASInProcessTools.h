@@ -0,0 +1,92 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+#include <OpenMS/DATASTRUCTURES/Param.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <map>
+
+namespace OpenMS
+{
+  class TOPPASInMemoryStore;
+
+  /**
+      @brief Runs TOPP tools inside the TOPPAS process
+
+      Tools whose work is done by an algorithm class can run inside the process executing the
+      workflow (see ExecutePipeline's '-in_memory' flag) instead of as separate executables.
+      They read their inputs from and write their outputs to a TOPPASInMemoryStore, such that
+      MSExperiment, FeatureMap, ConsensusMap and identification data are handed to the next
+      tool without writing and parsing intermediate files.
+
+      The tools behave like their executables: they take the same parameters (the content of
+      their INI file), perform the same checks, annotate the same data processing information
+      and return the same exit codes. Currently supported are NoiseFilterGaussian,
+      NoiseFilterSGolay, PeakPickerHiRes, FeatureFinderCentroided, ConsensusMapNormalizer
+      and PeptideIndexer. All other tools (and external tools) run as executables.
+
+      @ingroup TOPPAS_elements
+  */
+  class OPENMS_GUI_DLLAPI TOPPASInProcessTools
+  {
+public:
+    /**
+      @brief Returns whether the tool @p name (of type @p type) with parameters @p param can run in-process
+
+      Tools configured for low-memory processing ('processOption' is 'lowmemory') stream their
+      data from disk and therefore run as executables.
+    */
+    static bool isSupported(const String& name, const String& type, const Param& param);
+
+    /**
+      @brief Runs the tool @p name with the parameters @p param (including its input and output files)
+
+      Inputs are taken from @p store (or loaded from their files if not held in memory). Each output
+      file with a positive count in @p readers is kept in @p store for that many readers, all other
+      outputs are written to their files. The number of OpenMP threads of the calling thread is
+      set from the tool's 'threads' parameter for the duration of the run.
+
+      May be called from any thread (TOPPAS runs each tool in a worker thread).
+
+      @return The exit code of the tool (see TOPPBase::ExitCodes)
+    */
+    static int run(const String& name, const Param& param, const std::map<String, Size>& readers, TOPPASInMemoryStore& store);
+  };
+
+}
@@ -39,10 +39,14 @@
 
 #include <OpenMS/VISUAL/TOPPASEdge.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/VISUAL/TOPPASInMemoryStore.h>
 #include <OpenMS/VISUAL/TOPPASToolVertex.h>
 
 #include <QtWidgets/QGraphicsScene>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QProcess>
+#include <QtCore/QThreadPool>
+#include <map>
 
 namespace OpenMS
 {
@@ -56,7 +60,7 @@ namespace OpenMS
   /**
     @brief A FakeProcess class.
   */
-  class FakeProcess :
+  class OPENMS_GUI_DLLAPI FakeProcess :
     public QProcess
   {
     Q_OBJECT
@@ -65,6 +69,44 @@ public:
     virtual void start(const QString & program, const QStringList & arguments, OpenMode mode = ReadWrite);
   };
 
+  /**
+    @brief Runs a TOPP tool inside the TOPPAS process (see TOPPASInProcessTools)
+
+    Used instead of a QProcess for tools which exchange their data through the scene's
+    TOPPASInMemoryStore. start() runs the tool in a thread of the given pool and returns
+    immediately; finished() is emitted with the tool's exit code once it is done.
+  */
+  class InProcessTool :
+    public QProcess
+  {
+    Q_OBJECT
+
+public:
+    /// Constructor; @p readers gives the number of in-memory readers of each output file
+    InProcessTool(const String & name, const Param & param, const std::map<String, Size> & readers, TOPPASInMemoryStore & store, QThreadPool & pool);
+
+    virtual void start(const QString & program, const QStringList & arguments, OpenMode mode = ReadWrite);
+
+public slots:
+    /// Reports the tool as crashed when it finishes (a running tool cannot be interrupted)
+    void cancel();
+
+protected slots:
+    /// Emits finished() with the exit code of the tool
+    void runFinished_();
+
+protected:
+    String name_;
+    Param param_;
+    std::map<String, Size> readers_;
+    TOPPASInMemoryStore & store_;
+    QThreadPool & pool_;
+    /// watches the tool running in @p pool_
+    QFutureWatcher<int> watcher_;
+    /// set by cancel()
+    bool canceled_;
+  };
+
   /**
       @brief A container for all visual items of a TOPPAS workflow
 
@@ -93,11 +135,14 @@ public:
     struct TOPPProcess
     {
       /// Constructor
-      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool) :
+      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool, int nr_threads = 1, double mem_mb = 0.0, int prio = 0) :
         proc(p),
         command(cmd),
         args(arg),
-        tv(tool)
+        tv(tool),
+        threads(nr_threads),
+        memory_mb(mem_mb),
+        priority(prio)
       {
       }
 
@@ -109,6 +154,12 @@ public:
       QStringList args;
       /// The tool which is started (used to call its slots)
       TOPPASToolVertex * tv;
+      /// Number of CPU cores the process will occupy (its '-threads' setting)
+      int threads;
+      /// Estimated peak memory (in MB) of the process, 0 if unknown
+      double memory_mb;
+      /// Scheduling priority (length of the critical path behind the tool); higher values run first
+      int priority;
     };
 
     /// The current action mode (creation of a new edge, or panning of the widget)
@@ -204,9 +255,9 @@ public:
     bool isPipelineRunning();
     /// Shows a dialog that allows to specify the output directory. If @p always_ask == false, the dialog won't be shown if a directory has been set, already.
     bool askForOutputDir(bool always_ask = true);
-    /// Enqueues the process, it will be run when the currently pending processes have finished
+    /// Enqueues the process, it will be run when enough CPU cores and memory (see setAllowedThreads() and setMemoryLimit()) are available
     void enqueueProcess(const TOPPProcess & process);
-    /// Runs the next process in the queue, if any
+    /// Starts queued processes (highest priority first) as long as they fit into the CPU and memory budget
     void runNextProcess();
     /// Resets the processes queue
     void resetProcessesQueue();
@@ -242,6 +293,16 @@ public:
     void setDescription(const QString & desc);
     /// sets the maximum number of jobs
     void setAllowedThreads(int num_threads);
+    /// Sets the memory budget (in MB) for all concurrently running TOPP tools (0 = unlimited)
+    void setMemoryLimit(double memory_mb);
+    /// Run supported tools in-process and keep their data in memory (see TOPPASInProcessTools), using at most @p memory_mb MB for intermediate data (0 = unlimited)
+    void setInMemory(bool in_memory, double memory_mb = 0.0);
+    /// Are supported tools run in-process, exchanging their data in memory?
+    bool isInMemory() const;
+    /// Returns the intermediate data held in memory
+    TOPPASInMemoryStore & getInMemoryStore();
+    /// Returns the threads running the in-process tools
+    QThreadPool & getInProcessThreadPool();
     /// returns the hovering edge
     TOPPASEdge* getHoveringEdge();
     /// Checks whether all output vertices are finished, and if yes, emits entirePipelineFinished() (called by finished output vertices)
@@ -275,8 +336,8 @@ public slots:
     void changedParameter(const bool invalidates_running_pipeline);
     /// Invoked by OutfilelistVertex of user changed the folder name
     void changedOutputFolder();
-    /// Called by a finished QProcess to indicate that we are free to start a new one
-    void processFinished();
+    /// Called by a finished QProcess @p p to indicate that its resources are free to start a new one
+    void processFinished(QProcess * p = nullptr);
     /// dirty solution: when using ExecutePipeline this slot is called when the pipeline crashes. This will quit the app
     void quitWithError();
 
@@ -355,8 +416,20 @@ protected:
     TOPPASScene * clipboard_;
     /// dry run mode (no tools are actually called)
     bool dry_run_;
-    /// currently running processes...
+    /// currently occupied CPU cores (sum of 'threads' of all running processes)
     int threads_active_;
+    /// currently reserved memory (in MB) of all running processes
+    double memory_active_;
+    /// maximum memory (in MB) for all running processes (0 = unlimited)
+    double memory_limit_mb_;
+    /// resources held by the currently running processes
+    std::map<QProcess*, TOPPProcess> running_processes_;
+    /// run supported tools in-process, exchanging their data in memory
+    bool in_memory_;
+    /// intermediate data of in-process tools
+    TOPPASInMemoryStore in_memory_store_;
+    /// threads running the in-process tools (declared after the store: waits for running tools on destruction)
+    QThreadPool in_process_pool_;
     /// description text
     QString description_text_;
     /// maximum number of allowed threads
@@ -370,6 +443,8 @@ protected:
     bool isEdgeAllowed_(TOPPASVertex * u, TOPPASVertex * v);
     /// DFS helper method. Returns true, if a back edge has been discovered
     bool dfsVisit_(TOPPASVertex * vertex);
+    /// Computes the critical path length of all tool vertices (used as scheduling priority); called once at pipeline start
+    void updateCriticalPathLengths_();
     /// Performs a sanity check of the pipeline and notifies user when it finds something strange. Returns if pipeline OK.
     /// if 'allowUserOverride' is true, some dialogs are shown which allow the user to ignore some warnings (e.g. disconnected nodes)
     bool sanityCheck_(bool allowUserOverride);
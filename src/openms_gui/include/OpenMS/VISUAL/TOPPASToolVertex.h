@@ -196,6 +196,14 @@ public:
     virtual void emitToolStarted();
     /// invert status of recycling (overriding base class)
     bool invertRecylingMode() override;
+    /// Returns the number of TOPP tools on the longest downstream path starting at (and including) this tool, i.e. the length of the critical path behind it
+    int getCriticalPathLength() const;
+    /// Sets the critical path length (computed by the scene for all vertices when the pipeline is started)
+    void setCriticalPathLength(int length);
+    /// Returns the highest peak memory (resident set size, in MB) observed for any run of this tool so far (0 if unknown)
+    double getPeakMemoryUsage() const;
+    /// Does this tool run inside the TOPPAS process, exchanging its data in memory (see TOPPASScene::setInMemory())?
+    bool runsInProcess() const;
 
 public slots:
 
@@ -246,6 +254,8 @@ protected:
     bool doesParamChangeInvalidate_();
     /// renames SUFFICES of the output files created by the TOPP tool by inspecting file content
     bool renameOutput_();
+    /// Returns how many tools read the output files of output parameter @p param_index from memory (0 if the files need to be written)
+    Size getInMemoryReaders_(int param_index) const;
     /// Initializes the parameters with standard values (from -write_ini), uses the parameters from the old_ini_file if given, returns if parameters have changed (if old_ini_file was given)
     bool initParam_(const QString& old_ini_file = "");
     /// Fills @p io_infos with the required input/output file/list parameters. If @p input_params is true, input params are returned, otherwise output params.
@@ -272,6 +282,10 @@ protected:
     bool tool_ready_{true};
     /// Breakpoint set?
     bool breakpoint_set_{false};
+    /// highest observed peak memory (in MB) of the TOPP tool processes started by this vertex
+    double peak_memory_mb_{0.0};
+    /// number of TOPP tools on the longest downstream path (see getCriticalPathLength())
+    int critical_path_length_{1};
   };
 }
 
@@ -12,6 +12,7 @@ EnhancedTabBarWidgetInterface.h
 EnhancedWorkspace.h
 GUIProgressLoggerImpl.h
 HistogramWidget.h
+IntensityPyramid.h
 LayerData.h
 ListEditor.h
 MetaDataBrowser.h
@@ -30,6 +31,8 @@ Spectrum3DWidget.h
 SpectrumCanvas.h
 SpectrumWidget.h
 TOPPASEdge.h
+TOPPASInMemoryStore.h
+TOPPASInProcessTools.h
 TOPPASInputFileListVertex.h
 TOPPASLogWindow.h
 TOPPASMergerVertex.h
@@ -39,6 +39,9 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 #include <OpenMS/FORMAT/HANDLERS/IndexedMzMLHandler.h>
+#include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/KERNEL/ChromatogramTools.h>
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
@@ -93,7 +96,11 @@
 #include <QtCore/QSettings>
 #include <QtCore/QDate>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
 #include <QtCore/QTime>
+#include <QtCore/QWaitCondition>
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore/QUrl>
 #include <QtWidgets/QCheckBox>
 #include <QCloseEvent>
@@ -107,6 +114,7 @@
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QMenuBar>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QProgressDialog>
 #include <QPainter>
 #include <QtWidgets/QSplashScreen>
 #include <QtWidgets/QStatusBar>
@@ -623,6 +631,8 @@ namespace OpenMS
     defaults_.setValidStrings("preferences:use_cached_ms2", ListUtils::create<String>("true,false"));
     defaults_.setValue("preferences:use_cached_ms1", "false", "If possible, do not load MS1 spectra into memory spectra into memory and keep MS2 spectra on disk (using indexed mzML).");
     defaults_.setValidStrings("preferences:use_cached_ms1", ListUtils::create<String>("true,false"));
+    defaults_.setValue("preferences:on_disc_threshold", 0, "Keep MS2 spectra of indexed mzML files larger than this size (in MB) on disk, regardless of 'use_cached_ms2' (0 = disabled).");
+    defaults_.setMinInt("preferences:on_disc_threshold", 0);
     // 1d view
     Spectrum1DCanvas* def1 = new Spectrum1DCanvas(Param(), nullptr);
     defaults_.insert("preferences:1d:", def1->getDefaults());
@@ -1134,114 +1144,229 @@ namespace OpenMS
       return;
     }
 
-    //try to load data and determine if it's 1D or 2D data
+    bool cache_ms2_on_disc = ((String)param_.getValue("preferences:use_cached_ms2") == "true");
+    bool cache_ms1_on_disc = ((String)param_.getValue("preferences:use_cached_ms1") == "true");
+
+    // keep MS2 spectra of very large files on disc (only possible for indexed mzML)
+    Int on_disc_threshold = param_.getValue("preferences:on_disc_threshold");
+    if (file_type == FileTypes::MZML && on_disc_threshold > 0 &&
+        QFileInfo(abs_filename.toQString()).size() > qint64(on_disc_threshold) * 1024 * 1024)
+    {
+      cache_ms2_on_disc = true;
+    }
+
+    // load the data in an extra thread, such that the GUI stays responsive and loading can be cancelled
+    boost::shared_ptr<DataFileLoad> load(new DataFileLoad());
+    QFuture<void> future = QtConcurrent::run(&TOPPViewBase::loadDataFile_, load, abs_filename, file_type, cache_ms1_on_disc, cache_ms2_on_disc);
+    {
+      QProgressDialog progress(String("Loading '" + File::basename(abs_filename) + "' ...").toQString(), "Cancel", 0, 0, this);
+      progress.setWindowTitle("Loading file");
+      progress.setWindowModality(Qt::WindowModal);
+      progress.setAutoReset(false);
+      progress.setAutoClose(false);
+      progress.setMinimumDuration(1000);
+      QMutex mutex; mutex.lock();
+      QWaitCondition qwait;
+      while (!future.isFinished())
+      {
+        Size expected = load->items_expected;
+        if (expected > 0)
+        {
+          progress.setMaximum(int(expected));
+          progress.setValue(int(std::min(Size(load->items_loaded), expected)));
+        }
+        if (progress.wasCanceled())
+        {
+          load->cancel = true;
+        }
+        qApp->processEvents(); // GUI responsiveness
+        qwait.wait(&mutex, 25); // block for 25ms (enough for GUI responsiveness), so CPU usage remains low
+      }
+      mutex.unlock();
+    }
+
+    if (load->cancel)
+    {
+      showLogMessage_(LS_NOTICE, "Loading cancelled", String("Loading of '") + abs_filename + "' was cancelled.");
+      setCursor(Qt::ArrowCursor);
+      return;
+    }
+    for (Size i = 0; i < load->warnings.size(); ++i)
+    {
+      showLogMessage_(LS_WARNING, "While loading file:", load->warnings[i]);
+    }
+    if (!load->error.empty())
+    {
+      showLogMessage_(LS_ERROR, "Error while loading file:", load->error);
+      setCursor(Qt::ArrowCursor);
+      return;
+    }
+
+    // try to add the data
+    if (caption == "")
+    {
+      caption = File::removeExtension(File::basename(abs_filename));
+    }
+    else
+    {
+      abs_filename = "";
+    }
+
+    addData(load->feature_map, 
+      load->consensus_map, 
+      load->peptides, 
+      load->peak_map, 
+      load->on_disc_peaks, 
+      load->data_type, 
+      false, 
+      show_options, 
+      true, 
+      abs_filename, 
+      caption, 
+      window_id, 
+      spectrum_id);
 
-    // create shared pointer to main data types
-    FeatureMapType* feature_map = new FeatureMapType();
-    FeatureMapSharedPtrType feature_map_sptr(feature_map);
+    // add to recent file
+    if (add_to_recent)
+    {
+      addRecentFile_(filename);
+    }
+
+    // watch file contents for changes
+    watcher_->addFile(abs_filename);
 
-    ExperimentSharedPtrType peak_map_sptr(new ExperimentType());
+    // reset cursor
+    setCursor(Qt::ArrowCursor);
+  }
 
-    ConsensusMapType* consensus_map = new ConsensusMapType();
-    ConsensusMapSharedPtrType consensus_map_sptr(consensus_map);
+  namespace
+  {
+    /// Counts the spectra and chromatograms read from an mzML file and aborts parsing on request
+    class LoadProgressConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+  public:
+      LoadProgressConsumer(std::atomic<Size>& loaded, std::atomic<Size>& expected, const std::atomic<bool>& cancel) :
+        loaded_(loaded),
+        expected_(expected),
+        cancel_(cancel)
+      {
+      }
 
-    vector<PeptideIdentification> peptides;
+      void setExperimentalSettings(const ExperimentalSettings& /* settings */) override
+      {
+      }
 
-    LayerData::DataType data_type;
+      void setExpectedSize(Size s_size, Size c_size) override
+      {
+        expected_ = s_size + c_size;
+      }
 
-    ODExperimentSharedPtrType on_disc_peaks(new OnDiscMSExperiment);
+      void consumeSpectrum(SpectrumType& /* s */) override
+      {
+        next_();
+      }
 
-    bool cache_ms2_on_disc = ((String)param_.getValue("preferences:use_cached_ms2") == "true");
-    bool cache_ms1_on_disc = ((String)param_.getValue("preferences:use_cached_ms1") == "true");
+      void consumeChromatogram(ChromatogramType& /* c */) override
+      {
+        next_();
+      }
 
+  private:
+      void next_()
+      {
+        if (cancel_)
+        {
+          // silently stops the XML parser
+          throw Internal::XMLHandler::EndParsingSoftly(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+        }
+        ++loaded_;
+      }
+
+      std::atomic<Size>& loaded_;
+      std::atomic<Size>& expected_;
+      const std::atomic<bool>& cancel_;
+    };
+  }
+
+  TOPPViewBase::DataFileLoad::DataFileLoad() :
+    feature_map(new FeatureMapType()),
+    consensus_map(new ConsensusMapType()),
+    peptides(),
+    peak_map(new ExperimentType()),
+    on_disc_peaks(new OnDiscMSExperiment()),
+    data_type(LayerData::DT_UNKNOWN),
+    warnings(),
+    error(),
+    items_loaded(0),
+    items_expected(0),
+    cancel(false)
+  {
+  }
+
+  void TOPPViewBase::loadDataFile_(boost::shared_ptr<DataFileLoad> load, const String& filename, FileTypes::Type file_type, bool cache_ms1_on_disc, bool cache_ms2_on_disc)
+  {
     try
     {
       if (file_type == FileTypes::FEATUREXML)
       {
-        FeatureXMLFile().load(abs_filename, *feature_map);
-        data_type = LayerData::DT_FEATURE;
+        FeatureXMLFile().load(filename, *load->feature_map);
+        load->data_type = LayerData::DT_FEATURE;
       }
       else if (file_type == FileTypes::CONSENSUSXML)
       {
-        ConsensusXMLFile().load(abs_filename, *consensus_map);
-        data_type = LayerData::DT_CONSENSUS;
+        ConsensusXMLFile().load(filename, *load->consensus_map);
+        load->data_type = LayerData::DT_CONSENSUS;
       }
-      else if (file_type == FileTypes::IDXML)
+      else if (file_type == FileTypes::IDXML || file_type == FileTypes::MZIDENTML)
       {
         vector<ProteinIdentification> proteins; // not needed later
-        IdXMLFile().load(abs_filename, proteins, peptides);
-        if (peptides.empty())
-        {
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No peptide identifications found");
-        }
-        // check if RT (and sequence) information is present:
-        vector<PeptideIdentification> peptides_with_rt;
-        for (vector<PeptideIdentification>::const_iterator it =
-               peptides.begin(); it != peptides.end(); ++it)
+        if (file_type == FileTypes::IDXML)
         {
-          if (!it->getHits().empty() && it->hasRT())
-          {
-            peptides_with_rt.push_back(*it);
-          }
+          IdXMLFile().load(filename, proteins, load->peptides);
         }
-        Size diff = peptides.size() - peptides_with_rt.size();
-        if (diff)
+        else
         {
-          String msg = String(diff) + " peptide identification(s) without"
-                                      " sequence and/or retention time information were removed.\n" +
-                       peptides_with_rt.size() + " peptide identification(s) remaining.";
-          showLogMessage_(LS_WARNING, "While loading file:", msg);
+          MzIdentMLFile().load(filename, proteins, load->peptides);
         }
-        if (peptides_with_rt.empty())
-        {
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No peptide identifications with sufficient information remaining.");
-        }
-        peptides.swap(peptides_with_rt);
-        data_type = LayerData::DT_IDENT;
-      }
-      else if (file_type == FileTypes::MZIDENTML)
-      {
-        vector<ProteinIdentification> proteins; // not needed later
-        MzIdentMLFile().load(abs_filename, proteins, peptides);
-        if (peptides.empty())
+        if (load->peptides.empty())
         {
           throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No peptide identifications found");
         }
         // check if RT (and sequence) information is present:
         vector<PeptideIdentification> peptides_with_rt;
         for (vector<PeptideIdentification>::const_iterator it =
-               peptides.begin(); it != peptides.end(); ++it)
+               load->peptides.begin(); it != load->peptides.end(); ++it)
         {
           if (!it->getHits().empty() && it->hasRT())
           {
             peptides_with_rt.push_back(*it);
           }
         }
-        Size diff = peptides.size() - peptides_with_rt.size();
+        Size diff = load->peptides.size() - peptides_with_rt.size();
         if (diff)
         {
           String msg = String(diff) + " peptide identification(s) without"
                                       " sequence and/or retention time information were removed.\n" +
                        peptides_with_rt.size() + " peptide identification(s) remaining.";
-          showLogMessage_(LS_WARNING, "While loading file:", msg);
+          load->warnings.push_back(msg);
         }
         if (peptides_with_rt.empty())
         {
           throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No peptide identifications with sufficient information remaining.");
         }
-        peptides.swap(peptides_with_rt);
-        data_type = LayerData::DT_IDENT;
+        load->peptides.swap(peptides_with_rt);
+        load->data_type = LayerData::DT_IDENT;
       }
       else
       {
-        FileTypes::Type type;
-        type = FileHandler::getType(filename);
+        ExperimentSharedPtrType& peak_map_sptr = load->peak_map;
+        ODExperimentSharedPtrType& on_disc_peaks = load->on_disc_peaks;
         bool parsing_success = false;
-        if (type == FileTypes::MZML)
+        if (file_type == FileTypes::MZML)
         {
 
           // Load index only and check success (is it indexed?)
-          MzMLFile f;
           Internal::IndexedMzMLHandler indexed_mzml_file_;
           indexed_mzml_file_.openFile(filename);
           if ( indexed_mzml_file_.getParsingSuccess() && cache_ms2_on_disc)
@@ -1267,12 +1392,15 @@ namespace OpenMS
             // peak_map_sptr = boost::static_pointer_cast<ExperimentSharedPtrType>(on_disc_peaks->getMetaData());
             peak_map_sptr = on_disc_peaks->getMetaData();
 
+            load->items_expected = indexed_mzml_file_.getNrSpectra();
             for (Size k = 0; k < indexed_mzml_file_.getNrSpectra() && !cache_ms1_on_disc; k++)
             {
+              if (load->cancel) return;
               if ( peak_map_sptr->getSpectrum(k).getMSLevel() == 1)
               {
                 peak_map_sptr->getSpectrum(k) = on_disc_peaks->getSpectrum(k);
               }
+              ++load->items_loaded;
             }
             for (Size k = 0; k < indexed_mzml_file_.getNrChromatograms() && !cache_ms2_on_disc; k++)
             {
@@ -1282,70 +1410,48 @@ namespace OpenMS
             // Load at least one spectrum into memory (TOPPView assumes that at least one spectrum is in memory)
             if (cache_ms1_on_disc && peak_map_sptr->getNrSpectra() > 0) peak_map_sptr->getSpectrum(0) = on_disc_peaks->getSpectrum(0);
           }
+          else
+          {
+            // Load all data into memory, counting spectra for the progress dialog (the consumer also aborts on cancel)
+            LoadProgressConsumer consumer(load->items_loaded, load->items_expected, load->cancel);
+            MzMLFile f;
+            f.transform(filename, &consumer, *peak_map_sptr, true);
+            if (load->cancel) return;
+            peak_map_sptr->setLoadedFilePath(filename);
+            peak_map_sptr->setLoadedFileType(filename);
+            ChromatogramTools().convertSpectraToChromatograms<PeakMap>(*peak_map_sptr, true);
+            parsing_success = true;
+          }
         }
 
         // Load all data into memory
         if (!parsing_success)
         {
-          fh.loadExperiment(abs_filename, *peak_map_sptr, file_type, ProgressLogger::GUI);
+          FileHandler().loadExperiment(filename, *peak_map_sptr, file_type);
         }
         OPENMS_LOG_INFO << "INFO: done loading all " << std::endl;
 
         // a mzML file may contain both, chromatogram and peak data
         // -> this is handled in SpectrumCanvas::addLayer
-        data_type = LayerData::DT_CHROMATOGRAM;
+        load->data_type = LayerData::DT_CHROMATOGRAM;
         if (TOPPViewBase::containsMS1Scans(*peak_map_sptr))
         {
-          data_type = LayerData::DT_PEAK;
+          load->data_type = LayerData::DT_PEAK;
         }
       }
-    }
-    catch (Exception::BaseException& e)
-    {
-      showLogMessage_(LS_ERROR, "Error while loading file:", e.what());
-      setCursor(Qt::ArrowCursor);
-      return;
-    }
-
-    // sort for mz and update ranges of newly loaded data
-    peak_map_sptr->sortSpectra(true);
-    peak_map_sptr->updateRanges(1);
 
-    // try to add the data
-    if (caption == "")
-    {
-      caption = File::removeExtension(File::basename(abs_filename));
+      // sort for mz and update ranges of newly loaded data
+      load->peak_map->sortSpectra(true);
+      load->peak_map->updateRanges(1);
     }
-    else
+    catch (Exception::BaseException& e)
     {
-      abs_filename = "";
+      load->error = e.what();
     }
-
-    addData(feature_map_sptr, 
-      consensus_map_sptr, 
-      peptides, 
-      peak_map_sptr, 
-      on_disc_peaks, 
-      data_type, 
-      false, 
-      show_options, 
-      true, 
-      abs_filename, 
-      caption, 
-      window_id, 
-      spectrum_id);
-
-    // add to recent file
-    if (add_to_recent)
+    catch (std::bad_alloc&)
     {
-      addRecentFile_(filename);
+      load->error = "Not enough memory to load the file. Consider keeping MS2 spectra on disc (see preferences).";
     }
-
-    // watch file contents for changes
-    watcher_->addFile(abs_filename);
-
-    // reset cursor
-    setCursor(Qt::ArrowCursor);
   }
 
   void TOPPViewBase::addData(FeatureMapSharedPtrType feature_map,
@@ -0,0 +1,298 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/IntensityPyramid.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    // identifies (and versions) the cache file format
+    const char PYRAMID_MAGIC[8] = {'O', 'M', 'S', 'P', 'Y', 'R', '0', '1'};
+
+    template <typename T>
+    void writeValue_(ofstream& os, const T& value)
+    {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue_(ifstream& is, T& value)
+    {
+      is.read(reinterpret_cast<char*>(&value), sizeof(T));
+      return bool(is);
+    }
+  }
+
+  IntensityPyramid::IntensityPyramid() :
+    levels_(),
+    rt_min_(0.0),
+    rt_max_(0.0),
+    mz_min_(0.0),
+    mz_max_(0.0)
+  {
+  }
+
+  void IntensityPyramid::clear()
+  {
+    levels_.clear();
+    rt_min_ = rt_max_ = mz_min_ = mz_max_ = 0.0;
+  }
+
+  bool IntensityPyramid::empty() const
+  {
+    return levels_.empty();
+  }
+
+  Size IntensityPyramid::getLevelCount() const
+  {
+    return levels_.size();
+  }
+
+  const IntensityPyramid::Level& IntensityPyramid::getLevel(Size index) const
+  {
+    return levels_[index];
+  }
+
+  double IntensityPyramid::getMinRT() const
+  {
+    return rt_min_;
+  }
+
+  double IntensityPyramid::getMaxRT() const
+  {
+    return rt_max_;
+  }
+
+  double IntensityPyramid::getMinMZ() const
+  {
+    return mz_min_;
+  }
+
+  double IntensityPyramid::getMaxMZ() const
+  {
+    return mz_max_;
+  }
+
+  void IntensityPyramid::build(const PeakMap& exp, Size max_rt_bins, Size max_mz_bins, Size min_bins)
+  {
+    clear();
+
+    // only non-empty MS1 spectra are painted in 2D view
+    vector<Size> ms1;
+    double mz_min = numeric_limits<double>::max();
+    double mz_max = -numeric_limits<double>::max();
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      if (exp[i].getMSLevel() == 1 && !exp[i].empty())
+      {
+        ms1.push_back(i);
+        mz_min = min(mz_min, exp[i].front().getMZ());
+        mz_max = max(mz_max, exp[i].back().getMZ());
+      }
+    }
+    if (ms1.empty() || max_rt_bins == 0 || max_mz_bins == 0) return;
+
+    rt_min_ = exp[ms1.front()].getRT();
+    rt_max_ = exp[ms1.back()].getRT();
+    mz_min_ = mz_min;
+    mz_max_ = mz_max;
+    // avoid degenerated bins for single spectra or single peaks
+    if (rt_max_ <= rt_min_) rt_max_ = rt_min_ + 1.0;
+    if (mz_max_ <= mz_min_) mz_max_ = mz_min_ + 1.0;
+
+    Level base;
+    base.rt_bins = min(max_rt_bins, ms1.size());
+    base.mz_bins = max_mz_bins;
+    base.rt_bin_size = (rt_max_ - rt_min_) / base.rt_bins;
+    base.mz_bin_size = (mz_max_ - mz_min_) / base.mz_bins;
+    base.max_intensity.assign(base.rt_bins * base.mz_bins, -1.0f);
+    base.sum_intensity.assign(base.rt_bins * base.mz_bins, 0.0f);
+
+    // assign spectra to RT bins first, so each bin row is written by one thread only
+    vector<vector<Size> > row_spectra(base.rt_bins);
+    for (Size i = 0; i < ms1.size(); ++i)
+    {
+      Size row = min(base.rt_bins - 1, Size((exp[ms1[i]].getRT() - rt_min_) / base.rt_bin_size));
+      row_spectra[row].push_back(ms1[i]);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize row = 0; row < (SignedSize)base.rt_bins; ++row)
+    {
+      float* max_row = &base.max_intensity[row * base.mz_bins];
+      float* sum_row = &base.sum_intensity[row * base.mz_bins];
+      for (Size s = 0; s < row_spectra[row].size(); ++s)
+      {
+        const MSSpectrum& spec = exp[row_spectra[row][s]];
+        for (MSSpectrum::ConstIterator it = spec.begin(); it != spec.end(); ++it)
+        {
+          Size col = min(base.mz_bins - 1, Size((it->getMZ() - mz_min_) / base.mz_bin_size));
+          max_row[col] = max(max_row[col], it->getIntensity());
+          sum_row[col] += it->getIntensity();
+        }
+      }
+    }
+    levels_.push_back(base);
+
+    // every coarser level merges 2x2 bins of the previous one
+    while (levels_.back().rt_bins / 2 >= min_bins && levels_.back().mz_bins / 2 >= min_bins)
+    {
+      const Level& fine = levels_.back();
+      Level coarse;
+      coarse.rt_bins = (fine.rt_bins + 1) / 2;
+      coarse.mz_bins = (fine.mz_bins + 1) / 2;
+      coarse.rt_bin_size = fine.rt_bin_size * 2.0;
+      coarse.mz_bin_size = fine.mz_bin_size * 2.0;
+      coarse.max_intensity.assign(coarse.rt_bins * coarse.mz_bins, -1.0f);
+      coarse.sum_intensity.assign(coarse.rt_bins * coarse.mz_bins, 0.0f);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize row = 0; row < (SignedSize)fine.rt_bins; row += 2)
+      {
+        Size row_end = min(fine.rt_bins, Size(row + 2));
+        for (Size r = row; r < row_end; ++r)
+        {
+          for (Size col = 0; col < fine.mz_bins; ++col)
+          {
+            Size target = (row / 2) * coarse.mz_bins + col / 2;
+            coarse.max_intensity[target] = max(coarse.max_intensity[target], fine.getMax(r, col));
+            coarse.sum_intensity[target] += fine.getSum(r, col);
+          }
+        }
+      }
+      levels_.push_back(coarse);
+    }
+  }
+
+  Size IntensityPyramid::selectLevel(double rt_extent, double mz_extent) const
+  {
+    Size selected = levels_.size();
+    for (Size i = 0; i < levels_.size(); ++i)
+    {
+      if (levels_[i].rt_bin_size > rt_extent || levels_[i].mz_bin_size > mz_extent) break;
+      selected = i;
+    }
+    return selected;
+  }
+
+  bool IntensityPyramid::store(const String& filename, UInt64 stamp) const
+  {
+    ofstream os(filename.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!os) return false;
+
+    os.write(PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC));
+    writeValue_(os, stamp);
+    writeValue_(os, rt_min_);
+    writeValue_(os, rt_max_);
+    writeValue_(os, mz_min_);
+    writeValue_(os, mz_max_);
+    writeValue_(os, UInt64(levels_.size()));
+    for (Size i = 0; i < levels_.size(); ++i)
+    {
+      const Level& level = levels_[i];
+      writeValue_(os, UInt64(level.rt_bins));
+      writeValue_(os, UInt64(level.mz_bins));
+      writeValue_(os, level.rt_bin_size);
+      writeValue_(os, level.mz_bin_size);
+      os.write(reinterpret_cast<const char*>(&level.max_intensity[0]), level.max_intensity.size() * sizeof(float));
+      os.write(reinterpret_cast<const char*>(&level.sum_intensity[0]), level.sum_intensity.size() * sizeof(float));
+    }
+    return bool(os);
+  }
+
+  bool IntensityPyramid::load(const String& filename, UInt64 stamp)
+  {
+    clear();
+
+    ifstream is(filename.c_str(), ios::in | ios::binary);
+    if (!is) return false;
+
+    char magic[sizeof(PYRAMID_MAGIC)];
+    is.read(magic, sizeof(magic));
+    UInt64 file_stamp(0), level_count(0);
+    if (!is || memcmp(magic, PYRAMID_MAGIC, sizeof(magic)) != 0 ||
+        !readValue_(is, file_stamp) || file_stamp != stamp ||
+        !readValue_(is, rt_min_) || !readValue_(is, rt_max_) ||
+        !readValue_(is, mz_min_) || !readValue_(is, mz_max_) ||
+        !readValue_(is, level_count))
+    {
+      clear();
+      return false;
+    }
+
+    levels_.resize(level_count);
+    for (Size i = 0; i < levels_.size(); ++i)
+    {
+      Level& level = levels_[i];
+      UInt64 rt_bins(0), mz_bins(0);
+      if (!readValue_(is, rt_bins) || !readValue_(is, mz_bins) ||
+          !readValue_(is, level.rt_bin_size) || !readValue_(is, level.mz_bin_size) ||
+          rt_bins == 0 || mz_bins == 0)
+      {
+        clear();
+        return false;
+      }
+      level.rt_bins = rt_bins;
+      level.mz_bins = mz_bins;
+      level.max_intensity.resize(rt_bins * mz_bins);
+      level.sum_intensity.resize(rt_bins * mz_bins);
+      is.read(reinterpret_cast<char*>(&level.max_intensity[0]), level.max_intensity.size() * sizeof(float));
+      is.read(reinterpret_cast<char*>(&level.sum_intensity[0]), level.sum_intensity.size() * sizeof(float));
+      if (!is)
+      {
+        clear();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  String IntensityPyramid::cacheFilename(const String& filename)
+  {
+    return filename + ".pyramid";
+  }
+
+}
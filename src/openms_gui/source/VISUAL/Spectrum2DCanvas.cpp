@@ -49,6 +49,7 @@
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 //STL
 #include <algorithm>
+#include <set>
 
 //QT
 #include <QMouseEvent>
@@ -57,6 +58,9 @@
 #include <QBitmap>
 #include <QPolygon>
 #include <QtCore/QTime>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtConcurrent/QtConcurrent>
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
@@ -103,6 +107,8 @@ namespace OpenMS
     defaults_.setMaxInt("dot:feature_icon_size", 999);
     defaults_.setValue("mapping_of_mz_to", "y_axis", "Determines which axis is the m/z axis.");
     defaults_.setValidStrings("mapping_of_mz_to", ListUtils::create<String>("x_axis,y_axis"));
+    defaults_.setValue("dot:pyramid_cache", "false", "Store the intensity overview used for zoomed-out peak maps next to the data file ('<file>.pyramid') and reuse it when the file is opened again.");
+    defaults_.setValidStrings("dot:pyramid_cache", ListUtils::create<String>("true,false"));
     defaultsToParam_();
     setName("Spectrum2DCanvas");
     setParameters(preferences);
@@ -395,7 +401,18 @@ namespace OpenMS
         // Also, we cannot upscale in this mode (since we operate on the buffer directly, i.e. '1 data point == 1 pixel'
         if (!has_low_pixel_coverage && (n_peaks_in_scan > mz_pixel_count || n_ms1_scans > rt_pixel_count))
         {
-          paintMaximumIntensities_(layer_index, rt_pixel_count, mz_pixel_count, painter);
+          // use precomputed bin maxima if a pyramid level is at least as fine as one pixel
+          // (data filters cannot be applied to the summarized data)
+          const IntensityPyramid* pyramid = layer.filters.isActive() ? nullptr : getIntensityPyramid_(layer_index);
+          Size level = (pyramid == nullptr) ? 0 : pyramid->selectLevel((rt_max - rt_min) / rt_pixel_count, (mz_max - mz_min) / mz_pixel_count);
+          if (pyramid != nullptr && level < pyramid->getLevelCount())
+          {
+            paintPyramidIntensities_(layer_index, *pyramid, level, rt_pixel_count, mz_pixel_count);
+          }
+          else
+          {
+            paintMaximumIntensities_(layer_index, rt_pixel_count, mz_pixel_count, painter);
+          }
         }
         else
         { // this is slower to paint, but allows scaling points
@@ -726,6 +743,154 @@ namespace OpenMS
     }
   }
 
+  void Spectrum2DCanvas::paintPyramidIntensities_(Size layer_index, const IntensityPyramid& pyramid, Size level_index, Size rt_pixel_count, Size mz_pixel_count)
+  {
+    //temporary variables
+    Int image_width = buffer_.width();
+    Int image_height = buffer_.height();
+
+    const LayerData & layer = getLayer(layer_index);
+    const IntensityPyramid::Level & level = pyramid.getLevel(level_index);
+    const double rt_min = visible_area_.minPosition()[1];
+    const double rt_max = visible_area_.maxPosition()[1];
+    const double mz_min = visible_area_.minPosition()[0];
+    const double mz_max = visible_area_.maxPosition()[0];
+
+    double snap_factor = snap_factors_[layer_index];
+
+    //calculate pixel size in data coordinates
+    double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
+    double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
+
+    //iterate over all pixels (RT dimension)
+    for (Size rt = 0; rt < rt_pixel_count; ++rt)
+    {
+      // interval in data coordinates for the current pixel
+      double rt_start = rt_min + rt_step_size * rt;
+      double rt_end = rt_start + rt_step_size;
+      if (rt_end < pyramid.getMinRT() || rt_start > pyramid.getMaxRT()) continue;
+
+      // bins overlapping the pixel (bins are not larger than a pixel, so these are only a few)
+      Size row_begin = Size(std::max(0.0, (rt_start - pyramid.getMinRT()) / level.rt_bin_size));
+      Size row_end = std::min(level.rt_bins - 1, Size(std::max(0.0, (rt_end - pyramid.getMinRT()) / level.rt_bin_size)));
+
+      //iterate over all pixels (m/z dimension)
+      for (Size mz = 0; mz < mz_pixel_count; ++mz)
+      {
+        double mz_start = mz_min + mz_step_size * mz;
+        double mz_end = mz_start + mz_step_size;
+        if (mz_end < pyramid.getMinMZ() || mz_start > pyramid.getMaxMZ()) continue;
+
+        Size col_begin = Size(std::max(0.0, (mz_start - pyramid.getMinMZ()) / level.mz_bin_size));
+        Size col_end = std::min(level.mz_bins - 1, Size(std::max(0.0, (mz_end - pyramid.getMinMZ()) / level.mz_bin_size)));
+
+        float max = -1.0;
+        for (Size row = row_begin; row <= row_end; ++row)
+        {
+          for (Size col = col_begin; col <= col_end; ++col)
+          {
+            max = std::max(max, level.getMax(row, col));
+          }
+        }
+
+        //draw to buffer
+        if (max >= 0.0)
+        {
+          QPoint pos;
+          dataToWidget_(mz_start + 0.5 * mz_step_size, rt_start + 0.5 * rt_step_size, pos);
+          if (pos.y() < image_height && pos.x() < image_width)
+          {
+            buffer_.setPixel(pos.x(), pos.y(), heightColor_(max, layer.gradient, snap_factor).rgb());
+          }
+        }
+      }
+    }
+  }
+
+  const IntensityPyramid* Spectrum2DCanvas::getIntensityPyramid_(Size layer_index)
+  {
+    const LayerData & layer = getLayer(layer_index);
+    const ExperimentType* data = layer.getPeakData().get();
+
+    std::map<const ExperimentType*, IntensityPyramidBuild>::const_iterator it = intensity_pyramids_.find(data);
+    if (it != intensity_pyramids_.end())
+    {
+      if (!it->second.watcher->isFinished() || it->second.entry->pyramid.empty())
+      {
+        return nullptr;
+      }
+      return &(it->second.entry->pyramid);
+    }
+
+    // first request for this data: build the pyramid in the background and paint raw data meanwhile
+    IntensityPyramidBuild build;
+    build.entry.reset(new IntensityPyramidEntry());
+    build.entry->data = layer.getPeakData();
+    build.entry->cache_stamp = 0;
+    if (param_.getValue("dot:pyramid_cache").toBool() && !layer.filename.empty())
+    {
+      QFileInfo info(layer.filename.toQString());
+      if (info.exists())
+      {
+        // identifies the file version and the part of it that was loaded
+        build.entry->cache_file = IntensityPyramid::cacheFilename(layer.filename);
+        build.entry->cache_stamp = UInt64(info.size()) * 1000003u
+                                   ^ UInt64(info.lastModified().toMSecsSinceEpoch()) * 31u
+                                   ^ UInt64(data->size()) << 32
+                                   ^ UInt64(data->getSize());
+      }
+    }
+    build.watcher.reset(new QFutureWatcher<void>());
+    connect(build.watcher.get(), SIGNAL(finished()), this, SLOT(intensityPyramidReady_()));
+    build.watcher->setFuture(QtConcurrent::run(&Spectrum2DCanvas::buildIntensityPyramid_, build.entry));
+    intensity_pyramids_[data] = build;
+
+    return nullptr;
+  }
+
+  void Spectrum2DCanvas::buildIntensityPyramid_(boost::shared_ptr<IntensityPyramidEntry> entry)
+  {
+    if (!entry->cache_file.empty() && entry->pyramid.load(entry->cache_file, entry->cache_stamp))
+    {
+      return;
+    }
+    entry->pyramid.build(*entry->data);
+    if (!entry->cache_file.empty() && !entry->pyramid.store(entry->cache_file, entry->cache_stamp))
+    {
+      OPENMS_LOG_WARN << "Could not write intensity pyramid cache '" << entry->cache_file << "'." << std::endl;
+    }
+  }
+
+  void Spectrum2DCanvas::releaseIntensityPyramids_()
+  {
+    std::set<const ExperimentType*> shown;
+    for (Size i = 0; i < getLayerCount(); ++i)
+    {
+      if (getLayer(i).type == LayerData::DT_PEAK)
+      {
+        shown.insert(getLayer(i).getPeakData().get());
+      }
+    }
+    for (std::map<const ExperimentType*, IntensityPyramidBuild>::iterator it = intensity_pyramids_.begin(); it != intensity_pyramids_.end(); )
+    {
+      // a running build keeps its own reference to the entry, so it can be dropped at any time
+      if (shown.count(it->first) == 0)
+      {
+        intensity_pyramids_.erase(it++);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  void Spectrum2DCanvas::intensityPyramidReady_()
+  {
+    update_buffer_ = true;
+    update_(OPENMS_PRETTY_FUNCTION);
+  }
+
   void Spectrum2DCanvas::paintFeatureData_(Size layer_index, QPainter& painter)
   {
     const LayerData& layer = getLayer(layer_index);
@@ -1353,6 +1518,7 @@ namespace OpenMS
 
     // remove the data
     layers_.erase(layers_.begin() + layer_index);
+    releaseIntensityPyramids_();
 
     // update visible area and boundaries
     DRange<3> old_data_range = overall_data_range_;
@@ -2844,6 +3010,11 @@ namespace OpenMS
   {
     //update nearest peak
     selected_peak_.clear();
+    // the data changed, its intensity pyramid is rebuilt on demand
+    if (i < getLayerCount() && getLayer(i).type == LayerData::DT_PEAK)
+    {
+      intensity_pyramids_.erase(getLayer(i).getPeakData().get());
+    }
     recalculateRanges_(0, 1, 2);
     resetZoom(false);     //no repaint as this is done in intensityModeChange_() anyway
     intensityModeChange_();
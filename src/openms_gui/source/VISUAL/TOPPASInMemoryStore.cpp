@@ -0,0 +1,323 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/TOPPASInMemoryStore.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+#include <QtCore/QMutexLocker>
+
+namespace OpenMS
+{
+  namespace
+  {
+    // helpers which differ by data type (estimated memory, file I/O)
+
+    double estimateMemory(const PeakMap& exp)
+    {
+      double bytes = 0.0;
+      for (Size i = 0; i < exp.size(); ++i)
+      {
+        bytes += sizeof(MSSpectrum) + exp[i].size() * sizeof(Peak1D);
+      }
+      for (Size i = 0; i < exp.getNrChromatograms(); ++i)
+      {
+        bytes += sizeof(MSChromatogram) + exp.getChromatograms()[i].size() * sizeof(ChromatogramPeak);
+      }
+      return bytes / (1024.0 * 1024.0);
+    }
+
+    double estimateMemory(const FeatureMap& map)
+    {
+      double bytes = 0.0;
+      for (Size i = 0; i < map.size(); ++i)
+      {
+        bytes += sizeof(Feature) + map[i].getSubordinates().size() * sizeof(Feature);
+        for (Size j = 0; j < map[i].getConvexHulls().size(); ++j)
+        {
+          bytes += map[i].getConvexHulls()[j].getHullPoints().size() * sizeof(ConvexHull2D::PointType);
+        }
+      }
+      return bytes / (1024.0 * 1024.0);
+    }
+
+    double estimateMemory(const ConsensusMap& map)
+    {
+      double bytes = 0.0;
+      for (Size i = 0; i < map.size(); ++i)
+      {
+        bytes += sizeof(ConsensusFeature) + map[i].size() * sizeof(FeatureHandle);
+      }
+      return bytes / (1024.0 * 1024.0);
+    }
+
+    double estimateMemory(const TOPPASInMemoryStore::IdentificationData& ids)
+    {
+      double bytes = 0.0;
+      for (Size i = 0; i < ids.proteins.size(); ++i)
+      {
+        bytes += sizeof(ProteinIdentification) + ids.proteins[i].getHits().size() * sizeof(ProteinHit);
+      }
+      for (Size i = 0; i < ids.peptides.size(); ++i)
+      {
+        bytes += sizeof(PeptideIdentification) + ids.peptides[i].getHits().size() * sizeof(PeptideHit);
+      }
+      return bytes / (1024.0 * 1024.0);
+    }
+
+    void swapData(PeakMap& a, PeakMap& b)
+    {
+      a.swap(b);
+    }
+
+    void swapData(FeatureMap& a, FeatureMap& b)
+    {
+      a.swap(b);
+    }
+
+    void swapData(ConsensusMap& a, ConsensusMap& b)
+    {
+      a.swap(b);
+    }
+
+    void swapData(TOPPASInMemoryStore::IdentificationData& a, TOPPASInMemoryStore::IdentificationData& b)
+    {
+      a.proteins.swap(b.proteins);
+      a.peptides.swap(b.peptides);
+    }
+
+    void readFile(const String& filename, PeakMap& exp)
+    {
+      MzMLFile().load(filename, exp);
+    }
+
+    void readFile(const String& filename, FeatureMap& map)
+    {
+      FeatureXMLFile().load(filename, map);
+    }
+
+    void readFile(const String& filename, ConsensusMap& map)
+    {
+      ConsensusXMLFile().load(filename, map);
+    }
+
+    void readFile(const String& filename, TOPPASInMemoryStore::IdentificationData& ids)
+    {
+      IdXMLFile().load(filename, ids.proteins, ids.peptides);
+    }
+
+    void writeFile(const String& filename, const PeakMap& exp)
+    {
+      MzMLFile().store(filename, exp);
+    }
+
+    void writeFile(const String& filename, const FeatureMap& map)
+    {
+      FeatureXMLFile().store(filename, map);
+    }
+
+    void writeFile(const String& filename, const ConsensusMap& map)
+    {
+      ConsensusXMLFile().store(filename, map);
+    }
+
+    void writeFile(const String& filename, const TOPPASInMemoryStore::IdentificationData& ids)
+    {
+      IdXMLFile().store(filename, ids.proteins, ids.peptides);
+    }
+
+    // data read from memory looks as if it was loaded from the file (as done by the file readers)
+    void setLoadedFile(const String& filename, DocumentIdentifier& data)
+    {
+      data.setLoadedFileType(filename);
+      data.setLoadedFilePath(filename);
+    }
+
+    void setLoadedFile(const String& /*filename*/, TOPPASInMemoryStore::IdentificationData& /*ids*/)
+    {
+    }
+  }
+
+  TOPPASInMemoryStore::TOPPASInMemoryStore() :
+    memory_limit_mb_(0.0),
+    memory_used_mb_(0.0),
+    mutex_(),
+    experiments_(),
+    feature_maps_(),
+    consensus_maps_(),
+    identifications_()
+  {
+  }
+
+  void TOPPASInMemoryStore::setMemoryLimit(double memory_mb)
+  {
+    QMutexLocker locker(&mutex_);
+    memory_limit_mb_ = std::max(memory_mb, 0.0);
+  }
+
+  double TOPPASInMemoryStore::getMemoryLimit() const
+  {
+    QMutexLocker locker(&mutex_);
+    return memory_limit_mb_;
+  }
+
+  double TOPPASInMemoryStore::getMemoryUsage() const
+  {
+    QMutexLocker locker(&mutex_);
+    return memory_used_mb_;
+  }
+
+  bool TOPPASInMemoryStore::contains(const String& filename) const
+  {
+    QMutexLocker locker(&mutex_);
+    return experiments_.count(filename) || feature_maps_.count(filename) ||
+           consensus_maps_.count(filename) || identifications_.count(filename);
+  }
+
+  template <typename DataType>
+  void TOPPASInMemoryStore::store_(std::map<String, Entry_<DataType> >& entries, const String& filename, DataType& data, Size readers)
+  {
+    QMutexLocker locker(&mutex_);
+
+    // data from an earlier run of the same tool is replaced
+    typename std::map<String, Entry_<DataType> >::iterator old = entries.find(filename);
+    if (old != entries.end())
+    {
+      memory_used_mb_ -= old->second.memory_mb;
+      entries.erase(old);
+    }
+
+    if (readers > 0)
+    {
+      double memory_mb = estimateMemory(data);
+      if (memory_limit_mb_ <= 0.0 || memory_used_mb_ + memory_mb <= memory_limit_mb_)
+      {
+        Entry_<DataType>& entry = entries[filename];
+        swapData(entry.data, data);
+        entry.readers = readers;
+        entry.memory_mb = memory_mb;
+        memory_used_mb_ += memory_mb;
+        return;
+      }
+      OPENMS_LOG_INFO << "Keeping '" << filename << "' (" << memory_mb << " MB) in memory would exceed the limit of "
+                      << memory_limit_mb_ << " MB (" << memory_used_mb_ << " MB in use). Writing it to disk." << std::endl;
+    }
+    locker.unlock();
+
+    writeFile(filename, data);
+    data = DataType();
+  }
+
+  template <typename DataType>
+  void TOPPASInMemoryStore::load_(std::map<String, Entry_<DataType> >& entries, const String& filename, DataType& data)
+  {
+    QMutexLocker locker(&mutex_);
+
+    typename std::map<String, Entry_<DataType> >::iterator it = entries.find(filename);
+    if (it == entries.end())
+    {
+      locker.unlock();
+      readFile(filename, data);
+      return;
+    }
+
+    if (--it->second.readers == 0)
+    { // last reader: hand out the data itself
+      data = DataType();
+      swapData(data, it->second.data);
+      memory_used_mb_ -= it->second.memory_mb;
+      entries.erase(it);
+    }
+    else
+    {
+      data = it->second.data;
+    }
+    setLoadedFile(filename, data);
+  }
+
+  void TOPPASInMemoryStore::store(const String& filename, PeakMap& data, Size readers)
+  {
+    store_(experiments_, filename, data, readers);
+  }
+
+  void TOPPASInMemoryStore::store(const String& filename, FeatureMap& data, Size readers)
+  {
+    store_(feature_maps_, filename, data, readers);
+  }
+
+  void TOPPASInMemoryStore::store(const String& filename, ConsensusMap& data, Size readers)
+  {
+    store_(consensus_maps_, filename, data, readers);
+  }
+
+  void TOPPASInMemoryStore::store(const String& filename, IdentificationData& data, Size readers)
+  {
+    store_(identifications_, filename, data, readers);
+  }
+
+  void TOPPASInMemoryStore::load(const String& filename, PeakMap& data)
+  {
+    load_(experiments_, filename, data);
+  }
+
+  void TOPPASInMemoryStore::load(const String& filename, FeatureMap& data)
+  {
+    load_(feature_maps_, filename, data);
+  }
+
+  void TOPPASInMemoryStore::load(const String& filename, ConsensusMap& data)
+  {
+    load_(consensus_maps_, filename, data);
+  }
+
+  void TOPPASInMemoryStore::load(const String& filename, IdentificationData& data)
+  {
+    load_(identifications_, filename, data);
+  }
+
+  void TOPPASInMemoryStore::clear()
+  {
+    QMutexLocker locker(&mutex_);
+    experiments_.clear();
+    feature_maps_.clear();
+    consensus_maps_.clear();
+    identifications_.clear();
+    memory_used_mb_ = 0.0;
+  }
+
+} //namespace OpenMS
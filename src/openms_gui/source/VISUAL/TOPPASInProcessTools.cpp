@@ -0,0 +1,284 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/TOPPASInProcessTools.h>
+
+#include <OpenMS/VISUAL/TOPPASInMemoryStore.h>
+
+#include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
+#include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// A single run of a tool: its parameters and where its data goes. The work is done by TOPPToolCores (as in the executables).
+    struct ToolRun
+    {
+      ToolRun(const String& n, const Param& p, const std::map<String, Size>& r, TOPPASInMemoryStore& s) :
+        name(n),
+        param(p),
+        readers(r),
+        store(s)
+      {
+      }
+
+      String getStringOption(const String& key) const
+      {
+        return param.getValue(key).toString();
+      }
+
+      bool getFlag(const String& key) const
+      {
+        return param.exists(key) && param.getValue(key).toString() == "true";
+      }
+
+      Int getDebugLevel() const
+      {
+        return param.exists("debug") ? (Int)param.getValue("debug") : 0;
+      }
+
+      ProgressLogger::LogType getLogType() const
+      {
+        return getFlag("no_progress") ? ProgressLogger::NONE : ProgressLogger::CMD;
+      }
+
+      /// number of tools which will read @p file from memory (0: write the file)
+      Size getReaders(const String& file) const
+      {
+        std::map<String, Size>::const_iterator it = readers.find(file);
+        return it == readers.end() ? 0 : it->second;
+      }
+
+      DataProcessing getProcessingInfo(DataProcessing::ProcessingAction action) const
+      {
+        std::set<DataProcessing::ProcessingAction> actions;
+        actions.insert(action);
+        return TOPPBase::getProcessingInfo(name, param, getFlag("test"), actions);
+      }
+
+      const String& name;
+      const Param& param;
+      const std::map<String, Size>& readers;
+      TOPPASInMemoryStore& store;
+    };
+
+    // NoiseFilterGaussian, NoiseFilterSGolay
+    template <typename FilterType>
+    TOPPBase::ExitCodes runNoiseFilter(const ToolRun& run)
+    {
+      String in = run.getStringOption("in");
+      String out = run.getStringOption("out");
+
+      FilterType filter;
+      filter.setLogType(run.getLogType());
+      filter.setParameters(run.param.copy("algorithm:", true));
+
+      PeakMap exp;
+      run.store.load(in, exp);
+
+      TOPPBase::ExitCodes result = TOPPToolCores::smooth(filter, exp);
+      if (result != TOPPBase::EXECUTION_OK) return result;
+
+      TOPPBase::addDataProcessing(exp, run.getProcessingInfo(DataProcessing::SMOOTHING));
+      run.store.store(out, exp, run.getReaders(out));
+      return TOPPBase::EXECUTION_OK;
+    }
+
+    // PeakPickerHiRes
+    TOPPBase::ExitCodes runPeakPickerHiRes(const ToolRun& run)
+    {
+      String in = run.getStringOption("in");
+      String out = run.getStringOption("out");
+
+      PeakPickerHiRes pp;
+      pp.setLogType(run.getLogType());
+      pp.setParameters(run.param.copy("algorithm:", true));
+
+      PeakMap ms_exp_raw;
+      run.store.load(in, ms_exp_raw);
+
+      PeakMap ms_exp_peaks;
+      TOPPBase::ExitCodes result = TOPPToolCores::pickPeaks(pp, ms_exp_raw, ms_exp_peaks, !run.getFlag("force"));
+      if (result != TOPPBase::EXECUTION_OK) return result;
+      ms_exp_raw.clear(true); // free the memory of the raw data before handing on the picked data
+
+      TOPPBase::addDataProcessing(ms_exp_peaks, run.getProcessingInfo(DataProcessing::PEAK_PICKING));
+      run.store.store(out, ms_exp_peaks, run.getReaders(out));
+      return TOPPBase::EXECUTION_OK;
+    }
+
+    // FeatureFinderCentroided
+    TOPPBase::ExitCodes runFeatureFinderCentroided(const ToolRun& run)
+    {
+      String in = run.getStringOption("in");
+      String out = run.getStringOption("out");
+      String out_mzq = run.getStringOption("out_mzq");
+
+      PeakMap exp;
+      run.store.load(in, exp);
+
+      FeatureMap seeds;
+      if (run.getStringOption("seeds") != "")
+      {
+        run.store.load(run.getStringOption("seeds"), seeds);
+      }
+
+      FeatureMap features;
+      TOPPToolCores::findFeatures(exp, in, seeds, run.param.copy("algorithm:", true), run.getFlag("force"), run.getFlag("test"),
+                                  run.getDebugLevel(), run.getLogType(), features);
+
+      TOPPBase::addDataProcessing(features, run.getProcessingInfo(DataProcessing::QUANTITATION));
+
+      if (!out_mzq.trim().empty())
+      {
+        TOPPToolCores::storeMzQuantML(out_mzq, features, exp);
+      }
+
+      run.store.store(out, features, run.getReaders(out));
+      return TOPPBase::EXECUTION_OK;
+    }
+
+    // ConsensusMapNormalizer
+    TOPPBase::ExitCodes runConsensusMapNormalizer(const ToolRun& run)
+    {
+      String in = run.getStringOption("in");
+      String out = run.getStringOption("out");
+
+      ConsensusMap map;
+      run.store.load(in, map);
+
+      TOPPBase::ExitCodes result = TOPPToolCores::normalize(map, run.getStringOption("algorithm_type"), run.param.getValue("ratio_threshold"),
+                                                            run.getStringOption("accession_filter"), run.getStringOption("description_filter"));
+      if (result != TOPPBase::EXECUTION_OK) return result;
+
+      TOPPBase::addDataProcessing(map, run.getProcessingInfo(DataProcessing::NORMALIZATION), run.getFlag("test"));
+      run.store.store(out, map, run.getReaders(out));
+      return TOPPBase::EXECUTION_OK;
+    }
+
+    // PeptideIndexer
+    TOPPBase::ExitCodes runPeptideIndexer(const ToolRun& run)
+    {
+      String in = run.getStringOption("in");
+      String out = run.getStringOption("out");
+
+      PeptideIndexing indexer;
+      Param param_pi = indexer.getParameters();
+      param_pi.update(run.param, false, OpenMS_Log_debug); // suppress param. update message
+      indexer.setParameters(param_pi);
+      indexer.setLogType(run.getLogType());
+      String db_name = run.getStringOption("fasta");
+      if (!TOPPToolCores::findDatabase(db_name))
+      {
+        OPENMS_LOG_ERROR << "Database '" << db_name << "' not found." << std::endl;
+        return TOPPBase::ILLEGAL_PARAMETERS;
+      }
+
+      TOPPASInMemoryStore::IdentificationData ids;
+      run.store.load(in, ids);
+
+      TOPPBase::ExitCodes result = TOPPToolCores::indexPeptides(indexer, db_name, run.getStringOption("index"),
+                                                                run.param.getValue("write_protein_sequence").toBool(), ids.proteins, ids.peptides);
+      if (result == TOPPBase::ILLEGAL_PARAMETERS) return result;
+
+      run.store.store(out, ids, run.getReaders(out));
+      return result;
+    }
+
+    /// runs the tool, mapping exceptions to exit codes as TOPPBase::main() does
+    int runTool(const ToolRun& tool_run)
+    {
+      try
+      {
+        if (tool_run.name == "NoiseFilterGaussian") return runNoiseFilter<GaussFilter>(tool_run);
+        if (tool_run.name == "NoiseFilterSGolay") return runNoiseFilter<SavitzkyGolayFilter>(tool_run);
+        if (tool_run.name == "PeakPickerHiRes") return runPeakPickerHiRes(tool_run);
+        if (tool_run.name == "FeatureFinderCentroided") return runFeatureFinderCentroided(tool_run);
+        if (tool_run.name == "ConsensusMapNormalizer") return runConsensusMapNormalizer(tool_run);
+        if (tool_run.name == "PeptideIndexer") return runPeptideIndexer(tool_run);
+      }
+      catch (Exception::BaseException& e)
+      {
+        String message;
+        TOPPBase::ExitCodes result = TOPPBase::getExitCode(e, message);
+        OPENMS_LOG_INFO << message << std::endl;
+        return result;
+      }
+
+      OPENMS_LOG_ERROR << "Tool '" << tool_run.name << "' cannot run in-process." << std::endl;
+      return TOPPBase::INTERNAL_ERROR;
+    }
+  }
+
+  bool TOPPASInProcessTools::isSupported(const String& name, const String& type, const Param& param)
+  {
+    if (!type.empty()) return false;
+    if (param.exists("processOption") && param.getValue("processOption").toString() == "lowmemory") return false;
+
+    return name == "NoiseFilterGaussian" || name == "NoiseFilterSGolay" || name == "PeakPickerHiRes" ||
+           name == "FeatureFinderCentroided" || name == "ConsensusMapNormalizer" || name == "PeptideIndexer";
+  }
+
+  int TOPPASInProcessTools::run(const String& name, const Param& param, const std::map<String, Size>& readers, TOPPASInMemoryStore& store)
+  {
+    ToolRun tool_run(name, param, readers, store);
+
+#ifdef _OPENMP
+    // the number of threads is set for this tool only (the calling thread is reused for other work)
+    int previous_threads = omp_get_max_threads();
+    if (param.exists("threads"))
+    {
+      TOPPBase::setMaxNumberOfThreads(std::max((int)param.getValue("threads"), 1));
+    }
+#endif
+
+    int result = runTool(tool_run);
+
+#ifdef _OPENMP
+    TOPPBase::setMaxNumberOfThreads(previous_threads);
+#endif
+    return result;
+  }
+
+} //namespace OpenMS
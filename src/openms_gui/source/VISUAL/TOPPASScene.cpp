@@ -36,6 +36,7 @@
 #include <OpenMS/VISUAL/TOPPASVertex.h>
 #include <OpenMS/VISUAL/TOPPASWidget.h>
 #include <OpenMS/VISUAL/TOPPASInputFileListVertex.h>
+#include <OpenMS/VISUAL/TOPPASInProcessTools.h>
 #include <OpenMS/VISUAL/TOPPASOutputFileListVertex.h>
 #include <OpenMS/VISUAL/TOPPASToolVertex.h>
 #include <OpenMS/VISUAL/TOPPASMergerVertex.h>
@@ -57,7 +58,9 @@
 #include <QtCore/QDir>
 #include <QtCore/QSet>
 #include <QtCore/QTextStream>
+#include <QtConcurrent/QtConcurrent>
 #include <QtWidgets/QMessageBox>
+#include <algorithm>
 
 namespace OpenMS
 {
@@ -70,6 +73,43 @@ namespace OpenMS
     emit finished(0, QProcess::NormalExit);
   }
 
+  InProcessTool::InProcessTool(const String& name, const Param& param, const std::map<String, Size>& readers, TOPPASInMemoryStore& store, QThreadPool& pool) :
+    QProcess(),
+    name_(name),
+    param_(param),
+    readers_(readers),
+    store_(store),
+    pool_(pool),
+    watcher_(),
+    canceled_(false)
+  {
+    connect(&watcher_, SIGNAL(finished()), this, SLOT(runFinished_()));
+  }
+
+  void InProcessTool::start(const QString& /*program*/, const QStringList& /*arguments*/, OpenMode /*mode = ReadWrite*/)
+  {
+    // the thread works on copies (this object may be deleted before the tool finishes)
+    String name = name_;
+    Param param = param_;
+    std::map<String, Size> readers = readers_;
+    TOPPASInMemoryStore* store = &store_;
+    watcher_.setFuture(QtConcurrent::run(&pool_, [name, param, readers, store]()
+    {
+      return TOPPASInProcessTools::run(name, param, readers, *store);
+    }));
+  }
+
+  void InProcessTool::cancel()
+  {
+    canceled_ = true;
+  }
+
+  void InProcessTool::runFinished_()
+  {
+    // do not touch members after this point: receivers may delete this object
+    emit finished(watcher_.result(), canceled_ ? QProcess::CrashExit : QProcess::NormalExit);
+  }
+
   TOPPASScene::TOPPASScene(QObject* parent, const QString& tmp_path, bool gui) :
     QGraphicsScene(parent),
     action_mode_(AM_NEW_EDGE),
@@ -88,6 +128,12 @@ namespace OpenMS
     clipboard_(nullptr),
     dry_run_(true),
     threads_active_(0),
+    memory_active_(0.0),
+    memory_limit_mb_(0.0),
+    running_processes_(),
+    in_memory_(false),
+    in_memory_store_(),
+    in_process_pool_(),
     allowed_threads_(1),
     resume_source_(nullptr)
   {
@@ -609,6 +655,30 @@ namespace OpenMS
     return false;
   }
 
+  void TOPPASScene::updateCriticalPathLengths_()
+  {
+    // visit the vertices in reverse topological order, so the path lengths of all successors
+    // are known when a vertex is processed (linear in the size of the graph)
+    std::vector<TOPPASVertex*> order(vertices_.begin(), vertices_.end());
+    std::sort(order.begin(), order.end(), [](TOPPASVertex* a, TOPPASVertex* b) { return a->getTopoNr() > b->getTopoNr(); });
+
+    std::map<TOPPASVertex*, int> path_length; // number of tool vertices on the longest path starting at a vertex
+    for (TOPPASVertex* tv : order)
+    {
+      int longest = 0;
+      for (TOPPASVertex::ConstEdgeIterator it = tv->outEdgesBegin(); it != tv->outEdgesEnd(); ++it)
+      {
+        longest = std::max(longest, path_length[(*it)->getTargetVertex()]);
+      }
+      TOPPASToolVertex* ttv = qobject_cast<TOPPASToolVertex*>(tv);
+      path_length[tv] = longest + (ttv ? 1 : 0); // merger/splitter nodes etc. do not count
+      if (ttv)
+      {
+        ttv->setCriticalPathLength(path_length[tv]);
+      }
+    }
+  }
+
   void TOPPASScene::resetDownstream(TOPPASVertex* vertex)
   {
     // reset all nodes
@@ -1660,16 +1730,37 @@ namespace OpenMS
   void TOPPASScene::setPipelineRunning(bool b)
   {
     running_ = b;
-    if (!running_) // whenever we stop the pipeline and user is not looking, the icon should flash
+    if (running_)
+    {
+      updateCriticalPathLengths_(); // scheduling priorities of the tools
+    }
+    else // whenever we stop the pipeline and user is not looking, the icon should flash
     {
       resume_source_ = nullptr;
+      in_memory_store_.clear(); // intermediate data of in-process tools is not needed anymore
       QApplication::alert(nullptr); // flash Taskbar || Dock
     }
   }
 
-  void TOPPASScene::processFinished()
+  void TOPPASScene::processFinished(QProcess* p)
   {
-    --threads_active_;
+    // give back the resources reserved for this process
+    std::map<QProcess*, TOPPProcess>::iterator it = running_processes_.find(p);
+    if (it != running_processes_.end())
+    {
+      threads_active_ -= it->second.threads;
+      memory_active_ -= it->second.memory_mb;
+      running_processes_.erase(it);
+    }
+    else
+    {
+      --threads_active_;
+    }
+    if (running_processes_.empty()) // avoid drift due to rounding
+    {
+      threads_active_ = 0;
+      memory_active_ = 0.0;
+    }
     // try to run next in line
     runNextProcess();
   }
@@ -2009,14 +2100,39 @@ namespace OpenMS
 
     while (!topp_processes_queue_.empty() && threads_active_ < allowed_threads_)
     {
-      ++threads_active_; // will be decreased, once the tool finishes
-      TOPPProcess tp = topp_processes_queue_.first();
-      topp_processes_queue_.pop_front();
+      // pick the process with the longest critical path behind it (ties: first come, first served)
+      // which fits into the remaining CPU and memory budget
+      int next = -1;
+      for (int i = 0; i < topp_processes_queue_.size(); ++i)
+      {
+        const TOPPProcess& cand = topp_processes_queue_[i];
+        if (next != -1 && cand.priority <= topp_processes_queue_[next].priority) continue;
+        // a tool requesting more cores or memory than available in total can still run, but only on its own
+        int threads = std::min(std::max(cand.threads, 1), allowed_threads_);
+        double memory_mb = cand.tv ? std::max(cand.memory_mb, cand.tv->getPeakMemoryUsage()) : cand.memory_mb; // refine by what earlier rounds needed
+        bool fits_cpu = threads_active_ + threads <= allowed_threads_;
+        bool fits_memory = memory_limit_mb_ <= 0.0 || running_processes_.empty() || memory_active_ + memory_mb <= memory_limit_mb_;
+        if (fits_cpu && fits_memory) next = i;
+      }
+      if (next == -1) break; // wait for running processes to free resources
+
+      TOPPProcess tp = topp_processes_queue_.takeAt(next);
+      tp.threads = std::min(std::max(tp.threads, 1), allowed_threads_);
+      if (tp.tv) tp.memory_mb = std::max(tp.memory_mb, tp.tv->getPeakMemoryUsage());
+      threads_active_ += tp.threads; // will be decreased, once the tool finishes
+      memory_active_ += tp.memory_mb;
+      running_processes_.insert(std::make_pair(tp.proc, tp));
       FakeProcess* p = qobject_cast<FakeProcess*>(tp.proc);
+      InProcessTool* ip = qobject_cast<InProcessTool*>(tp.proc);
       if (p)
       {
         p->start(tp.command, tp.args);
       }
+      else if (ip)
+      {
+        tp.tv->emitToolStarted();
+        ip->start(tp.command, tp.args);
+      }
       else
       {
         tp.tv->emitToolStarted();
@@ -2350,6 +2466,34 @@ namespace OpenMS
       return;
 
     allowed_threads_ = num_jobs;
+    // runNextProcess() starts at most that many tools at a time
+    in_process_pool_.setMaxThreadCount(num_jobs);
+  }
+
+  void TOPPASScene::setMemoryLimit(double memory_mb)
+  {
+    memory_limit_mb_ = std::max(memory_mb, 0.0);
+  }
+
+  void TOPPASScene::setInMemory(bool in_memory, double memory_mb)
+  {
+    in_memory_ = in_memory;
+    in_memory_store_.setMemoryLimit(memory_mb);
+  }
+
+  bool TOPPASScene::isInMemory() const
+  {
+    return in_memory_;
+  }
+
+  TOPPASInMemoryStore& TOPPASScene::getInMemoryStore()
+  {
+    return in_memory_store_;
+  }
+
+  QThreadPool& TOPPASScene::getInProcessThreadPool()
+  {
+    return in_process_pool_;
   }
 
   bool TOPPASScene::isGUIMode() const
@@ -39,6 +39,7 @@
 #include <OpenMS/FORMAT/ParamXMLFile.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/VISUAL/TOPPASInputFileListVertex.h>
+#include <OpenMS/VISUAL/TOPPASInProcessTools.h>
 #include <OpenMS/VISUAL/TOPPASOutputFileListVertex.h>
 #include <OpenMS/VISUAL/TOPPASScene.h>
 #include <OpenMS/VISUAL/DIALOGS/TOPPASToolConfigDialog.h>
@@ -53,6 +54,8 @@
 
 #include <QSvgRenderer>
 
+#include <algorithm>
+
 namespace OpenMS
 {
   struct NameComponent
@@ -495,6 +498,10 @@ namespace OpenMS
     if (type_ != "")
       shared_args << "-type" << type_.toQString();
 
+    // resources needed by each round (used by the scene to schedule processes)
+    int sched_threads = param_.exists("threads") ? std::max((int)param_.getValue("threads"), 1) : 1;
+    int sched_priority = getCriticalPathLength();
+
     // get *all* input|output file parameters (regardless if edge exists)
     QVector<IOInfo> in_params, out_params;
     getInputParameters(in_params);
@@ -502,6 +509,10 @@ namespace OpenMS
 
     bool ini_round_dependent = false; // indicates if we need a new INI file for each round (usually GenericWrapper issue)
 
+    // tools with an algorithm class may run in this process and exchange their data in memory;
+    // they take all their input/output files from the INI
+    bool in_process = runsInProcess();
+
     // maximum number of filenames per TOPP parameter file-list to put on the commandline
     // If more filenames are needed, e.g. for MapAligner's -in/-out etc., they are put in the .INI file
     // to avoid exceeding the 8KB length limit of the Windows commandline
@@ -514,6 +525,8 @@ namespace OpenMS
 
       // we might need to modify input/output file parameters before storing to INI
       Param param_tmp = param_;
+      // first guess of the memory needed: size of the input files, or what previous runs of this tool needed
+      qint64 input_bytes = 0;
 
       /// INCOMING EDGES
       for (RoundPackageConstIt ite = pkg[round].begin();
@@ -532,11 +545,15 @@ namespace OpenMS
         String param_name = in_params[param_index].param_name;
 
         const QStringList& file_list = ite->second.filenames.get();
+        foreach(const QString& file, file_list)
+        {
+          input_bytes += QFileInfo(file).size();
+        }
 
         bool store_to_ini = false;
         // check for GenericWrapper input/output files and put them in INI file:
         // OR if there are a lot of input files (which might exceed the 8k length limit of cmd.exe on Windows)
-        if (param_name.hasPrefix("ETool:") || file_list.size() > MAX_FILES_CMDLINE)
+        if (param_name.hasPrefix("ETool:") || file_list.size() > MAX_FILES_CMDLINE || in_process)
         {
           store_to_ini = true;
           ini_round_dependent = true;
@@ -579,7 +596,7 @@ namespace OpenMS
         
         // check for GenericWrapper input/output files and put them in INI file:
         // OR if there are a lot of input files (which might exceed the 8k length limit of cmd.exe on Windows)
-        if (param_name.hasPrefix("ETool:") || output_files.size() > MAX_FILES_CMDLINE)
+        if (param_name.hasPrefix("ETool:") || output_files.size() > MAX_FILES_CMDLINE || in_process)
         {
           store_to_ini = true;
           ini_round_dependent = true;
@@ -619,7 +636,20 @@ namespace OpenMS
 
       // create process
       QProcess* p;
-      if (!ts->isDryRun())
+      if (in_process)
+      {
+        std::map<String, Size> readers;
+        for (EdgeIndexIt it_edge = output_files_[round].begin(); it_edge != output_files_[round].end(); ++it_edge)
+        {
+          Size param_readers = getInMemoryReaders_(it_edge->first);
+          foreach(const QString& file, it_edge->second.filenames.get())
+          {
+            readers[file] = param_readers;
+          }
+        }
+        p = new InProcessTool(name_, param_tmp, readers, ts->getInMemoryStore(), ts->getInProcessThreadPool());
+      }
+      else if (!ts->isDryRun())
       {
         p = new QProcess();
       }
@@ -630,7 +660,14 @@ namespace OpenMS
 
       p->setProcessChannelMode(QProcess::MergedChannels);
       connect(p, SIGNAL(readyReadStandardOutput()), this, SLOT(forwardTOPPOutput()));
-      connect(ts, SIGNAL(terminateCurrentPipeline()), p, SLOT(kill()));
+      if (qobject_cast<InProcessTool*>(p))
+      {
+        connect(ts, SIGNAL(terminateCurrentPipeline()), p, SLOT(cancel()));
+      }
+      else
+      {
+        connect(ts, SIGNAL(terminateCurrentPipeline()), p, SLOT(kill()));
+      }
       // let this node know that round is done
       connect(p, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(executionFinished(int, QProcess::ExitStatus)));
 
@@ -647,7 +684,8 @@ namespace OpenMS
         }
       }
       toolScheduledSlot();
-      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findSiblingTOPPExecutable(name_).toQString(), args, this));
+      double memory_mb = std::max(peak_memory_mb_, input_bytes / (1024.0 * 1024.0));
+      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findSiblingTOPPExecutable(name_).toQString(), args, this, sched_threads, memory_mb, sched_priority));
     }
 
     // run pending processes
@@ -714,13 +752,13 @@ namespace OpenMS
 
     //clean up
     QProcess* p = qobject_cast<QProcess*>(QObject::sender());
+    // release the resources of the process (the pointer is only used for lookup)
+    ts->processFinished(p);
     if (p)
     {
-      delete p;
+      p->deleteLater(); // we are called from a signal of p
     }
 
-    ts->processFinished();
-
     __DEBUG_END_METHOD__
   }
 
@@ -728,6 +766,8 @@ namespace OpenMS
   {
     // get all output names
     QStringList files = this->getFileNames();
+    // data handed to the next tool in memory has no file to inspect (and its name is never seen by the user)
+    const TOPPASInMemoryStore& in_memory = getScene_()->getInMemoryStore();
 
     std::map<String, NameComponent> name_old_to_new;
     Map<String, int> name_new_count, name_new_idx; // count occurrence (for optional counter infix)
@@ -736,6 +776,7 @@ namespace OpenMS
 
     foreach(QString file, files)
     {
+      if (in_memory.contains(file)) continue;
       QFileInfo fi(file);
       String new_suffix = FileTypes::typeToName(FileHandler::getTypeByContent(file));
       String new_prefix = String(fi.path() + "/" + fi.baseName()) + ".";
@@ -746,6 +787,7 @@ namespace OpenMS
     // for all names which occur more than once, introduce a counter  
     foreach(QString file, files)
     {
+      if (in_memory.contains(file)) continue;
       if (name_new_count[name_old_to_new[file].toString()] > 1) // candidate for counter
       {
         name_old_to_new[file].counter = ++name_new_idx[name_old_to_new[file].toString()]; // start at index 1
@@ -763,6 +805,7 @@ namespace OpenMS
         {
           // rename file and update record
           String old_filename = it->second.filenames[fi];
+          if (in_memory.contains(old_filename)) continue;
           String new_filename = name_old_to_new[it->second.filenames[fi]].toString();
           if (QFileInfo(old_filename.toQString()).canonicalFilePath() == QFileInfo(new_filename.toQString()).canonicalFilePath())
           { // source and target are identical -- no action required
@@ -1069,6 +1112,62 @@ namespace OpenMS
 
     QString out = p->readAllStandardOutput();
     emit toppOutputReady(out);
+
+#ifdef __linux__
+    // record the peak memory ('high water mark') of the running tool, later rounds are scheduled accordingly
+    QFile status(QString("/proc/%1/status").arg(p->processId()));
+    if (p->processId() > 0 && status.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+      foreach(const QString& line, QString(status.readAll()).split('\n'))
+      {
+        if (!line.startsWith("VmHWM:")) continue;
+        QStringList fields = line.simplified().split(' '); // e.g. "VmHWM: 12345 kB"
+        if (fields.size() >= 2)
+        {
+          peak_memory_mb_ = std::max(peak_memory_mb_, fields[1].toDouble() / 1024.0);
+        }
+        break;
+      }
+    }
+#endif
+  }
+
+  int TOPPASToolVertex::getCriticalPathLength() const
+  {
+    return critical_path_length_;
+  }
+
+  void TOPPASToolVertex::setCriticalPathLength(int length)
+  {
+    critical_path_length_ = length;
+  }
+
+  double TOPPASToolVertex::getPeakMemoryUsage() const
+  {
+    return peak_memory_mb_;
+  }
+
+  bool TOPPASToolVertex::runsInProcess() const
+  {
+    const TOPPASScene* ts = getScene_();
+    return ts && ts->isInMemory() && !ts->isDryRun() && TOPPASInProcessTools::isSupported(name_, type_, param_);
+  }
+
+  Size TOPPASToolVertex::getInMemoryReaders_(int param_index) const
+  {
+    // recycled output is read once per round of the downstream tool
+    if (isRecyclingEnabled()) return 0;
+
+    Size readers = 0;
+    for (ConstEdgeIterator it = outEdgesBegin(); it != outEdgesEnd(); ++it)
+    {
+      if ((*it)->getSourceOutParam() != param_index) continue;
+      // output nodes, mergers and tools running as executables need the file
+      TOPPASToolVertex* ttv = qobject_cast<TOPPASToolVertex*>((*it)->getTargetVertex());
+      if (!ttv || !ttv->runsInProcess()) return 0;
+      ++readers;
+    }
+    return readers;
   }
 
   void TOPPASToolVertex::toolStartedSlot()
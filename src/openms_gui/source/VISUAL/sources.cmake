@@ -12,6 +12,7 @@ EnhancedTabBarWidgetInterface.cpp
 EnhancedWorkspace.cpp
 GUIProgressLoggerImpl.cpp
 HistogramWidget.cpp
+IntensityPyramid.cpp
 LayerData.cpp
 ListEditor.cpp
 MetaDataBrowser.cpp
@@ -33,6 +34,8 @@ Spectrum3DWidget.cpp
 SpectrumCanvas.cpp
 SpectrumWidget.cpp
 TOPPASEdge.cpp
+TOPPASInMemoryStore.cpp
+TOPPASInProcessTools.cpp
 TOPPASInputFileListVertex.cpp
 TOPPASLogWindow.cpp
 TOPPASMergerVertex.cpp
@@ -0,0 +1,20 @@
+set(format_benchmarks_list
+  Base64_benchmark
+  MSNumpressCoder_benchmark
+  MzMLFile_benchmark
+)
+
+set(processing_benchmarks_list
+  ChromatogramExtractorAlgorithm_benchmark
+  FalseDiscoveryRate_benchmark
+  FeatureGroupingAlgorithmKD_benchmark
+  HyperScore_benchmark
+  MassTraceDetection_benchmark
+  PeakPickerHiRes_benchmark
+)
+
+### collect benchmark executables
+set(BENCHMARK_executables
+    ${format_benchmarks_list}
+    ${processing_benchmarks_list}
+)
@@ -0,0 +1,466 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+/**
+  @brief Minimal framework for the OpenMS microbenchmarks
+
+  Each benchmark executable consists of a single translation unit which
+  includes this header, generates its input data deterministically (see
+  BenchmarkRandom and the generate* functions) and registers its measurements
+  with a BenchmarkRunner:
+
+  @code
+  int main(int argc, const char** argv)
+  {
+    BenchmarkRunner runner(argc, argv, "Base64");
+    std::vector<double> data = ...;
+    String out;
+    runner.run("encode", data.size(), "values", [&]() { Base64::encode(data, Base64::BYTEORDER_LITTLEENDIAN, out); });
+    return runner.finish();
+  }
+  @endcode
+
+  Supported command line options:
+    - <tt>-repetitions \<n\></tt>: number of measured runs per benchmark (default: 5)
+    - <tt>-filter \<text\></tt>: only run benchmarks whose name contains @em text
+    - <tt>-out \<file\></tt>: write the results as JSON to @em file
+
+  For every benchmark the minimum, median and mean wall time of a run, the
+  throughput (items per second, based on the median) and the number and size
+  of heap allocations per run are reported. Allocations are counted by
+  replacing the global operator new, therefore this header must be included
+  by exactly one translation unit per executable.
+*/
+
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/CONCEPT/VersionInfo.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace OpenMS
+{
+  /// Global allocation counters, updated by the replaced operator new
+  struct BenchmarkAllocations
+  {
+    static std::atomic<Size>& count()
+    {
+      static std::atomic<Size> count_(0);
+      return count_;
+    }
+
+    static std::atomic<Size>& bytes()
+    {
+      static std::atomic<Size> bytes_(0);
+      return bytes_;
+    }
+  };
+}
+
+void* operator new(std::size_t size)
+{
+  OpenMS::BenchmarkAllocations::count().fetch_add(1, std::memory_order_relaxed);
+  OpenMS::BenchmarkAllocations::bytes().fetch_add(size, std::memory_order_relaxed);
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace OpenMS
+{
+  /**
+    @brief Platform independent, seeded random numbers for synthetic benchmark data
+
+    Only the raw output of std::mt19937 is used (which is fully specified by
+    the standard); the conversion to floating point numbers is done here since
+    the standard distributions differ between library implementations.
+  */
+  class BenchmarkRandom
+  {
+public:
+    explicit BenchmarkRandom(unsigned seed) :
+      engine_(seed)
+    {
+    }
+
+    /// uniform in [min, max)
+    double uniform(double min = 0.0, double max = 1.0)
+    {
+      return min + (max - min) * (engine_() / 4294967296.0);
+    }
+
+    /// uniform integer in [min, max]
+    Size uniformInt(Size min, Size max)
+    {
+      return min + Size(uniform() * (max - min + 1));
+    }
+
+    /// normal distribution (Box-Muller transform)
+    double normal(double mean = 0.0, double stdev = 1.0)
+    {
+      double u1 = uniform(), u2 = uniform();
+      if (u1 < 1e-300) u1 = 1e-300;
+      return mean + stdev * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * Constants::PI * u2);
+    }
+
+private:
+    std::mt19937 engine_;
+  };
+
+  /**
+    @brief Generates a profile spectrum consisting of Gaussian peaks
+
+    @param rng Random number source
+    @param peaks Number of peaks
+    @param mz_min Smallest peak position
+    @param mz_max Largest peak position
+    @param points_per_peak Number of raw data points per peak
+  */
+  inline MSSpectrum generateProfileSpectrum(BenchmarkRandom& rng, Size peaks, double mz_min = 400.0, double mz_max = 1600.0, Size points_per_peak = 15)
+  {
+    MSSpectrum spectrum;
+    spectrum.reserve(peaks * points_per_peak);
+    std::vector<double> centers(peaks);
+    for (Size i = 0; i < peaks; ++i) centers[i] = rng.uniform(mz_min, mz_max);
+    std::sort(centers.begin(), centers.end());
+    for (Size i = 0; i < peaks; ++i)
+    {
+      // resolution of about 60000 at m/z 400
+      double sigma = centers[i] / 60000.0 / 2.3548 * std::sqrt(centers[i] / 400.0);
+      double spacing = 6.0 * sigma / points_per_peak;
+      double height = rng.uniform(1e3, 1e6);
+      for (Size k = 0; k < points_per_peak; ++k)
+      {
+        double mz = centers[i] + (double(k) - points_per_peak / 2.0) * spacing;
+        double d = (mz - centers[i]) / sigma;
+        spectrum.push_back(Peak1D(mz, height * std::exp(-0.5 * d * d)));
+      }
+    }
+    spectrum.sortByPosition();
+    spectrum.setType(SpectrumSettings::PROFILE);
+    spectrum.setMSLevel(1);
+    return spectrum;
+  }
+
+  /// Generates an MS1 experiment of profile spectra (see generateProfileSpectrum())
+  inline PeakMap generateProfileExperiment(unsigned seed, Size spectra, Size peaks_per_spectrum)
+  {
+    BenchmarkRandom rng(seed);
+    PeakMap exp;
+    for (Size i = 0; i < spectra; ++i)
+    {
+      MSSpectrum spectrum = generateProfileSpectrum(rng, peaks_per_spectrum);
+      spectrum.setRT(double(i));
+      spectrum.setNativeID("scan=" + String(i + 1));
+      exp.addSpectrum(spectrum);
+    }
+    exp.updateRanges();
+    return exp;
+  }
+
+  /**
+    @brief Generates a centroided LC-MS map containing isotope traces of
+    compounds with Gaussian elution profiles plus uniform noise peaks
+
+    @param seed Random seed
+    @param spectra Number of MS1 spectra (one per second)
+    @param compounds Number of compounds (each contributing three isotope traces)
+    @param noise_peaks Number of noise peaks per spectrum
+  */
+  inline PeakMap generateCentroidedExperiment(unsigned seed, Size spectra, Size compounds, Size noise_peaks)
+  {
+    BenchmarkRandom rng(seed);
+    struct Compound { double mz, rt, width, height; Int charge; };
+    std::vector<Compound> cmp(compounds);
+    for (Size i = 0; i < compounds; ++i)
+    {
+      cmp[i].mz = rng.uniform(400.0, 1200.0);
+      cmp[i].rt = rng.uniform(0.0, double(spectra));
+      cmp[i].width = rng.uniform(3.0, 10.0);
+      cmp[i].height = rng.uniform(1e4, 1e7);
+      cmp[i].charge = Int(rng.uniformInt(1, 3));
+    }
+
+    PeakMap exp;
+    for (Size s = 0; s < spectra; ++s)
+    {
+      MSSpectrum spectrum;
+      spectrum.setRT(double(s));
+      spectrum.setMSLevel(1);
+      spectrum.setType(SpectrumSettings::CENTROID);
+      spectrum.setNativeID("scan=" + String(s + 1));
+      for (Size i = 0; i < compounds; ++i)
+      {
+        double d = (double(s) - cmp[i].rt) / cmp[i].width;
+        if (std::fabs(d) > 3.0) continue;
+        double elution = cmp[i].height * std::exp(-0.5 * d * d);
+        for (Size iso = 0; iso < 3; ++iso)
+        {
+          double mz = cmp[i].mz + iso * Constants::C13C12_MASSDIFF_U / cmp[i].charge;
+          spectrum.push_back(Peak1D(mz + rng.normal(0.0, mz * 2e-6), elution / (iso + 1.0)));
+        }
+      }
+      for (Size i = 0; i < noise_peaks; ++i)
+      {
+        spectrum.push_back(Peak1D(rng.uniform(400.0, 1200.0), rng.uniform(100.0, 1000.0)));
+      }
+      spectrum.sortByPosition();
+      exp.addSpectrum(spectrum);
+    }
+    exp.updateRanges();
+    return exp;
+  }
+
+  /**
+    @brief Generates feature maps of the same compounds with per-map RT shifts,
+    m/z errors and some missing features
+
+    @param seed Random seed
+    @param maps Number of feature maps
+    @param features Number of compounds (features per map)
+  */
+  inline std::vector<FeatureMap> generateFeatureMaps(unsigned seed, Size maps, Size features)
+  {
+    BenchmarkRandom rng(seed);
+    std::vector<double> mz(features), rt(features), intensity(features);
+    std::vector<Int> charge(features);
+    for (Size i = 0; i < features; ++i)
+    {
+      mz[i] = rng.uniform(400.0, 1200.0);
+      rt[i] = rng.uniform(0.0, 3600.0);
+      intensity[i] = rng.uniform(1e4, 1e7);
+      charge[i] = Int(rng.uniformInt(1, 4));
+    }
+
+    std::vector<FeatureMap> result(maps);
+    for (Size m = 0; m < maps; ++m)
+    {
+      double shift = rng.normal(0.0, 10.0);
+      for (Size i = 0; i < features; ++i)
+      {
+        if (rng.uniform() < 0.1) continue; // feature not detected in this map
+        Feature f;
+        f.setMZ(mz[i] + rng.normal(0.0, mz[i] * 3e-6));
+        f.setRT(rt[i] + shift + rng.normal(0.0, 2.0));
+        f.setIntensity(intensity[i] * rng.uniform(0.5, 2.0));
+        f.setCharge(charge[i]);
+        f.setOverallQuality(1.0);
+        f.setUniqueId(UInt64(m) * features + i + 1);
+        result[m].push_back(f);
+      }
+      result[m].setUniqueId(m + 1);
+      result[m].updateRanges();
+    }
+    return result;
+  }
+
+  /**
+    @brief Generates target and decoy peptide identifications with one hit each
+
+    Target scores are drawn from a mixture of correct and incorrect matches,
+    decoy scores from the incorrect distribution only. Higher scores are better.
+  */
+  inline std::vector<PeptideIdentification> generatePeptideIdentifications(unsigned seed, Size ids)
+  {
+    BenchmarkRandom rng(seed);
+    std::vector<PeptideIdentification> result(ids);
+    for (Size i = 0; i < ids; ++i)
+    {
+      bool decoy = rng.uniform() < 0.5;
+      bool correct = !decoy && rng.uniform() < 0.6;
+      PeptideHit hit;
+      hit.setScore(correct ? rng.normal(50.0, 10.0) : rng.normal(20.0, 8.0));
+      hit.setSequence(AASequence::fromString("PEPTIDEK"));
+      hit.setMetaValue("target_decoy", decoy ? "decoy" : "target");
+      result[i].setScoreType("score");
+      result[i].setHigherScoreBetter(true);
+      result[i].setRT(double(i));
+      result[i].setMZ(rng.uniform(400.0, 1200.0));
+      result[i].insertHit(hit);
+    }
+    return result;
+  }
+
+  /// Runs, measures and reports benchmarks (see BenchmarkHelper.h)
+  class BenchmarkRunner
+  {
+public:
+    BenchmarkRunner(int argc, const char** argv, const String& suite) :
+      suite_(suite),
+      repetitions_(5)
+    {
+      for (int i = 1; i + 1 < argc; i += 2)
+      {
+        String option(argv[i]), value(argv[i + 1]);
+        if (option == "-repetitions") repetitions_ = std::max(1, value.toInt());
+        else if (option == "-filter") filter_ = value;
+        else if (option == "-out") out_ = value;
+        else std::cerr << "Unknown option '" << option << "' ignored." << std::endl;
+      }
+      std::cout << std::left << std::setw(40) << (suite_ + " benchmark") << std::right << std::setw(12) << "median [s]"
+                << std::setw(24) << "throughput" << std::setw(14) << "allocs/run" << std::setw(14) << "MB/run" << std::endl;
+    }
+
+    /**
+      @brief Measure @p func
+
+      @param name Name of the benchmark
+      @param items Number of items processed by one call of @p func (used for the throughput)
+      @param unit Unit of the items (e.g. "spectra", "bytes")
+      @param func The code to measure. It is called once for warm-up and then @p repetitions times.
+    */
+    void run(const String& name, Size items, const String& unit, const std::function<void()>& func)
+    {
+      if (!filter_.empty() && !name.hasSubstring(filter_)) return;
+
+      func(); // warm-up
+
+      Result r;
+      r.name = name;
+      r.items = items;
+      r.unit = unit;
+      std::vector<double> times;
+      Size alloc_count = BenchmarkAllocations::count().load();
+      Size alloc_bytes = BenchmarkAllocations::bytes().load();
+      for (Int i = 0; i < repetitions_; ++i)
+      {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        func();
+        times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+      }
+      r.allocations = double(BenchmarkAllocations::count().load() - alloc_count) / repetitions_;
+      r.allocated_bytes = double(BenchmarkAllocations::bytes().load() - alloc_bytes) / repetitions_;
+
+      std::sort(times.begin(), times.end());
+      r.min = times.front();
+      r.median = (times.size() % 2 == 1) ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2.0;
+      r.mean = 0.0;
+      for (Size i = 0; i < times.size(); ++i) r.mean += times[i];
+      r.mean /= times.size();
+      r.throughput = r.median > 0.0 ? items / r.median : 0.0;
+      results_.push_back(r);
+
+      std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << std::setprecision(4) << r.median
+                << std::setw(24) << (String(r.throughput, false) + " " + unit + "/s")
+                << std::setw(14) << Size(r.allocations) << std::setw(14) << std::setprecision(3) << r.allocated_bytes / 1048576.0 << std::endl;
+    }
+
+    /// Write the JSON report (if requested); returns the exit code for main()
+    int finish() const
+    {
+      if (out_.empty()) return EXIT_SUCCESS;
+
+      std::ofstream os(out_.c_str());
+      os << std::setprecision(9);
+      os << "{\n"
+         << "  \"suite\": \"" << suite_ << "\",\n"
+         << "  \"openms_version\": \"" << VersionInfo::getVersion() << "\",\n"
+         << "  \"repetitions\": " << repetitions_ << ",\n"
+         << "  \"benchmarks\": [";
+      for (Size i = 0; i < results_.size(); ++i)
+      {
+        const Result& r = results_[i];
+        os << (i == 0 ? "\n" : ",\n")
+           << "    {\"name\": \"" << r.name << "\", \"items\": " << r.items << ", \"unit\": \"" << r.unit << "\", "
+           << "\"min_s\": " << r.min << ", \"median_s\": " << r.median << ", \"mean_s\": " << r.mean << ", "
+           << "\"throughput_per_s\": " << r.throughput << ", "
+           << "\"allocations_per_run\": " << r.allocations << ", \"allocated_bytes_per_run\": " << r.allocated_bytes << "}";
+      }
+      os << "\n  ]\n}\n";
+      if (!os)
+      {
+        std::cerr << "Error: could not write benchmark results to '" << out_ << "'." << std::endl;
+        return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+    }
+
+private:
+    struct Result
+    {
+      String name;
+      Size items;
+      String unit;
+      double min, median, mean, throughput, allocations, allocated_bytes;
+    };
+
+    String suite_;
+    String filter_;
+    String out_;
+    Int repetitions_;
+    std::vector<Result> results_;
+  };
+}
@@ -0,0 +1,94 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkHelper.h"
+
+#include <OpenMS/FORMAT/Base64.h>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  BenchmarkRunner runner(argc, argv, "Base64");
+
+  PeakMap exp = generateProfileExperiment(42, 20, 3000);
+  std::vector<double> mz;
+  std::vector<float> intensity;
+  for (const MSSpectrum& spectrum : exp)
+  {
+    for (const Peak1D& p : spectrum)
+    {
+      mz.push_back(p.getMZ());
+      intensity.push_back(p.getIntensity());
+    }
+  }
+
+  String mz_encoded, mz_compressed, int_encoded;
+  Base64::encode(mz, Base64::BYTEORDER_LITTLEENDIAN, mz_encoded);
+  Base64::encode(mz, Base64::BYTEORDER_LITTLEENDIAN, mz_compressed, true);
+  Base64::encode(intensity, Base64::BYTEORDER_LITTLEENDIAN, int_encoded);
+
+  runner.run("encode_64bit", mz.size(), "values", [&]()
+  {
+    String out;
+    Base64::encode(mz, Base64::BYTEORDER_LITTLEENDIAN, out);
+  });
+  runner.run("encode_32bit", intensity.size(), "values", [&]()
+  {
+    String out;
+    Base64::encode(intensity, Base64::BYTEORDER_LITTLEENDIAN, out);
+  });
+  runner.run("encode_64bit_zlib", mz.size(), "values", [&]()
+  {
+    String out;
+    Base64::encode(mz, Base64::BYTEORDER_LITTLEENDIAN, out, true);
+  });
+  runner.run("decode_64bit", mz.size(), "values", [&]()
+  {
+    std::vector<double> out;
+    Base64::decode(mz_encoded, Base64::BYTEORDER_LITTLEENDIAN, out);
+  });
+  runner.run("decode_32bit", intensity.size(), "values", [&]()
+  {
+    std::vector<float> out;
+    Base64::decode(int_encoded, Base64::BYTEORDER_LITTLEENDIAN, out);
+  });
+  runner.run("decode_64bit_zlib", mz.size(), "values", [&]()
+  {
+    std::vector<double> out;
+    Base64::decode(mz_compressed, Base64::BYTEORDER_LITTLEENDIAN, out, true);
+  });
+
+  return runner.finish();
+}
@@ -0,0 +1,89 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkHelper.h"
+
+#include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  BenchmarkRunner runner(argc, argv, "ChromatogramExtractorAlgorithm");
+
+  boost::shared_ptr<PeakMap> exp(new PeakMap(generateCentroidedExperiment(42, 2000, 2000, 1000)));
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  // extraction coordinates for random transitions, sorted by m/z as required
+  BenchmarkRandom rng(7);
+  std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates> coordinates(5000);
+  for (Size i = 0; i < coordinates.size(); ++i)
+  {
+    coordinates[i].mz = rng.uniform(400.0, 1200.0);
+    coordinates[i].rt_start = -1;
+    coordinates[i].rt_end = -2; // whole chromatogram
+    coordinates[i].id = "tr" + String(i);
+  }
+  std::sort(coordinates.begin(), coordinates.end(), ChromatogramExtractorAlgorithm::ExtractionCoordinates::SortExtractionCoordinatesByMZ);
+
+  std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates> rt_coordinates = coordinates;
+  for (Size i = 0; i < rt_coordinates.size(); ++i)
+  {
+    rt_coordinates[i].rt_start = rng.uniform(0.0, 1800.0);
+    rt_coordinates[i].rt_end = rt_coordinates[i].rt_start + 200.0;
+  }
+
+  ChromatogramExtractorAlgorithm extractor;
+  runner.run("extract_full_rt_Th", exp->size(), "spectra", [&]()
+  {
+    std::vector<OpenSwath::ChromatogramPtr> output;
+    for (Size i = 0; i < coordinates.size(); ++i) output.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    extractor.extractChromatograms(expptr, output, coordinates, 0.05, false, -1, "tophat");
+  });
+  runner.run("extract_full_rt_ppm", exp->size(), "spectra", [&]()
+  {
+    std::vector<OpenSwath::ChromatogramPtr> output;
+    for (Size i = 0; i < coordinates.size(); ++i) output.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    extractor.extractChromatograms(expptr, output, coordinates, 20.0, true, -1, "tophat");
+  });
+  runner.run("extract_rt_window", exp->size(), "spectra", [&]()
+  {
+    std::vector<OpenSwath::ChromatogramPtr> output;
+    for (Size i = 0; i < rt_coordinates.size(); ++i) output.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    extractor.extractChromatograms(expptr, output, rt_coordinates, 0.05, false, -1, "tophat");
+  });
+
+  return runner.finish();
+}
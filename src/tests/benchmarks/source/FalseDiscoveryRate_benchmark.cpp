@@ -0,0 +1,68 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkHelper.h"
+
+#include <OpenMS/ANALYSIS/ID/FalseDiscoveryRate.h>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  BenchmarkRunner runner(argc, argv, "FalseDiscoveryRate");
+
+  std::vector<PeptideIdentification> ids = generatePeptideIdentifications(42, 200000);
+
+  // apply() replaces the scores, so each run works on a copy (included in the measured time)
+  FalseDiscoveryRate fdr;
+  runner.run("apply", ids.size(), "PSMs", [&]()
+  {
+    std::vector<PeptideIdentification> copy = ids;
+    fdr.apply(copy);
+  });
+
+  runner.run("copy_only", ids.size(), "PSMs", [&]()
+  {
+    std::vector<PeptideIdentification> copy = ids;
+  });
+
+  FalseDiscoveryRate fdr_basic;
+  runner.run("applyBasic", ids.size(), "PSMs", [&]()
+  {
+    std::vector<PeptideIdentification> copy = ids;
+    fdr_basic.applyBasic(copy);
+  });
+
+  return runner.finish();
+}
@@ -0,0 +1,98 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkHelper.h"
+
+#include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  BenchmarkRunner runner(argc, argv, "HyperScore");
+
+  // random tryptic peptides and their annotated theoretical spectra
+  BenchmarkRandom rng(42);
+  const String residues = "ACDEFGHILMNPQSTVWY";
+  TheoreticalSpectrumGenerator tsg;
+  Param p = tsg.getParameters();
+  p.setValue("add_metainfo", "true");
+  tsg.setParameters(p);
+
+  std::vector<PeakSpectrum> theo_spectra, exp_spectra;
+  for (Size i = 0; i < 2000; ++i)
+  {
+    String seq;
+    Size length = rng.uniformInt(7, 25);
+    for (Size k = 0; k + 1 < length; ++k) seq += residues[rng.uniformInt(0, residues.size() - 1)];
+    seq += (rng.uniform() < 0.5) ? "K" : "R";
+
+    PeakSpectrum theo;
+    tsg.getSpectrum(theo, AASequence::fromString(seq), 1, 2);
+    theo_spectra.push_back(theo);
+
+    // experimental spectrum: a subset of the fragments with mass errors and noise peaks
+    PeakSpectrum exp;
+    for (const Peak1D& peak : theo)
+    {
+      if (rng.uniform() < 0.6) exp.push_back(Peak1D(peak.getMZ() + rng.normal(0.0, 0.005), rng.uniform(10.0, 1000.0)));
+    }
+    for (Size k = 0; k < 100; ++k) exp.push_back(Peak1D(rng.uniform(100.0, 2000.0), rng.uniform(1.0, 100.0)));
+    exp.sortByPosition();
+    exp_spectra.push_back(exp);
+  }
+
+  runner.run("compute_Da", theo_spectra.size(), "PSMs", [&]()
+  {
+    double sum = 0.0;
+    for (Size i = 0; i < theo_spectra.size(); ++i)
+    {
+      sum += HyperScore::compute(0.02, false, exp_spectra[i], theo_spectra[i]);
+    }
+    if (sum < 0.0) std::cout << sum << std::endl; // keep the result alive
+  });
+  runner.run("compute_ppm", theo_spectra.size(), "PSMs", [&]()
+  {
+    double sum = 0.0;
+    for (Size i = 0; i < theo_spectra.size(); ++i)
+    {
+      sum += HyperScore::compute(10.0, true, exp_spectra[i], theo_spectra[i]);
+    }
+    if (sum < 0.0) std::cout << sum << std::endl;
+  });
+
+  return runner.finish();
+}
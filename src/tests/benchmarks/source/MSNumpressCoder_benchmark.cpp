@@ -0,0 +1,104 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkHelper.h"
+
+#include <OpenMS/FORMAT/MSNumpressCoder.h>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  BenchmarkRunner runner(argc, argv, "MSNumpressCoder");
+
+  PeakMap exp = generateProfileExperiment(42, 20, 3000);
+  std::vector<double> mz, intensity;
+  for (const MSSpectrum& spectrum : exp)
+  {
+    for (const Peak1D& p : spectrum)
+    {
+      mz.push_back(p.getMZ());
+      intensity.push_back(p.getIntensity());
+    }
+  }
+
+  MSNumpressCoder coder;
+  MSNumpressCoder::NumpressConfig linear, slof, pic;
+  linear.setCompression("linear");
+  slof.setCompression("slof");
+  pic.setCompression("pic");
+
+  String mz_linear, int_slof, int_pic;
+  coder.encodeNP(mz, mz_linear, false, linear);
+  coder.encodeNP(intensity, int_slof, false, slof);
+  coder.encodeNP(intensity, int_pic, false, pic);
+
+  runner.run("encode_linear", mz.size(), "values", [&]()
+  {
+    String out;
+    coder.encodeNP(mz, out, false, linear);
+  });
+  runner.run("encode_linear_zlib", mz.size(), "values", [&]()
+  {
+    String out;
+    coder.encodeNP(mz, out, true, linear);
+  });
+  runner.run("encode_slof", intensity.size(), "values", [&]()
+  {
+    String out;
+    coder.encodeNP(intensity, out, false, slof);
+  });
+  runner.run("encode_pic", intensity.size(), "values", [&]()
+  {
+    String out;
+    coder.encodeNP(intensity, out, false, pic);
+  });
+  runner.run("decode_linear", mz.size(), "values", [&]()
+  {
+    std::vector<double> out;
+    coder.decodeNP(mz_linear, out, false, linear);
+  });
+  runner.run("decode_slof", intensity.size(), "values", [&]()
+  {
+    std::vector<double> out;
+    coder.decodeNP(int_slof, out, false, slof);
+  });
+  runner.run("decode_pic", intensity.size(), "values", [&]()
+  {
+    std::vector<double> out;
+    coder.decodeNP(int_pic, out, false, pic);
+  });
+
+  return runner.finish();
+}
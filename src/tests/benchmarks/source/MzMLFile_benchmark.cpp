@@ -0,0 +1,104 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkHelper.h"
+
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/SYSTEM/File.h>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  BenchmarkRunner runner(argc, argv, "MzMLFile");
+
+  PeakMap exp = generateProfileExperiment(42, 200, 500);
+  Size spectra = exp.size();
+
+  String filename = File::getTemporaryFile();
+
+  MzMLFile plain;
+  MzMLFile compressed;
+  compressed.getOptions().setCompression(true);
+  MzMLFile numpress;
+  MSNumpressCoder::NumpressConfig np_mz, np_int;
+  np_mz.setCompression("linear");
+  np_int.setCompression("slof");
+  numpress.getOptions().setNumpressConfigurationMassTime(np_mz);
+  numpress.getOptions().setNumpressConfigurationIntensity(np_int);
+
+  std::string buffer_plain, buffer_compressed, buffer_numpress;
+  plain.storeBuffer(buffer_plain, exp);
+  compressed.storeBuffer(buffer_compressed, exp);
+  numpress.storeBuffer(buffer_numpress, exp);
+
+  runner.run("store", spectra, "spectra", [&]() { plain.store(filename, exp); });
+  runner.run("load", spectra, "spectra", [&]()
+  {
+    PeakMap in;
+    plain.load(filename, in);
+  });
+  runner.run("storeBuffer", spectra, "spectra", [&]()
+  {
+    std::string out;
+    plain.storeBuffer(out, exp);
+  });
+  runner.run("storeBuffer_zlib", spectra, "spectra", [&]()
+  {
+    std::string out;
+    compressed.storeBuffer(out, exp);
+  });
+  runner.run("storeBuffer_numpress", spectra, "spectra", [&]()
+  {
+    std::string out;
+    numpress.storeBuffer(out, exp);
+  });
+  runner.run("loadBuffer", spectra, "spectra", [&]()
+  {
+    PeakMap in;
+    plain.loadBuffer(buffer_plain, in);
+  });
+  runner.run("loadBuffer_zlib", spectra, "spectra", [&]()
+  {
+    PeakMap in;
+    plain.loadBuffer(buffer_compressed, in);
+  });
+  runner.run("loadBuffer_numpress", spectra, "spectra", [&]()
+  {
+    PeakMap in;
+    plain.loadBuffer(buffer_numpress, in);
+  });
+
+  return runner.finish();
+}
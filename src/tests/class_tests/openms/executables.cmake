@@ -29,6 +29,7 @@ set(qc_executables_list
 
 set(datastructures_executables_list
   Adduct_test
+  AtomicSnapshot_test
   #BinaryTreeNode_test
   CalibrationData_test
   ClusteringGrid_test
@@ -126,6 +127,7 @@ set(system_executables_list
   File_test
   FileWatcher_test
   JavaInfo_test
+  Profiler_test
   StopWatch_test
   SysInfo_test
 )
@@ -135,6 +137,8 @@ set(kernel_executables_list
   BaseFeature_test
   ChromatogramPeak_test
   ChromatogramTools_test
+  CompactMSExperiment_test
+  CompactSpectrum_test
   ComparatorUtils_test
   ConsensusFeature_test
   ConsensusMap_test
@@ -257,10 +261,14 @@ set(format_executables_list
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
   MSDataChainingConsumer_test
+  MSDataCompactingConsumer_test
+  MSDataConsumerThreadPool_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
+  SpectrumAccessOpenMSCompact_test
   SpectrumAccessQuadMZTransforming_test
   SpectrumAccessSqMass_test
+  SwathMapPrefetcher_test
   SiriusFragmentAnnotation_test
 )
 
@@ -381,7 +389,9 @@ set(comparison_executables_list
 set(chemistry_executables_list
   AAIndex_test
   AASequence_test
+  AASequenceCache_test
   CoarseIsotopeDistribution_test
+  CoarseIsotopePatternTable_test
   CrossLinksDB_test
   DigestionEnzymeProtein_test
   ElementDB_test
@@ -532,6 +542,7 @@ set(analysis_executables_list
   PrecursorIonSelectionPreprocessing_test
   PrecursorIonSelection_test
   PrecursorPurity_test
+  ProteinIndex_test
   ProtonDistributionModel_test
   ProteinResolver_test
   PSLPFormulation_test
@@ -560,6 +571,7 @@ set(applications_executables_list
   INIUpdater_test
   #MapAlignerBase_test
   TOPPBase_test
+  TOPPToolCores_test
   ToolHandler_test
   ParameterInformation_test
   ConsoleUtils_test
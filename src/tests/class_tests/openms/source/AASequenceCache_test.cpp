@@ -0,0 +1,194 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/AASequenceCache.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AASequenceCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+AASequenceCache* ptr = nullptr;
+AASequenceCache* nullPointer = nullptr;
+START_SECTION(explicit AASequenceCache(Size max_entries = 100000))
+{
+  ptr = new AASequenceCache();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getMaxSize(), 100000)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(~AASequenceCache())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(AASequence parse(const String& s, bool permissive = true))
+{
+  AASequenceCache cache;
+  AASequence seq = cache.parse("PEPTM(Oxidation)IDEK");
+  TEST_EQUAL(seq, AASequence::fromString("PEPTM(Oxidation)IDEK"))
+  TEST_EQUAL(cache.size(), 1)
+  TEST_EQUAL(cache.getMisses(), 1)
+  TEST_EQUAL(cache.getHits(), 0)
+
+  // second call is answered from the cache
+  AASequence seq2 = cache.parse("PEPTM(Oxidation)IDEK");
+  TEST_EQUAL(seq2, seq)
+  TEST_EQUAL(seq2.toString(), "PEPTM(Oxidation)IDEK")
+  TEST_EQUAL(cache.size(), 1)
+  TEST_EQUAL(cache.getHits(), 1)
+
+  // copies are independent of the cached sequence
+  seq2.setModification(3, "Phospho");
+  TEST_EQUAL(cache.parse("PEPTM(Oxidation)IDEK").toString(), "PEPTM(Oxidation)IDEK")
+
+  // permissive and strict parsing are cached separately
+  TEST_EQUAL(cache.parse("PEP*TIDE").toString(), "PEPXTIDE")
+  TEST_EXCEPTION(Exception::ParseError, cache.parse("PEP*TIDE", false))
+
+  // invalid sequences are not cached
+  Size size = cache.size();
+  TEST_EXCEPTION(Exception::InvalidValue, cache.parse("PEPTIDE(UnknownModification)"))
+  TEST_EQUAL(cache.size(), size)
+
+  // disabled cache
+  AASequenceCache disabled(0);
+  TEST_EQUAL(disabled.parse("PEPTIDE").toString(), "PEPTIDE")
+  TEST_EQUAL(disabled.size(), 0)
+}
+END_SECTION
+
+START_SECTION(void parse(const std::vector<String>& s, std::vector<AASequence>& aas, bool permissive = true))
+{
+  AASequenceCache cache;
+  vector<String> seqs = ListUtils::create<String>("PEPTIDE,PEPTIDEK,PEPTIDE,.(Acetyl)PEPTIDER.,PEPTIDEK");
+  vector<AASequence> aas;
+  cache.parse(seqs, aas);
+  TEST_EQUAL(aas.size(), 5)
+  TEST_EQUAL(aas[0].toString(), "PEPTIDE")
+  TEST_EQUAL(aas[1].toString(), "PEPTIDEK")
+  TEST_EQUAL(aas[2].toString(), "PEPTIDE")
+  TEST_EQUAL(aas[3].toString(), ".(Acetyl)PEPTIDER")
+  TEST_EQUAL(aas[4].toString(), "PEPTIDEK")
+  TEST_EQUAL(cache.getMisses(), 3)
+
+  // distinct strings are parsed once, even without caching
+  AASequenceCache disabled(0);
+  disabled.parse(seqs, aas);
+  TEST_EQUAL(aas.size(), 5)
+  TEST_EQUAL(aas[4].toString(), "PEPTIDEK")
+}
+END_SECTION
+
+START_SECTION(Size getMaxSize() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(void setMaxSize(Size max_entries))
+{
+  // the number of cached sequences is bounded
+  AASequenceCache cache(64);
+  String aa = "ACDEFGHIKLMNPQRSTVWY";
+  for (Size i = 0; i < 20; ++i)
+  {
+    for (Size j = 0; j < 20; ++j)
+    {
+      cache.parse(String("PEPTIDE") + aa[i] + aa[j]);
+    }
+  }
+  TEST_EQUAL(cache.size() <= 64, true)
+  TEST_EQUAL(cache.getMisses(), 400)
+
+  cache.setMaxSize(1000);
+  TEST_EQUAL(cache.getMaxSize(), 1000)
+  TEST_EQUAL(cache.size(), 0)
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  AASequenceCache cache;
+  cache.parse("PEPTIDE");
+  TEST_EQUAL(cache.size(), 1)
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+}
+END_SECTION
+
+START_SECTION(Size getHits() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size getMisses() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION([EXTRA] AASequence::setParseCacheSize(Size max_entries))
+{
+  TEST_EQUAL(AASequence::getParseCacheSize(), 0)
+  AASequence::setParseCacheSize(1000);
+  TEST_EQUAL(AASequence::getParseCacheSize(), 1000)
+  TEST_EQUAL(AASequence::fromString("PEPTM(Oxidation)IDEK").toString(), "PEPTM(Oxidation)IDEK")
+  TEST_EQUAL(AASequence::fromString("PEPTM(Oxidation)IDEK").toString(), "PEPTM(Oxidation)IDEK")
+  AASequence::setParseCacheSize(0);
+  TEST_EQUAL(AASequence::getParseCacheSize(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
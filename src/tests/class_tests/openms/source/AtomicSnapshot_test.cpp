@@ -0,0 +1,154 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/DATASTRUCTURES/AtomicSnapshot.h>
+///////////////////////////
+
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <map>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AtomicSnapshot, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+typedef map<String, int> Table;
+typedef AtomicSnapshot<Table> TableSnapshot;
+
+TableSnapshot* ptr = nullptr;
+TableSnapshot* nullPointer = nullptr;
+START_SECTION(AtomicSnapshot())
+{
+  ptr = new TableSnapshot();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getVersion(), 0)
+  TEST_EQUAL(ptr->load() == nullptr, true)
+}
+END_SECTION
+
+START_SECTION(~AtomicSnapshot())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(explicit AtomicSnapshot(Pointer initial))
+{
+  shared_ptr<Table> table(new Table);
+  (*table)["A"] = 1;
+  TableSnapshot snapshot(table);
+  TEST_EQUAL(snapshot.getVersion(), 1)
+  TEST_EQUAL(snapshot.load()->at("A"), 1)
+}
+END_SECTION
+
+START_SECTION(Pointer load() const)
+{
+  shared_ptr<Table> table(new Table);
+  (*table)["A"] = 1;
+  TableSnapshot snapshot(table);
+  TableSnapshot::Pointer first = snapshot.load();
+  TEST_EQUAL(first.get(), table.get())
+  // repeated loads return the same (cached) snapshot
+  TEST_EQUAL(snapshot.load().get(), first.get())
+
+  // each instance has its own snapshot
+  TableSnapshot other(shared_ptr<Table>(new Table));
+  TEST_EQUAL(other.load()->size(), 0)
+  TEST_EQUAL(snapshot.load()->size(), 1)
+}
+END_SECTION
+
+START_SECTION(void publish(Pointer snapshot))
+{
+  TableSnapshot snapshot(shared_ptr<Table>(new Table));
+  TableSnapshot::Pointer old_table = snapshot.load();
+
+  // copy-on-write update
+  shared_ptr<Table> new_table(new Table(*old_table));
+  (*new_table)["B"] = 2;
+  snapshot.publish(new_table);
+  TEST_EQUAL(snapshot.getVersion(), 2)
+
+  // readers holding the old snapshot are not affected
+  TEST_EQUAL(old_table->size(), 0)
+  TEST_EQUAL(snapshot.load()->size(), 1)
+  TEST_EQUAL(snapshot.load()->at("B"), 2)
+
+  // concurrent readers always see a complete snapshot
+  Size errors = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: errors)
+#endif
+  for (SignedSize i = 0; i < 2000; ++i)
+  {
+    if (i % 100 == 0)
+    {
+#ifdef _OPENMP
+#pragma omp critical (AtomicSnapshot_test)
+#endif
+      {
+        shared_ptr<Table> t(new Table(*snapshot.load()));
+        (*t)[String(i)] = (int)i;
+        (*t)["size"] = 0;
+        (*t)["size"] = (int)t->size();
+        snapshot.publish(t);
+      }
+    }
+    TableSnapshot::Pointer t = snapshot.load();
+    if (t->count("size") && t->at("size") != (int)t->size()) ++errors;
+  }
+  TEST_EQUAL(errors, 0)
+  TEST_EQUAL(snapshot.getVersion(), 22)
+  TEST_EQUAL(snapshot.load()->size(), 22) // "B", "size" and 20 numbers
+}
+END_SECTION
+
+START_SECTION(Size getVersion() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -38,6 +38,7 @@
 ///////////////////////////
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterHierarchical.h>
 #include <OpenMS/COMPARISON/CLUSTERING/SingleLinkage.h>
+#include <OpenMS/COMPARISON/CLUSTERING/CompleteLinkage.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSharedPeakCount.h>
 #include <OpenMS/SYSTEM/File.h>
@@ -282,6 +283,111 @@ START_SECTION((void cluster(std::vector<PeakSpectrum>& data, const BinnedSpectru
 }
 END_SECTION
 
+START_SECTION((template <typename Data, typename SimilarityComparator> void clusterSparse(const std::vector< Data > &data, const SimilarityComparator &comparator, const LinkageMethod linkage, std::vector< BinaryTreeNode > &cluster_tree) const))
+{
+ vector<Size> d(6,0);
+ for (Size i = 0; i<d.size(); ++i)
+ {
+  d[i]=i;
+ }
+ ClusterHierarchical ch;
+ LowlevelComparator lc;
+ vector< BinaryTreeNode > result;
+ vector< BinaryTreeNode > tree;
+ tree.push_back(BinaryTreeNode(1,2,0.3f));
+ tree.push_back(BinaryTreeNode(3,4,0.4f));
+ tree.push_back(BinaryTreeNode(0,1,0.5f));
+ tree.push_back(BinaryTreeNode(0,3,0.6f));
+ tree.push_back(BinaryTreeNode(0,5,0.7f));
+
+ ch.clusterSparse(d, lc, ClusterHierarchical::SINGLE_LINKAGE, result);
+
+ TEST_EQUAL(tree.size(), result.size());
+ for (Size i = 0; i < tree.size(); ++i)
+ {
+   TOLERANCE_ABSOLUTE(0.0001);
+   TEST_EQUAL(tree[i].left_child, result[i].left_child);
+   TEST_EQUAL(tree[i].right_child, result[i].right_child);
+   TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
+ }
+
+ // complete linkage gives the same tree as the dense functor
+ // (not tested for average linkage, which has a tie at 0.7667 here that both may resolve differently)
+ CompleteLinkage cl;
+ DistanceMatrix<float> matrix;
+ vector< BinaryTreeNode > dense_tree;
+ ch.cluster<Size,LowlevelComparator>(d, lc, cl, dense_tree, matrix);
+ ch.clusterSparse(d, lc, ClusterHierarchical::COMPLETE_LINKAGE, result);
+ TEST_EQUAL(dense_tree.size(), result.size());
+ for (Size i = 0; i < dense_tree.size(); ++i)
+ {
+   TOLERANCE_ABSOLUTE(0.0001);
+   TEST_EQUAL(dense_tree[i].left_child, result[i].left_child);
+   TEST_EQUAL(dense_tree[i].right_child, result[i].right_child);
+   TEST_REAL_SIMILAR(dense_tree[i].distance, result[i].distance);
+ }
+
+ // pairs at or above the threshold are not stored; remaining clusters are connected by dummy nodes
+ ch.setThreshold(0.45);
+ ch.clusterSparse(d, lc, ClusterHierarchical::SINGLE_LINKAGE, result);
+ TEST_EQUAL(result.size(), 5);
+ ABORT_IF(result.size() != 5);
+ TEST_EQUAL(result[0].left_child, 1);
+ TEST_EQUAL(result[0].right_child, 2);
+ TEST_EQUAL(result[1].left_child, 3);
+ TEST_EQUAL(result[1].right_child, 4);
+ TEST_EQUAL(result[2].left_child, 0);
+ TEST_EQUAL(result[2].right_child, 1);
+ TEST_REAL_SIMILAR(result[2].distance, -1.0);
+ TEST_EQUAL(result[3].right_child, 3);
+ TEST_EQUAL(result[4].right_child, 5);
+ TEST_REAL_SIMILAR(result[4].distance, -1.0);
+}
+END_SECTION
+
+START_SECTION((void clusterSparse(const Size element_count, std::vector< SparseDistance > &distances, const LinkageMethod linkage, std::vector< BinaryTreeNode > &cluster_tree) const))
+{
+ ClusterHierarchical ch;
+ ch.setThreshold(0.5);
+ vector< BinaryTreeNode > result;
+ // two groups {0,2,3} and {1,4}; 3 is close to 0 but far from 2
+ vector<ClusterHierarchical::SparseDistance> dist;
+ dist.push_back(ClusterHierarchical::SparseDistance(0, 2, 0.1f));
+ dist.push_back(ClusterHierarchical::SparseDistance(0, 3, 0.2f));
+ dist.push_back(ClusterHierarchical::SparseDistance(4, 1, 0.3f));
+
+ ch.clusterSparse(5, dist, ClusterHierarchical::SINGLE_LINKAGE, result);
+ TEST_EQUAL(result.size(), 4);
+ ABORT_IF(result.size() != 4);
+ TEST_EQUAL(result[0].left_child, 0); TEST_EQUAL(result[0].right_child, 2); TEST_REAL_SIMILAR(result[0].distance, 0.1);
+ TEST_EQUAL(result[1].left_child, 0); TEST_EQUAL(result[1].right_child, 3); TEST_REAL_SIMILAR(result[1].distance, 0.2);
+ TEST_EQUAL(result[2].left_child, 1); TEST_EQUAL(result[2].right_child, 4); TEST_REAL_SIMILAR(result[2].distance, 0.3);
+ TEST_EQUAL(result[3].left_child, 0); TEST_EQUAL(result[3].right_child, 1); TEST_REAL_SIMILAR(result[3].distance, -1.0);
+
+ // complete linkage: d({0,2},3) is missing (>= threshold), so 3 stays alone
+ ch.clusterSparse(5, dist, ClusterHierarchical::COMPLETE_LINKAGE, result);
+ TEST_EQUAL(result.size(), 4);
+ ABORT_IF(result.size() != 4);
+ TEST_EQUAL(result[0].left_child, 0); TEST_EQUAL(result[0].right_child, 2); TEST_REAL_SIMILAR(result[0].distance, 0.1);
+ TEST_EQUAL(result[1].left_child, 1); TEST_EQUAL(result[1].right_child, 4); TEST_REAL_SIMILAR(result[1].distance, 0.3);
+ TEST_REAL_SIMILAR(result[2].distance, -1.0);
+ TEST_REAL_SIMILAR(result[3].distance, -1.0);
+
+ // average linkage: d({0,2},3) = (0.2 + 0.5) / 2 = 0.35 (missing distance capped at the threshold)
+ ch.clusterSparse(5, dist, ClusterHierarchical::AVERAGE_LINKAGE, result);
+ TEST_EQUAL(result.size(), 4);
+ ABORT_IF(result.size() != 4);
+ TEST_EQUAL(result[0].left_child, 0); TEST_EQUAL(result[0].right_child, 2); TEST_REAL_SIMILAR(result[0].distance, 0.1);
+ TEST_EQUAL(result[1].left_child, 1); TEST_EQUAL(result[1].right_child, 4); TEST_REAL_SIMILAR(result[1].distance, 0.3);
+ TEST_EQUAL(result[2].left_child, 0); TEST_EQUAL(result[2].right_child, 3); TEST_REAL_SIMILAR(result[2].distance, 0.35);
+ TEST_EQUAL(result[3].left_child, 0); TEST_EQUAL(result[3].right_child, 1); TEST_REAL_SIMILAR(result[3].distance, -1.0);
+
+ vector<ClusterHierarchical::SparseDistance> none;
+ TEST_EXCEPTION(ClusterFunctor::InsufficientInput, ch.clusterSparse(1, none, ClusterHierarchical::SINGLE_LINKAGE, result));
+ TEST_EXCEPTION(Exception::IndexOverflow, ch.clusterSparse(3, dist, ClusterHierarchical::AVERAGE_LINKAGE, result));
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,244 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternTable.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CoarseIsotopePatternTable, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CoarseIsotopePatternTable* ptr = nullptr;
+CoarseIsotopePatternTable* null_ptr = nullptr;
+START_SECTION(CoarseIsotopePatternTable(double max_mass = 10000.0, Size max_isotope = 10, double max_error = 0.0, AveragineModel model = PEPTIDE, double min_node_distance = 0.5))
+{
+  ptr = new CoarseIsotopePatternTable(2000.0, 5);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EXCEPTION(Exception::InvalidValue, CoarseIsotopePatternTable(0.0))
+  TEST_EXCEPTION(Exception::InvalidValue, CoarseIsotopePatternTable(2000.0, 0))
+  TEST_EXCEPTION(Exception::InvalidValue, CoarseIsotopePatternTable(2000.0, 5, -1.0))
+}
+END_SECTION
+
+START_SECTION(double getMinMass() const)
+{
+  TEST_EQUAL(ptr->getMinMass() > 0.0, true)
+  TEST_EQUAL(ptr->getMinMass() < 20.0, true)
+}
+END_SECTION
+
+START_SECTION(double getMaxMass() const)
+{
+  TEST_REAL_SIMILAR(ptr->getMaxMass(), 2000.0)
+}
+END_SECTION
+
+START_SECTION(Size getMaxIsotope() const)
+{
+  TEST_EQUAL(ptr->getMaxIsotope(), 5)
+}
+END_SECTION
+
+START_SECTION(double getMaxError() const)
+{
+  TEST_EQUAL(ptr->getMaxError(), 0.0)
+  CoarseIsotopePatternTable approx(2000.0, 5, 1e-3);
+  TEST_EQUAL(approx.getMaxError() <= 1e-3, true)
+}
+END_SECTION
+
+START_SECTION(Size getNumberOfNodes() const)
+{
+  // exact table: roughly one node per Dalton
+  TEST_EQUAL(ptr->getNumberOfNodes() > 1500, true)
+  // interpolated table: considerably fewer nodes
+  CoarseIsotopePatternTable approx(2000.0, 5, 1e-3);
+  TEST_EQUAL(approx.getNumberOfNodes() < ptr->getNumberOfNodes() / 2, true)
+}
+END_SECTION
+
+START_SECTION(AveragineModel getModel() const)
+{
+  TEST_EQUAL(ptr->getModel(), CoarseIsotopePatternTable::PEPTIDE)
+  CoarseIsotopePatternTable rna(500.0, 3, 0.0, CoarseIsotopePatternTable::RNA);
+  TEST_EQUAL(rna.getModel(), CoarseIsotopePatternTable::RNA)
+}
+END_SECTION
+
+START_SECTION(static const CoarseIsotopePatternTable& getDefaultTable(AveragineModel model = PEPTIDE))
+{
+  const CoarseIsotopePatternTable& table = CoarseIsotopePatternTable::getDefaultTable();
+  TEST_EQUAL(&table == &CoarseIsotopePatternTable::getDefaultTable(CoarseIsotopePatternTable::PEPTIDE), true)
+  TEST_EQUAL(table.getModel(), CoarseIsotopePatternTable::PEPTIDE)
+  TEST_EQUAL(CoarseIsotopePatternTable::getDefaultTable(CoarseIsotopePatternTable::DNA).getModel(), CoarseIsotopePatternTable::DNA)
+  TEST_EQUAL(table.isTabulated(9999.0), true)
+}
+END_SECTION
+
+START_SECTION(bool isTabulated(double average_weight) const)
+{
+  TEST_EQUAL(ptr->isTabulated(1.0), false)
+  TEST_EQUAL(ptr->isTabulated(100.0), true)
+  TEST_EQUAL(ptr->isTabulated(1999.9), true)
+  TEST_EQUAL(ptr->isTabulated(2000.1), false)
+}
+END_SECTION
+
+START_SECTION(IsotopeDistribution estimateFromWeight(double average_weight, Size max_isotope = 0) const)
+{
+  // identical to the generator (exact table)
+  for (double weight = 50.0; weight < 2000.0; weight += 47.3)
+  {
+    CoarseIsotopePatternGenerator solver(3);
+    IsotopeDistribution exact = solver.estimateFromPeptideWeight(weight);
+    IsotopeDistribution table = ptr->estimateFromWeight(weight, 3);
+    ABORT_IF(exact.size() != table.size())
+    for (Size i = 0; i < exact.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(table[i].getMZ(), exact[i].getMZ())
+      TEST_REAL_SIMILAR(table[i].getIntensity(), exact[i].getIntensity())
+    }
+  }
+
+  // all stored isotopes, small molecule with fewer possible isotopes
+  CoarseIsotopePatternGenerator solver(5);
+  TEST_EQUAL(ptr->estimateFromWeight(1000.0).size(), 5)
+  TEST_EQUAL(ptr->estimateFromWeight(15.0).size(), solver.estimateFromPeptideWeight(15.0).size())
+
+  // outside of the table: exact generator
+  CoarseIsotopePatternGenerator solver_large(8);
+  IsotopeDistribution exact = solver_large.estimateFromPeptideWeight(3000.0);
+  IsotopeDistribution table = ptr->estimateFromWeight(3000.0, 8);
+  TEST_EQUAL(table.size(), 8)
+  TEST_REAL_SIMILAR(table[0].getIntensity(), exact[0].getIntensity())
+  TEST_REAL_SIMILAR(table[7].getIntensity(), exact[7].getIntensity())
+  table = ptr->estimateFromWeight(1000.0, 8); // more isotopes than stored
+  TEST_EQUAL(table.size(), 8)
+
+  // interpolation stays within the accuracy bound
+  CoarseIsotopePatternTable approx(2000.0, 5, 1e-3);
+  double max_deviation = 0.0;
+  for (double weight = 50.0; weight < 2000.0; weight += 3.7)
+  {
+    IsotopeDistribution exact = solver.estimateFromPeptideWeight(weight);
+    IsotopeDistribution table = approx.estimateFromWeight(weight);
+    for (Size i = 0; i < exact.size(); ++i)
+    {
+      max_deviation = std::max(max_deviation, (double)std::fabs(exact[i].getIntensity() - table[i].getIntensity()));
+    }
+  }
+  TEST_EQUAL(max_deviation < 2e-3, true)
+
+  // RNA model
+  CoarseIsotopePatternTable rna(2000.0, 4, 0.0, CoarseIsotopePatternTable::RNA);
+  CoarseIsotopePatternGenerator solver_rna(4);
+  exact = solver_rna.estimateFromRNAWeight(1234.5);
+  table = rna.estimateFromWeight(1234.5);
+  TEST_EQUAL(table.size(), exact.size())
+  TEST_REAL_SIMILAR(table[1].getMZ(), exact[1].getMZ())
+  TEST_REAL_SIMILAR(table[1].getIntensity(), exact[1].getIntensity())
+}
+END_SECTION
+
+START_SECTION(void getIntensities(double average_weight, Size max_isotope, std::vector<double>& intensities) const)
+{
+  std::vector<double> intensities;
+  ptr->getIntensities(1000.0, 3, intensities);
+  CoarseIsotopePatternGenerator solver(3);
+  IsotopeDistribution exact = solver.estimateFromPeptideWeight(1000.0);
+  TEST_EQUAL(intensities.size(), 3)
+  TEST_REAL_SIMILAR(intensities[0], exact[0].getIntensity())
+  TEST_REAL_SIMILAR(intensities[1], exact[1].getIntensity())
+  TEST_REAL_SIMILAR(intensities[2], exact[2].getIntensity())
+
+  // impossible isotopes are reported as zero
+  ptr->getIntensities(15.0, 5, intensities);
+  TEST_EQUAL(intensities.size(), 5)
+  TEST_REAL_SIMILAR(intensities[4], 0.0)
+
+  // all stored isotopes, and outside of the table
+  ptr->getIntensities(1000.0, 0, intensities);
+  TEST_EQUAL(intensities.size(), 5)
+  ptr->getIntensities(5000.0, 2, intensities);
+  CoarseIsotopePatternGenerator solver_large(2);
+  exact = solver_large.estimateFromPeptideWeight(5000.0);
+  TEST_EQUAL(intensities.size(), 2)
+  TEST_REAL_SIMILAR(intensities[1], exact[1].getIntensity())
+}
+END_SECTION
+
+START_SECTION(IsotopeDistribution estimateForFragmentFromWeight(double average_weight_precursor, double average_weight_fragment, const std::set<UInt>& precursor_isotopes) const)
+{
+  std::set<UInt> precursor_isotopes;
+  precursor_isotopes.insert(0);
+  precursor_isotopes.insert(2);
+  CoarseIsotopePatternGenerator solver;
+  for (double weight = 300.0; weight < 1500.0; weight += 111.1)
+  {
+    IsotopeDistribution exact = solver.estimateForFragmentFromPeptideWeight(1800.0, weight, precursor_isotopes);
+    IsotopeDistribution table = ptr->estimateForFragmentFromWeight(1800.0, weight, precursor_isotopes);
+    ABORT_IF(exact.size() != table.size())
+    for (Size i = 0; i < exact.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(table[i].getMZ(), exact[i].getMZ())
+      TEST_REAL_SIMILAR(table[i].getIntensity(), exact[i].getIntensity())
+    }
+  }
+
+  // isolated isotopes beyond the stored ones: exact generator
+  precursor_isotopes.insert(6);
+  IsotopeDistribution exact = solver.estimateForFragmentFromPeptideWeight(1800.0, 700.0, precursor_isotopes);
+  IsotopeDistribution table = ptr->estimateForFragmentFromWeight(1800.0, 700.0, precursor_isotopes);
+  TEST_EQUAL(table.size(), exact.size())
+  TEST_REAL_SIMILAR(table[6].getIntensity(), exact[6].getIntensity())
+}
+END_SECTION
+
+delete ptr;
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
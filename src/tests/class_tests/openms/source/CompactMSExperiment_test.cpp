@@ -0,0 +1,283 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/CompactMSExperiment.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CompactMSExperiment, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeakMap exp;
+exp.setComment("experiment");
+for (Size s = 0; s < 5; ++s)
+{
+  MSSpectrum spec;
+  spec.setRT(10.0 * s);
+  spec.setMSLevel(s % 2 + 1);
+  for (Size i = 0; i < 10 * (s + 1); ++i)
+  {
+    spec.push_back(Peak1D(300.0 + i * 1.234567, 100.0f * i));
+  }
+  exp.addSpectrum(spec);
+}
+MSChromatogram chrom;
+chrom.setNativeID("chrom");
+chrom.push_back(ChromatogramPeak(1.0, 2.0));
+exp.addChromatogram(chrom);
+
+CompactMSExperiment* ptr = nullptr;
+CompactMSExperiment* null_ptr = nullptr;
+START_SECTION(CompactMSExperiment())
+{
+  ptr = new CompactMSExperiment();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getNrSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION(~CompactMSExperiment())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(void fromExperiment(PeakMap& exp))
+{
+  PeakMap tmp = exp;
+  CompactMSExperiment cexp;
+  cexp.fromExperiment(tmp);
+  TEST_EQUAL(tmp.size(), 0)
+  TEST_EQUAL(tmp.getNrChromatograms(), 1)
+  TEST_EQUAL(cexp.getNrSpectra(), 5)
+  TEST_EQUAL(cexp.getNrChromatograms(), 1)
+  TEST_EQUAL(cexp.getExperimentalSettings().getComment(), "experiment")
+}
+END_SECTION
+
+START_SECTION(void toExperiment(PeakMap& exp) const)
+{
+  PeakMap tmp = exp;
+  CompactMSExperiment cexp;
+  cexp.fromExperiment(tmp);
+  PeakMap decoded;
+  cexp.toExperiment(decoded);
+  TEST_EQUAL(decoded.size(), exp.size())
+  TEST_EQUAL(decoded.getNrChromatograms(), 1)
+  TEST_EQUAL(decoded.getComment(), "experiment")
+  TOLERANCE_ABSOLUTE(1e-6)
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    TEST_EQUAL(decoded[s].size(), exp[s].size())
+    TEST_REAL_SIMILAR(decoded[s].getRT(), exp[s].getRT())
+    TEST_EQUAL(decoded[s].getMSLevel(), exp[s].getMSLevel())
+    for (Size i = 0; i < exp[s].size(); ++i)
+    {
+      TEST_REAL_SIMILAR(decoded[s][i].getMZ(), exp[s][i].getMZ())
+      TEST_EQUAL(decoded[s][i].getIntensity(), exp[s][i].getIntensity())
+    }
+  }
+  TEST_EQUAL(decoded.getMinRT(), 0.0)
+  TEST_EQUAL(decoded.getMaxRT(), 40.0)
+}
+END_SECTION
+
+START_SECTION(MSSpectrum getSpectrum(Size id) const)
+{
+  CompactMSExperiment cexp;
+  cexp.addSpectrum(exp[3]);
+  TEST_EQUAL(cexp.getSpectrum(0).size(), 40)
+  TEST_REAL_SIMILAR(cexp.getSpectrum(0).getRT(), 30.0)
+}
+END_SECTION
+
+START_SECTION(MSSpectrum operator[](Size id) const)
+{
+  CompactMSExperiment cexp;
+  cexp.addSpectrum(exp[3]);
+  TEST_EQUAL(cexp[0].size(), 40)
+}
+END_SECTION
+
+START_SECTION(const CompactSpectrum& getCompactSpectrum(Size id) const)
+{
+  CompactMSExperiment cexp;
+  cexp.addSpectrum(exp[1]);
+  TEST_EQUAL(cexp.getCompactSpectrum(0).size(), 20)
+  TEST_EQUAL(cexp.getCompactSpectrum(0).getMSLevel(), 2)
+}
+END_SECTION
+
+START_SECTION(const MSChromatogram& getChromatogram(Size id) const)
+{
+  CompactMSExperiment cexp;
+  cexp.addChromatogram(chrom);
+  TEST_EQUAL(cexp.getChromatogram(0).getNativeID(), "chrom")
+  TEST_EQUAL(cexp.getChromatogram(0).size(), 1)
+}
+END_SECTION
+
+START_SECTION(const std::vector<CompactSpectrum>& getSpectra() const)
+{
+  CompactMSExperiment cexp;
+  cexp.addSpectrum(exp[0]);
+  TEST_EQUAL(cexp.getSpectra().size(), 1)
+}
+END_SECTION
+
+START_SECTION(const std::vector<MSChromatogram>& getChromatograms() const)
+{
+  CompactMSExperiment cexp;
+  cexp.addChromatogram(chrom);
+  TEST_EQUAL(cexp.getChromatograms().size(), 1)
+}
+END_SECTION
+
+START_SECTION(void addSpectrum(const MSSpectrum& spectrum))
+{
+  CompactMSExperiment cexp;
+  cexp.addSpectrum(exp[0]);
+  cexp.addSpectrum(exp[1]);
+  TEST_EQUAL(cexp.size(), 2)
+}
+END_SECTION
+
+START_SECTION(void addSpectrum(CompactSpectrum&& spectrum))
+{
+  CompactMSExperiment cexp;
+  cexp.addSpectrum(CompactSpectrum(exp[2]));
+  TEST_EQUAL(cexp.getSpectrum(0).size(), 30)
+}
+END_SECTION
+
+START_SECTION(void addChromatogram(const MSChromatogram& chromatogram))
+{
+  CompactMSExperiment cexp;
+  cexp.addChromatogram(chrom);
+  TEST_EQUAL(cexp.getNrChromatograms(), 1)
+  TEST_EQUAL(cexp.getNrSpectra(), 0)
+  TEST_EQUAL(cexp.empty(), false)
+}
+END_SECTION
+
+START_SECTION(void reserve(Size s_size, Size c_size))
+{
+  CompactMSExperiment cexp;
+  cexp.reserve(10, 10);
+  TEST_EQUAL(cexp.getSpectra().capacity() >= 10, true)
+  TEST_EQUAL(cexp.getChromatograms().capacity() >= 10, true)
+}
+END_SECTION
+
+START_SECTION(void setExperimentalSettings(const ExperimentalSettings& settings))
+{
+  CompactMSExperiment cexp;
+  ExperimentalSettings settings;
+  settings.setComment("settings");
+  cexp.setExperimentalSettings(settings);
+  TEST_EQUAL(cexp.getExperimentalSettings().getComment(), "settings")
+}
+END_SECTION
+
+START_SECTION(const ExperimentalSettings& getExperimentalSettings() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size getNrSpectra() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size getNrChromatograms() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size size() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(bool empty() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void clear())
+{
+  CompactMSExperiment cexp;
+  cexp.addSpectrum(exp[0]);
+  cexp.addChromatogram(chrom);
+  cexp.clear();
+  TEST_EQUAL(cexp.empty(), true)
+}
+END_SECTION
+
+START_SECTION(Size getPeakDataSize() const)
+{
+  PeakMap tmp = exp;
+  CompactMSExperiment cexp;
+  cexp.fromExperiment(tmp);
+  // 150 peaks at 8 bytes each
+  TEST_EQUAL(cexp.getPeakDataSize(), 1200)
+}
+END_SECTION
+
+START_SECTION(bool operator==(const CompactMSExperiment& rhs) const)
+{
+  CompactMSExperiment cexp1, cexp2;
+  cexp1.addSpectrum(exp[0]);
+  cexp2.addSpectrum(exp[0]);
+  TEST_EQUAL(cexp1 == cexp2, true)
+  cexp2.addChromatogram(chrom);
+  TEST_EQUAL(cexp1 == cexp2, false)
+}
+END_SECTION
+
+START_SECTION(bool operator!=(const CompactMSExperiment& rhs) const)
+{
+  CompactMSExperiment cexp1, cexp2;
+  cexp1.addSpectrum(exp[0]);
+  TEST_EQUAL(cexp1 != cexp2, true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,261 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/CompactSpectrum.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CompactSpectrum, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSSpectrum spec;
+spec.setRT(123.4);
+spec.setMSLevel(2);
+spec.setName("spec");
+spec.setNativeID("scan=42");
+spec.getPrecursors().resize(1);
+spec.getPrecursors()[0].setMZ(500.25);
+spec.getFloatDataArrays().resize(1);
+spec.getFloatDataArrays()[0].setName("ion mobility");
+for (Size i = 0; i < 100; ++i)
+{
+  Peak1D p;
+  p.setMZ(200.0 + i * 37.123456789);
+  p.setIntensity(1000.0f + i * 3.5f);
+  spec.push_back(p);
+  spec.getFloatDataArrays()[0].push_back(i * 0.5f);
+}
+
+CompactSpectrum* ptr = nullptr;
+CompactSpectrum* null_ptr = nullptr;
+START_SECTION(CompactSpectrum())
+{
+  ptr = new CompactSpectrum();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getPeakDataSize(), 0)
+  TEST_REAL_SIMILAR(ptr->getMZAccuracy(), 0.0)
+}
+END_SECTION
+
+START_SECTION(~CompactSpectrum())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(explicit CompactSpectrum(const MSSpectrum& spectrum))
+{
+  CompactSpectrum cs(spec);
+  TEST_EQUAL(cs.size(), 100)
+  TEST_EQUAL(cs.empty(), false)
+}
+END_SECTION
+
+START_SECTION(void set(const MSSpectrum& spectrum))
+{
+  CompactSpectrum cs;
+  cs.set(spec);
+  TEST_EQUAL(cs.size(), 100)
+  cs.set(MSSpectrum());
+  TEST_EQUAL(cs.size(), 0)
+}
+END_SECTION
+
+START_SECTION(double getMZ(Size index) const)
+{
+  CompactSpectrum cs(spec);
+  double max_error = 0.0;
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    max_error = std::max(max_error, std::fabs(cs.getMZ(i) - spec[i].getMZ()));
+  }
+  TEST_EQUAL(max_error <= cs.getMZAccuracy() * 1.0001, true)
+  TEST_EQUAL(max_error < 1e-6, true)
+  // extreme values are exact
+  TEST_REAL_SIMILAR(cs.getMZ(0), spec[0].getMZ())
+  TEST_REAL_SIMILAR(cs.getMZ(99), spec[99].getMZ())
+}
+END_SECTION
+
+START_SECTION(float getIntensity(Size index) const)
+{
+  CompactSpectrum cs(spec);
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_EQUAL(cs.getIntensity(i), spec[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION(double getMZAccuracy() const)
+{
+  CompactSpectrum cs(spec);
+  // range of ~3675 Th spread over 2^32 codes
+  TEST_EQUAL(cs.getMZAccuracy() > 0.0, true)
+  TEST_EQUAL(cs.getMZAccuracy() < 5e-7, true)
+
+  // single peak: exact
+  MSSpectrum single;
+  single.push_back(spec[5]);
+  CompactSpectrum cs_single(single);
+  TEST_EQUAL(cs_single.getMZ(0), spec[5].getMZ())
+}
+END_SECTION
+
+START_SECTION(Size getPeakDataSize() const)
+{
+  CompactSpectrum cs(spec);
+  TEST_EQUAL(cs.getPeakDataSize(), 800)
+  TEST_EQUAL(cs.getPeakDataSize() * 2 <= spec.size() * sizeof(Peak1D), true)
+}
+END_SECTION
+
+START_SECTION(MSSpectrum toSpectrum() const)
+{
+  CompactSpectrum cs(spec);
+  MSSpectrum decoded = cs.toSpectrum();
+  TEST_EQUAL(decoded.size(), spec.size())
+  TEST_REAL_SIMILAR(decoded.getRT(), 123.4)
+  TEST_EQUAL(decoded.getMSLevel(), 2)
+  TEST_EQUAL(decoded.getName(), "spec")
+  TEST_EQUAL(decoded.getNativeID(), "scan=42")
+  TEST_EQUAL(decoded.getPrecursors().size(), 1)
+  TEST_REAL_SIMILAR(decoded.getPrecursors()[0].getMZ(), 500.25)
+  TEST_EQUAL(decoded.getFloatDataArrays().size(), 1)
+  TEST_EQUAL(decoded.getFloatDataArrays()[0].size(), 100)
+  TEST_EQUAL(decoded.getFloatDataArrays()[0].getName(), "ion mobility")
+  TOLERANCE_ABSOLUTE(1e-6)
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(decoded[i].getMZ(), spec[i].getMZ())
+    TEST_EQUAL(decoded[i].getIntensity(), spec[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION(void get(MSSpectrum& spectrum) const)
+{
+  CompactSpectrum cs(spec);
+  MSSpectrum decoded;
+  decoded.push_back(Peak1D());
+  decoded.setComment("overwritten");
+  cs.get(decoded);
+  TEST_EQUAL(decoded.size(), 100)
+  TEST_EQUAL(decoded.getComment(), "")
+  TEST_EQUAL(decoded.getNativeID(), "scan=42")
+}
+END_SECTION
+
+START_SECTION(const MSSpectrum& getSettings() const)
+{
+  CompactSpectrum cs(spec);
+  TEST_EQUAL(cs.getSettings().size(), 0)
+  TEST_EQUAL(cs.getSettings().getNativeID(), "scan=42")
+}
+END_SECTION
+
+START_SECTION(double getRT() const)
+{
+  CompactSpectrum cs(spec);
+  TEST_REAL_SIMILAR(cs.getRT(), 123.4)
+}
+END_SECTION
+
+START_SECTION(UInt getMSLevel() const)
+{
+  CompactSpectrum cs(spec);
+  TEST_EQUAL(cs.getMSLevel(), 2)
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(bool empty() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void clear())
+{
+  CompactSpectrum cs(spec);
+  cs.clear();
+  TEST_EQUAL(cs.size(), 0)
+  TEST_EQUAL(cs.getSettings().getNativeID(), "")
+}
+END_SECTION
+
+START_SECTION(bool operator==(const CompactSpectrum& rhs) const)
+{
+  CompactSpectrum cs1(spec), cs2(spec);
+  TEST_EQUAL(cs1 == cs2, true)
+  cs2.set(MSSpectrum());
+  TEST_EQUAL(cs1 == cs2, false)
+}
+END_SECTION
+
+START_SECTION(bool operator!=(const CompactSpectrum& rhs) const)
+{
+  CompactSpectrum cs1(spec), cs2;
+  TEST_EQUAL(cs1 != cs2, true)
+}
+END_SECTION
+
+START_SECTION([EXTRA] unsorted spectra keep their peak order)
+{
+  MSSpectrum unsorted;
+  unsorted.push_back(spec[10]);
+  unsorted.push_back(spec[2]);
+  unsorted.push_back(spec[50]);
+  CompactSpectrum cs(unsorted);
+  TOLERANCE_ABSOLUTE(1e-6)
+  TEST_REAL_SIMILAR(cs.getMZ(0), spec[10].getMZ())
+  TEST_REAL_SIMILAR(cs.getMZ(1), spec[2].getMZ())
+  TEST_REAL_SIMILAR(cs.getMZ(2), spec[50].getMZ())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -40,6 +40,10 @@
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 ///////////////////////////
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -107,6 +111,92 @@ START_SECTION((void fitElutionModels(FeatureMap& features)))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] features without signal))
+{
+  FeatureMap features;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ElutionModelFitter_test.featureXML"), features);
+  ABORT_IF(features.size() != 25);
+
+  // copy of a feature with all intensities set to zero:
+  Feature empty = features[0];
+  for (vector<Feature>::iterator sub_it = empty.getSubordinates().begin();
+       sub_it != empty.getSubordinates().end(); ++sub_it)
+  {
+    ConvexHull2D::PointArrayType points = sub_it->getConvexHulls()[0].getHullPoints();
+    for (Size i = 0; i < points.size(); ++i)
+    {
+      points[i].setY(0.0);
+    }
+    sub_it->getConvexHulls()[0].setHullPoints(points);
+  }
+  features.push_back(empty);
+
+  ElutionModelFitter emf;
+  emf.fitElutionModels(features);
+  TEST_EQUAL(features.size(), 26);
+  TEST_STRING_EQUAL(features[25].getMetaValue("model_status"), "1 (invalid area)");
+  TEST_REAL_SIMILAR(features[25].getMetaValue("model_area"), 0.0);
+  TEST_REAL_SIMILAR(features[25].getMetaValue("model_error"), -1.0);
+  TEST_EQUAL(features[25].metaValueExists("model_Gauss_sigma"), true);
+}
+END_SECTION
+
+START_SECTION(([EXTRA] features with missing meta values))
+{
+  FeatureMap features;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ElutionModelFitter_test.featureXML"), features);
+  ABORT_IF(features.size() != 25);
+
+  ElutionModelFitter emf;
+  FeatureMap no_width = features;
+  no_width[10].removeMetaValue("rightWidth");
+  TEST_EXCEPTION(Exception::MissingInformation, emf.fitElutionModels(no_width));
+
+  FeatureMap no_probability = features;
+  no_probability[10].getSubordinates().back().removeMetaValue("isotope_probability");
+  TEST_EXCEPTION(Exception::MissingInformation, emf.fitElutionModels(no_probability));
+}
+END_SECTION
+
+START_SECTION(([EXTRA] results do not depend on the number of threads))
+{
+#ifdef _OPENMP
+  FeatureMap features_serial, features_parallel;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ElutionModelFitter_test.featureXML"), features_serial);
+  ABORT_IF(features_serial.size() != 25);
+  features_parallel = features_serial;
+
+  ElutionModelFitter emf;
+  Param params;
+  params.setValue("asymmetric", "true");
+  emf.setParameters(params);
+
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  emf.fitElutionModels(features_serial);
+  omp_set_num_threads(4);
+  emf.fitElutionModels(features_parallel);
+  omp_set_num_threads(max_threads);
+
+  TEST_EQUAL(features_serial.size(), features_parallel.size());
+  const char* keys[] = {"model_height", "model_FWHM", "model_center",
+                        "model_lower", "model_upper", "model_EGH_tau",
+                        "model_EGH_sigma", "model_error", "model_area",
+                        "model_status", "raw_intensity"};
+  for (Size i = 0; i < features_serial.size(); ++i)
+  {
+    TEST_EQUAL(features_serial[i].getIntensity(), features_parallel[i].getIntensity());
+    for (Size k = 0; k < sizeof(keys) / sizeof(keys[0]); ++k)
+    {
+      TEST_EQUAL(features_serial[i].getMetaValue(keys[k]), features_parallel[i].getMetaValue(keys[k]));
+    }
+  }
+#else
+  NOT_TESTABLE
+#endif
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
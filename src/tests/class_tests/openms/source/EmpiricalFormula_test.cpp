@@ -406,6 +406,40 @@ START_SECTION(ConstIterator end() const)
   NOT_TESTABLE
 END_SECTION
 
+START_SECTION(([EXTRA] fixed and additional elements))
+  // C, H, O are stored in fixed slots, Fe and (13)C are not
+  EmpiricalFormula ef("C6H12O6Fe2(13)C1");
+  TEST_EQUAL(ef.getNumberOf(db->getElement("C")), 6)
+  TEST_EQUAL(ef.getNumberOf(db->getElement("Fe")), 2)
+  TEST_EQUAL(ef.getNumberOf(db->getElement("(13)C")), 1)
+  TEST_EQUAL(ef.getNumberOfAtoms(), 27)
+  TEST_EQUAL(std::distance(ef.begin(), ef.end()), 5)
+  TEST_REAL_SIMILAR(ef.getMonoWeight(), EmpiricalFormula("C6H12O6").getMonoWeight()
+    + 2 * db->getElement("Fe")->getMonoWeight() + db->getElement("(13)C")->getMonoWeight())
+
+  // elements cancelling out are not iterated
+  EmpiricalFormula ef2 = ef - EmpiricalFormula("H12Fe2");
+  TEST_EQUAL(std::distance(ef2.begin(), ef2.end()), 3)
+  TEST_EQUAL(ef2.hasElement(db->getElement("H")), false)
+  TEST_EQUAL(ef2.hasElement(db->getElement("Fe")), false)
+  TEST_EQUAL(ef2 == EmpiricalFormula("C6O6(13)C1"), true)
+  TEST_EQUAL(ef2 + EmpiricalFormula("H12Fe2") == ef, true)
+  TEST_EQUAL((ef2 * 0).isEmpty(), true)
+
+  // zero counts are not stored
+  EmpiricalFormula ef3(0, db->getElement("C"));
+  TEST_EQUAL(ef3.isEmpty(), true)
+  TEST_EQUAL(ef3 == ef_empty, true)
+  EmpiricalFormula ef4("C2C-2");
+  TEST_EQUAL(ef4.isEmpty(), true)
+  TEST_EQUAL(ef4 == ef_empty, true)
+
+  // ordering does not depend on the storage layout
+  TEST_EQUAL(EmpiricalFormula("CFe") < EmpiricalFormula("CFe2"), true)
+  TEST_EQUAL(EmpiricalFormula("CFe2") < EmpiricalFormula("CFe"), false)
+  TEST_EQUAL(EmpiricalFormula("CFe") < EmpiricalFormula("CFe"), false)
+END_SECTION
+
 START_SECTION(IsotopeDistribution getIsotopeDistribution(UInt max_depth) const)
   EmpiricalFormula ef("C");
   IsotopeDistribution iso = ef.getIsotopeDistribution(CoarseIsotopePatternGenerator(20));
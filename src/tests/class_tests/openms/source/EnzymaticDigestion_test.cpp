@@ -39,10 +39,29 @@
 
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/CHEMISTRY/DigestionEnzymeProtein.h>
+#include <random>
 #include <vector>
 using namespace OpenMS;
 using namespace std;
 
+// exposes the cleavage site table to compare it with regex matching
+class TableDigestion : public EnzymaticDigestion
+{
+public:
+  using EnzymaticDigestion::tokenize_;
+
+  bool hasCleavageTable() const
+  {
+    return cleavage_table_ != nullptr;
+  }
+
+  void disableCleavageTable()
+  {
+    cleavage_table_.reset();
+  }
+};
+
 ///////////////////////////
 
 START_TEST(EnzymaticDigestion, "$Id$")
@@ -496,6 +515,73 @@ START_SECTION((bool isValidProduct(const String& sequence, int pos, int length,
 }
 END_SECTION
 
+START_SECTION((Size digestUnmodified(const StringView& sequence, std::vector<DigestionProduct>& output, Size min_length = 1, Size max_length = 0) const))
+{
+  EnzymaticDigestion ed;
+  ed.setMissedCleavages(1);
+  const String seq = "ACKDEKRPFGRH";
+  vector<EnzymaticDigestion::DigestionProduct> out;
+  vector<pair<Size, Size> > pairs;
+  TEST_EQUAL(ed.digestUnmodified(seq, out), 0)
+  ed.digestUnmodified(seq, pairs);
+  TEST_EQUAL(out.size(), pairs.size())
+  TEST_EQUAL(out.size(), 7)
+  for (Size i = 0; i < out.size(); ++i)
+  {
+    TEST_EQUAL(out[i].offset, pairs[i].first)
+    TEST_EQUAL(out[i].length, pairs[i].second)
+  }
+  // ACK, DEK, RPFGR, H
+  TEST_EQUAL(seq.substr(out[0].offset, out[0].length), "ACK")
+  TEST_EQUAL(out[0].missed_cleavages, 0)
+  TEST_EQUAL(seq.substr(out[2].offset, out[2].length), "RPFGR")
+  TEST_EQUAL(out[3].missed_cleavages, 0)
+  // missed cleavages: ACKDEK, DEKRPFGR, RPFGRH
+  TEST_EQUAL(seq.substr(out[4].offset, out[4].length), "ACKDEK")
+  TEST_EQUAL(out[4].missed_cleavages, 1)
+  TEST_EQUAL(seq.substr(out[6].offset, out[6].length), "RPFGRH")
+  TEST_EQUAL(out[6].missed_cleavages, 1)
+
+  // length restrictions
+  TEST_EQUAL(ed.digestUnmodified(seq, out, 4, 6), 4)
+  TEST_EQUAL(out.size(), 3)
+
+  // output is cleared
+  TEST_EQUAL(ed.digestUnmodified(StringView(), out), 0)
+  TEST_EQUAL(out.size(), 0)
+}
+END_SECTION
+
+START_SECTION([EXTRA] cleavage site table agrees with regular expression for all enzymes)
+{
+  vector<String> names;
+  ProteaseDB::getInstance()->getAllNames(names);
+  const String alphabet = "ACDEFGHIKLMNPQRSTVWYBZXJKRKRDEPPW*";
+  for (const String& name : names)
+  {
+    TableDigestion table_digest, regex_digest;
+    table_digest.setEnzyme(ProteaseDB::getInstance()->getEnzyme(name));
+    regex_digest.setEnzyme(ProteaseDB::getInstance()->getEnzyme(name));
+    regex_digest.disableCleavageTable();
+    // all enzymes currently shipped only look at the residues directly around a site
+    TEST_EQUAL(table_digest.hasCleavageTable() || name == EnzymaticDigestion::NoCleavage, true)
+
+    std::mt19937 rng(7);
+    Size mismatches(0);
+    for (Size n = 0; n < 500; ++n)
+    {
+      String seq(rng() % 40, ' ');
+      for (char& c : seq) c = alphabet[rng() % alphabet.size()];
+      const int a = int(rng() % (seq.size() + 1)), b = int(rng() % (seq.size() + 1));
+      const int start = std::min(a, b) - int(rng() % 3); // may be negative
+      const int end = std::max(a, b) + int(rng() % 2); // may be beyond the sequence
+      if (table_digest.tokenize_(seq, start, end) != regex_digest.tokenize_(seq, start, end)) ++mismatches;
+    }
+    TEST_EQUAL(mismatches, 0)
+  }
+}
+END_SECTION
+
 START_SECTION([EXTRA] Size countMissedCleavages_(const std::vector<int>& cleavage_positions, Size pep_start, Size pep_end) const)
   EnzymaticDigestion ed;
   ed.setMissedCleavages(2);
@@ -117,6 +117,51 @@ START_SECTION((static double compute(double fragment_mass_tolerance, bool fragme
 }
 END_SECTION
 
+START_SECTION((static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const std::vector<double>& theo_mzs, const std::vector<char>& theo_ion_types)))
+{
+  PeakSpectrum exp_spectrum;
+  std::vector<double> prefix_masses, theo_mzs;
+  std::vector<char> theo_ion_types;
+
+  AASequence peptide = AASequence::fromString("PEPTIDE");
+  TheoreticalSpectrumGenerator::getPrefixMasses(peptide, prefix_masses);
+
+  // empty spectrum
+  tsg.getFragmentMZs(prefix_masses, 1, 1, theo_mzs, theo_ion_types);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_mzs, theo_ion_types), 0.0);
+
+  // full match, 11 identical masses, identical intensities (=1)
+  tsg.getSpectrum(exp_spectrum, peptide, 1, 1);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_mzs, theo_ion_types), 13.8516496);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, exp_spectrum, theo_mzs, theo_ion_types), 13.8516496);
+
+  exp_spectrum.clear(true);
+
+  // no match
+  tsg.getSpectrum(exp_spectrum, peptide, 1, 3);
+  TheoreticalSpectrumGenerator::getPrefixMasses(AASequence::fromString("YYYYYY"), prefix_masses);
+  tsg.getFragmentMZs(prefix_masses, 1, 3, theo_mzs, theo_ion_types);
+  TEST_REAL_SIMILAR(HyperScore::compute(1e-5, false, exp_spectrum, theo_mzs, theo_ion_types), 0.0);
+
+  // full match, 33 identical masses, identical intensities (=1)
+  TheoreticalSpectrumGenerator::getPrefixMasses(peptide, prefix_masses);
+  tsg.getFragmentMZs(prefix_masses, 1, 3, theo_mzs, theo_ion_types);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_mzs, theo_ion_types), 67.8210771);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, exp_spectrum, theo_mzs, theo_ion_types), 67.8210771);
+
+  // full match if ppm tolerance and partial match for Da tolerance
+  for (Size i = 0; i < theo_mzs.size(); ++i)
+  {
+    double mz = pow(theo_mzs[i], 2);
+    exp_spectrum[i].setMZ(mz);
+    theo_mzs[i] = mz + 9 * 1e-6 * mz; // +9 ppm error
+  }
+
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_mzs, theo_ion_types), 3.401197);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, exp_spectrum, theo_mzs, theo_ion_types), 67.8210771);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,141 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataCompactingConsumer.h>
+
+///////////////////////////
+
+START_TEST(MSDataCompactingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataCompactingConsumer* compacting_consumer_ptr = nullptr;
+MSDataCompactingConsumer* compacting_consumer_nullPointer = nullptr;
+
+START_SECTION((MSDataCompactingConsumer()))
+  compacting_consumer_ptr = new MSDataCompactingConsumer();
+  TEST_NOT_EQUAL(compacting_consumer_ptr, compacting_consumer_nullPointer)
+END_SECTION
+
+START_SECTION((~MSDataCompactingConsumer()))
+    delete compacting_consumer_ptr;
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType & s)))
+{
+  MSDataCompactingConsumer consumer;
+
+  MSSpectrum s;
+  s.setName("spec1");
+  s.setRT(5);
+  s.push_back(Peak1D(400.0, 10.0f));
+  s.push_back(Peak1D(500.0, 20.0f));
+  consumer.consumeSpectrum(s);
+  s.setName("spec2");
+  s.setRT(15);
+  consumer.consumeSpectrum(s);
+
+  TEST_EQUAL(consumer.getData().getNrSpectra(), 2)
+  TEST_EQUAL(consumer.getData().getNrChromatograms(), 0)
+  TEST_EQUAL(consumer.getData().getSpectrum(0).getName(), "spec1")
+  TEST_EQUAL(consumer.getData().getSpectrum(1).getName(), "spec2")
+  TEST_EQUAL(consumer.getData().getSpectrum(1).size(), 2)
+  TEST_REAL_SIMILAR(consumer.getData().getSpectrum(1)[1].getMZ(), 500.0)
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType & c)))
+{
+  MSDataCompactingConsumer consumer;
+
+  MSChromatogram c;
+  c.setNativeID("testid");
+  consumer.consumeChromatogram(c);
+
+  TEST_EQUAL(consumer.getData().getNrSpectra(), 0)
+  TEST_EQUAL(consumer.getData().getNrChromatograms(), 1)
+  TEST_EQUAL(consumer.getData().getChromatogram(0).getNativeID(), "testid")
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size, Size)))
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings&)))
+{
+  MSDataCompactingConsumer consumer;
+  consumer.setExpectedSize(1, 1);
+
+  MSSpectrum spec;
+  spec.setName("spec1");
+  consumer.consumeSpectrum(spec);
+
+  ExperimentalSettings s;
+  s.setComment("mySettings");
+  consumer.setExperimentalSettings(s);
+
+  TEST_EQUAL(consumer.getData().getNrSpectra(), 1)
+  TEST_EQUAL(consumer.getData().getExperimentalSettings().getComment(), "mySettings")
+}
+END_SECTION
+
+START_SECTION((const CompactMSExperiment& getData() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((void swapData(CompactMSExperiment& exp)))
+{
+  MSDataCompactingConsumer consumer;
+  MSSpectrum spec;
+  consumer.consumeSpectrum(spec);
+
+  CompactMSExperiment exp;
+  consumer.swapData(exp);
+  TEST_EQUAL(exp.getNrSpectra(), 1)
+  TEST_EQUAL(consumer.getData().empty(), true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
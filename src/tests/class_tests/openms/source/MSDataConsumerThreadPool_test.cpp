@@ -0,0 +1,143 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataConsumerThreadPool.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+
+///////////////////////////
+
+using namespace OpenMS;
+
+// fails on spectra named "fail"
+class FailingConsumer :
+  public MSDataStoringConsumer
+{
+public:
+  void consumeSpectrum(SpectrumType & s) override
+  {
+    if (s.getName() == "fail")
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "fail");
+    }
+    MSDataStoringConsumer::consumeSpectrum(s);
+  }
+};
+
+START_TEST(MSDataConsumerThreadPool, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSDataConsumerThreadPool* pool_ptr = nullptr;
+MSDataConsumerThreadPool* pool_nullPointer = nullptr;
+
+START_SECTION((MSDataConsumerThreadPool(Size nr_threads, Size max_queued_spectra = 0)))
+{
+  pool_ptr = new MSDataConsumerThreadPool(2);
+  TEST_NOT_EQUAL(pool_ptr, pool_nullPointer)
+  TEST_EQUAL(pool_ptr->getNrThreads(), 2)
+}
+END_SECTION
+
+START_SECTION((~MSDataConsumerThreadPool()))
+{
+  delete pool_ptr;
+}
+END_SECTION
+
+START_SECTION((Size getNrThreads() const))
+{
+  MSDataConsumerThreadPool pool(0);
+  TEST_EQUAL(pool.getNrThreads(), 1)
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(Interfaces::IMSDataConsumer* consumer, const MSSpectrum& s)))
+{
+  std::vector<MSDataStoringConsumer> consumers(5);
+  {
+    MSDataConsumerThreadPool pool(3, 7);
+    for (Size i = 0; i < 500; ++i)
+    {
+      MSSpectrum s;
+      s.setRT(i);
+      s.push_back(Peak1D(100.0 + i, 1.0f));
+      pool.consumeSpectrum(&consumers[i % 5], s);
+      TEST_EQUAL(s.size(), 1) // input is not modified
+    }
+    pool.finish();
+  }
+
+  // each consumer receives its spectra in order
+  for (Size c = 0; c < consumers.size(); ++c)
+  {
+    const PeakMap& data = consumers[c].getData();
+    TEST_EQUAL(data.size(), 100)
+    bool in_order = true;
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      in_order &= (data[i].getRT() == double(i * 5 + c));
+      in_order &= (data[i].size() == 1 && data[i][0].getMZ() == 100.0 + i * 5 + c);
+    }
+    TEST_EQUAL(in_order, true)
+  }
+}
+END_SECTION
+
+START_SECTION((void finish()))
+{
+  FailingConsumer failing;
+  MSDataStoringConsumer storing;
+  MSDataConsumerThreadPool pool(2);
+  MSSpectrum s;
+  pool.consumeSpectrum(&storing, s);
+  pool.finish();
+  TEST_EQUAL(storing.getData().size(), 1)
+
+  // errors in the worker threads are passed on
+  s.setName("fail");
+  pool.consumeSpectrum(&failing, s);
+  TEST_EXCEPTION(Exception::IllegalArgument, pool.finish())
+  TEST_EXCEPTION(Exception::IllegalArgument, pool.consumeSpectrum(&storing, s))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
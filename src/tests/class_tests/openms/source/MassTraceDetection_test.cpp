@@ -175,6 +175,38 @@ START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &)))
 }
 END_SECTION
 
+START_SECTION((void addSpectrum(const MSSpectrum & spectrum)))
+{
+  NOT_TESTABLE // tested with run(std::vector<MassTrace>&, const Size) below
+}
+END_SECTION
+
+START_SECTION((void run(std::vector<MassTrace> & found_masstraces, const Size max_traces = 0)))
+{
+  // passing the spectra one at a time gives the same result as the in-memory run:
+  MassTraceDetection stream_mtd;
+  stream_mtd.setParameters(p_mtd);
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    stream_mtd.addSpectrum(input[i]);
+  }
+  std::vector<MassTrace> stream_mt;
+  stream_mtd.run(stream_mt);
+  TEST_EQUAL(stream_mt.size(), 3);
+
+  for (Size i = 0; i < stream_mt.size(); ++i)
+  {
+    TEST_EQUAL(stream_mt[i].getSize(), exp_mt_lengths[i]);
+    TEST_REAL_SIMILAR(stream_mt[i].getCentroidRT(), exp_mt_rts[i]);
+    TEST_REAL_SIMILAR(stream_mt[i].getCentroidMZ(), exp_mt_mzs[i]);
+    TEST_REAL_SIMILAR(stream_mt[i].computePeakArea(), exp_mt_ints[i]);
+  }
+
+  // the spectra are discarded after the run:
+  TEST_EXCEPTION(Exception::InvalidValue, stream_mtd.run(stream_mt));
+}
+END_SECTION
+
 std::vector<MassTrace> filt;
 
 //START_SECTION((void filterByPeakWidth(std::vector< MassTrace > &, std::vector< MassTrace > &)))
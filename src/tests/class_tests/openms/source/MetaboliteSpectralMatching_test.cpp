@@ -38,6 +38,8 @@
 #include <OpenMS/ANALYSIS/ID/MetaboliteSpectralMatching.h>
 ///////////////////////////
 
+#include <fstream>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -75,7 +77,136 @@ END_SECTION
 
 START_SECTION((void run(PeakMap &, MzTab &)))
 {
-  // TODO
+  // library: one matching spectrum, one with only two matching peaks, one with a different precursor
+  PeakMap spec_db;
+  double db_precursors[] = {200.0, 200.0005, 300.0};
+  double db_peaks[][3] = {{100.0, 120.0, 150.0}, {100.0, 120.0, 180.0}, {100.0, 120.0, 150.0}};
+  for (Size i = 0; i < 3; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(2);
+    spec.getPrecursors().resize(1);
+    spec.getPrecursors()[0].setMZ(db_precursors[i]);
+    spec.getPrecursors()[0].setCharge(1);
+    for (Size j = 0; j < 3; ++j)
+    {
+      Peak1D peak(db_peaks[i][j], 100.0);
+      spec.push_back(peak);
+    }
+    spec.setMetaValue("Massbank_Accession_ID", String("DB") + i);
+    spec.setMetaValue("HMDB_ID", "HMDB:0");
+    spec.setMetaValue("Sum_Formula", "C6H12O6");
+    spec.setMetaValue("Metabolite_Name", "name");
+    spec.setMetaValue("Inchi_String", "inchi");
+    spec.setMetaValue("SMILES_String", "smiles");
+    spec.setMetaValue("Precursor_Ion", "[M+H]+");
+    spec_db.addSpectrum(spec);
+  }
+
+  PeakMap exp;
+  MSSpectrum query;
+  query.setMSLevel(2);
+  query.setRT(10.0);
+  query.getPrecursors().resize(1);
+  query.getPrecursors()[0].setMZ(200.0);
+  double query_peaks[] = {100.01, 120.0, 150.02, 170.0};
+  for (Size j = 0; j < 4; ++j)
+  {
+    Peak1D peak(query_peaks[j], 50.0);
+    query.push_back(peak);
+  }
+  exp.addSpectrum(query);
+  query.getPrecursors()[0].setMZ(400.0);
+  query.setRT(20.0);
+  exp.addSpectrum(query);
+
+  MetaboliteSpectralMatching msm;
+  MzTab mztab;
+  msm.run(exp, spec_db, mztab);
+  MzTabSmallMoleculeSectionRows rows = mztab.getSmallMoleculeSectionRows();
+  TEST_EQUAL(rows.size(), 1)
+  ABORT_IF(rows.size() != 1)
+  TEST_EQUAL(rows[0].identifier.get()[0].get(), "DB0")
+}
+END_SECTION
+
+START_SECTION((static void storeLibraryCache(const String& filename, const PeakMap& spec_db, const String& source = "")))
+{
+  NOT_TESTABLE // tested with loadLibraryCache
+}
+END_SECTION
+
+START_SECTION((static void loadLibraryCache(const String& filename, PeakMap& spec_db)))
+{
+  PeakMap spec_db;
+  MSSpectrum spec;
+  spec.setMSLevel(2);
+  spec.setRT(12.5);
+  spec.getPrecursors().resize(1);
+  spec.getPrecursors()[0].setMZ(181.0707);
+  spec.getPrecursors()[0].setCharge(-1);
+  spec.push_back(Peak1D(59.0139, 20.0));
+  spec.push_back(Peak1D(89.0244, 100.0));
+  spec.setMetaValue("Metabolite_Name", "Glucose");
+  spec_db.addSpectrum(spec);
+  spec_db.addSpectrum(MSSpectrum());
+
+  String filename;
+  NEW_TMP_FILE(filename)
+  MetaboliteSpectralMatching::storeLibraryCache(filename, spec_db);
+  PeakMap loaded;
+  MetaboliteSpectralMatching::loadLibraryCache(filename, loaded);
+  TEST_EQUAL(loaded.size(), 2)
+  ABORT_IF(loaded.size() != 2)
+  TEST_EQUAL(loaded[0].getMSLevel(), 2)
+  TEST_REAL_SIMILAR(loaded[0].getRT(), 12.5)
+  TEST_EQUAL(loaded[0].getPrecursors().size(), 1)
+  TEST_REAL_SIMILAR(loaded[0].getPrecursors()[0].getMZ(), 181.0707)
+  TEST_EQUAL(loaded[0].getPrecursors()[0].getCharge(), -1)
+  TEST_EQUAL(loaded[0].size(), 2)
+  TEST_REAL_SIMILAR(loaded[0][1].getMZ(), 89.0244)
+  TEST_REAL_SIMILAR(loaded[0][1].getIntensity(), 100.0)
+  TEST_EQUAL(loaded[0].getMetaValue("Metabolite_Name"), "Glucose")
+  TEST_EQUAL(loaded[1].size(), 0)
+
+  TEST_EXCEPTION(Exception::FileNotFound, MetaboliteSpectralMatching::loadLibraryCache("this_file_does_not_exist", loaded))
+  String not_a_cache;
+  NEW_TMP_FILE(not_a_cache)
+  std::ofstream(not_a_cache.c_str()) << "no cache";
+  TEST_EXCEPTION(Exception::ParseError, MetaboliteSpectralMatching::loadLibraryCache(not_a_cache, loaded))
+}
+END_SECTION
+
+START_SECTION((static bool isLibraryCacheCurrent(const String& filename, const String& source)))
+{
+  PeakMap spec_db;
+  spec_db.addSpectrum(MSSpectrum());
+
+  String source, other_source;
+  NEW_TMP_FILE(source)
+  NEW_TMP_FILE(other_source)
+  std::ofstream(source.c_str()) << "library";
+  std::ofstream(other_source.c_str()) << "library";
+
+  String filename;
+  NEW_TMP_FILE(filename)
+  MetaboliteSpectralMatching::storeLibraryCache(filename, spec_db, source);
+  TEST_EQUAL(MetaboliteSpectralMatching::isLibraryCacheCurrent(filename, source), true)
+  TEST_EQUAL(MetaboliteSpectralMatching::isLibraryCacheCurrent(filename, other_source), false)
+  TEST_EQUAL(MetaboliteSpectralMatching::isLibraryCacheCurrent("this_file_does_not_exist", source), false)
+
+  // the source was modified
+  std::ofstream(source.c_str(), std::ios::app) << " with more spectra";
+  TEST_EQUAL(MetaboliteSpectralMatching::isLibraryCacheCurrent(filename, source), false)
+
+  // no source stored
+  MetaboliteSpectralMatching::storeLibraryCache(filename, spec_db);
+  TEST_EQUAL(MetaboliteSpectralMatching::isLibraryCacheCurrent(filename, source), false)
+
+  String not_a_cache;
+  NEW_TMP_FILE(not_a_cache)
+  std::ofstream(not_a_cache.c_str()) << "no cache";
+  TEST_EQUAL(MetaboliteSpectralMatching::isLibraryCacheCurrent(not_a_cache, source), false)
 }
 END_SECTION
 
@@ -38,6 +38,7 @@
 ///////////////////////////
 
 #include <OpenMS/FORMAT/MzIdentMLFile.h>
+#include <OpenMS/FORMAT/HANDLERS/MzIdentMLDOMHandler.h>
 #include <OpenMS/CONCEPT/FuzzyStringComparator.h>
 #include <OpenMS/CHEMISTRY/CrossLinksDB.h>
 #include <OpenMS/CONCEPT/Constants.h>
@@ -543,6 +544,53 @@ START_SECTION(([EXTRA] XLMS data unlabeled cross-linker))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] streaming reader matches DOM reader))
+{
+  StringList files = ListUtils::create<String>("MzIdentMLFile_msgf_mini.mzid,MzIdentMLFile_whole.mzid,MzIdentML_3runs.mzid");
+  for (Size f = 0; f < files.size(); ++f)
+  {
+    String input_path = OPENMS_GET_TEST_DATA_PATH(files[f]);
+    std::vector<ProteinIdentification> protein_ids, protein_ids_dom;
+    std::vector<PeptideIdentification> peptide_ids, peptide_ids_dom;
+    MzIdentMLFile mzid;
+    mzid.load(input_path, protein_ids, peptide_ids);
+    Internal::MzIdentMLDOMHandler(protein_ids_dom, peptide_ids_dom, "1.1.0", mzid).readMzIdentMLFile(input_path);
+
+    TEST_EQUAL(protein_ids.size(), protein_ids_dom.size())
+    for (Size i = 0; i < std::min(protein_ids.size(), protein_ids_dom.size()); ++i)
+    {
+      TEST_EQUAL(protein_ids[i].getSearchEngine(), protein_ids_dom[i].getSearchEngine())
+      TEST_EQUAL(protein_ids[i].getSearchEngineVersion(), protein_ids_dom[i].getSearchEngineVersion())
+      TEST_EQUAL(protein_ids[i].getSearchParameters().db, protein_ids_dom[i].getSearchParameters().db)
+      TEST_EQUAL(protein_ids[i].getSignificanceThreshold(), protein_ids_dom[i].getSignificanceThreshold())
+      TEST_EQUAL(protein_ids[i].getHits().size(), protein_ids_dom[i].getHits().size())
+      for (Size j = 0; j < std::min(protein_ids[i].getHits().size(), protein_ids_dom[i].getHits().size()); ++j)
+      {
+        TEST_EQUAL(protein_ids[i].getHits()[j].getAccession(), protein_ids_dom[i].getHits()[j].getAccession())
+      }
+    }
+
+    TEST_EQUAL(peptide_ids.size(), peptide_ids_dom.size())
+    for (Size i = 0; i < std::min(peptide_ids.size(), peptide_ids_dom.size()); ++i)
+    {
+      TEST_REAL_SIMILAR(peptide_ids[i].getRT(), peptide_ids_dom[i].getRT())
+      TEST_EQUAL(peptide_ids[i].getScoreType(), peptide_ids_dom[i].getScoreType())
+      TEST_EQUAL(peptide_ids[i].getHits().size(), peptide_ids_dom[i].getHits().size())
+      for (Size j = 0; j < std::min(peptide_ids[i].getHits().size(), peptide_ids_dom[i].getHits().size()); ++j)
+      {
+        const PeptideHit& hit = peptide_ids[i].getHits()[j];
+        const PeptideHit& hit_dom = peptide_ids_dom[i].getHits()[j];
+        TEST_EQUAL(hit.getSequence(), hit_dom.getSequence())
+        TEST_REAL_SIMILAR(hit.getScore(), hit_dom.getScore())
+        TEST_EQUAL(hit.getRank(), hit_dom.getRank())
+        TEST_EQUAL(hit.getCharge(), hit_dom.getCharge())
+        TEST_EQUAL(hit.extractProteinAccessionsSet().size(), hit_dom.extractProteinAccessionsSet().size())
+      }
+    }
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
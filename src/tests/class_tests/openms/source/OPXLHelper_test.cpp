@@ -51,6 +51,9 @@
 #include <OpenMS/CHEMISTRY/Tagger.h>
 #include <QStringList>
 
+#include <set>
+#include <tuple>
+
 using namespace OpenMS;
 
 START_TEST(OPXLHelper, "$Id$")
@@ -150,6 +153,42 @@ START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLin
 
 END_SECTION
 
+
+START_SECTION([EXTRA] enumerateCrossLinksAndMasses in blocks of alpha peptides)
+  std::vector< int > all_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> all_precursors = OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, all_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+
+  // enumerating in blocks of alpha peptides has to result in the same candidates
+  std::vector< int > block_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> block_precursors;
+  Size block_size = peptides.size() / 3 + 1;
+  for (Size alpha_begin = 0; alpha_begin < peptides.size(); alpha_begin += block_size)
+  {
+    std::vector< int > positions;
+    std::vector<OPXLDataStructs::XLPrecursor> block = OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, alpha_begin, alpha_begin + block_size);
+    block_precursors.insert(block_precursors.end(), block.begin(), block.end());
+    block_positions.insert(block_positions.end(), positions.begin(), positions.end());
+  }
+  TEST_EQUAL(block_precursors.size(), all_precursors.size())
+  TEST_EQUAL(block_positions.size(), all_positions.size())
+
+  std::multiset< std::tuple<Size, Size, int> > all_set, block_set;
+  for (Size i = 0; i < all_precursors.size(); ++i)
+  {
+    all_set.insert(std::make_tuple(all_precursors[i].alpha_index, all_precursors[i].beta_index, all_positions[i]));
+  }
+  for (Size i = 0; i < block_precursors.size(); ++i)
+  {
+    block_set.insert(std::make_tuple(block_precursors[i].alpha_index, block_precursors[i].beta_index, block_positions[i]));
+  }
+  TEST_EQUAL(all_set == block_set, true)
+
+  // an empty range results in no candidates
+  std::vector< int > empty_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> empty_precursors = OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, empty_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, peptides.size(), peptides.size() + 10);
+  TEST_EQUAL(empty_precursors.size(), 0)
+  TEST_EQUAL(empty_positions.size(), 0)
+END_SECTION
 // building more data structures required in the following test
 std::cout << std::endl;
 std::vector< int > spectrum_precursor_correction_positions;
@@ -426,6 +465,60 @@ START_SECTION(static std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXL
 
 END_SECTION
 
+START_SECTION(static Size prescoreCandidatesInBlocks(Size peptide_count, Size block_size, Size number_top_hits, const std::function<std::vector<OPXLDataStructs::ProteinProteinCrossLink>(Size, Size)>& collect_candidates, const std::function<void(const std::vector<OPXLDataStructs::ProteinProteinCrossLink>&, std::vector<OPXLDataStructs::CrossLinkSpectrumMatch>&)>& prescore_candidates, std::vector<OPXLDataStructs::CrossLinkSpectrumMatch>& prescored_csms))
+
+  IntList precursor_correction_steps;
+  precursor_correction_steps.push_back(2);
+  precursor_correction_steps.push_back(1);
+
+  double precursor_mass = 10668.85060;
+  String cross_link_name = "MyLinker";
+
+  std::vector< std::pair<Size, Size> > blocks;
+  auto collect_candidates = [&](Size alpha_begin, Size alpha_end)
+  {
+    blocks.push_back(std::make_pair(alpha_begin, alpha_end));
+    return OPXLHelper::collectPrecursorCandidates(precursor_correction_steps, precursor_mass, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, cross_link_name, false, std::vector<std::string>(), alpha_begin, alpha_end);
+  };
+  // score by the mass of the alpha peptide
+  auto prescore_candidates = [](const std::vector<OPXLDataStructs::ProteinProteinCrossLink>& candidates, std::vector<OPXLDataStructs::CrossLinkSpectrumMatch>& csms)
+  {
+    for (const OPXLDataStructs::ProteinProteinCrossLink& candidate : candidates)
+    {
+      OPXLDataStructs::CrossLinkSpectrumMatch csm;
+      csm.cross_link = candidate;
+      csm.score = candidate.alpha->getMonoWeight();
+      csms.push_back(csm);
+    }
+  };
+
+  // all candidates at once
+  std::vector<OPXLDataStructs::CrossLinkSpectrumMatch> all_csms;
+  Size candidates_count = OPXLHelper::prescoreCandidatesInBlocks(peptides.size(), 0, 10000, collect_candidates, prescore_candidates, all_csms);
+  TEST_EQUAL(candidates_count, 1050)
+  TEST_EQUAL(all_csms.size(), 1050)
+  TEST_EQUAL(blocks.size(), 1)
+
+  // in blocks, keeping only the best matches
+  blocks.clear();
+  std::vector<OPXLDataStructs::CrossLinkSpectrumMatch> top_csms;
+  candidates_count = OPXLHelper::prescoreCandidatesInBlocks(peptides.size(), peptides.size() / 3 + 1, 5, collect_candidates, prescore_candidates, top_csms);
+  TEST_EQUAL(candidates_count, 1050)
+  TEST_EQUAL(top_csms.size(), 5)
+  TEST_EQUAL(blocks.size(), 3)
+  TEST_EQUAL(blocks[0].first, 0)
+  TEST_EQUAL(blocks[1].first, blocks[0].second)
+  TEST_EQUAL(blocks[2].second, peptides.size())
+
+  std::sort(all_csms.rbegin(), all_csms.rend(), OPXLDataStructs::CLSMScoreComparator());
+  std::sort(top_csms.rbegin(), top_csms.rend(), OPXLDataStructs::CLSMScoreComparator());
+  for (Size i = 0; i < top_csms.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(top_csms[i].score, all_csms[i].score)
+  }
+
+END_SECTION
+
 START_SECTION(static double OPXLHelper::computePrecursorError(OPXLDataStructs::CrossLinkSpectrumMatch csm, double precursor_mz, int precursor_charge))
 
   OPXLDataStructs::ProteinProteinCrossLink ppcl;
@@ -278,6 +278,63 @@ START_SECTION((ExitCodes run(std::vector<FASTAFile::FASTAEntry>& proteins, std::
 }
 END_SECTION
 
+START_SECTION((void setProteinIndex(std::shared_ptr<const ProteinIndex> index)))
+{
+  std::vector<FASTAFile::FASTAEntry> proteins = toFASTAVec(QStringList() << "MKPEPTIDERAAAK*" << "AAPEPXIDEBRK" << "KPEPTLDEK" << "KEDITPEPRK",
+                                                           QStringList() << "P1" << "P2" << "P3" << "DECOY_P1");
+  QStringList peptides = QStringList() << "PEPTIDER" << "PEPTIDEDR" << "PEPTIDEK" << "EDITPEPR" << "AAAK";
+
+  for (int IL = 0; IL < 2; ++IL)
+  {
+    for (int aaa = 0; aaa < 3; ++aaa)
+    {
+      for (int mm = 0; mm < 2; ++mm)
+      {
+        PeptideIndexing pi;
+        Param p = pi.getParameters();
+        p.setValue("aaa_max", aaa);
+        p.setValue("mismatches_max", mm);
+        p.setValue("IL_equivalent", IL ? "true" : "false");
+        p.setValue("allow_unmatched", "true");
+        pi.setParameters(p);
+
+        // Aho-Corasick
+        std::vector<ProteinIdentification> prot_ids_ac(1);
+        std::vector<PeptideIdentification> pep_ids_ac = toPepVec(peptides);
+        PeptideIndexing::ExitCodes r_ac = pi.run(proteins, prot_ids_ac, pep_ids_ac);
+
+        // prebuilt index: same result
+        std::shared_ptr<ProteinIndex> index(new ProteinIndex());
+        FASTAContainer<TFI_Vector> container(proteins);
+        index->build(container, IL == 1);
+        pi.setProteinIndex(index);
+        std::vector<ProteinIdentification> prot_ids_idx(1);
+        std::vector<PeptideIdentification> pep_ids_idx = toPepVec(peptides);
+        PeptideIndexing::ExitCodes r_idx = pi.run(proteins, prot_ids_idx, pep_ids_idx);
+
+        TEST_EQUAL(r_idx, r_ac)
+        ABORT_IF(pep_ids_idx.size() != pep_ids_ac.size())
+        for (Size i = 0; i < pep_ids_ac.size(); ++i)
+        {
+          TEST_EQUAL(pep_ids_idx[i].getHits()[0].getPeptideEvidences() == pep_ids_ac[i].getHits()[0].getPeptideEvidences(), true)
+          TEST_EQUAL(pep_ids_idx[i].getHits()[0].getMetaValue("target_decoy"), pep_ids_ac[i].getHits()[0].getMetaValue("target_decoy"))
+        }
+        TEST_EQUAL(prot_ids_idx[0].getHits().size(), prot_ids_ac[0].getHits().size())
+
+        // index built with a different I/L setting or from another database is rejected
+        FASTAContainer<TFI_Vector> container2(proteins);
+        index->build(container2, IL == 0);
+        TEST_EQUAL(pi.run(proteins, prot_ids_idx, pep_ids_idx), PeptideIndexing::ILLEGAL_PARAMETERS)
+        std::vector<FASTAFile::FASTAEntry> other = toFASTAVec(QStringList() << "MKPEPTIDERAAAK");
+        FASTAContainer<TFI_Vector> container3(other);
+        index->build(container3, IL == 1);
+        TEST_EQUAL(pi.run(proteins, prot_ids_idx, pep_ids_idx), PeptideIndexing::ILLEGAL_PARAMETERS)
+      }
+    }
+  }
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -0,0 +1,200 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/SYSTEM/Profiler.h>
+
+#include <chrono>
+#include <fstream>
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+void wait(double seconds)
+{
+  auto start = std::chrono::system_clock::now();
+  while (true)
+  {
+   double s = std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+   if (s > seconds) break;
+  };
+}
+
+START_TEST(Profiler, "$Id$")
+
+/////////////////////////////////////////////////////////////
+
+START_SECTION(static bool isEnabled())
+{
+  TEST_EQUAL(Profiler::isEnabled(), false)
+}
+END_SECTION
+
+START_SECTION(Stage(const String& name))
+{
+  // disabled: nothing is recorded
+  {
+    Profiler::Stage stage("disabled");
+  }
+  Profiler::addCount("disabled");
+  TEST_EQUAL(Profiler::getStageNames().size(), 0)
+  TEST_EQUAL(Profiler::getCounts().size(), 0)
+}
+END_SECTION
+
+START_SECTION(static void setEnabled(bool enabled))
+{
+  Profiler::setEnabled(true);
+  TEST_EQUAL(Profiler::isEnabled(), true)
+}
+END_SECTION
+
+START_SECTION(~Stage())
+{
+  {
+    Profiler::Stage stage("outer");
+    {
+      Profiler::Stage inner("inner");
+      wait(0.1);
+    }
+    wait(0.1);
+  }
+  {
+    Profiler::Stage stage("inner");
+    wait(0.1);
+  }
+  std::vector<String> names = Profiler::getStageNames();
+  TEST_EQUAL(names.size(), 2)
+  ABORT_IF(names.size() != 2)
+  // in order of completion
+  TEST_EQUAL(names[0], "inner")
+  TEST_EQUAL(names[1], "outer")
+}
+END_SECTION
+
+START_SECTION(void stop())
+{
+  Profiler::Stage stage("stopped");
+  stage.stop();
+  TEST_EQUAL(Profiler::getStage("stopped").calls, 1)
+  stage.stop(); // only the first call counts
+  TEST_EQUAL(Profiler::getStage("stopped").calls, 1)
+}
+END_SECTION
+
+START_SECTION(static StageStatistics getStage(const String& name))
+{
+  Profiler::StageStatistics inner = Profiler::getStage("inner");
+  TEST_EQUAL(inner.calls, 2)
+  TEST_EQUAL(inner.wall_time >= 0.2, true)
+  TEST_EQUAL(inner.cpu_time > 0.0, true)
+  Profiler::StageStatistics outer = Profiler::getStage("outer");
+  TEST_EQUAL(outer.calls, 1)
+  TEST_EQUAL(outer.wall_time >= 0.2, true)
+  Profiler::StageStatistics unknown = Profiler::getStage("unknown");
+  TEST_EQUAL(unknown.calls, 0)
+  TEST_REAL_SIMILAR(unknown.wall_time, 0.0)
+}
+END_SECTION
+
+START_SECTION(static void addStage(const String& name, double wall_time, double cpu_time, size_t peak_memory, size_t peak_memory_increase))
+{
+  Profiler::addStage("manual", 2.0, 3.0, 100, 10);
+  Profiler::addStage("manual", 2.0, 5.0, 50, 20);
+  Profiler::StageStatistics stats = Profiler::getStage("manual");
+  TEST_EQUAL(stats.calls, 2)
+  TEST_REAL_SIMILAR(stats.wall_time, 4.0)
+  TEST_REAL_SIMILAR(stats.cpu_time, 8.0)
+  TEST_REAL_SIMILAR(stats.getThreadUtilization(), 2.0)
+  TEST_EQUAL(stats.peak_memory, 100)
+  TEST_EQUAL(stats.peak_memory_increase, 20)
+}
+END_SECTION
+
+START_SECTION(static void addCount(const String& name, Int64 count = 1))
+{
+  Profiler::addCount("spectra", 10);
+  Profiler::addCount("spectra");
+  Profiler::addCount("peaks", 1000);
+  std::map<String, Int64> counts = Profiler::getCounts();
+  TEST_EQUAL(counts.size(), 2)
+  TEST_EQUAL(counts["spectra"], 11)
+  TEST_EQUAL(counts["peaks"], 1000)
+}
+END_SECTION
+
+START_SECTION(static std::vector<String> getStageNames())
+{
+  TEST_EQUAL(Profiler::getStageNames().size(), 4)
+}
+END_SECTION
+
+START_SECTION((static std::map<String, Int64> getCounts()))
+{
+  TEST_EQUAL(Profiler::getCounts().size(), 2)
+}
+END_SECTION
+
+START_SECTION(static void storeJSON(const String& filename, const String& name = ""))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  Profiler::storeJSON(filename, "Profiler_test");
+  std::ifstream is(filename.c_str());
+  std::string content((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  TEST_EQUAL(String(content).hasSubstring("\"name\": \"Profiler_test\""), true)
+  TEST_EQUAL(String(content).hasSubstring("\"name\": \"manual\""), true)
+  TEST_EQUAL(String(content).hasSubstring("\"wall_time_s\": 4.0"), true)
+  TEST_EQUAL(String(content).hasSubstring("\"spectra\": 11"), true)
+
+  TEST_EXCEPTION(Exception::UnableToCreateFile, Profiler::storeJSON("/does/not/exist/profile.json"))
+}
+END_SECTION
+
+START_SECTION(static void clear())
+{
+  Profiler::clear();
+  TEST_EQUAL(Profiler::getStageNames().size(), 0)
+  TEST_EQUAL(Profiler::getCounts().size(), 0)
+  Profiler::setEnabled(false);
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -605,6 +605,41 @@ START_SECTION((bool isValidProduct(const AASequence& protein, int pep_pos, int p
 
 END_SECTION
 
+START_SECTION((template <typename T, typename Callback> Size digestDatabase(FASTAContainer<T>& proteins, Callback callback, Size min_length = 1, Size max_length = 0, Size chunk_size = 100000) const))
+{
+  ProteaseDigestion pd;
+  pd.setMissedCleavages(1);
+  vector<FASTAFile::FASTAEntry> db;
+  for (Size i = 0; i < 250; ++i)
+  {
+    db.push_back(FASTAFile::FASTAEntry("P" + String(i), "", String("ACKDEKRPFGRH").substr(i % 12) + String(i % 7, 'K')));
+  }
+  FASTAContainer<TFI_Vector> proteins(db);
+
+  vector<vector<pair<Size, Size> > > result(db.size());
+  vector<Size> calls(db.size(), 0);
+  Size count = pd.digestDatabase(proteins,
+    [&result, &calls](Size index, const FASTAFile::FASTAEntry&, const vector<EnzymaticDigestion::DigestionProduct>& products)
+    {
+      ++calls[index]; // each index is visited by one thread only
+      for (const EnzymaticDigestion::DigestionProduct& p : products) result[index].emplace_back(p.offset, p.length);
+    }, 2, 10);
+  TEST_EQUAL(count, db.size())
+
+  Size mismatches(0);
+  for (Size i = 0; i < db.size(); ++i)
+  {
+    vector<pair<Size, Size> > expected;
+    pd.digestUnmodified(StringView(db[i].sequence), expected, 2, 10);
+    if (calls[i] != 1 || result[i] != expected) ++mismatches;
+  }
+  TEST_EQUAL(mismatches, 0)
+
+  // a second call starts from the beginning again
+  TEST_EQUAL(pd.digestDatabase(proteins, [](Size, const FASTAFile::FASTAEntry&, const vector<EnzymaticDigestion::DigestionProduct>&) {}), db.size())
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,237 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/ProteinIndex.h>
+///////////////////////////
+
+#include <random>
+
+using namespace OpenMS;
+using namespace std;
+
+// brute force reference with the matching rules of ProteinIndex/AhoCorasickAmbiguous
+vector<ProteinIndex::Hit> bruteForce(const vector<String>& proteins, const String& pep, Size aaa_max, Size mm_max)
+{
+  vector<ProteinIndex::Hit> hits;
+  for (Size p = 0; p < proteins.size(); ++p)
+  {
+    const String& prot = proteins[p];
+    for (Size pos = 0; pos + pep.size() <= prot.size(); ++pos)
+    {
+      Size aaa(0), mm(0);
+      for (Size i = 0; i < pep.size(); ++i)
+      {
+        const char c = prot[pos + i], a = pep[i];
+        if (c == a) continue;
+        bool amb = (c == 'X') || (c == 'B' && (a == 'D' || a == 'N')) || (c == 'Z' && (a == 'E' || a == 'Q')) || (c == 'J' && (a == 'I' || a == 'L'));
+        if (amb && aaa < aaa_max) ++aaa;
+        else ++mm;
+      }
+      if (mm <= mm_max)
+      {
+        ProteinIndex::Hit h;
+        h.protein_index = p;
+        h.position = pos;
+        hits.push_back(h);
+      }
+    }
+  }
+  return hits;
+}
+
+String toString(const vector<ProteinIndex::Hit>& hits)
+{
+  String s;
+  for (const ProteinIndex::Hit& h : hits) s += String(h.protein_index) + ":" + String(h.position) + " ";
+  return s.trim();
+}
+
+START_TEST(ProteinIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ProteinIndex* ptr = nullptr;
+ProteinIndex* null_ptr = nullptr;
+START_SECTION(ProteinIndex())
+{
+  ptr = new ProteinIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(~ProteinIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+vector<FASTAFile::FASTAEntry> db;
+db.push_back(FASTAFile::FASTAEntry("P1", "", "MKPEPTIDERAAAK*"));
+db.push_back(FASTAFile::FASTAEntry("P2", "", "PEPTIDEKPEPTLDE"));
+db.push_back(FASTAFile::FASTAEntry("P3", "", "AAPEPXIDEBR"));
+db.push_back(FASTAFile::FASTAEntry("P4", "", ""));
+db.push_back(FASTAFile::FASTAEntry("P5", "", "PEJTIDE"));
+
+START_SECTION((template <typename T> void build(FASTAContainer<T>& proteins, bool IL_equivalent)))
+{
+  FASTAContainer<TFI_Vector> proteins(db);
+  ProteinIndex index;
+  index.build(proteins, false);
+  TEST_EQUAL(index.size(), 5)
+  TEST_EQUAL(index.isILEquivalent(), false)
+  TEST_EQUAL(index.getProteinSequence(0), "MKPEPTIDERAAAK") // '*' removed
+  TEST_EQUAL(index.getProteinLength(0), 14)
+  TEST_EQUAL(index.getProteinSequence(3), "")
+  TEST_EQUAL(index.getProteinSequence(4), "PEJTIDE")
+
+  index.build(proteins, true);
+  TEST_EQUAL(index.isILEquivalent(), true)
+  TEST_EQUAL(index.getProteinSequence(1), "PEPTIDEKPEPTIDE")
+  TEST_EQUAL(index.getProteinSequence(4), "PEITIDE")
+}
+END_SECTION
+
+START_SECTION((void search(const String& peptide, Size aaa_max, Size mm_max, std::vector<Hit>& hits) const))
+{
+  FASTAContainer<TFI_Vector> proteins(db);
+  ProteinIndex index;
+  index.build(proteins, false);
+  vector<ProteinIndex::Hit> hits;
+  index.search("PEPTIDE", 0, 0, hits);
+  TEST_EQUAL(toString(hits), "0:2 1:0")
+  index.search("PEPTIDE", 1, 0, hits); // X in P3 stands for T, but J in P5 does not stand for P
+  TEST_EQUAL(toString(hits), "0:2 1:0 2:2")
+  index.search("PEPTIDE", 0, 1, hits);
+  TEST_EQUAL(toString(hits), "0:2 1:0 1:8 2:2 4:0")
+  index.search("PEPTIDED", 2, 0, hits); // X for T and B for D
+  TEST_EQUAL(toString(hits), "2:2")
+  index.search("PEPTIDED", 1, 0, hits);
+  TEST_EQUAL(toString(hits), "")
+  index.search("AAKPEP", 0, 0, hits); // must not match across protein boundaries
+  TEST_EQUAL(toString(hits), "")
+  index.search("", 0, 0, hits);
+  TEST_EQUAL(hits.size(), 0)
+
+  // I/L equivalence: peptides need to be normalized as well
+  index.build(proteins, true);
+  String pep = "PEPTLDE";
+  ProteinIndex::normalizeSequence(pep, true);
+  TEST_EQUAL(pep, "PEPTIDE")
+  index.search(pep, 0, 0, hits);
+  TEST_EQUAL(toString(hits), "0:2 1:0 1:8")
+
+  // compare to brute force on random data
+  std::mt19937 rng(42);
+  const String alphabet = "ACDEFGHIKLMNPQRSTVWYBZXJ";
+  vector<FASTAFile::FASTAEntry> random_db;
+  vector<String> seqs;
+  for (Size i = 0; i < 30; ++i)
+  {
+    String seq;
+    for (Size j = rng() % 60; j > 0; --j) seq += alphabet[rng() % (j % 7 == 0 ? alphabet.size() : 20)];
+    random_db.push_back(FASTAFile::FASTAEntry(String(i), "", seq));
+    seqs.push_back(seq);
+  }
+  FASTAContainer<TFI_Vector> random_proteins(random_db);
+  index.build(random_proteins, false);
+  Size mismatches(0);
+  for (Size n = 0; n < 300; ++n)
+  {
+    const String& prot = seqs[rng() % seqs.size()];
+    if (prot.size() < 4) continue;
+    const Size len = 3 + rng() % std::min<Size>(prot.size() - 3, 10);
+    String pep = prot.substr(rng() % (prot.size() - len + 1), len);
+    for (char& c : pep) if (c == 'B' || c == 'Z' || c == 'X' || c == 'J') c = 'A'; // peptides are unambiguous
+    const Size aaa = rng() % 3, mm = rng() % 2;
+    index.search(pep, aaa, mm, hits);
+    if (toString(hits) != toString(bruteForce(seqs, pep, aaa, mm))) ++mismatches;
+  }
+  TEST_EQUAL(mismatches, 0)
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+{
+  NOT_TESTABLE // tested with load()
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename)))
+{
+  FASTAContainer<TFI_Vector> proteins(db);
+  ProteinIndex index;
+  index.build(proteins, true);
+  String tmp_file;
+  NEW_TMP_FILE(tmp_file);
+  index.store(tmp_file);
+
+  ProteinIndex loaded;
+  loaded.load(tmp_file);
+  TEST_EQUAL(loaded.size(), 5)
+  TEST_EQUAL(loaded.isILEquivalent(), true)
+  for (Size i = 0; i < loaded.size(); ++i)
+  {
+    TEST_EQUAL(loaded.getProteinSequence(i), index.getProteinSequence(i))
+  }
+  vector<ProteinIndex::Hit> hits;
+  loaded.search("PEPTIDE", 0, 0, hits);
+  TEST_EQUAL(toString(hits), "0:2 1:0 1:8")
+
+  loaded.clear();
+  TEST_EQUAL(loaded.empty(), true)
+
+  TEST_EXCEPTION(Exception::FileNotFound, loaded.load("this_file_does_not_exist.idx"))
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+}
+END_SECTION
+
+START_SECTION((static void normalizeSequence(String& sequence, bool IL_equivalent)))
+{
+  String seq = "LIJK*";
+  ProteinIndex::normalizeSequence(seq, false);
+  TEST_EQUAL(seq, "LIJK")
+  ProteinIndex::normalizeSequence(seq, true);
+  TEST_EQUAL(seq, "IIIK")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -146,6 +146,56 @@ START_SECTION((template < typename MapType > void mergeSpectraPrecursors(MapType
 
 END_SECTION
 
+START_SECTION(([EXTRA] template < typename MapType > void mergeSpectraPrecursors(MapType &exp)))
+{
+  // precursors chained within the RT tolerance end up in one block (single linkage)
+  PeakMap exp;
+  double rts[] = {0.0, 4.0, 8.0, 8.0, 30.0};
+  double mzs[] = {500.0, 500.0, 500.0, 600.0, 500.0};
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(2);
+    spec.setRT(rts[i]);
+    Precursor prec;
+    prec.setMZ(mzs[i]);
+    spec.setPrecursors(std::vector<Precursor>(1, prec));
+    spec.push_back(Peak1D(100.0 + i, 10.0));
+    exp.addSpectrum(spec);
+  }
+  MSSpectrum ms1;
+  ms1.setMSLevel(1);
+  ms1.setRT(1.0);
+  exp.addSpectrum(ms1);
+  exp.sortSpectra();
+
+  SpectraMerger merger;
+  Param p(merger.getParameters());
+  p.setValue("mz_binning_width", 0.3);
+  p.setValue("mz_binning_width_unit", "Da");
+  p.setValue("precursor_method:mz_tolerance", 0.01);
+  p.setValue("precursor_method:rt_tolerance", 5.0);
+  merger.setParameters(p);
+  merger.mergeSpectraPrecursors(exp);
+
+  // MS1 + merged (0, 4, 8 s) + two singletons
+  TEST_EQUAL(exp.size(), 4)
+  ABORT_IF(exp.size() != 4)
+  TEST_EQUAL(exp[0].getMSLevel(), 1)
+  TEST_REAL_SIMILAR(exp[1].getRT(), 4.0)
+  TEST_EQUAL(exp[1].size(), 3)
+  TEST_REAL_SIMILAR(exp[2].getRT(), 8.0)
+  TEST_REAL_SIMILAR(exp[2].getPrecursors()[0].getMZ(), 600.0)
+  TEST_REAL_SIMILAR(exp[3].getRT(), 30.0)
+
+  // a single MS2 spectrum is left untouched
+  PeakMap single;
+  single.addSpectrum(exp[3]);
+  merger.mergeSpectraPrecursors(single);
+  TEST_EQUAL(single.size(), 1)
+}
+END_SECTION
+
 START_SECTION((template < typename MapType > void averageGaussian(MapType &exp)))
 	PeakMap exp;
 	MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_3.mzML"), exp);    // profile mode
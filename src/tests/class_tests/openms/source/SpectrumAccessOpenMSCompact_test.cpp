@@ -0,0 +1,262 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCompact.h>
+#include <boost/shared_ptr.hpp>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SpectrumAccessOpenMSCompact, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SpectrumAccessOpenMSCompact* ptr = nullptr;
+SpectrumAccessOpenMSCompact* nullPointer = nullptr;
+
+START_SECTION(SpectrumAccessOpenMSCompact(boost::shared_ptr<MSExperimentType> ms_experiment))
+{
+  boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+  ptr = new SpectrumAccessOpenMSCompact(exp);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+}
+END_SECTION
+
+START_SECTION(~SpectrumAccessOpenMSCompact())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(SpectrumAccessOpenMSCompact(const SpectrumAccessOpenMSCompact & rhs))
+{
+  boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+  MSSpectrum s;
+  exp->addSpectrum(s);
+  SpectrumAccessOpenMSCompact spectrum_acc(exp);
+  SpectrumAccessOpenMSCompact spectrum_acc_copy(spectrum_acc);
+  TEST_EQUAL(spectrum_acc_copy.getNrSpectra(), 1)
+
+  // only the pointer is copied
+  exp->addSpectrum(s);
+  TEST_EQUAL(spectrum_acc_copy.getNrSpectra(), 2)
+}
+END_SECTION
+
+START_SECTION( size_t getNrSpectra() const)
+{
+  {
+    boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+    SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+    TEST_EQUAL(spectrum_acc.getNrSpectra(), 0);
+    TEST_EQUAL(spectrum_acc.getNrChromatograms(), 0);
+  }
+
+  {
+    boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+    MSSpectrum s;
+    MSChromatogram c;
+    exp->addSpectrum(s);
+    exp->addSpectrum(s);
+    exp->addChromatogram(c);
+    SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+    TEST_EQUAL(spectrum_acc.getNrSpectra(), 2);
+    TEST_EQUAL(spectrum_acc.getNrChromatograms(), 1);
+  }
+}
+END_SECTION
+
+START_SECTION ( boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const)
+{
+  boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+  MSSpectrum s;
+  MSChromatogram c;
+  exp->addSpectrum(s);
+  exp->addSpectrum(s);
+  exp->addChromatogram(c);
+  SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> sa_clone = spectrum_acc.lightClone();
+  TEST_EQUAL(sa_clone->getNrSpectra(), 2);
+  TEST_EQUAL(sa_clone->getNrChromatograms(), 1);
+}
+END_SECTION
+
+START_SECTION ( OpenSwath::SpectrumPtr getSpectrumById(int id))
+{
+  {
+    boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+    MSSpectrum s;
+    s.setRT(20);
+    Peak1D p;
+    p.setMZ(20.0);
+    p.setIntensity(22.0);
+    s.push_back(p);
+    p.setMZ(500.25);
+    p.setIntensity(5.0);
+    s.push_back(p);
+    exp->addSpectrum(s);
+    SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+    TEST_EQUAL(spectrum_acc.getNrSpectra(), 1)
+    OpenSwath::SpectrumPtr sptr = spectrum_acc.getSpectrumById(0);
+    TEST_EQUAL(sptr->getMZArray()->data.size(), 2)
+    TEST_EQUAL(sptr->getIntensityArray()->data.size(), 2)
+    TOLERANCE_ABSOLUTE(exp->getCompactSpectrum(0).getMZAccuracy())
+    TEST_REAL_SIMILAR (sptr->getMZArray()->data[0], 20.0)
+    TEST_REAL_SIMILAR (sptr->getMZArray()->data[1], 500.25)
+    TEST_REAL_SIMILAR (sptr->getIntensityArray()->data[0], 22.0)
+    TEST_REAL_SIMILAR (sptr->getIntensityArray()->data[1], 5.0)
+    TEST_EQUAL (sptr->getDataArrays().size(), 2)
+  }
+
+  {
+    boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+    MSSpectrum s;
+    s.setRT(20);
+    Peak1D p;
+    p.setMZ(20.0);
+    p.setIntensity(22.0);
+    s.push_back(p);
+
+    OpenMS::DataArrays::FloatDataArray fda;
+    fda.push_back(50);
+    fda.setName("testName");
+    auto fdas = s.getFloatDataArrays();
+    fdas.push_back(fda);
+    s.setFloatDataArrays(fdas);
+
+    OpenMS::DataArrays::IntegerDataArray ida;
+    ida.push_back(51);
+    ida.setName("testName_integer");
+    auto idas = s.getIntegerDataArrays();
+    idas.push_back(ida);
+    s.setIntegerDataArrays(idas);
+
+    exp->addSpectrum(s);
+    SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+    OpenSwath::SpectrumPtr sptr = spectrum_acc.getSpectrumById(0);
+    TEST_EQUAL (sptr->getDataArrays().size(), 4)
+    TEST_EQUAL (sptr->getDataArrays()[2]->description, "testName")
+    TEST_REAL_SIMILAR (sptr->getDataArrays()[2]->data[0], 50.0)
+    TEST_EQUAL (sptr->getDataArrays()[3]->description, "testName_integer")
+    TEST_REAL_SIMILAR (sptr->getDataArrays()[3]->data[0], 51.0)
+  }
+}
+END_SECTION
+
+START_SECTION ( OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const)
+{
+  boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+  MSSpectrum s;
+  s.setRT(20);
+  s.setMSLevel(2);
+  exp->addSpectrum(s);
+  SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+  OpenSwath::SpectrumMeta spmeta = spectrum_acc.getSpectrumMetaById(0);
+  TEST_REAL_SIMILAR(spmeta.RT, 20.0)
+  TEST_EQUAL(spmeta.ms_level, 2)
+}
+END_SECTION
+
+START_SECTION ( std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const)
+{
+  boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+  MSSpectrum s;
+  s.setRT(20);
+  exp->addSpectrum(s);
+  s.setRT(40);
+  exp->addSpectrum(s);
+  SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+  TEST_EQUAL(spectrum_acc.getSpectraByRT(20, 5.0).size(),  1);
+  TEST_EQUAL(spectrum_acc.getSpectraByRT(20, 25.0).size(), 2);
+  TEST_EQUAL(spectrum_acc.getSpectraByRT(40, 5.0).size(),  1);
+  TEST_EQUAL(spectrum_acc.getSpectraByRT(40, 5.0)[0],  1);
+  TEST_EQUAL(spectrum_acc.getSpectraByRT(40, 25.0).size(), 2);
+  TEST_EQUAL(spectrum_acc.getSpectraByRT(50, 5.0).size(),  0);
+}
+END_SECTION
+
+START_SECTION( size_t getNrChromatograms() const)
+{
+  NOT_TESTABLE // see getNrSpectra
+}
+END_SECTION
+
+START_SECTION(OpenSwath::ChromatogramPtr getChromatogramById(int id))
+{
+  boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+  MSChromatogram c;
+  c.setNativeID("native_id_nr_1");
+  ChromatogramPeak p;
+  p.setRT(20.0);
+  p.setIntensity(22.0);
+  c.push_back(p);
+  exp->addChromatogram(c);
+  SpectrumAccessOpenMSCompact chrom_acc(exp);
+
+  TEST_EQUAL(chrom_acc.getNrChromatograms(), 1)
+  OpenSwath::ChromatogramPtr cptr = chrom_acc.getChromatogramById(0);
+  TEST_REAL_SIMILAR (cptr->getTimeArray()->data[0], 20.0)
+  TEST_REAL_SIMILAR (cptr->getIntensityArray()->data[0], 22.0)
+}
+END_SECTION
+
+START_SECTION(std::string getChromatogramNativeID(int id) const)
+{
+  boost::shared_ptr< CompactMSExperiment > exp ( new CompactMSExperiment );
+  MSChromatogram c;
+  c.setNativeID("native_id_nr_1");
+  exp->addChromatogram(c);
+  SpectrumAccessOpenMSCompact spectrum_acc(exp);
+
+  TEST_EQUAL (spectrum_acc.getChromatogramNativeID(0), "native_id_nr_1")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -407,6 +407,75 @@ START_SECTION(([EXTRA] void consumeSpectrum(MapType::SpectrumType & s)))
 END_SECTION
 }
 
+// Test compact in-memory consumer
+// - shared functions in the base class are already tested, only test the compact storage here
+{
+
+CompactSwathFileConsumer* compact_sfc_ptr = nullptr;
+CompactSwathFileConsumer* compact_sfc_nullPointer = nullptr;
+
+START_SECTION(([EXTRA] CompactSwathFileConsumer()))
+  compact_sfc_ptr = new CompactSwathFileConsumer;
+  TEST_NOT_EQUAL(compact_sfc_ptr, compact_sfc_nullPointer)
+END_SECTION
+
+START_SECTION(([EXTRA] virtual ~CompactSwathFileConsumer()))
+    delete compact_sfc_ptr;
+END_SECTION
+
+START_SECTION(([EXTRA] consumeAndRetrieve))
+{
+  compact_sfc_ptr = new CompactSwathFileConsumer();
+  PeakMap exp;
+  getSwathFile(exp);
+  // Consume all the spectra
+  for (Size i = 0; i < exp.getSpectra().size(); i++)
+  {
+    compact_sfc_ptr->consumeSpectrum(exp.getSpectra()[i]);
+  }
+
+  std::vector< OpenSwath::SwathMap > maps;
+  compact_sfc_ptr->retrieveSwathMaps(maps);
+
+  TEST_EQUAL(maps.size(), 33)
+  TEST_EQUAL(maps[0].ms1, true)
+  TEST_EQUAL(maps[0].sptr->getNrSpectra(), 1)
+  TEST_REAL_SIMILAR(maps[0].sptr->getSpectrumById(0)->getMZArray()->data[0], 100.0)
+  for (Size i = 0; i< 32; i++)
+  {
+    TEST_EQUAL(maps[i+1].ms1, false)
+    TEST_EQUAL(maps[i+1].sptr->getNrSpectra(), 1)
+    TEST_EQUAL(maps[i+1].sptr->getSpectrumById(0)->getMZArray()->data.size(), 1)
+    TEST_REAL_SIMILAR(maps[i+1].sptr->getSpectrumById(0)->getMZArray()->data[0], 101.0+i)
+    TEST_REAL_SIMILAR(maps[i+1].sptr->getSpectrumById(0)->getIntensityArray()->data[0], 201.0+i)
+    TEST_REAL_SIMILAR(maps[i+1].lower, 400+i*25.0)
+    TEST_REAL_SIMILAR(maps[i+1].upper, 425+i*25.0)
+  }
+  delete compact_sfc_ptr;
+}
+END_SECTION
+
+START_SECTION(([EXTRA] consumeAndRetrieve_noMS1))
+{
+  compact_sfc_ptr = new CompactSwathFileConsumer();
+  PeakMap exp;
+  getSwathFile(exp, 32, false);
+  for (Size i = 0; i < exp.getSpectra().size(); i++)
+  {
+    compact_sfc_ptr->consumeSpectrum(exp.getSpectra()[i]);
+  }
+
+  std::vector< OpenSwath::SwathMap > maps;
+  compact_sfc_ptr->retrieveSwathMaps(maps);
+
+  TEST_EQUAL(maps.size(), 32)
+  TEST_EQUAL(maps[0].ms1, false)
+  TEST_REAL_SIMILAR(maps[0].sptr->getSpectrumById(0)->getMZArray()->data[0], 101.0)
+  delete compact_sfc_ptr;
+}
+END_SECTION
+}
+
 // Test cached consumer
 // - shared functions in the base class are already tested, only test I/O here
 {
@@ -462,6 +531,41 @@ START_SECTION(([EXTRA] consumeAndRetrieve))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] consumeAndRetrieve_writerThreads))
+{
+  int nr_swath = 8;
+  std::vector<int> nr_ms2_spectra(nr_swath, 2);
+  cached_sfc_ptr = new CachedSwathFileConsumer("./", "tmp_osw_cached_threads", 2, nr_ms2_spectra);
+  cached_sfc_ptr->setWriterThreads(3, 4);
+  PeakMap exp;
+  getSwathFile(exp, nr_swath);
+  getSwathFile(exp, nr_swath);
+  // Consume all the spectra
+  for (Size i = 0; i < exp.getSpectra().size(); i++)
+  {
+    cached_sfc_ptr->consumeSpectrum(exp.getSpectra()[i]);
+    TEST_EQUAL(exp.getSpectra()[i].empty(), true) // data is removed, as without threads
+  }
+
+  std::vector< OpenSwath::SwathMap > maps;
+  cached_sfc_ptr->retrieveSwathMaps(maps);
+
+  TEST_EQUAL(maps.size(), nr_swath+1) // Swath number + MS1
+  TEST_EQUAL(maps[0].ms1, true)
+  TEST_EQUAL(maps[0].sptr->getNrSpectra(), 2)
+  TEST_REAL_SIMILAR(maps[0].sptr->getSpectrumById(1)->getMZArray()->data[0], 100.0)
+  for (int i = 0; i< nr_swath; i++)
+  {
+    TEST_EQUAL(maps[i+1].ms1, false)
+    TEST_EQUAL(maps[i+1].sptr->getNrSpectra(), 2)
+    TEST_EQUAL(maps[i+1].sptr->getSpectrumById(1)->getMZArray()->data.size(), 1)
+    TEST_REAL_SIMILAR(maps[i+1].sptr->getSpectrumById(1)->getMZArray()->data[0], 101.0+i)
+    TEST_REAL_SIMILAR(maps[i+1].sptr->getSpectrumById(1)->getIntensityArray()->data[0], 201.0+i)
+  }
+  delete cached_sfc_ptr;
+}
+END_SECTION
+
 START_SECTION(([EXTRA] consumeAndRetrieve_noMS1))
 {
   // 2 SWATH should be sufficient for the test
@@ -0,0 +1,180 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SwathMapPrefetcher.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+std::vector<OpenSwath::SwathMap> getMaps(Size nr_maps)
+{
+  std::vector<OpenSwath::SwathMap> maps;
+  for (Size m = 0; m < nr_maps; ++m)
+  {
+    boost::shared_ptr<PeakMap> exp(new PeakMap);
+    for (Size s = 0; s < 10; ++s)
+    {
+      MSSpectrum spec;
+      spec.setRT(s * 3.0);
+      spec.setMSLevel(m == 0 ? 1 : 2);
+      for (Size i = 0; i < 100; ++i)
+      {
+        spec.push_back(Peak1D(400.0 + i, 10.0f * (m + 1)));
+      }
+      exp->addSpectrum(spec);
+    }
+    OpenSwath::SwathMap map(400.0 + m * 25, 425.0 + m * 25, 412.5 + m * 25, m == 0);
+    map.sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+    maps.push_back(map);
+  }
+  return maps;
+}
+
+START_TEST(SwathMapPrefetcher, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+std::vector<OpenSwath::SwathMap> maps = getMaps(6);
+
+SwathMapPrefetcher* ptr = nullptr;
+SwathMapPrefetcher* null_ptr = nullptr;
+START_SECTION((SwathMapPrefetcher(const std::vector<OpenSwath::SwathMap>& swath_maps, Size max_maps, double max_memory_mb = 0.0, Size nr_threads = 1)))
+{
+  ptr = new SwathMapPrefetcher(maps, 2);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION(~SwathMapPrefetcher())
+{
+  // loading is stopped even though no map was released
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumAccessPtr acquire(Size index))
+{
+  SwathMapPrefetcher prefetcher(maps, 2);
+
+  // MS1 maps are passed through
+  TEST_EQUAL(prefetcher.acquire(0) == maps[0].sptr, true)
+
+  for (Size m = 1; m < maps.size(); ++m)
+  {
+    OpenSwath::SpectrumAccessPtr map = prefetcher.acquire(m);
+    TEST_EQUAL(map == maps[m].sptr, false) // in-memory copy
+    TEST_EQUAL(map->getNrSpectra(), 10)
+    OpenSwath::SpectrumPtr spec = map->getSpectrumById(3);
+    TEST_EQUAL(spec->getMZArray()->data.size(), 100)
+    TEST_REAL_SIMILAR(spec->getIntensityArray()->data[0], 10.0 * (m + 1))
+    TEST_REAL_SIMILAR(map->getSpectrumMetaById(3).RT, 9.0)
+    prefetcher.release(m);
+  }
+  TEST_EQUAL(prefetcher.getNrLoadedMaps(), 5)
+
+  TEST_EXCEPTION(Exception::IllegalArgument, prefetcher.acquire(1))
+}
+END_SECTION
+
+START_SECTION(void release(Size index))
+{
+  SwathMapPrefetcher prefetcher(maps, 1);
+  // maps which are not needed can be released without acquiring them
+  prefetcher.release(1);
+  prefetcher.release(2);
+  prefetcher.release(3);
+  OpenSwath::SpectrumAccessPtr map = prefetcher.acquire(4);
+  TEST_EQUAL(map->getNrSpectra(), 10)
+  prefetcher.release(4);
+  map = prefetcher.acquire(5);
+  TEST_EQUAL(map->getNrSpectra(), 10)
+  prefetcher.release(5);
+  TEST_EQUAL(prefetcher.getNrLoadedMaps() <= 5, true)
+  TEST_EQUAL(prefetcher.getNrLoadedMaps() >= 2, true)
+}
+END_SECTION
+
+START_SECTION(Size getPeakMemoryUsage() const)
+{
+  OpenSwath::SpectrumAccessPtr map = maps[1].sptr;
+  Size single_map = SwathMapPrefetcher::estimateMemoryUsage(*map);
+
+  // a budget smaller than one map still allows one map at a time
+  SwathMapPrefetcher prefetcher(maps, 5, 1e-6);
+  for (Size m = 1; m < maps.size(); ++m)
+  {
+    prefetcher.acquire(m);
+    prefetcher.release(m);
+  }
+  TEST_EQUAL(prefetcher.getPeakMemoryUsage(), single_map)
+
+  // without budget, all maps may be held at once
+  SwathMapPrefetcher prefetcher2(maps, 5, 0.0, 2);
+  std::vector<OpenSwath::SpectrumAccessPtr> held;
+  for (Size m = 1; m < maps.size(); ++m)
+  {
+    held.push_back(prefetcher2.acquire(m));
+  }
+  TEST_EQUAL(prefetcher2.getPeakMemoryUsage(), 5 * single_map)
+  for (Size m = 1; m < maps.size(); ++m)
+  {
+    prefetcher2.release(m);
+  }
+}
+END_SECTION
+
+START_SECTION(Size getNrLoadedMaps() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(static Size estimateMemoryUsage(OpenSwath::ISpectrumAccess& map))
+{
+  OpenSwath::SpectrumAccessPtr map = maps[1].sptr;
+  // 10 spectra with 100 peaks (m/z and intensity stored as double)
+  TEST_EQUAL(SwathMapPrefetcher::estimateMemoryUsage(*map) >= 10 * 100 * 2 * sizeof(double), true)
+  TEST_EQUAL(SwathMapPrefetcher::estimateMemoryUsage(*map) < 10 * 100 * 2 * sizeof(double) * 2, true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
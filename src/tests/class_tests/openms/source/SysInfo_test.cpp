@@ -77,4 +77,15 @@ START_SECTION(static bool getProcessMemoryConsumption(size_t& mem_virtual))
 }
 END_SECTION
 
+START_SECTION(static bool getProcessPeakMemoryConsumption(size_t& mem_virtual))
+{
+  size_t peak(0), current(0);
+  TEST_EQUAL(SysInfo::getProcessPeakMemoryConsumption(peak), true);
+  TEST_EQUAL(SysInfo::getProcessMemoryConsumption(current), true);
+  std::cout << "Peak memory consumed: " << peak << " KB" << std::endl;
+  // the peak cannot be smaller than the current working set
+  TEST_EQUAL(peak >= current, true)
+}
+END_SECTION
+
 END_TEST
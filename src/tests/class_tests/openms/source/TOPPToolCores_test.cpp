@@ -0,0 +1,166 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
+///////////////////////////
+
+#include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
+#include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+
+#include <cmath>
+
+using namespace OpenMS;
+using namespace std;
+
+// a single gaussian peak at m/z 500 in profile mode
+PeakMap createProfileMap()
+{
+  MSSpectrum spec;
+  spec.setMSLevel(1);
+  spec.setType(SpectrumSettings::PROFILE);
+  for (Size i = 0; i <= 100; ++i)
+  {
+    double mz = 499.5 + i * 0.01;
+    spec.push_back(Peak1D(mz, 1000.0 * exp(-(mz - 500.0) * (mz - 500.0) / (2 * 0.05 * 0.05))));
+  }
+  PeakMap exp;
+  exp.addSpectrum(spec);
+  return exp;
+}
+
+// the same data, but not sorted by m/z
+PeakMap createUnsortedMap()
+{
+  PeakMap exp = createProfileMap();
+  std::reverse(exp[0].begin(), exp[0].end());
+  return exp;
+}
+
+START_TEST(TOPPToolCores, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION((static TOPPBase::ExitCodes smooth(GaussFilter& filter, PeakMap& exp)))
+{
+  GaussFilter filter;
+  PeakMap empty;
+  TEST_EQUAL(TOPPToolCores::smooth(filter, empty), TOPPBase::INCOMPATIBLE_INPUT_DATA)
+  PeakMap unsorted = createUnsortedMap();
+  TEST_EQUAL(TOPPToolCores::smooth(filter, unsorted), TOPPBase::INCOMPATIBLE_INPUT_DATA)
+  PeakMap exp = createProfileMap();
+  TEST_EQUAL(TOPPToolCores::smooth(filter, exp), TOPPBase::EXECUTION_OK)
+  TEST_EQUAL(exp[0].size(), 101)
+}
+END_SECTION
+
+START_SECTION((static TOPPBase::ExitCodes smooth(SavitzkyGolayFilter& filter, PeakMap& exp)))
+{
+  SavitzkyGolayFilter filter;
+  PeakMap empty;
+  TEST_EQUAL(TOPPToolCores::smooth(filter, empty), TOPPBase::INCOMPATIBLE_INPUT_DATA)
+  PeakMap unsorted = createUnsortedMap();
+  TEST_EQUAL(TOPPToolCores::smooth(filter, unsorted), TOPPBase::INCOMPATIBLE_INPUT_DATA)
+  PeakMap exp = createProfileMap();
+  TEST_EQUAL(TOPPToolCores::smooth(filter, exp), TOPPBase::EXECUTION_OK)
+  TEST_EQUAL(exp[0].size(), 101)
+}
+END_SECTION
+
+START_SECTION((static TOPPBase::ExitCodes pickPeaks(const PeakPickerHiRes& picker, const PeakMap& input, PeakMap& output, bool check_spectrum_type)))
+{
+  PeakPickerHiRes picker;
+  PeakMap output;
+  TEST_EQUAL(TOPPToolCores::pickPeaks(picker, createUnsortedMap(), output, false), TOPPBase::INCOMPATIBLE_INPUT_DATA)
+  TEST_EQUAL(TOPPToolCores::pickPeaks(picker, createProfileMap(), output, false), TOPPBase::EXECUTION_OK)
+  TEST_EQUAL(output.size(), 1)
+  ABORT_IF(output.size() != 1)
+  TEST_EQUAL(output[0].size(), 1)
+  ABORT_IF(output[0].size() != 1)
+  TEST_REAL_SIMILAR(output[0][0].getMZ(), 500.0)
+}
+END_SECTION
+
+START_SECTION((static void findFeatures(PeakMap& exp, const String& in, const FeatureMap& seeds, const Param& algorithm_param, bool force, bool test_mode, Int debug_level, ProgressLogger::LogType log_type, FeatureMap& features)))
+{
+  FeatureMap seeds, features;
+  PeakMap empty;
+  TEST_EXCEPTION(Exception::FileEmpty, TOPPToolCores::findFeatures(empty, "in.mzML", seeds, Param(), false, true, 0, ProgressLogger::NONE, features))
+  // profile data is rejected unless forced
+  PeakMap exp = createProfileMap();
+  TEST_EXCEPTION(Exception::IllegalArgument, TOPPToolCores::findFeatures(exp, "in.mzML", seeds, Param(), false, true, 0, ProgressLogger::NONE, features))
+  // fragment spectra are removed
+  exp = createProfileMap();
+  exp[0].setMSLevel(2);
+  TEST_EXCEPTION(Exception::FileEmpty, TOPPToolCores::findFeatures(exp, "in.mzML", seeds, Param(), true, true, 0, ProgressLogger::NONE, features))
+}
+END_SECTION
+
+START_SECTION((static void storeMzQuantML(const String& filename, const FeatureMap& features, const PeakMap& exp)))
+{
+  NOT_TESTABLE // tested by the FeatureFinderCentroided TOPP test
+}
+END_SECTION
+
+START_SECTION((static TOPPBase::ExitCodes normalize(ConsensusMap& map, const String& algorithm_type, double ratio_threshold, const String& accession_filter, const String& description_filter)))
+{
+  ConsensusMap map;
+  TEST_EQUAL(TOPPToolCores::normalize(map, "unknown", 0.67, "", ""), TOPPBase::ILLEGAL_PARAMETERS)
+}
+END_SECTION
+
+START_SECTION((static bool findDatabase(String& db_name)))
+{
+  String db_name = OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta");
+  TEST_EQUAL(TOPPToolCores::findDatabase(db_name), true)
+  TEST_EQUAL(db_name, OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"))
+  db_name = "this_database_does_not_exist.fasta";
+  TEST_EQUAL(TOPPToolCores::findDatabase(db_name), false)
+}
+END_SECTION
+
+START_SECTION((static TOPPBase::ExitCodes indexPeptides(PeptideIndexing& indexer, const String& db_name, const String& index_name, bool compute_coverage, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids)))
+{
+  NOT_TESTABLE // tested by the PeptideIndexer TOPP tests
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -453,6 +453,86 @@ START_SECTION(void getSpectrum(PeakSpectrum& spec, const AASequence& peptide, In
 
 END_SECTION
 
+START_SECTION(static void getPrefixMasses(const AASequence& peptide, std::vector<double>& prefix_masses))
+{
+  std::vector<double> prefix_masses;
+  TheoreticalSpectrumGenerator::getPrefixMasses(peptide, prefix_masses);
+  TEST_EQUAL(prefix_masses.size(), 8)
+  TEST_REAL_SIMILAR(prefix_masses[0], 0.0)
+  TEST_REAL_SIMILAR(prefix_masses[1], peptide[0].getMonoWeight(Residue::Internal))
+  TEST_REAL_SIMILAR(prefix_masses[7], peptide.getMonoWeight(Residue::Internal))
+
+  // terminal modifications
+  AASequence modified = AASequence::fromString(".(Acetyl)IFSQVGK.(Amidated)");
+  TheoreticalSpectrumGenerator::getPrefixMasses(modified, prefix_masses);
+  TEST_EQUAL(prefix_masses.size(), 8)
+  TEST_REAL_SIMILAR(prefix_masses[0], 42.010565)
+  TEST_REAL_SIMILAR(prefix_masses[7], peptide.getMonoWeight(Residue::Internal) + 42.010565 - 0.984016)
+
+  TheoreticalSpectrumGenerator::getPrefixMasses(AASequence(), prefix_masses);
+  TEST_EQUAL(prefix_masses.size(), 1)
+}
+END_SECTION
+
+START_SECTION(void getFragmentMZs(const std::vector<double>& prefix_masses, Int min_charge, Int max_charge, std::vector<double>& mzs, std::vector<char>& ion_types) const)
+{
+  std::vector<double> prefix_masses, mzs;
+  std::vector<char> ion_types;
+  TheoreticalSpectrumGenerator::getPrefixMasses(peptide, prefix_masses);
+  TheoreticalSpectrumGenerator default_gen;
+  default_gen.getFragmentMZs(prefix_masses, 1, 1, mzs, ion_types);
+  TEST_EQUAL(mzs.size(), 11)
+  TEST_EQUAL(ion_types.size(), 11)
+
+  TOLERANCE_ABSOLUTE(0.001)
+  double result[] = {147.113, 204.135, 261.16, 303.203, 348.192, 431.262, 476.251, 518.294, 575.319, 632.341, 665.362};
+  char result_types[] = {'y', 'y', 'b', 'y', 'b', 'y', 'b', 'y', 'b', 'b', 'y'};
+  for (Size i = 0; i != mzs.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(mzs[i], result[i])
+    TEST_EQUAL(ion_types[i], result_types[i])
+  }
+
+  // same positions as getSpectrum for all ion types, several charges and modified peptides
+  TheoreticalSpectrumGenerator t_gen;
+  Param params = t_gen.getParameters();
+  params.setValue("add_a_ions", "true");
+  params.setValue("add_c_ions", "true");
+  params.setValue("add_x_ions", "true");
+  params.setValue("add_z_ions", "true");
+  params.setValue("add_first_prefix_ion", "true");
+  params.setValue("add_metainfo", "true");
+  t_gen.setParameters(params);
+
+  AASequence modified = AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)");
+  PeakSpectrum spec;
+  t_gen.getSpectrum(spec, modified, 1, 3);
+  TheoreticalSpectrumGenerator::getPrefixMasses(modified, prefix_masses);
+  t_gen.getFragmentMZs(prefix_masses, 1, 3, mzs, ion_types);
+  TEST_EQUAL(mzs.size(), spec.size())
+  ABORT_IF(mzs.size() != spec.size())
+  TOLERANCE_ABSOLUTE(1e-6)
+  for (Size i = 0; i != mzs.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(mzs[i], spec[i].getMZ())
+    TEST_EQUAL(ion_types[i], spec.getStringDataArrays()[0][i][0])
+  }
+
+  // reusing the arrays
+  TheoreticalSpectrumGenerator::getPrefixMasses(AASequence::fromString("PEPTIDE"), prefix_masses);
+  t_gen.getFragmentMZs(prefix_masses, 1, 1, mzs, ion_types);
+  TEST_EQUAL(mzs.size(), 36)
+  TEST_EQUAL(std::is_sorted(mzs.begin(), mzs.end()), true)
+
+  // empty peptide, single amino acid
+  TheoreticalSpectrumGenerator::getPrefixMasses(AASequence(), prefix_masses);
+  t_gen.getFragmentMZs(prefix_masses, 1, 1, mzs, ion_types);
+  TEST_EQUAL(mzs.size(), 0)
+  TheoreticalSpectrumGenerator::getPrefixMasses(AASequence::fromString("K"), prefix_masses);
+  TEST_EXCEPTION(Exception::InvalidSize, t_gen.getFragmentMZs(prefix_masses, 1, 1, mzs, ion_types))
+}
+END_SECTION
+
 START_SECTION(([EXTRA] bugfix test where losses lead to formulae with negative element frequencies))
 {
   // this tests for the loss of CONH2 on Arginine, however it is not clear how
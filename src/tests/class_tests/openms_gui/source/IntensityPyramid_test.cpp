@@ -0,0 +1,210 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+
+#include <OpenMS/VISUAL/IntensityPyramid.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(IntensityPyramid, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// four MS1 spectra and one MS2 spectrum, which is ignored
+PeakMap exp;
+double rts[] = {0.0, 1.0, 2.0, 3.0};
+double mzs[][3] = {{100.0, 150.0, 200.0}, {100.0, 200.0, 0.0}, {120.0, 0.0, 0.0}, {100.0, 199.0, 0.0}};
+float ints[][3] = {{1.0, 2.0, 3.0}, {4.0, 5.0, 0.0}, {6.0, 0.0, 0.0}, {7.0, 8.0, 0.0}};
+Size sizes[] = {3, 2, 1, 2};
+for (Size i = 0; i < 4; ++i)
+{
+  MSSpectrum spec;
+  spec.setRT(rts[i]);
+  spec.setMSLevel(1);
+  for (Size j = 0; j < sizes[i]; ++j)
+  {
+    spec.push_back(Peak1D(mzs[i][j], ints[i][j]));
+  }
+  exp.addSpectrum(spec);
+  if (i == 1)
+  {
+    MSSpectrum ms2;
+    ms2.setRT(1.5);
+    ms2.setMSLevel(2);
+    ms2.push_back(Peak1D(150.0, 100.0));
+    exp.addSpectrum(ms2);
+  }
+}
+
+IntensityPyramid* ptr = nullptr;
+IntensityPyramid* null_ptr = nullptr;
+START_SECTION((IntensityPyramid()))
+{
+  ptr = new IntensityPyramid();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getLevelCount(), 0)
+}
+END_SECTION
+
+START_SECTION((~IntensityPyramid()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void build(const PeakMap& exp, Size max_rt_bins = 2048, Size max_mz_bins = 4096, Size min_bins = 64)))
+{
+  IntensityPyramid pyramid;
+  pyramid.build(exp, 4, 4, 1);
+  TEST_EQUAL(pyramid.empty(), false)
+  TEST_EQUAL(pyramid.getLevelCount(), 3)
+  TEST_REAL_SIMILAR(pyramid.getMinRT(), 0.0)
+  TEST_REAL_SIMILAR(pyramid.getMaxRT(), 3.0)
+  TEST_REAL_SIMILAR(pyramid.getMinMZ(), 100.0)
+  TEST_REAL_SIMILAR(pyramid.getMaxMZ(), 200.0)
+
+  const IntensityPyramid::Level& l0 = pyramid.getLevel(0);
+  TEST_EQUAL(l0.rt_bins, 4)
+  TEST_EQUAL(l0.mz_bins, 4)
+  TEST_REAL_SIMILAR(l0.rt_bin_size, 0.75)
+  TEST_REAL_SIMILAR(l0.mz_bin_size, 25.0)
+  TEST_REAL_SIMILAR(l0.getMax(0, 0), 1.0)
+  TEST_REAL_SIMILAR(l0.getMax(0, 2), 2.0)
+  TEST_REAL_SIMILAR(l0.getMax(0, 3), 3.0)
+  TEST_REAL_SIMILAR(l0.getMax(0, 1), -1.0)
+  TEST_REAL_SIMILAR(l0.getMax(1, 2), -1.0) // MS2 peak is not included
+  TEST_REAL_SIMILAR(l0.getMax(2, 0), 6.0)
+  TEST_REAL_SIMILAR(l0.getMax(3, 3), 8.0)
+
+  const IntensityPyramid::Level& l1 = pyramid.getLevel(1);
+  TEST_EQUAL(l1.rt_bins, 2)
+  TEST_EQUAL(l1.mz_bins, 2)
+  TEST_REAL_SIMILAR(l1.getMax(0, 0), 4.0)
+  TEST_REAL_SIMILAR(l1.getSum(0, 0), 5.0)
+  TEST_REAL_SIMILAR(l1.getMax(0, 1), 5.0)
+  TEST_REAL_SIMILAR(l1.getSum(0, 1), 10.0)
+  TEST_REAL_SIMILAR(l1.getMax(1, 0), 7.0)
+  TEST_REAL_SIMILAR(l1.getSum(1, 0), 13.0)
+  TEST_REAL_SIMILAR(l1.getMax(1, 1), 8.0)
+
+  const IntensityPyramid::Level& l2 = pyramid.getLevel(2);
+  TEST_EQUAL(l2.rt_bins, 1)
+  TEST_EQUAL(l2.mz_bins, 1)
+  TEST_REAL_SIMILAR(l2.getMax(0, 0), 8.0)
+  TEST_REAL_SIMILAR(l2.getSum(0, 0), 36.0)
+
+  // RT bins are capped at the number of MS1 spectra
+  pyramid.build(exp, 100, 8, 2);
+  TEST_EQUAL(pyramid.getLevel(0).rt_bins, 4)
+  TEST_EQUAL(pyramid.getLevel(0).mz_bins, 8)
+  TEST_EQUAL(pyramid.getLevelCount(), 2)
+
+  // no MS1 data
+  pyramid.build(PeakMap());
+  TEST_EQUAL(pyramid.empty(), true)
+}
+END_SECTION
+
+START_SECTION((Size selectLevel(double rt_extent, double mz_extent) const))
+{
+  IntensityPyramid pyramid;
+  TEST_EQUAL(pyramid.selectLevel(1.0, 1.0), 0)
+  pyramid.build(exp, 4, 4, 1);
+  TEST_EQUAL(pyramid.selectLevel(1.0, 30.0), 0)
+  TEST_EQUAL(pyramid.selectLevel(2.0, 60.0), 1)
+  TEST_EQUAL(pyramid.selectLevel(2.0, 30.0), 0)
+  TEST_EQUAL(pyramid.selectLevel(10.0, 1000.0), 2)
+  TEST_EQUAL(pyramid.selectLevel(0.5, 100.0), 3) // too coarse: raw data
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  IntensityPyramid pyramid;
+  pyramid.build(exp, 4, 4, 1);
+  pyramid.clear();
+  TEST_EQUAL(pyramid.empty(), true)
+  TEST_REAL_SIMILAR(pyramid.getMaxRT(), 0.0)
+}
+END_SECTION
+
+START_SECTION((bool store(const String& filename, UInt64 stamp) const))
+{
+  NOT_TESTABLE // see load
+}
+END_SECTION
+
+START_SECTION((bool load(const String& filename, UInt64 stamp)))
+{
+  IntensityPyramid pyramid, loaded;
+  pyramid.build(exp, 4, 4, 1);
+  String filename;
+  NEW_TMP_FILE(filename)
+  TEST_EQUAL(pyramid.store(filename, 42), true)
+
+  // stamp mismatch
+  TEST_EQUAL(loaded.load(filename, 43), false)
+  TEST_EQUAL(loaded.empty(), true)
+
+  TEST_EQUAL(loaded.load(filename, 42), true)
+  TEST_EQUAL(loaded.getLevelCount(), pyramid.getLevelCount())
+  TEST_REAL_SIMILAR(loaded.getMaxMZ(), 200.0)
+  for (Size i = 0; i < loaded.getLevelCount(); ++i)
+  {
+    TEST_EQUAL(loaded.getLevel(i).rt_bins, pyramid.getLevel(i).rt_bins)
+    TEST_EQUAL(loaded.getLevel(i).mz_bins, pyramid.getLevel(i).mz_bins)
+    TEST_EQUAL(loaded.getLevel(i).max_intensity == pyramid.getLevel(i).max_intensity, true)
+    TEST_EQUAL(loaded.getLevel(i).sum_intensity == pyramid.getLevel(i).sum_intensity, true)
+  }
+
+  TEST_EQUAL(loaded.load("IntensityPyramid_does_not_exist.pyramid", 42), false)
+}
+END_SECTION
+
+START_SECTION((static String cacheFilename(const String& filename)))
+{
+  TEST_STRING_EQUAL(IntensityPyramid::cacheFilename("/data/run.mzML"), "/data/run.mzML.pyramid")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
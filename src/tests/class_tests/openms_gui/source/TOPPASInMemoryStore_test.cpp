@@ -0,0 +1,260 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/VISUAL/TOPPASInMemoryStore.h>
+///////////////////////////
+
+#include <OpenMS/SYSTEM/File.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(TOPPASInMemoryStore, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+TOPPASInMemoryStore* ptr = nullptr;
+TOPPASInMemoryStore* null_ptr = nullptr;
+START_SECTION(TOPPASInMemoryStore())
+{
+  ptr = new TOPPASInMemoryStore();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_REAL_SIMILAR(ptr->getMemoryLimit(), 0.0)
+  TEST_REAL_SIMILAR(ptr->getMemoryUsage(), 0.0)
+}
+END_SECTION
+
+START_SECTION(~TOPPASInMemoryStore())
+{
+  delete ptr;
+}
+END_SECTION
+
+PeakMap exp;
+exp.resize(2);
+for (Size i = 0; i < exp.size(); ++i)
+{
+  exp[i].setRT(10.0 * (i + 1));
+  exp[i].setMSLevel(1);
+  for (Size j = 0; j < 50; ++j)
+  {
+    Peak1D p;
+    p.setMZ(400.0 + j);
+    p.setIntensity(100.0f);
+    exp[i].push_back(p);
+  }
+}
+
+START_SECTION(void setMemoryLimit(double memory_mb))
+{
+  TOPPASInMemoryStore store;
+  store.setMemoryLimit(100.0);
+  TEST_REAL_SIMILAR(store.getMemoryLimit(), 100.0)
+  store.setMemoryLimit(-1.0);
+  TEST_REAL_SIMILAR(store.getMemoryLimit(), 0.0)
+}
+END_SECTION
+
+START_SECTION(double getMemoryLimit() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(double getMemoryUsage() const)
+{
+  TOPPASInMemoryStore store;
+  PeakMap data = exp;
+  store.store("a.mzML", data, 1);
+  TEST_EQUAL(store.getMemoryUsage() > 0.0, true)
+  store.load("a.mzML", data);
+  TEST_REAL_SIMILAR(store.getMemoryUsage(), 0.0)
+}
+END_SECTION
+
+START_SECTION(bool contains(const String& filename) const)
+{
+  TOPPASInMemoryStore store;
+  TEST_EQUAL(store.contains("a.featureXML"), false)
+  FeatureMap data;
+  data.push_back(Feature());
+  store.store("a.featureXML", data, 1);
+  TEST_EQUAL(store.contains("a.featureXML"), true)
+  TEST_EQUAL(store.contains("b.featureXML"), false)
+}
+END_SECTION
+
+START_SECTION(void store(const String& filename, PeakMap& data, Size readers))
+{
+  TOPPASInMemoryStore store;
+  PeakMap data = exp;
+  store.store("a.mzML", data, 2);
+  TEST_EQUAL(data.size(), 0) // swapped into the store
+  TEST_EQUAL(store.contains("a.mzML"), true)
+
+  // the first reader gets a copy, the last one the data itself
+  PeakMap first, second;
+  store.load("a.mzML", first);
+  TEST_EQUAL(first.size(), 2)
+  TEST_EQUAL(first[1].size(), 50)
+  TEST_EQUAL(store.contains("a.mzML"), true)
+  store.load("a.mzML", second);
+  TEST_EQUAL(second.size(), 2)
+  TEST_REAL_SIMILAR(second[1].getRT(), 20.0)
+  TEST_EQUAL(second.getLoadedFilePath().hasSuffix("a.mzML"), true)
+  TEST_EQUAL(store.contains("a.mzML"), false)
+
+  // no reader in memory: the data is written to the file
+  String filename;
+  NEW_TMP_FILE(filename)
+  data = exp;
+  store.store(filename, data, 0);
+  TEST_EQUAL(store.contains(filename), false)
+  TEST_EQUAL(File::exists(filename), true)
+  store.load(filename, first);
+  TEST_EQUAL(first.size(), 2)
+  TEST_EQUAL(first[0].size(), 50)
+
+  // data exceeding the memory limit is written to the file
+  NEW_TMP_FILE(filename)
+  store.setMemoryLimit(1e-6);
+  data = exp;
+  store.store(filename, data, 1);
+  TEST_EQUAL(store.contains(filename), false)
+  TEST_EQUAL(File::exists(filename), true)
+  TEST_REAL_SIMILAR(store.getMemoryUsage(), 0.0)
+}
+END_SECTION
+
+START_SECTION(void store(const String& filename, FeatureMap& data, Size readers))
+{
+  TOPPASInMemoryStore store;
+  FeatureMap data;
+  Feature f;
+  f.setRT(12.0);
+  data.push_back(f);
+  data.push_back(f);
+  store.store("a.featureXML", data, 2);
+  TEST_EQUAL(data.size(), 0)
+
+  FeatureMap first, second;
+  store.load("a.featureXML", first);
+  store.load("a.featureXML", second);
+  TEST_EQUAL(first.size(), 2)
+  TEST_EQUAL(second.size(), 2)
+  TEST_REAL_SIMILAR(second[0].getRT(), 12.0)
+  TEST_EQUAL(store.contains("a.featureXML"), false)
+}
+END_SECTION
+
+START_SECTION(void store(const String& filename, ConsensusMap& data, Size readers))
+{
+  TOPPASInMemoryStore store;
+  ConsensusMap data;
+  data.push_back(ConsensusFeature());
+  store.store("a.consensusXML", data, 1);
+  TEST_EQUAL(data.size(), 0)
+  TEST_EQUAL(store.contains("a.consensusXML"), true)
+
+  store.load("a.consensusXML", data);
+  TEST_EQUAL(data.size(), 1)
+  TEST_EQUAL(store.contains("a.consensusXML"), false)
+}
+END_SECTION
+
+START_SECTION(void store(const String& filename, IdentificationData& data, Size readers))
+{
+  TOPPASInMemoryStore store;
+  TOPPASInMemoryStore::IdentificationData data;
+  data.proteins.resize(1);
+  data.peptides.resize(3);
+  store.store("a.idXML", data, 2);
+  TEST_EQUAL(data.peptides.size(), 0)
+
+  TOPPASInMemoryStore::IdentificationData first, second;
+  store.load("a.idXML", first);
+  store.load("a.idXML", second);
+  TEST_EQUAL(first.proteins.size(), 1)
+  TEST_EQUAL(first.peptides.size(), 3)
+  TEST_EQUAL(second.peptides.size(), 3)
+  TEST_EQUAL(store.contains("a.idXML"), false)
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename, PeakMap& data))
+{
+  TOPPASInMemoryStore store;
+  PeakMap data;
+  TEST_EXCEPTION(Exception::FileNotFound, store.load("does_not_exist.mzML", data))
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename, FeatureMap& data))
+{
+  NOT_TESTABLE // tested with store()
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename, ConsensusMap& data))
+{
+  NOT_TESTABLE // tested with store()
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename, IdentificationData& data))
+{
+  NOT_TESTABLE // tested with store()
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  TOPPASInMemoryStore store;
+  PeakMap data = exp;
+  store.store("a.mzML", data, 1);
+  store.clear();
+  TEST_EQUAL(store.contains("a.mzML"), false)
+  TEST_REAL_SIMILAR(store.getMemoryUsage(), 0.0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
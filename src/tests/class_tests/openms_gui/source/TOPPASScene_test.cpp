@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Johannes Veit $
+// $Authors: Johannes Veit $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/VISUAL/TOPPASScene.h>
+///////////////////////////
+
+#include <OpenMS/VISUAL/TOPPASEdge.h>
+#include <OpenMS/VISUAL/TOPPASMergerVertex.h>
+#include <OpenMS/VISUAL/TOPPASToolVertex.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QApplication>
+
+using namespace OpenMS;
+using namespace std;
+
+/// records the order in which the scene starts its processes (instead of running anything)
+class RecordingProcess :
+  public FakeProcess
+{
+public:
+  RecordingProcess(const QString& name, QStringList& started) :
+    name_(name),
+    started_(started)
+  {
+  }
+
+  void start(const QString& /*program*/, const QStringList& /*arguments*/, OpenMode /*mode*/ = ReadWrite) override
+  {
+    started_ << name_;
+  }
+
+private:
+  QString name_;
+  QStringList& started_;
+};
+
+/// connects @p source to @p target
+void connectVertices(TOPPASScene& scene, TOPPASVertex* source, TOPPASVertex* target)
+{
+  TOPPASEdge* edge = new TOPPASEdge();
+  edge->setSourceVertex(source);
+  edge->setTargetVertex(target);
+  source->addOutEdge(edge);
+  target->addInEdge(edge);
+  scene.addEdge(edge);
+}
+
+START_TEST(TOPPASScene, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+{
+  qputenv("QT_QPA_PLATFORM", "offscreen"); // no display required
+}
+QApplication app(argc, argv);
+
+TOPPASScene* ptr = nullptr;
+TOPPASScene* null_ptr = nullptr;
+START_SECTION((TOPPASScene(QObject* parent, const QString& tmp_path, bool gui = true)))
+{
+  ptr = new TOPPASScene(nullptr, File::getTempDirectory().toQString(), false);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isPipelineRunning(), false)
+}
+END_SECTION
+
+START_SECTION((~TOPPASScene()))
+{
+  delete ptr;
+}
+END_SECTION
+
+// a small workflow with a diamond and a merger node:
+//
+//   t1 -> t2 -> t4 -> t5      t6      t7 -> merger -> t8
+//    \--> t3 --/
+//
+TOPPASScene scene(nullptr, File::getTempDirectory().toQString(), false);
+std::vector<TOPPASToolVertex*> t(9, nullptr);
+for (Size i = 1; i < t.size(); ++i)
+{
+  t[i] = new TOPPASToolVertex("FileInfo");
+  scene.addVertex(t[i]);
+}
+TOPPASMergerVertex* merger = new TOPPASMergerVertex(true);
+scene.addVertex(merger);
+connectVertices(scene, t[1], t[2]);
+connectVertices(scene, t[1], t[3]);
+connectVertices(scene, t[2], t[4]);
+connectVertices(scene, t[3], t[4]);
+connectVertices(scene, t[4], t[5]);
+connectVertices(scene, t[7], merger);
+connectVertices(scene, merger, t[8]);
+scene.topoSort();
+
+START_SECTION((void setPipelineRunning(bool b = true)))
+{
+  // critical path lengths are computed when the pipeline is started
+  scene.setPipelineRunning(true);
+  TEST_EQUAL(scene.isPipelineRunning(), true)
+  TEST_EQUAL(t[1]->getCriticalPathLength(), 4)
+  TEST_EQUAL(t[2]->getCriticalPathLength(), 3)
+  TEST_EQUAL(t[3]->getCriticalPathLength(), 3)
+  TEST_EQUAL(t[4]->getCriticalPathLength(), 2)
+  TEST_EQUAL(t[5]->getCriticalPathLength(), 1)
+  TEST_EQUAL(t[6]->getCriticalPathLength(), 1)
+  TEST_EQUAL(t[7]->getCriticalPathLength(), 2) // merger nodes do not count
+  TEST_EQUAL(t[8]->getCriticalPathLength(), 1)
+}
+END_SECTION
+
+START_SECTION((void runNextProcess()))
+{
+  QStringList started;
+  RecordingProcess p6("t6", started), p7("t7", started), p1("t1", started);
+  scene.setAllowedThreads(1);
+  // enqueue the sources of the workflow, shortest critical path first
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p6, "", QStringList(), t[6], 1, 0.0, t[6]->getCriticalPathLength()));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p7, "", QStringList(), t[7], 1, 0.0, t[7]->getCriticalPathLength()));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p1, "", QStringList(), t[1], 1, 0.0, t[1]->getCriticalPathLength()));
+
+  // only one core: the process with the longest critical path behind it is started first
+  scene.runNextProcess();
+  TEST_STRING_EQUAL(String(started.join(",")), "t1")
+  scene.processFinished(&p1);
+  TEST_STRING_EQUAL(String(started.join(",")), "t1,t7")
+  scene.processFinished(&p7);
+  TEST_STRING_EQUAL(String(started.join(",")), "t1,t7,t6")
+  scene.processFinished(&p6);
+
+  // equal priorities: first come, first served
+  started.clear();
+  RecordingProcess p2("t2", started), p3("t3", started);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p3, "", QStringList(), t[3], 1, 0.0, t[3]->getCriticalPathLength()));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p2, "", QStringList(), t[2], 1, 0.0, t[2]->getCriticalPathLength()));
+  scene.runNextProcess();
+  scene.processFinished(&p3);
+  scene.processFinished(&p2);
+  TEST_STRING_EQUAL(String(started.join(",")), "t3,t2")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
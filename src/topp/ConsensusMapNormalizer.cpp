@@ -36,10 +36,7 @@
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
-
-#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmThreshold.h>
-#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmMedian.h>
-#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmQuantile.h>
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -130,32 +127,10 @@ protected:
     infile.load(in, map);
 
     //map normalization
-    if (algo_type == "robust_regression")
-    {
-      map.sortBySize();
-      vector<double> results = ConsensusMapNormalizerAlgorithmThreshold::computeCorrelation(map, ratio_threshold, acc_filter, desc_filter);
-      ConsensusMapNormalizerAlgorithmThreshold::normalizeMaps(map, results);
-    }
-    else if (algo_type == "median")
-    {
-      ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(map, ConsensusMapNormalizerAlgorithmMedian::NM_SCALE, acc_filter, desc_filter);
-    }
-    else if (algo_type == "median_shift")
-    {
-      ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(map, ConsensusMapNormalizerAlgorithmMedian::NM_SHIFT, acc_filter, desc_filter);
-    }
-    else if (algo_type == "quantile")
-    {
-      if (acc_filter != "" || desc_filter != "")
-      {
-        OPENMS_LOG_WARN << endl << "NOTE: Accession / description filtering is not supported in quantile normalization mode. Ignoring filters." << endl << endl;
-      }
-      ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(map);
-    }
-    else
+    ExitCodes result = TOPPToolCores::normalize(map, algo_type, ratio_threshold, acc_filter, desc_filter);
+    if (result != EXECUTION_OK)
     {
-      cerr << "Unknown algorithm type  '" << algo_type.c_str() << "'." << endl;
-      return ILLEGAL_PARAMETERS;
+      return result;
     }
 
     //annotate output with data processing info and save output file
@@ -41,6 +41,7 @@
 
 #include <QApplication>
 #include <QtCore/QDir>
+#include <QtCore/QStorageInfo>
 
 #include <iostream>
 
@@ -83,6 +84,34 @@ using namespace std;
 </PARAMETERS>
   \endcode
 
+  <B> Intermediate files </B>
+
+  By default, all tools of the workflow run as separate processes, which exchange data through intermediate files
+  in a temporary directory. With the <TT>-in_memory</TT> flag, tools which are backed by an algorithm class
+  (currently NoiseFilterGaussian, NoiseFilterSGolay, PeakPickerHiRes, FeatureFinderCentroided,
+  ConsensusMapNormalizer and PeptideIndexer) run inside the ExecutePipeline process instead, one after the other.
+  Their results (peak maps, feature maps, consensus maps and identifications) are handed to the next of these tools
+  in memory, without writing or parsing a file. An intermediate result is written to a file nevertheless if it is
+  also read by an output node, a merger/splitter or a tool which runs as an executable (e.g. external tools), if
+  its tool recycles its output, or if keeping it would exceed <TT>-in_memory_limit</TT> MB.
+  The files which are still written are placed on a memory-backed file system (<TT>-memory_dir</TT>, e.g.
+  <TT>/dev/shm</TT> on Linux). If that directory is not available or has less than <TT>-memory_min_free</TT> MB
+  of free space, the regular temporary directory is used instead.
+
+  <B> Parallel execution </B>
+
+  Independent branches of the workflow and the rounds (one per input file) of each tool are run concurrently.
+  <TT>-num_cores</TT> is the number of CPU cores available to the workflow; a tool occupies as many of them as its
+  <TT>threads</TT> parameter requests. With <TT>-memory_limit</TT>, tools are only started if their estimated
+  memory (the size of their input files, or the peak memory observed for previous rounds of the same tool) fits
+  into the remaining budget. Among the tools ready to run, those with the longest chain of dependent tools behind
+  them (the critical path) are started first.
+
+  @deprecated Up to OpenMS 2.4, the parallelism was given by @p num_jobs as the number of tools running at the same
+  time, regardless of their @p threads parameter. It has been replaced by @p num_cores, which is a budget of CPU
+  cores shared by all running tools. @p num_jobs is still accepted as an alias of @p num_cores (a tool with
+  @p threads = 4 now counts as four jobs), but will be removed in a future version.
+
     <B>The command line parameters of this tool are:</B>
     @verbinclude TOPP_ExecutePipeline.cli
     <B>INI file documentation of this tool:</B>
@@ -110,8 +139,42 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("toppas"));
     registerStringOption_("out_dir", "<directory>", "", "Directory for output files (default: user's home directory)", false);
     registerStringOption_("resource_file", "<file>", "", "A TOPPAS resource file (*.trf) specifying the files this workflow is to be applied to", false);
-    registerIntOption_("num_jobs", "<integer>", 1, "Maximum number of jobs running in parallel", false, false);
+    registerIntOption_("num_cores", "<integer>", 1, "Maximum number of CPU cores used by the jobs running in parallel (each tool occupies as many cores as given by its 'threads' parameter)", false, false);
+    setMinInt_("num_cores", 1);
+    registerIntOption_("num_jobs", "<integer>", 1, "Deprecated alias of 'num_cores' (used if 'num_cores' is not set). Up to OpenMS 2.4, this was the number of tools running in parallel regardless of their 'threads' parameter.", false, true);
     setMinInt_("num_jobs", 1);
+    registerDoubleOption_("memory_limit", "<MB>", 0.0, "Maximum memory (in MB) used by the jobs running in parallel, estimated from the input file sizes and the peak memory of previous runs of each tool (0 = unlimited)", false, true);
+    setMinFloat_("memory_limit", 0.0);
+    registerFlag_("in_memory", "Run tools backed by an algorithm class in-process and hand their data to each other in memory; other intermediate files are written to the memory-backed file system given by 'memory_dir'", true);
+    registerDoubleOption_("in_memory_limit", "<MB>", 4096.0, "Maximum memory (in MB) for intermediate data kept in memory if 'in_memory' is set; larger data is written to a file (0 = unlimited)", false, true);
+    setMinFloat_("in_memory_limit", 0.0);
+    registerStringOption_("memory_dir", "<directory>", "/dev/shm", "Memory-backed directory (e.g. a tmpfs mount) for intermediate files which are still written if 'in_memory' is set", false, true);
+    registerDoubleOption_("memory_min_free", "<MB>", 1024.0, "Minimal free space (in MB) on 'memory_dir' required to use it, otherwise intermediate files are written to the regular temporary directory", false, true);
+    setMinFloat_("memory_min_free", 0.0);
+  }
+
+  /// Returns the directory below which intermediate files are stored
+  String getTempRoot_() const
+  {
+    String disk_tmp = File::getTempDirectory();
+    if (!getFlag_("in_memory")) return disk_tmp;
+
+    String memory_dir = getStringOption_("memory_dir");
+    if (!File::exists(memory_dir) || !File::isDirectory(memory_dir) || !File::writable(memory_dir + "/" + File::getUniqueName()))
+    {
+      OPENMS_LOG_WARN << "Memory-backed directory '" << memory_dir << "' is not available. Writing intermediate files to '" << disk_tmp << "'." << std::endl;
+      return disk_tmp;
+    }
+
+    double free_mb = QStorageInfo(memory_dir.toQString()).bytesAvailable() / (1024.0 * 1024.0);
+    if (free_mb < getDoubleOption_("memory_min_free"))
+    {
+      OPENMS_LOG_WARN << "Only " << free_mb << " MB available in '" << memory_dir << "' (see 'memory_min_free'). Writing intermediate files to '" << disk_tmp << "'." << std::endl;
+      return disk_tmp;
+    }
+
+    OPENMS_LOG_INFO << "Writing intermediate files to the memory-backed directory '" << memory_dir << "' (" << free_mb << " MB available)." << std::endl;
+    return memory_dir;
   }
 
   ExitCodes main_(int argc, const char ** argv) override
@@ -119,13 +182,19 @@ protected:
     QString toppas_file = getStringOption_("in").toQString();
     QString out_dir_name = getStringOption_("out_dir").toQString();
     QString resource_file = getStringOption_("resource_file").toQString();
-    int num_jobs = getIntOption_("num_jobs");
+    int num_cores = getIntOption_("num_cores");
+    if (getIntOption_("num_jobs") != 1)
+    {
+      OPENMS_LOG_WARN << "The parameter 'num_jobs' is deprecated and now limits the number of CPU cores (each tool uses as many as its 'threads' parameter). Please use 'num_cores' instead." << std::endl;
+      if (num_cores == 1) num_cores = getIntOption_("num_jobs");
+    }
 
     QApplication a(argc, const_cast<char **>(argv), false);
 
     //set & create temporary path -- make sure its a new subdirectory, as it will be deleted later
+    String tmp_root = getTempRoot_();
     QString new_tmp_dir = File::getUniqueName().toQString();
-    QDir qd(File::getTempDirectory().toQString());
+    QDir qd(tmp_root.toQString());
     qd.mkdir(new_tmp_dir);
     qd.cd(new_tmp_dir);
     QString tmp_path = qd.absolutePath();
@@ -138,7 +207,9 @@ protected:
     if (!a.connect(&ts, SIGNAL(pipelineExecutionFailed()), &ts, SLOT(quitWithError()))) return UNKNOWN_ERROR;   // ... thus we use this
 
     ts.load(toppas_file);
-    ts.setAllowedThreads(num_jobs);
+    ts.setAllowedThreads(num_cores);
+    ts.setMemoryLimit(getDoubleOption_("memory_limit"));
+    ts.setInMemory(getFlag_("in_memory"), getDoubleOption_("in_memory_limit"));
 
     if (resource_file != "")
     {
@@ -184,7 +255,7 @@ protected:
     {
       // delete temporary files
       // safety measure: only delete if subdirectory of Temp path; we do not want to delete / or c:
-      if (String(tmp_path).substitute("\\", "/").hasPrefix(File::getTempDirectory().substitute("\\", "/") + "/"))
+      if (String(tmp_path).substitute("\\", "/").hasPrefix(tmp_root.substitute("\\", "/") + "/"))
       {
         File::removeDirRecursively(tmp_path);
       }
@@ -39,9 +39,7 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinder.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPicked.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
-#include <OpenMS/FORMAT/MzQuantMLFile.h>
-#include <OpenMS/METADATA/MSQuantifications.h>
-#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -184,23 +182,6 @@ protected:
 
     PeakMap exp;
     f.load(in, exp);
-    exp.updateRanges();
-
-    if (exp.getSpectra().empty())
-    {
-      throw OpenMS::Exception::FileEmpty(__FILE__, __LINE__, __FUNCTION__, "Error: No MS1 spectra in input file.");
-    }
-
-    // determine type of spectral data (profile or centroided)
-    SpectrumSettings::SpectrumType  spectrum_type = exp[0].getType();
-
-    if (spectrum_type == SpectrumSettings::PROFILE)
-    {
-      if (!getFlag_("force"))
-      {
-        throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Profile data provided but centroided spectra expected. To enforce processing of the data set the -force flag.");
-      }
-    }
 
     //load seeds
     FeatureMap seeds;
@@ -209,49 +190,13 @@ protected:
       FeatureXMLFile().load(getStringOption_("seeds"), seeds);
     }
 
-    //setup of FeatureFinder
-    FeatureFinder ff;
-    ff.setLogType(log_type_);
-
-    // A map for the resulting features
-    FeatureMap features;
-
-    if (getFlag_("test"))
-    {
-      // if test mode set, add file without path so we can compare it
-      features.setPrimaryMSRunPath({"file://" + File::basename(in)}, exp);
-    }
-    else
-    {
-      features.setPrimaryMSRunPath({in}, exp);
-    }    
-    
     // get parameters specific for the feature finder
     Param feafi_param = getParam_().copy("algorithm:", true);
     writeDebug_("Parameters passed to FeatureFinder", feafi_param, 3);
 
-    // Apply the feature finder
-    ff.run(FeatureFinderAlgorithmPicked::getProductName(), exp, features, feafi_param, seeds);
-    features.applyMemberFunction(&UniqueIdInterface::setUniqueId);
-
-    // DEBUG
-    if (debug_level_ > 10)
-    {
-      FeatureMap::Iterator it;
-      for (it = features.begin(); it != features.end(); ++it)
-      {
-        if (!it->isMetaEmpty())
-        {
-          vector<String> keys;
-          it->getKeys(keys);
-          OPENMS_LOG_INFO << "Feature " << it->getUniqueId() << endl;
-          for (Size i = 0; i < keys.size(); i++)
-          {
-            OPENMS_LOG_INFO << "  " << keys[i] << " = " << it->getMetaValue(keys[i]) << endl;
-          }
-        }
-      }
-    }
+    // A map for the resulting features
+    FeatureMap features;
+    TOPPToolCores::findFeatures(exp, in, seeds, feafi_param, getFlag_("force"), getFlag_("test"), debug_level_, log_type_, features);
 
     //-------------------------------------------------------------
     // writing files
@@ -261,38 +206,11 @@ protected:
     addDataProcessing_(features, getProcessingInfo_(DataProcessing::QUANTITATION));
 
     // write features to user specified output file
-    FeatureXMLFile map_file;
-
-    // Remove detailed convex hull information and subordinate features
-    // (unless requested otherwise) to reduce file size of feature files
-    // unless debugging is turned on.
-    if (debug_level_ < 5)
-    {
-      FeatureMap::Iterator it;
-      for (it = features.begin(); it != features.end(); ++it)
-      {
-        it->getConvexHull().expandToBoundingBox();
-        for (Size i = 0; i < it->getConvexHulls().size(); ++i)
-        {
-          it->getConvexHulls()[i].expandToBoundingBox();
-        }
-        it->getSubordinates().clear();
-      }
-    }
-
-    map_file.store(out, features);
+    FeatureXMLFile().store(out, features);
 
     if (!out_mzq.trim().empty())
     {
-      std::vector<DataProcessing> tmp;
-      for (Size i = 0; i < exp[0].getDataProcessing().size(); i++)
-      {
-        tmp.push_back(*exp[0].getDataProcessing()[i].get());
-      }
-      MSQuantifications msq(features, exp.getExperimentalSettings(), tmp );
-      msq.assignUIDs();
-      MzQuantMLFile file;
-      file.store(out_mzq, msq);
+      TOPPToolCores::storeMzQuantML(out_mzq, features, exp);
     }
 
     return EXECUTION_OK;
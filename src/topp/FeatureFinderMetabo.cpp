@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
 #include <OpenMS/KERNEL/MassTrace.h>
@@ -178,25 +179,67 @@ protected:
     String out_chrom = getStringOption_("out_chrom");
 
     //-------------------------------------------------------------
-    // loading input
+    // set parameters
     //-------------------------------------------------------------
+
+    Param common_param = getParam_().copy("algorithm:common:", true);
+    writeDebug_("Common parameters passed to sub-algorithms (mtd and ffm)", common_param, 3);
+
+    Param mtd_param = getParam_().copy("algorithm:mtd:", true);
+    writeDebug_("Parameters passed to MassTraceDetection", mtd_param, 3);
+
+    Param epd_param = getParam_().copy("algorithm:epd:", true);
+    writeDebug_("Parameters passed to ElutionPeakDetection", epd_param, 3);
+
+    Param ffm_param = getParam_().copy("algorithm:ffm:", true);
+    writeDebug_("Parameters passed to FeatureFindingMetabo", ffm_param, 3);
+
+    //-------------------------------------------------------------
+    // configure mass trace detection and load input
+    //-------------------------------------------------------------
+
+    MassTraceDetection mtdet;
+    mtd_param.insert("", common_param);
+    mtd_param.remove("chrom_fwhm");
+    mtdet.setParameters(mtd_param);
+
+    // spectra are passed to mass trace detection while the file is read, so
+    // the input map is never held in memory (only the MS1 peaks above the
+    // noise threshold are kept)
+    PeakMap ms_settings; // meta data only, no spectra
+    Size spectra_count(0);
+    SpectrumSettings::SpectrumType spectrum_type = SpectrumSettings::UNKNOWN;
+    set<IonSource::Polarity> pols;
+
+    MSDataTransformingConsumer consumer;
+    consumer.setSpectraProcessingFunc([&](MSSpectrum& spec)
+    {
+      // determine type of spectral data (profile or centroided)
+      if (spectra_count == 0) spectrum_type = spec.getType();
+      ++spectra_count;
+      pols.insert(spec.getInstrumentSettings().getPolarity());
+      // make sure the spectra are sorted by m/z
+      spec.sortByPosition();
+      mtdet.addSpectrum(spec);
+    });
+    consumer.setExperimentalSettingsFunc([&](const ExperimentalSettings& settings)
+    {
+      static_cast<ExperimentalSettings&>(ms_settings) = settings;
+    });
+
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
-    PeakMap ms_peakmap;
     std::vector<Int> ms_level(1, 1);
     mz_data_file.getOptions().setMSLevels(ms_level);
-    mz_data_file.load(in, ms_peakmap);
+    mz_data_file.transform(in, &consumer, true);
 
-    if (ms_peakmap.empty())
+    if (spectra_count == 0)
     {
       OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
                   " contain chromatograms. This tool currently cannot handle them, sorry.";
       return INCOMPATIBLE_INPUT_DATA;
     }
 
-    // determine type of spectral data (profile or centroided)
-    SpectrumSettings::SpectrumType spectrum_type = ms_peakmap[0].getType();
-
     if (spectrum_type == SpectrumSettings::PROFILE)
     {
       if (!getFlag_("force"))
@@ -206,37 +249,12 @@ protected:
       }
     }
 
-    // make sure the spectra are sorted by m/z
-    ms_peakmap.sortSpectra(true);
-
-    vector<MassTrace> m_traces;
-
     //-------------------------------------------------------------
-    // set parameters
+    // run mass trace detection
     //-------------------------------------------------------------
 
-    Param common_param = getParam_().copy("algorithm:common:", true);
-    writeDebug_("Common parameters passed to sub-algorithms (mtd and ffm)", common_param, 3);
-
-    Param mtd_param = getParam_().copy("algorithm:mtd:", true);
-    writeDebug_("Parameters passed to MassTraceDetection", mtd_param, 3);
-
-    Param epd_param = getParam_().copy("algorithm:epd:", true);
-    writeDebug_("Parameters passed to ElutionPeakDetection", epd_param, 3);
-
-    Param ffm_param = getParam_().copy("algorithm:ffm:", true);
-    writeDebug_("Parameters passed to FeatureFindingMetabo", ffm_param, 3);
-
-    //-------------------------------------------------------------
-    // configure and run mass trace detection
-    //-------------------------------------------------------------
-
-    MassTraceDetection mtdet;
-    mtd_param.insert("", common_param);
-    mtd_param.remove("chrom_fwhm");
-    mtdet.setParameters(mtd_param);
-
-    mtdet.run(ms_peakmap, m_traces);
+    vector<MassTrace> m_traces;
+    mtdet.run(m_traces);
 
     //-------------------------------------------------------------
     // configure and run elution peak detection
@@ -347,11 +365,6 @@ protected:
     // store ionization mode of spectra (useful for post-processing by AccurateMassSearch tool)
     if (!feat_map.empty())
     {
-      set<IonSource::Polarity> pols;
-      for (Size i = 0; i < ms_peakmap.size(); ++i)
-      {
-        pols.insert(ms_peakmap[i].getInstrumentSettings().getPolarity());
-      }
       // concat to single string
       StringList sl_pols;
       for (set<IonSource::Polarity>::const_iterator it = pols.begin(); it != pols.end(); ++it)
@@ -376,7 +389,7 @@ protected:
     }
     else
     {
-      feat_map.setPrimaryMSRunPath({in}, ms_peakmap);
+      feat_map.setPrimaryMSRunPath({in}, ms_settings);
     }    
 
     FeatureXMLFile feature_xml_file;
@@ -37,6 +37,7 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
 #include <OpenMS/DATASTRUCTURES/StringListUtils.h>
 
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
@@ -192,49 +193,13 @@ public:
     PeakMap exp;
     mz_data_file.load(in, exp);
 
-    if (exp.empty() && exp.getChromatograms().size() == 0)
-    {
-      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.";
-      return INCOMPATIBLE_INPUT_DATA;
-    }
-    //check for peak type (profile data required)
-    if (!exp.empty() && exp[0].getType(true) == SpectrumSettings::CENTROID)
-    {
-      writeLog_("Warning: OpenMS peak type estimation indicates that this is not profile data!");
-    }
-
-    //check if spectra are sorted
-    for (Size i = 0; i < exp.size(); ++i)
-    {
-      if (!exp[i].isSorted())
-      {
-        writeLog_("Error: Not all spectra are sorted according to peak m/z positions. Use FileFilter to sort the input!");
-        return INCOMPATIBLE_INPUT_DATA;
-      }
-    }
-
-    //check if chromatograms are sorted
-    for (Size i = 0; i < exp.getChromatograms().size(); ++i)
-    {
-      if (!exp.getChromatogram(i).isSorted())
-      {
-        writeLog_("Error: Not all chromatograms are sorted according to peak m/z positions. Use FileFilter to sort the input!");
-        return INCOMPATIBLE_INPUT_DATA;
-      }
-    }
-
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
-    try
-    {
-      gauss.filterExperiment(exp);
-    }
-    catch (Exception::IllegalArgument & e)
+    ExitCodes result = TOPPToolCores::smooth(gauss, exp);
+    if (result != EXECUTION_OK)
     {
-      writeLog_(String("Error: ") + e.getMessage());
-      return INCOMPATIBLE_INPUT_DATA;
+      return result;
     }
 
     //-------------------------------------------------------------
@@ -34,6 +34,7 @@
 #include <OpenMS/config.h>
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/DATASTRUCTURES/StringListUtils.h>
 #include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
@@ -195,42 +196,14 @@ public:
     PeakMap exp;
     mz_data_file.load(in, exp);
 
-    if (exp.empty() && exp.getChromatograms().size() == 0)
-    {
-      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.";
-      return INCOMPATIBLE_INPUT_DATA;
-    }
-    //check for peak type (profile data required)
-    if (!exp.empty() && exp[0].getType(true) == SpectrumSettings::CENTROID)
-    {
-      writeLog_("Warning: OpenMS peak type estimation indicates that this is not profile data!");
-    }
-
-    //check if spectra are sorted
-    for (Size i = 0; i < exp.size(); ++i)
-    {
-      if (!exp[i].isSorted())
-      {
-        writeLog_("Error: Not all spectra are sorted according to peak m/z positions. Use FileFilter to sort the input!");
-        return INCOMPATIBLE_INPUT_DATA;
-      }
-    }
-
-    //check if chromatograms are sorted
-    for (Size i = 0; i < exp.getChromatograms().size(); ++i)
-    {
-      if (!exp.getChromatogram(i).isSorted())
-      {
-        writeLog_("Error: Not all chromatograms are sorted according to peak m/z positions. Use FileFilter to sort the input!");
-        return INCOMPATIBLE_INPUT_DATA;
-      }
-    }
-
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
-    sgolay.filterExperiment(exp);
+    ExitCodes result = TOPPToolCores::smooth(sgolay, exp);
+    if (result != EXECUTION_OK)
+    {
+      return result;
+    }
 
     //-------------------------------------------------------------
     // writing output
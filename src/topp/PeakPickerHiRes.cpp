@@ -37,6 +37,7 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
 
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 
@@ -229,39 +230,16 @@ protected:
     PeakMap ms_exp_raw;
     mz_data_file.load(in, ms_exp_raw);
 
-    if (ms_exp_raw.empty() && ms_exp_raw.getChromatograms().size() == 0)
-    {
-      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.";
-      return INCOMPATIBLE_INPUT_DATA;
-    }
-
-    //check if spectra are sorted
-    for (Size i = 0; i < ms_exp_raw.size(); ++i)
-    {
-      if (!ms_exp_raw[i].isSorted())
-      {
-        writeLog_("Error: Not all spectra are sorted according to peak m/z positions. Use FileFilter to sort the input!");
-        return INCOMPATIBLE_INPUT_DATA;
-      }
-    }
-
-    //check if chromatograms are sorted
-    for (Size i = 0; i < ms_exp_raw.getChromatograms().size(); ++i)
-    {
-      if (!ms_exp_raw.getChromatogram(i).isSorted())
-      {
-        writeLog_("Error: Not all chromatograms are sorted according to peak m/z positions. Use FileFilter to sort the input!");
-        return INCOMPATIBLE_INPUT_DATA;
-      }
-    }
-
     //-------------------------------------------------------------
     // pick
     //-------------------------------------------------------------
     PeakMap ms_exp_peaks;
     bool check_spectrum_type = !getFlag_("force");
-    pp.pickExperiment(ms_exp_raw, ms_exp_peaks, check_spectrum_type);
+    ExitCodes result = TOPPToolCores::pickPeaks(pp, ms_exp_raw, ms_exp_peaks, check_spectrum_type);
+    if (result != EXECUTION_OK)
+    {
+      return result;
+    }
 
     //-------------------------------------------------------------
     // writing output
@@ -33,13 +33,13 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/APPLICATIONS/TOPPToolCores.h>
 
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
-#include <OpenMS/SYSTEM/File.h>
 
 using namespace OpenMS;
 
@@ -92,6 +92,10 @@ using namespace OpenMS;
   PeptideIndexer supports relative database filenames, which (when not found in the current working directory) are looked up in the directories specified
   by @p OpenMS.ini:id_db_dir (see @subpage TOPP_advanced).
 
+  If the same database is searched repeatedly, build a protein index once using @ref UTILS_ProteinIndexBuilder and pass it via @p index.
+  Peptides are then looked up in the index directly, which avoids scanning the whole database in every run. The FASTA file is still required
+  (for accessions and target/decoy information) and must be the one the index was built from.
+
   Further details can be found in the underlying PeptideIndexing implementation.
   
   @note Currently mzIdentML (mzid) is not directly supported as an input/output format of this tool. Convert mzid files to/from idXML using @ref TOPP_IDFileConverter if necessary.
@@ -123,6 +127,7 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("idXML"));
     registerInputFile_("fasta", "<file>", "", "Input sequence database in FASTA format. Non-existing relative filenames are looked up via 'OpenMS.ini:id_db_dir'", true, false, ListUtils::create<String>("skipexists"));
     setValidFormats_("fasta", ListUtils::create<String>("fasta"));
+    registerInputFile_("index", "<file>", "", "Protein index of the database, built by ProteinIndexBuilder (optional). Speeds up repeated searches of the same database.", false, true);
     registerOutputFile_("out", "<file>", "", "Output idXML file.");
     setValidFormats_("out", ListUtils::create<String>("idXML"));
 
@@ -144,27 +149,16 @@ protected:
     indexer.setParameters(param_pi);
     indexer.setLogType(this->log_type_);
     String db_name = getStringOption_("fasta");
-    if (!File::readable(db_name))
+    if (!TOPPToolCores::findDatabase(db_name))
     {
-      String full_db_name;
-      try
-      {
-        full_db_name = File::findDatabase(db_name);
-      }
-      catch (...)
-      {
-        printUsage_();
-        return ILLEGAL_PARAMETERS;
-      }
-      db_name = full_db_name;
+      printUsage_();
+      return ILLEGAL_PARAMETERS;
     }
 
-
     //-------------------------------------------------------------
     // reading input
     //-------------------------------------------------------------
 
-    // we stream the Fasta file
     std::vector<ProteinIdentification> prot_ids;
     std::vector<PeptideIdentification> pep_ids;
 
@@ -176,19 +170,10 @@ protected:
     // calculations
     //-------------------------------------------------------------
 
-    FASTAContainer<TFI_File> proteins(db_name);
-    PeptideIndexing::ExitCodes indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
-  
-    //-------------------------------------------------------------
-    // calculate protein coverage
-    //-------------------------------------------------------------
-
-    if (param.getValue("write_protein_sequence").toBool())
-    {
-      for (Size i = 0; i < prot_ids.size(); ++i)
-      {
-        prot_ids[i].computeCoverage(pep_ids);
-      }
+    ExitCodes result = TOPPToolCores::indexPeptides(indexer, db_name, getStringOption_("index"), param.getValue("write_protein_sequence").toBool(), prot_ids, pep_ids);
+    if (result == ILLEGAL_PARAMETERS)
+    { // e.g. the protein index does not match the database; no output is written
+      return result;
     }
 
     //-------------------------------------------------------------
@@ -196,20 +181,7 @@ protected:
     //-------------------------------------------------------------
     idxmlfile.store(out, prot_ids, pep_ids);
 
-    if (indexer_exit == PeptideIndexing::DATABASE_EMPTY)
-    {
-      return INPUT_FILE_EMPTY;       
-    }
-    else if (indexer_exit == PeptideIndexing::UNEXPECTED_RESULT)
-    {
-      return UNEXPECTED_RESULT;
-    }
-    else if ((indexer_exit != PeptideIndexing::EXECUTION_OK) &&
-             (indexer_exit != PeptideIndexing::PEPTIDE_IDS_EMPTY))
-    {
-      return UNKNOWN_ERROR;
-    }
-    return EXECUTION_OK;
+    return result;
   }
 
 };
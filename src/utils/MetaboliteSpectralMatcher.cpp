@@ -78,6 +78,10 @@ using namespace std;
 
         MetaboliteSpectralMatcher matches spectra from a spectral library with tandem MS spectra.
 
+        Parsing a large spectral library (mzML) can take longer than the search itself. With @p database_cache,
+        the library is written to a binary cache file on the first run and read from that file on subsequent runs.
+        The cache is rebuilt automatically if it was created from a different database file, or if the database file was modified since.
+
         <B>The command line parameters of this tool are:</B>
         @verbinclude UTILS_MetaboliteSpectralMatcher.cli
         <B>INI file documentation of this tool:</B>
@@ -104,6 +108,7 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("mzML"));
     registerInputFile_("database", "<file>", "", "Default spectral database.", true);
     setValidFormats_("database", ListUtils::create<String>("mzML"));
+    registerStringOption_("database_cache", "<file>", "", "Binary cache of the spectral database. If the file exists and was created from the current 'database', the database is read from it, otherwise it is (re)created.", false, true);
     registerOutputFile_("out", "<file>", "", "mzTab file");
     setValidFormats_("out", ListUtils::create<String>("mzTab"));
 
@@ -167,7 +172,25 @@ protected:
     //-------------------------------------------------------------
 
     PeakMap spec_db;
-    mz_file.load(spec_db_filename, spec_db);
+    String database_cache = getStringOption_("database_cache");
+    if (!database_cache.empty() && MetaboliteSpectralMatching::isLibraryCacheCurrent(database_cache, spec_db_filename))
+    {
+      writeLog_("Reading spectral database from cache file '" + database_cache + "'.");
+      MetaboliteSpectralMatching::loadLibraryCache(database_cache, spec_db);
+    }
+    else
+    {
+      mz_file.load(spec_db_filename, spec_db);
+      if (!database_cache.empty())
+      {
+        if (File::exists(database_cache))
+        {
+          writeLog_("Spectral database cache file '" + database_cache + "' was not created from the current '" + spec_db_filename + "'. Rebuilding it.");
+        }
+        writeLog_("Writing spectral database cache file '" + database_cache + "'.");
+        MetaboliteSpectralMatching::storeLibraryCache(database_cache, spec_db, spec_db_filename);
+      }
+    }
 
     if (spec_db.empty())
     {
@@ -138,7 +138,10 @@ using namespace OpenMS;
   Since the file size can become rather large, it is recommended to not load the
   whole file into memory but rather cache it somewhere on the disk using a
   fast-access data format. This can be specified using the -readOptions cache
-  parameter (this is recommended!).
+  parameter (this is recommended!). Alternatively, -readOptions compact keeps
+  the data of a single mzML or mzXML file in memory in a compact form, which
+  needs about half the memory of -readOptions normal (at an m/z precision
+  better than 1e-6 Th, see CompactSpectrum).
 
   The assay library (transition list) is provided through the @p -tr parameter and can be in one of the following formats:
   
@@ -514,8 +517,8 @@ protected:
     registerFlag_("split_file_input", "The input files each contain one single SWATH (alternatively: all SWATH are in separate files)", true);
     registerFlag_("use_elution_model_score", "Turn on elution model score (EMG fit to peak)", true);
 
-    registerStringOption_("readOptions", "<name>", "normal", "Whether to run OpenSWATH directly on the input data, cache data to disk first or to perform a datareduction step first. If you choose cache, make sure to also set tempDirectory", false, true);
-    setValidStrings_("readOptions", ListUtils::create<String>("normal,cache,cacheWorkingInMemory,workingInMemory"));
+    registerStringOption_("readOptions", "<name>", "normal", "Whether to run OpenSWATH directly on the input data, cache data to disk first or to perform a datareduction step first. If you choose cache, make sure to also set tempDirectory. 'compact' keeps the input in memory using about half the memory of 'normal' (single mzML or mzXML input only).", false, true);
+    setValidStrings_("readOptions", ListUtils::create<String>("normal,cache,cacheWorkingInMemory,workingInMemory,compact"));
 
     registerStringOption_("mz_correction_function", "<name>", "none", "Use the retention time normalization peptide MS2 masses to perform a mass correction (linear, weighted by intensity linear or quadratic) of all spectra.", false, true);
     setValidStrings_("mz_correction_function", ListUtils::create<String>("none,regression_delta_ppm,unweighted_regression,weighted_regression,quadratic_regression,weighted_quadratic_regression,weighted_quadratic_regression_delta_ppm,quadratic_regression_delta_ppm"));
@@ -528,6 +531,10 @@ protected:
     registerIntOption_("batchSize", "<number>", 250, "The batch size of chromatograms to process (0 means to only have one batch, sensible values are around 250-1000)", false, true);
     setMinInt_("batchSize", 0);
     registerIntOption_("outer_loop_threads", "<number>", -1, "How many threads should be used for the outer loop (-1 use all threads, use 4 to analyze 4 SWATH windows in memory at once).", false, true);
+    registerIntOption_("prefetch_maps", "<number>", 0, "Number of SWATH maps to load into memory in the background while the current maps are analyzed (0 disables prefetching). Use at least the number of outer loop threads; recommended with readOptions 'cache'.", false, true);
+    setMinInt_("prefetch_maps", 0);
+    registerDoubleOption_("prefetch_memory", "<MB>", 0.0, "Memory budget in MB for prefetched SWATH maps (0 means no limit other than prefetch_maps).", false, true);
+    setMinFloat_("prefetch_memory", 0.0);
 
     registerIntOption_("ms1_isotopes", "<number>", 0, "The number of MS1 isotopes used for extraction", false, true);
     setMinInt_("ms1_isotopes", 0);
@@ -687,6 +694,8 @@ protected:
     bool enable_uis_scoring = getFlag_("enable_uis_scoring");
     int batchSize = (int)getIntOption_("batchSize");
     int outer_loop_threads = (int)getIntOption_("outer_loop_threads");
+    Size prefetch_maps = (Size)getIntOption_("prefetch_maps");
+    double prefetch_memory = getDoubleOption_("prefetch_memory");
     int ms1_isotopes = (int)getIntOption_("ms1_isotopes");
     Size debug_level = (Size)getIntOption_("debug");
 
@@ -724,6 +733,12 @@ protected:
       std::cout << "When using sqMass input files, it is highly recommended to use the workingInMemory option as otherwise data access will be very slow." << std::endl;
     }
 
+    if (readoptions == "compact" && (split_file || file_list.size() > 1 || is_sqmass_input))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "The readOptions 'compact' can only be used with a single mzML or mzXML input file.");
+    }
+
     if (trafo_in.empty() && irt_tr_file.empty())
     {
       std::cout << "Since neither rt_norm nor tr_irt is set, OpenSWATH will " <<
@@ -948,6 +963,7 @@ protected:
     {
       OpenSwathWorkflow wf(use_ms1_traces, use_ms1_im, prm, outer_loop_threads);
       wf.setLogType(log_type_);
+      wf.setPrefetch(prefetch_maps, prefetch_memory);
       wf.performExtraction(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
           out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory);
     }
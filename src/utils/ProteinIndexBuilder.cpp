@@ -0,0 +1,131 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Chris Bielow $
+// $Authors: Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+
+#include <OpenMS/ANALYSIS/ID/ProteinIndex.h>
+#include <OpenMS/DATASTRUCTURES/FASTAContainer.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+  @page UTILS_ProteinIndexBuilder ProteinIndexBuilder
+
+  @brief Builds a protein index of a FASTA database, to speed up repeated runs of @ref TOPP_PeptideIndexer on the same database.
+
+  <CENTER>
+  <table>
+    <tr>
+      <td ALIGN = "center" BGCOLOR="#EBEBEB"> pot. predecessor tools </td>
+      <td VALIGN="middle" ROWSPAN=2> \f$ \longrightarrow \f$ ProteinIndexBuilder \f$ \longrightarrow \f$</td>
+      <td ALIGN = "center" BGCOLOR="#EBEBEB"> pot. successor tools </td>
+    </tr>
+    <tr>
+      <td VALIGN="middle" ALIGN = "center" ROWSPAN=1> @ref UTILS_DecoyDatabase </td>
+      <td VALIGN="middle" ALIGN = "center" ROWSPAN=1> @ref TOPP_PeptideIndexer </td>
+    </tr>
+  </table>
+  </CENTER>
+
+  The index contains the protein sequences of the (target+decoy) database together with their suffix array (see ProteinIndex).
+  @ref TOPP_PeptideIndexer memory-maps it (parameter @p index) and looks up each peptide directly, instead of scanning the whole database for every input file.
+
+  The index must be rebuilt whenever the database changes; PeptideIndexer verifies that database and index match.
+  The @p IL_equivalent setting is part of the index and must match the one used in PeptideIndexer.
+  All other PeptideIndexer settings (enzyme, ambiguous amino acids, mismatches, decoy string) can be chosen freely when searching.
+
+  Building requires about 20 bytes of memory per residue in the database; the index file takes about 5 bytes per residue.
+
+  <B>The command line parameters of this tool are:</B>
+  @verbinclude UTILS_ProteinIndexBuilder.cli
+  <B>INI file documentation of this tool:</B>
+  @htmlinclude UTILS_ProteinIndexBuilder.html
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPProteinIndexBuilder :
+  public TOPPBase
+{
+public:
+  TOPPProteinIndexBuilder() :
+    TOPPBase("ProteinIndexBuilder", "Builds a protein index of a FASTA database for PeptideIndexer.", false)
+  {
+  }
+
+protected:
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "Input sequence database in FASTA format (usually the concatenated target+decoy database).");
+    setValidFormats_("in", ListUtils::create<String>("fasta"));
+    registerOutputFile_("out", "<file>", "", "Output protein index.");
+    registerFlag_("IL_equivalent", "Treat the isobaric amino acids isoleucine ('I') and leucine ('L') as equivalent (see PeptideIndexer). Must match the PeptideIndexer setting.");
+  }
+
+  ExitCodes main_(int, const char**) override
+  {
+    String in = getStringOption_("in");
+    String out = getStringOption_("out");
+
+    StopWatch sw;
+    sw.start();
+    FASTAContainer<TFI_File> proteins(in);
+    ProteinIndex index;
+    index.build(proteins, getFlag_("IL_equivalent"));
+    if (index.empty())
+    {
+      OPENMS_LOG_ERROR << "Error: The database '" << in << "' is empty." << endl;
+      return INPUT_FILE_EMPTY;
+    }
+    index.store(out);
+    sw.stop();
+
+    OPENMS_LOG_INFO << "Indexed " << index.size() << " proteins in " << sw.toString() << "." << endl;
+    return EXECUTION_OK;
+  }
+};
+
+int main(int argc, const char** argv)
+{
+  TOPPProteinIndexBuilder tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
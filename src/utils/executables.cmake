@@ -49,6 +49,7 @@ QCExtractor
 QCImporter
 QCMerger
 QCShrinker
+ProteinIndexBuilder
 ProteomicsLFQ
 RNADigestor
 RNAMassCalculator